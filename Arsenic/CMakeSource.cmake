@@ -41,6 +41,36 @@ ${EXTERNAL_SOURCE}
 
 "Source/Arsenic/Renderer/Camera.cpp"
 "Source/Arsenic/Renderer/Camera.hpp"
+"Source/Arsenic/Renderer/DeletionQueue.hpp"
+"Source/Arsenic/Renderer/DeletionQueue.cpp"
+"Source/Arsenic/Renderer/FrameAllocator.hpp"
+"Source/Arsenic/Renderer/FrameAllocator.cpp"
+"Source/Arsenic/Renderer/MemoryBudget.hpp"
+"Source/Arsenic/Renderer/MemoryBudget.cpp"
+"Source/Arsenic/Renderer/Defragmenter.hpp"
+"Source/Arsenic/Renderer/Defragmenter.cpp"
+"Source/Arsenic/Renderer/GpuTimeline.hpp"
+"Source/Arsenic/Renderer/GpuTimeline.cpp"
+"Source/Arsenic/Renderer/HostAllocator.hpp"
+"Source/Arsenic/Renderer/HostAllocator.cpp"
+"Source/Arsenic/Renderer/UploadBatch.hpp"
+"Source/Arsenic/Renderer/UploadBatch.cpp"
+"Source/Arsenic/Renderer/ScatterUpload.hpp"
+"Source/Arsenic/Renderer/ScatterUpload.cpp"
+"Source/Arsenic/Renderer/TextureStreamer.hpp"
+"Source/Arsenic/Renderer/TextureStreamer.cpp"
+"Source/Arsenic/Renderer/Ktx2Loader.hpp"
+"Source/Arsenic/Renderer/Ktx2Loader.cpp"
+"Source/Arsenic/Renderer/MipDownsampler.hpp"
+"Source/Arsenic/Renderer/MipDownsampler.cpp"
+"Source/Arsenic/Renderer/ExrImage.hpp"
+"Source/Arsenic/Renderer/ExrImage.cpp"
+"Source/Arsenic/Renderer/IblBaker.hpp"
+"Source/Arsenic/Renderer/IblBaker.cpp"
+"Source/Arsenic/Renderer/BindlessTable.hpp"
+"Source/Arsenic/Renderer/BindlessTable.cpp"
+"Source/Arsenic/Renderer/TextureFeedback.hpp"
+"Source/Arsenic/Renderer/TextureFeedback.cpp"
 "Source/Arsenic/Renderer/MaterialManager.hpp"
 "Source/Arsenic/Renderer/MaterialManager.cpp"
 "Source/Arsenic/Renderer/VulkanBuffer.hpp"
@@ -49,6 +79,20 @@ ${EXTERNAL_SOURCE}
 "Source/Arsenic/Renderer/VulkanImage.cpp"
 "Source/Arsenic/Renderer/Shader.hpp"
 "Source/Arsenic/Renderer/Shader.cpp"
+"Source/Arsenic/Renderer/PipelineCache.hpp"
+"Source/Arsenic/Renderer/PipelineCache.cpp"
+"Source/Arsenic/Renderer/PipelineBuilder.hpp"
+"Source/Arsenic/Renderer/PipelineBuilder.cpp"
+"Source/Arsenic/Renderer/LayoutCache.hpp"
+"Source/Arsenic/Renderer/LayoutCache.cpp"
+"Source/Arsenic/Renderer/ShaderHotReload.hpp"
+"Source/Arsenic/Renderer/ShaderHotReload.cpp"
+"Source/Arsenic/Renderer/ShaderVariantCache.hpp"
+"Source/Arsenic/Renderer/ShaderVariantCache.cpp"
+"Source/Arsenic/Renderer/ShaderMetadata.hpp"
+"Source/Arsenic/Renderer/ShaderMetadata.cpp"
+"Source/Arsenic/Renderer/ShaderBundle.hpp"
+"Source/Arsenic/Renderer/ShaderBundle.cpp"
 "Source/Arsenic/Renderer/Structure.hpp"
 "Source/Arsenic/Renderer/Handle.hpp"
 "Source/Arsenic/Renderer/Instance.cpp"
@@ -70,9 +114,14 @@ ${EXTERNAL_SOURCE}
 
 "Source/Arsenic/Arsenicpch.hpp"
 "Source/Arsenic/Core/EntryPoint.cpp"
+"Source/Arsenic/Core/FileSystem.cpp"
+"Source/Arsenic/Core/FileSystem.hpp"
+"Source/Arsenic/Core/Hash.hpp"
 "Source/Arsenic/Core/Application.cpp"
 "Source/Arsenic/Core/Application.hpp"
 "Source/Arsenic/Core/Application.inl"
+"Source/Arsenic/Core/Inflate.cpp"
+"Source/Arsenic/Core/Inflate.hpp"
 "Source/Arsenic/Core/Input.cpp"
 "Source/Arsenic/Core/Input.hpp"
 "Source/Arsenic/Core/Keycode.hpp"
@@ -80,6 +129,8 @@ ${EXTERNAL_SOURCE}
 "Source/Arsenic/Core/Logger.cpp"
 "Source/Arsenic/Core/Logger.hpp"
 "Source/Arsenic/Core/Mousecode.hpp"
+"Source/Arsenic/Core/ThreadPool.cpp"
+"Source/Arsenic/Core/ThreadPool.hpp"
 "Source/Arsenic/Core/Utils.hpp"
 "Source/Arsenic/Core/Window.cpp"
 "Source/Arsenic/Core/Window.hpp")
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "../../Arsenic/Source/Arsenic/Core/Application.hpp"
+#include "../../Arsenic/Source/Arsenic/Core/FileSystem.hpp"
+#include "../../Arsenic/Source/Arsenic/Core/Hash.hpp"
+#include "../../Arsenic/Source/Arsenic/Core/Inflate.hpp"
 #include "../../Arsenic/Source/Arsenic/Core/Input.hpp"
 #include "../../Arsenic/Source/Arsenic/Core/Keycode.hpp"
 #include "../../Arsenic/Source/Arsenic/Core/Layer.hpp"
 #include "../../Arsenic/Source/Arsenic/Core/Mousecode.hpp"
+#include "../../Arsenic/Source/Arsenic/Core/ThreadPool.hpp"
 #include "../../Arsenic/Source/Arsenic/Core/Utils.hpp"
 #include "../../Arsenic/Source/Arsenic/Core/Window.hpp"
 
@@ -20,8 +24,30 @@
 #include "../../Arsenic/Source/Arsenic/Renderer/Structure.hpp"
 #include "../../Arsenic/Source/Arsenic/Renderer/VulkanBuffer.hpp"
 #include "../../Arsenic/Source/Arsenic/Renderer/VulkanImage.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/DeletionQueue.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/FrameAllocator.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/MemoryBudget.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/Defragmenter.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/HostAllocator.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/UploadBatch.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/ScatterUpload.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/TextureStreamer.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/Ktx2Loader.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/MipDownsampler.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/ExrImage.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/IblBaker.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/GpuTimeline.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/BindlessTable.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/TextureFeedback.hpp"
 #include "../../Arsenic/Source/Arsenic/Renderer/MaterialManager.hpp"
 #include "../../Arsenic/Source/Arsenic/Renderer/Shader.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/PipelineCache.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/PipelineBuilder.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/LayoutCache.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/ShaderHotReload.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/ShaderVariantCache.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/ShaderMetadata.hpp"
+#include "../../Arsenic/Source/Arsenic/Renderer/ShaderBundle.hpp"
 #include "../../Arsenic/Source/Arsenic/Renderer/Camera.hpp"
 #include "../../Arsenic/Source/Arsenic/Renderer/Swapchain.hpp"
 #include "../../Arsenic/Source/Arsenic/Renderer/VulkanHeader.hpp"
@@ -9,9 +9,11 @@
 #include <cstddef>
 #include <type_traits>
 #include <sstream>
+#include <iomanip>
 #include <fstream>
 #include <filesystem>
 #include <mutex>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
@@ -33,6 +35,7 @@
 #include <deque>
 #include <queue>
 #include <future>
+#include <condition_variable>
 #include <map>
 #include <unordered_map>
 #include <set>
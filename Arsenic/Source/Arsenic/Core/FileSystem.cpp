@@ -0,0 +1,393 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Core/Logger.hpp"
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace arsenic
+{
+    // Whole file mapped read only, empty files have a null pData but are still valid
+    class MappedFile final
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile(MappedFile &&) = delete;
+        MappedFile &operator=(MappedFile &&) = delete;
+
+        static std::shared_ptr<MappedFile> open(const std::string &filePath);
+
+        void prefetch(const std::size_t offset, const std::size_t size) const;
+
+        const uint8_t *getData() const { return m_pData; }
+        std::size_t getSize() const { return m_size; }
+    private:
+        const uint8_t *m_pData = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    struct Mount
+    {
+        std::string mountPoint;
+        std::string directoryPath;
+        // Only set for packs
+        std::shared_ptr<MappedFile> pack;
+        const PackEntry *pEntries = nullptr;
+        uint32_t entryCount = 0;
+    };
+
+    static std::mutex s_mountMutex;
+    static std::vector<std::shared_ptr<const Mount>> s_mounts;
+
+#ifdef _WIN32
+    MappedFile::~MappedFile()
+    {
+        if (m_pData) {
+            UnmapViewOfFile(m_pData);
+        }
+    }
+
+    std::shared_ptr<MappedFile> MappedFile::open(const std::string &filePath)
+    {
+        const std::wstring wideFilePath = std::filesystem::path(filePath).wstring();
+
+        HANDLE file = CreateFileW(wideFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        auto mappedFile = std::make_shared<MappedFile>();
+        mappedFile->m_size = static_cast<std::size_t>(fileSize.QuadPart);
+
+        if (mappedFile->m_size != 0) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+            if (mapping) {
+                mappedFile->m_pData = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                // The view keeps the mapping object alive on its own
+                CloseHandle(mapping);
+            }
+
+            if (!mappedFile->m_pData) {
+                CloseHandle(file);
+                return nullptr;
+            }
+        }
+
+        CloseHandle(file);
+        return mappedFile;
+    }
+
+    void MappedFile::prefetch(const std::size_t offset, const std::size_t size) const
+    {
+        if (!m_pData || offset >= m_size) {
+            return;
+        }
+
+        WIN32_MEMORY_RANGE_ENTRY range = {};
+        range.VirtualAddress = const_cast<uint8_t *>(m_pData + offset);
+        range.NumberOfBytes = std::min(size, m_size - offset);
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    MappedFile::~MappedFile()
+    {
+        if (m_pData) {
+            munmap(const_cast<uint8_t *>(m_pData), m_size);
+        }
+    }
+
+    std::shared_ptr<MappedFile> MappedFile::open(const std::string &filePath)
+    {
+        const int fd = ::open(filePath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat fileStat = {};
+        if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+            close(fd);
+            return nullptr;
+        }
+
+        auto mappedFile = std::make_shared<MappedFile>();
+        mappedFile->m_size = static_cast<std::size_t>(fileStat.st_size);
+
+        if (mappedFile->m_size != 0) {
+            void *pData = mmap(nullptr, mappedFile->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (pData == MAP_FAILED) {
+                close(fd);
+                return nullptr;
+            }
+
+            mappedFile->m_pData = static_cast<const uint8_t *>(pData);
+        }
+
+        // The mapping keeps a reference to the file on its own
+        close(fd);
+        return mappedFile;
+    }
+
+    void MappedFile::prefetch(const std::size_t offset, const std::size_t size) const
+    {
+        if (!m_pData || offset >= m_size) {
+            return;
+        }
+
+        static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+        const std::size_t begin = offset & ~(pageSize - 1);
+        const std::size_t end = offset + std::min(size, m_size - offset);
+        madvise(const_cast<uint8_t *>(m_pData + begin), end - begin, MADV_WILLNEED);
+    }
+#endif
+
+    static std::string normalizePath(const char *path)
+    {
+        std::string normalizedPath(path);
+        std::replace(normalizedPath.begin(), normalizedPath.end(), '\\', '/');
+
+        while (normalizedPath.compare(0, 2, "./") == 0) {
+            normalizedPath.erase(0, 2);
+        }
+
+        while (!normalizedPath.empty() && normalizedPath.back() == '/') {
+            normalizedPath.pop_back();
+        }
+
+        return normalizedPath;
+    }
+
+    // Path relative to the mount point, or nullopt when the mount does not serve path
+    static std::optional<std::string_view> getRelativePath(const Mount &mount, const std::string &path)
+    {
+        if (mount.mountPoint.empty()) {
+            return std::string_view(path);
+        }
+
+        if (path.compare(0, mount.mountPoint.size(), mount.mountPoint) != 0) {
+            return std::nullopt;
+        }
+
+        if (path.size() == mount.mountPoint.size()) {
+            return std::string_view();
+        }
+
+        if (path[mount.mountPoint.size()] != '/') {
+            return std::nullopt;
+        }
+
+        return std::string_view(path).substr(mount.mountPoint.size() + 1);
+    }
+
+    static const PackEntry *findPackEntry(const Mount &mount, const std::string_view relativePath)
+    {
+        const char *pNames = reinterpret_cast<const char *>(mount.pack->getData() + reinterpret_cast<const PackHeader *>(mount.pack->getData())->namesOffset);
+
+        const PackEntry *pEnd = mount.pEntries + mount.entryCount;
+        const PackEntry *pEntry = std::lower_bound(mount.pEntries, pEnd, relativePath, [pNames](const PackEntry &entry, const std::string_view name) {
+            return std::string_view(pNames + entry.nameOffset, entry.nameLength) < name;
+        });
+
+        if (pEntry != pEnd && std::string_view(pNames + pEntry->nameOffset, pEntry->nameLength) == relativePath) {
+            return pEntry;
+        }
+
+        return nullptr;
+    }
+
+    static std::vector<std::shared_ptr<const Mount>> getMounts()
+    {
+        std::lock_guard<std::mutex> lock(s_mountMutex);
+        return s_mounts;
+    }
+
+    bool mountDirectory(const char *mountPoint, const char *directoryPath)
+    {
+        if (!std::filesystem::is_directory(directoryPath)) {
+            ARSENIC_ERROR("FileSystem: {} is not a directory", directoryPath);
+            return false;
+        }
+
+        auto mount = std::make_shared<Mount>();
+        mount->mountPoint = normalizePath(mountPoint);
+        mount->directoryPath = normalizePath(directoryPath);
+
+        std::lock_guard<std::mutex> lock(s_mountMutex);
+        s_mounts.emplace_back(std::move(mount));
+
+        return true;
+    }
+
+    bool mountPack(const char *mountPoint, const char *packFilePath)
+    {
+        std::shared_ptr<MappedFile> pack = MappedFile::open(packFilePath);
+
+        if (!pack) {
+            ARSENIC_ERROR("FileSystem: Failed to map pack {}", packFilePath);
+            return false;
+        }
+
+        if (pack->getSize() < sizeof(PackHeader)) {
+            ARSENIC_ERROR("FileSystem: {} is not a pack", packFilePath);
+            return false;
+        }
+
+        const PackHeader &header = *reinterpret_cast<const PackHeader *>(pack->getData());
+        const uint64_t entriesEnd = header.entriesOffset + static_cast<uint64_t>(header.entryCount) * sizeof(PackEntry);
+
+        if (header.magic != packMagic || header.version != packVersion || header.entriesOffset % alignof(PackEntry) != 0 ||
+            entriesEnd > pack->getSize() || header.namesOffset > pack->getSize()) {
+            ARSENIC_ERROR("FileSystem: {} is not a version {} pack", packFilePath, packVersion);
+            return false;
+        }
+
+        auto mount = std::make_shared<Mount>();
+        mount->mountPoint = normalizePath(mountPoint);
+        mount->pEntries = reinterpret_cast<const PackEntry *>(pack->getData() + header.entriesOffset);
+        mount->entryCount = header.entryCount;
+
+        const uint64_t namesSize = pack->getSize() - header.namesOffset;
+        for (uint32_t i = 0; i != mount->entryCount; ++i) {
+            const PackEntry &entry = mount->pEntries[i];
+
+            if (entry.dataOffset > pack->getSize() || entry.size > pack->getSize() - entry.dataOffset ||
+                static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > namesSize) {
+                ARSENIC_ERROR("FileSystem: Entry {} of {} is out of bounds", i, packFilePath);
+                return false;
+            }
+        }
+
+        mount->pack = std::move(pack);
+
+        std::lock_guard<std::mutex> lock(s_mountMutex);
+        s_mounts.emplace_back(std::move(mount));
+
+        return true;
+    }
+
+    void unmountAll()
+    {
+        // Views already handed out keep their mappings alive
+        std::lock_guard<std::mutex> lock(s_mountMutex);
+        s_mounts.clear();
+    }
+
+    // Resolves path to a mapping and the range of it the file occupies
+    static bool resolveFile(const std::string &path, std::shared_ptr<MappedFile> &mappedFile, std::size_t &offset, std::size_t &size)
+    {
+        const std::vector<std::shared_ptr<const Mount>> mounts = getMounts();
+
+        for (auto it = mounts.rbegin(); it != mounts.rend(); ++it) {
+            const Mount &mount = **it;
+            const std::optional<std::string_view> relativePath = getRelativePath(mount, path);
+
+            if (!relativePath) {
+                continue;
+            }
+
+            if (mount.pack) {
+                if (const PackEntry *pEntry = findPackEntry(mount, *relativePath)) {
+                    mappedFile = mount.pack;
+                    offset = static_cast<std::size_t>(pEntry->dataOffset);
+                    size = static_cast<std::size_t>(pEntry->size);
+                    return true;
+                }
+            }
+            else {
+                std::string filePath = mount.directoryPath;
+                filePath += '/';
+                filePath += *relativePath;
+
+                if ((mappedFile = MappedFile::open(filePath))) {
+                    offset = 0;
+                    size = mappedFile->getSize();
+                    return true;
+                }
+            }
+        }
+
+        if ((mappedFile = MappedFile::open(path))) {
+            offset = 0;
+            size = mappedFile->getSize();
+            return true;
+        }
+
+        return false;
+    }
+
+    FileView readFile(const char *filePath)
+    {
+        std::shared_ptr<MappedFile> mappedFile;
+        std::size_t offset = 0;
+        std::size_t size = 0;
+
+        if (!resolveFile(normalizePath(filePath), mappedFile, offset, size)) {
+            return {};
+        }
+
+        FileView fileView = {};
+        fileView.pData = mappedFile->getData() ? mappedFile->getData() + offset : nullptr;
+        fileView.size = size;
+        fileView.mapping = std::move(mappedFile);
+
+        return fileView;
+    }
+
+    bool fileExists(const char *filePath)
+    {
+        const std::string path = normalizePath(filePath);
+
+        for (const std::shared_ptr<const Mount> &mount : getMounts()) {
+            const std::optional<std::string_view> relativePath = getRelativePath(*mount, path);
+
+            if (!relativePath) {
+                continue;
+            }
+
+            if (mount->pack ? findPackEntry(*mount, *relativePath) != nullptr
+                            : std::filesystem::is_regular_file(mount->directoryPath + '/' + std::string(*relativePath))) {
+                return true;
+            }
+        }
+
+        return std::filesystem::is_regular_file(path);
+    }
+
+    void prefetchFile(const char *filePath)
+    {
+        std::shared_ptr<MappedFile> mappedFile;
+        std::size_t offset = 0;
+        std::size_t size = 0;
+
+        // Loose files are unmapped right away again, what was read ahead stays in the page cache
+        if (resolveFile(normalizePath(filePath), mappedFile, offset, size)) {
+            mappedFile->prefetch(offset, size);
+        }
+    }
+}
\ No newline at end of file
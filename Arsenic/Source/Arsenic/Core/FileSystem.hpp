@@ -0,0 +1,54 @@
+#pragma once
+
+namespace arsenic
+{
+    // Read only bytes of a file, pData points straight into a memory mapping that stays alive as long as any view of it does.
+    // Views of files inside a pack share the mapping of the whole pack
+    struct FileView
+    {
+        const uint8_t *pData = nullptr;
+        std::size_t size = 0;
+        std::shared_ptr<const void> mapping;
+
+        bool isValid() const { return mapping != nullptr; }
+        std::string_view asString() const { return std::string_view(reinterpret_cast<const char *>(pData), size); }
+    };
+
+    // Layout of a pack written by ArsenicCooker pack, all fields little endian. The entry table is sorted by path,
+    // file data follows in the order the cooker was given so files read together page in together
+    constexpr uint32_t packMagic = 0x4B504141;
+    constexpr uint32_t packVersion = 1;
+    constexpr uint64_t packDataAlignment = 64;
+
+    struct PackHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t entriesOffset;
+        uint64_t namesOffset;
+    };
+
+    struct PackEntry
+    {
+        uint64_t dataOffset;
+        uint64_t size;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    // Paths are relative and use forward slashes, e.g. "Assets/Shaders/Spv/rtCompute.comp.spv". A mount serves every path
+    // below its mount point, mounts are searched from the most recent one and a path none of them serves is mapped relative
+    // to the working directory. Mount before other threads start reading, reads themselves may come from any thread
+    bool mountDirectory(const char *mountPoint, const char *directoryPath);
+    bool mountPack(const char *mountPoint, const char *packFilePath);
+    void unmountAll();
+
+    // Returns an invalid view when the file can not be found or mapped
+    FileView readFile(const char *filePath);
+    bool fileExists(const char *filePath);
+
+    // Asks the OS to start paging the file in, so a readFile issued later on does not wait on the disk
+    void prefetchFile(const char *filePath);
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace arsenic
+{
+    // FNV-1a. The result only depends on the bytes fed in, so it is also fit for naming and validating files on disk.
+    // Pass the result of a previous call as hash to continue hashing
+    constexpr uint64_t fnv1aOffsetBasis = 0xCBF29CE484222325ull;
+    constexpr uint64_t fnv1aPrime = 0x100000001B3ull;
+
+    inline uint64_t hashBytes(const void *pData, const std::size_t size, uint64_t hash = fnv1aOffsetBasis)
+    {
+        const uint8_t *pBytes = static_cast<const uint8_t *>(pData);
+
+        for (std::size_t i = 0; i != size; ++i) {
+            hash = (hash ^ pBytes[i]) * fnv1aPrime;
+        }
+
+        return hash;
+    }
+
+    // Feeds the 8 bytes of value least significant first, whatever the width of the type it came from
+    inline uint64_t hashValue(const uint64_t value, uint64_t hash = fnv1aOffsetBasis)
+    {
+        for (uint32_t i = 0; i != sizeof(value); ++i) {
+            hash = (hash ^ ((value >> (8 * i)) & 0xff)) * fnv1aPrime;
+        }
+
+        return hash;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/Inflate.hpp"
+
+namespace arsenic
+{
+    // Every code is resolved with a single lookup, the table is indexed by the next maxCodeLength input bits
+    static constexpr uint32_t maxCodeLength = 15;
+    static constexpr uint32_t lengthSymbolCount = 288;
+    static constexpr uint32_t distanceSymbolCount = 32;
+
+    static constexpr std::array<uint16_t, 29> lengthBases = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+
+    static constexpr std::array<uint8_t, 29> lengthExtraBits = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+
+    static constexpr std::array<uint16_t, 30> distanceBases = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+    };
+
+    static constexpr std::array<uint8_t, 30> distanceExtraBits = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    // Order in which the code lengths of the code length alphabet are stored in a dynamic block header
+    static constexpr std::array<uint8_t, 19> codeLengthOrder = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+    };
+
+    // Deflate packs bits LSB first. Zeros are fed past the end of the input so a code can always be looked up,
+    // the stream is only overrun once any of them has actually been consumed
+    struct BitReader
+    {
+        const uint8_t *pData;
+        const uint8_t *pEnd;
+        uint64_t bits = 0;
+        uint32_t bitCount = 0;
+        uint32_t paddingBitCount = 0;
+
+        void refill()
+        {
+            while (bitCount <= 56) {
+                if (pData != pEnd) {
+                    bits |= static_cast<uint64_t>(*pData++) << bitCount;
+                }
+                else {
+                    paddingBitCount += 8;
+                }
+
+                bitCount += 8;
+            }
+        }
+
+        bool isOverrun() const
+        {
+            return bitCount < paddingBitCount;
+        }
+
+        uint32_t peek(const uint32_t count) const
+        {
+            return static_cast<uint32_t>(bits & ((1ull << count) - 1));
+        }
+
+        void consume(const uint32_t count)
+        {
+            bits >>= count;
+            bitCount -= count;
+        }
+
+        uint32_t read(const uint32_t count)
+        {
+            if (bitCount < count) {
+                refill();
+            }
+
+            const uint32_t value = peek(count);
+            consume(count);
+
+            return value;
+        }
+    };
+
+    // Entries hold symbol << 4 | code length, 0 for bit patterns no code maps to
+    struct HuffmanTable
+    {
+        std::array<uint16_t, 1 << maxCodeLength> entries;
+    };
+
+    static bool buildHuffmanTable(HuffmanTable &table, const uint8_t *pCodeLengths, const uint32_t symbolCount)
+    {
+        std::array<uint32_t, maxCodeLength + 1> lengthCounts = {};
+        for (uint32_t i = 0; i != symbolCount; ++i) {
+            ++lengthCounts[pCodeLengths[i]];
+        }
+
+        lengthCounts[0] = 0;
+
+        std::array<uint32_t, maxCodeLength + 1> nextCodes = {};
+        uint32_t code = 0;
+        int32_t unusedCodes = 1;
+
+        for (uint32_t length = 1; length <= maxCodeLength; ++length) {
+            code = (code + lengthCounts[length - 1]) << 1;
+            nextCodes[length] = code;
+
+            unusedCodes = (unusedCodes << 1) - static_cast<int32_t>(lengthCounts[length]);
+            if (unusedCodes < 0) {
+                return false;
+            }
+        }
+
+        table.entries.fill(0);
+
+        for (uint32_t symbol = 0; symbol != symbolCount; ++symbol) {
+            const uint32_t length = pCodeLengths[symbol];
+            if (length == 0) {
+                continue;
+            }
+
+            // Codes are stored MSB first inside the LSB first bit stream, so the table is indexed by the reversed code
+            const uint32_t symbolCode = nextCodes[length]++;
+            uint32_t reversedCode = 0;
+            for (uint32_t i = 0; i != length; ++i) {
+                reversedCode |= ((symbolCode >> i) & 1) << (length - 1 - i);
+            }
+
+            const uint16_t entry = static_cast<uint16_t>(symbol << 4 | length);
+            for (uint32_t i = reversedCode; i < table.entries.size(); i += 1u << length) {
+                table.entries[i] = entry;
+            }
+        }
+
+        return true;
+    }
+
+    static bool decodeSymbol(BitReader &bitReader, const HuffmanTable &table, uint32_t &symbol)
+    {
+        if (bitReader.bitCount < maxCodeLength) {
+            bitReader.refill();
+        }
+
+        const uint16_t entry = table.entries[bitReader.peek(maxCodeLength)];
+        const uint32_t length = entry & 0xf;
+
+        if (length == 0) {
+            return false;
+        }
+
+        bitReader.consume(length);
+        symbol = entry >> 4;
+
+        return true;
+    }
+
+    static bool readDynamicTables(BitReader &bitReader, HuffmanTable &lengthTable, HuffmanTable &distanceTable)
+    {
+        const uint32_t lengthCount = bitReader.read(5) + 257;
+        const uint32_t distanceCount = bitReader.read(5) + 1;
+        const uint32_t codeLengthCount = bitReader.read(4) + 4;
+
+        std::array<uint8_t, codeLengthOrder.size()> codeLengthCodeLengths = {};
+        for (uint32_t i = 0; i != codeLengthCount; ++i) {
+            codeLengthCodeLengths[codeLengthOrder[i]] = static_cast<uint8_t>(bitReader.read(3));
+        }
+
+        // The code length alphabet is decoded with the distance table as scratch, it is rebuilt right after
+        if (!buildHuffmanTable(distanceTable, codeLengthCodeLengths.data(), static_cast<uint32_t>(codeLengthCodeLengths.size()))) {
+            return false;
+        }
+
+        std::array<uint8_t, lengthSymbolCount + distanceSymbolCount> codeLengths = {};
+        uint32_t count = 0;
+
+        while (count < lengthCount + distanceCount) {
+            uint32_t symbol = 0;
+            if (!decodeSymbol(bitReader, distanceTable, symbol)) {
+                return false;
+            }
+
+            if (symbol < 16) {
+                codeLengths[count++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t repeatedLength = 0;
+            uint32_t repeatCount = 0;
+
+            if (symbol == 16) {
+                if (count == 0) {
+                    return false;
+                }
+
+                repeatedLength = codeLengths[count - 1];
+                repeatCount = bitReader.read(2) + 3;
+            }
+            else if (symbol == 17) {
+                repeatCount = bitReader.read(3) + 3;
+            }
+            else {
+                repeatCount = bitReader.read(7) + 11;
+            }
+
+            if (count + repeatCount > lengthCount + distanceCount) {
+                return false;
+            }
+
+            std::fill_n(codeLengths.begin() + count, repeatCount, repeatedLength);
+            count += repeatCount;
+        }
+
+        // Literal 256 ends the block, a table without it cannot be valid
+        if (codeLengths[256] == 0) {
+            return false;
+        }
+
+        return buildHuffmanTable(lengthTable, codeLengths.data(), lengthCount) && 
+               buildHuffmanTable(distanceTable, codeLengths.data() + lengthCount, distanceCount);
+    }
+
+    static void buildFixedTables(HuffmanTable &lengthTable, HuffmanTable &distanceTable)
+    {
+        std::array<uint8_t, lengthSymbolCount> lengthCodeLengths = {};
+        std::fill(lengthCodeLengths.begin(), lengthCodeLengths.begin() + 144, static_cast<uint8_t>(8));
+        std::fill(lengthCodeLengths.begin() + 144, lengthCodeLengths.begin() + 256, static_cast<uint8_t>(9));
+        std::fill(lengthCodeLengths.begin() + 256, lengthCodeLengths.begin() + 280, static_cast<uint8_t>(7));
+        std::fill(lengthCodeLengths.begin() + 280, lengthCodeLengths.end(), static_cast<uint8_t>(8));
+
+        std::array<uint8_t, distanceSymbolCount> distanceCodeLengths = {};
+        distanceCodeLengths.fill(5);
+
+        buildHuffmanTable(lengthTable, lengthCodeLengths.data(), lengthSymbolCount);
+        buildHuffmanTable(distanceTable, distanceCodeLengths.data(), distanceSymbolCount);
+    }
+
+    static bool inflateBlock(BitReader &bitReader, const HuffmanTable &lengthTable, const HuffmanTable &distanceTable, 
+                    uint8_t *pDst, const std::size_t dstSize, std::size_t &dstOffset)
+    {
+        for (;;) {
+            uint32_t symbol = 0;
+            if (!decodeSymbol(bitReader, lengthTable, symbol)) {
+                return false;
+            }
+
+            if (symbol < 256) {
+                if (dstOffset == dstSize) {
+                    return false;
+                }
+
+                pDst[dstOffset++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            if (symbol == 256) {
+                return !bitReader.isOverrun();
+            }
+
+            symbol -= 257;
+            if (symbol >= lengthBases.size()) {
+                return false;
+            }
+
+            const std::size_t length = lengthBases[symbol] + bitReader.read(lengthExtraBits[symbol]);
+
+            uint32_t distanceSymbol = 0;
+            if (!decodeSymbol(bitReader, distanceTable, distanceSymbol) || distanceSymbol >= distanceBases.size()) {
+                return false;
+            }
+
+            const std::size_t distance = distanceBases[distanceSymbol] + bitReader.read(distanceExtraBits[distanceSymbol]);
+
+            if (distance > dstOffset || length > dstSize - dstOffset) {
+                return false;
+            }
+
+            // Matches may overlap their own output, which repeats the last distance bytes
+            const uint8_t *pMatch = pDst + dstOffset - distance;
+            uint8_t *pOut = pDst + dstOffset;
+
+            if (distance >= length) {
+                std::memcpy(pOut, pMatch, length);
+            }
+            else {
+                for (std::size_t i = 0; i != length; ++i) {
+                    pOut[i] = pMatch[i];
+                }
+            }
+
+            dstOffset += length;
+        }
+    }
+
+    bool inflateDeflate(const uint8_t *pSrc, const std::size_t srcSize, uint8_t *pDst, const std::size_t dstSize)
+    {
+        BitReader bitReader = {pSrc, pSrc + srcSize};
+
+        // Both tables are 64KiB, too large for the stack of worker threads
+        auto pLengthTable = std::make_unique<HuffmanTable>();
+        auto pDistanceTable = std::make_unique<HuffmanTable>();
+
+        std::size_t dstOffset = 0;
+        bool finalBlock = false;
+
+        while (!finalBlock) {
+            finalBlock = bitReader.read(1) != 0;
+            const uint32_t blockType = bitReader.read(2);
+
+            if (blockType == 0) {
+                if (bitReader.isOverrun()) {
+                    return false;
+                }
+
+                // Stored blocks start on a byte boundary, whole bytes still in the bit buffer are handed back to the input
+                bitReader.consume(bitReader.bitCount % 8);
+                bitReader.pData -= (bitReader.bitCount - bitReader.paddingBitCount) / 8;
+                bitReader.bits = 0;
+                bitReader.bitCount = 0;
+                bitReader.paddingBitCount = 0;
+
+                if (bitReader.pEnd - bitReader.pData < 4) {
+                    return false;
+                }
+
+                const uint32_t length = bitReader.pData[0] | bitReader.pData[1] << 8;
+                const uint32_t invLength = bitReader.pData[2] | bitReader.pData[3] << 8;
+                bitReader.pData += 4;
+
+                if ((length ^ 0xffff) != invLength || length > static_cast<std::size_t>(bitReader.pEnd - bitReader.pData) || 
+                    length > dstSize - dstOffset) {
+                    return false;
+                }
+
+                std::memcpy(pDst + dstOffset, bitReader.pData, length);
+                bitReader.pData += length;
+                dstOffset += length;
+                continue;
+            }
+
+            if (blockType == 1) {
+                buildFixedTables(*pLengthTable, *pDistanceTable);
+            }
+            else if (blockType == 2) {
+                if (!readDynamicTables(bitReader, *pLengthTable, *pDistanceTable) || bitReader.isOverrun()) {
+                    return false;
+                }
+            }
+            else {
+                return false;
+            }
+
+            if (!inflateBlock(bitReader, *pLengthTable, *pDistanceTable, pDst, dstSize, dstOffset)) {
+                return false;
+            }
+        }
+
+        return dstOffset == dstSize;
+    }
+
+    bool inflateZlib(const uint8_t *pSrc, const std::size_t srcSize, uint8_t *pDst, const std::size_t dstSize)
+    {
+        if (srcSize < 2) {
+            return false;
+        }
+
+        // Deflate with a window of at most 32KiB, no preset dictionary, and a header that is a multiple of 31
+        const uint32_t cmf = pSrc[0];
+        const uint32_t flg = pSrc[1];
+
+        if ((cmf & 0xf) != 8 || (cmf >> 4) > 7 || (flg & 0x20) != 0 || (cmf << 8 | flg) % 31 != 0) {
+            return false;
+        }
+
+        // The trailing adler32 is not verified, a corrupted stream almost always fails to decode to the exact size anyway
+        return inflateDeflate(pSrc + 2, srcSize - 2, pDst, dstSize);
+    }
+}
\ No newline at end of file
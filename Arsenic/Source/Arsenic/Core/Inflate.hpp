@@ -0,0 +1,11 @@
+#pragma once
+
+namespace arsenic
+{
+    // Decompresses a zlib stream (RFC 1950 wrapping RFC 1951 deflate) into exactly dstSize bytes.
+    // Returns false on malformed input or when the stream does not decode to exactly dstSize bytes
+    bool inflateZlib(const uint8_t *pSrc, const std::size_t srcSize, uint8_t *pDst, const std::size_t dstSize);
+
+    // Same as inflateZlib for a raw deflate stream without the zlib header and checksum
+    bool inflateDeflate(const uint8_t *pSrc, const std::size_t srcSize, uint8_t *pDst, const std::size_t dstSize);
+}
\ No newline at end of file
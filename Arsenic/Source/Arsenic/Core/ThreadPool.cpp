@@ -0,0 +1,99 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/ThreadPool.hpp"
+
+namespace arsenic
+{
+    ThreadPool::ThreadPool(uint32_t threadCount)
+    {
+        if (threadCount == 0) {
+            threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        m_workers.reserve(threadCount);
+
+        for (uint32_t i = 0; i != threadCount; ++i) {
+            m_workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_tasks.clear();
+        }
+
+        m_taskAvailable.notify_all();
+
+        for (std::thread &worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::enqueue(std::function<void()> &&task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            assert(!m_stop);
+            m_tasks.push_back(std::move(task));
+        }
+
+        m_taskAvailable.notify_one();
+    }
+
+    void ThreadPool::waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (runOneTask(lock)) {
+        }
+
+        m_idle.wait(lock, [this]() { return m_tasks.empty() && m_busyWorkers == 0; });
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            m_taskAvailable.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+
+            if (m_stop) {
+                return;
+            }
+
+            runOneTask(lock);
+        }
+    }
+
+    bool ThreadPool::runOneTask(std::unique_lock<std::mutex> &lock)
+    {
+        if (m_tasks.empty()) {
+            return false;
+        }
+
+        std::function<void()> task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        ++m_busyWorkers;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        --m_busyWorkers;
+
+        if (m_tasks.empty() && m_busyWorkers == 0) {
+            m_idle.notify_all();
+        }
+
+        return true;
+    }
+
+    ThreadPool &getSharedThreadPool()
+    {
+        static ThreadPool sharedThreadPool;
+        return sharedThreadPool;
+    }
+}
\ No newline at end of file
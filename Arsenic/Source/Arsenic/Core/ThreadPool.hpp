@@ -0,0 +1,57 @@
+#pragma once
+
+namespace arsenic
+{
+    // Fixed set of worker threads draining one FIFO task queue.
+    // Tasks still queued on destruction are dropped, the ones already running are finished first
+    class ThreadPool final
+    {
+    public:
+        // 0 picks one worker per hardware thread, leaving one for the main thread
+        explicit ThreadPool(uint32_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ThreadPool(ThreadPool &&) = delete;
+        ThreadPool &operator=(ThreadPool &&) = delete;
+
+        void enqueue(std::function<void()> &&task);
+
+        template<typename F>
+        auto submit(F &&task) -> std::future<decltype(task())>;
+
+        // Runs queued tasks on the calling thread until the queue is empty and no worker is busy
+        void waitIdle();
+
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    private:
+        void workerLoop();
+        bool runOneTask(std::unique_lock<std::mutex> &lock);
+    private:
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_taskAvailable;
+        std::condition_variable m_idle;
+        uint32_t m_busyWorkers = 0;
+        bool m_stop = false;
+    };
+
+    // Process wide pool for one-shot parallel work such as decoding cube map faces or EXR chunks, created on first use
+    // with the default worker count. Its tasks must not wait on other tasks of the pool
+    ThreadPool &getSharedThreadPool();
+
+    template<typename F>
+    auto ThreadPool::submit(F &&task) -> std::future<decltype(task())>
+    {
+        using Result = decltype(task());
+
+        auto pPackagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = pPackagedTask->get_future();
+
+        enqueue([pPackagedTask]() { (*pPackagedTask)(); });
+
+        return future;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/BindlessTable.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+
+namespace arsenic
+{
+    static constexpr uint32_t allFramesMask = (1u << maxFrameInFlight) - 1;
+
+    VkDescriptorSetLayout createBindlessDescriptorSetLayout(const VulkanContext &vulkanContext)
+    {
+        std::array<VkDescriptorSetLayoutBinding, 2> layoutBindings = {};
+        layoutBindings[0].binding = bindlessTextureBinding;
+        layoutBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        layoutBindings[0].descriptorCount = maxBindlessTextures;
+        layoutBindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+
+        layoutBindings[1].binding = bindlessSamplerBinding;
+        layoutBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        layoutBindings[1].descriptorCount = maxBindlessSamplers;
+        layoutBindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+        // Update after bind is what lifts the per stage limits to something a texture table fits in
+        const std::array<VkDescriptorBindingFlags, 2> bindingFlags = {
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT,
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+        };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+        bindingFlagsCI.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+        bindingFlagsCI.pBindingFlags = bindingFlags.data();
+
+        VkDescriptorSetLayoutCreateInfo layoutCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+        layoutCI.pNext = &bindingFlagsCI;
+        layoutCI.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutCI.bindingCount = static_cast<uint32_t>(layoutBindings.size());
+        layoutCI.pBindings = layoutBindings.data();
+
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        checkVkResult(vkCreateDescriptorSetLayout(vulkanContext.device, &layoutCI, getHostAllocationCallbacks(HostAllocationTag::Descriptor), &descriptorSetLayout));
+
+        return descriptorSetLayout;
+    }
+
+    BindlessTable createBindlessTable(const VulkanContext &vulkanContext)
+    {
+        BindlessTable bindlessTable = {};
+        bindlessTable.descriptorSetLayout = createBindlessDescriptorSetLayout(vulkanContext);
+
+        const std::array<VkDescriptorPoolSize, 2> poolSizes = {
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxBindlessTextures * maxFrameInFlight},
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, maxBindlessSamplers * maxFrameInFlight}
+        };
+
+        VkDescriptorPoolCreateInfo descriptorPoolCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+        descriptorPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        descriptorPoolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        descriptorPoolCI.pPoolSizes = poolSizes.data();
+        descriptorPoolCI.maxSets = maxFrameInFlight;
+
+        checkVkResult(vkCreateDescriptorPool(vulkanContext.device, &descriptorPoolCI, getHostAllocationCallbacks(HostAllocationTag::Descriptor),
+                                        &bindlessTable.descriptorPool));
+
+        std::array<VkDescriptorSetLayout, maxFrameInFlight> setLayouts;
+        setLayouts.fill(bindlessTable.descriptorSetLayout);
+
+        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        descriptorSetAllocateInfo.descriptorPool = bindlessTable.descriptorPool;
+        descriptorSetAllocateInfo.descriptorSetCount = maxFrameInFlight;
+        descriptorSetAllocateInfo.pSetLayouts = setLayouts.data();
+
+        checkVkResult(vkAllocateDescriptorSets(vulkanContext.device, &descriptorSetAllocateInfo, bindlessTable.descriptorSets.value.data()));
+
+        return bindlessTable;
+    }
+
+    void destroyBindlessTable(const VulkanContext &vulkanContext, BindlessTable &bindlessTable)
+    {
+        vkDestroyDescriptorPool(vulkanContext.device, bindlessTable.descriptorPool, getHostAllocationCallbacks(HostAllocationTag::Descriptor));
+        vkDestroyDescriptorSetLayout(vulkanContext.device, bindlessTable.descriptorSetLayout, getHostAllocationCallbacks(HostAllocationTag::Descriptor));
+        bindlessTable = {};
+    }
+
+    void writeBindlessTexture(BindlessTable &bindlessTable, const uint32_t textureIndex, const VkImageView imageView)
+    {
+        assert(textureIndex < maxBindlessTextures);
+        bindlessTable.pendingWrites.push_back({bindlessTextureBinding, textureIndex, imageView, VK_NULL_HANDLE, allFramesMask});
+    }
+
+    void writeBindlessSampler(BindlessTable &bindlessTable, const uint32_t samplerIndex, const VkSampler sampler)
+    {
+        assert(samplerIndex < maxBindlessSamplers);
+        bindlessTable.pendingWrites.push_back({bindlessSamplerBinding, samplerIndex, VK_NULL_HANDLE, sampler, allFramesMask});
+    }
+
+    void flushBindlessWrites(const VulkanContext &vulkanContext, BindlessTable &bindlessTable, const uint32_t frameIndex)
+    {
+        assert(frameIndex < maxFrameInFlight);
+
+        const uint32_t frameBit = 1u << frameIndex;
+        const VkDescriptorSet descriptorSet = bindlessTable.descriptorSets.value[frameIndex];
+
+        std::vector<VkDescriptorImageInfo> imageInfos;
+        std::vector<VkWriteDescriptorSet> writeDescriptors;
+        imageInfos.reserve(bindlessTable.pendingWrites.size());
+        writeDescriptors.reserve(bindlessTable.pendingWrites.size());
+
+        // Writes are replayed in the order they were made so a slot written twice ends up with the latest descriptor
+        for (BindlessWrite &bindlessWrite : bindlessTable.pendingWrites) {
+            if ((bindlessWrite.pendingFrameMask & frameBit) == 0) {
+                continue;
+            }
+
+            bindlessWrite.pendingFrameMask &= ~frameBit;
+
+            VkDescriptorImageInfo &imageInfo = imageInfos.emplace_back();
+            imageInfo.sampler = bindlessWrite.sampler;
+            imageInfo.imageView = bindlessWrite.imageView;
+            imageInfo.imageLayout = bindlessWrite.binding == bindlessTextureBinding ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+
+            VkWriteDescriptorSet &writeDescriptor = writeDescriptors.emplace_back();
+            writeDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptor.dstSet = descriptorSet;
+            writeDescriptor.dstBinding = bindlessWrite.binding;
+            writeDescriptor.dstArrayElement = bindlessWrite.arrayElement;
+            writeDescriptor.descriptorCount = 1;
+            writeDescriptor.descriptorType = bindlessWrite.binding == bindlessTextureBinding ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLER;
+            writeDescriptor.pImageInfo = &imageInfo;
+        }
+
+        if (!writeDescriptors.empty()) {
+            vkUpdateDescriptorSets(vulkanContext.device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr);
+        }
+
+        bindlessTable.pendingWrites.erase(std::remove_if(bindlessTable.pendingWrites.begin(), bindlessTable.pendingWrites.end(),
+                                [](const BindlessWrite &bindlessWrite) { return bindlessWrite.pendingFrameMask == 0; }),
+                                bindlessTable.pendingWrites.end());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/Structure.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    // Match MAX_BINDLESS_TEXTURES and MAX_BINDLESS_SAMPLERS in bindless.glsl
+    constexpr uint32_t maxBindlessTextures = 4096;
+    constexpr uint32_t maxBindlessSamplers = 64;
+
+    constexpr uint32_t bindlessTextureBinding = 0;
+    constexpr uint32_t bindlessSamplerBinding = 1;
+
+    // A slot written with a new descriptor, replayed into every frame's set once that frame is no longer in flight
+    struct BindlessWrite
+    {
+        uint32_t binding;
+        uint32_t arrayElement;
+        VkImageView imageView;
+        VkSampler sampler;
+        uint32_t pendingFrameMask;
+    };
+
+    // Sampled images and samplers shaders pick by index, see Material. Every frame in flight owns a copy of the set
+    // so slots can be rewritten without waiting for the GPU, unwritten slots are left unbound
+    struct BindlessTable
+    {
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        PerFrame<VkDescriptorSet> descriptorSets = {};
+        std::vector<BindlessWrite> pendingWrites;
+    };
+
+    // Layouts created by this are compatible with each other, the LayoutCache uses it for bindlessDescriptorSet
+    VkDescriptorSetLayout createBindlessDescriptorSetLayout(const VulkanContext &vulkanContext);
+
+    BindlessTable createBindlessTable(const VulkanContext &vulkanContext);
+    void destroyBindlessTable(const VulkanContext &vulkanContext, BindlessTable &bindlessTable);
+
+    // imageView has to be in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL by the time a frame samples it
+    void writeBindlessTexture(BindlessTable &bindlessTable, const uint32_t textureIndex, const VkImageView imageView);
+    void writeBindlessSampler(BindlessTable &bindlessTable, const uint32_t samplerIndex, const VkSampler sampler);
+
+    // Call once the GPU is done with frameIndex and before its command buffer binds the table
+    void flushBindlessWrites(const VulkanContext &vulkanContext, BindlessTable &bindlessTable, const uint32_t frameIndex);
+}
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/DeletionQueue.hpp"
+#include "Arsenic/Renderer/Defragmenter.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+
+namespace arsenic
+{
+    void registerDefragmentableBuffer(Defragmenter &defragmenter, VulkanBuffer &vulkanBuffer, std::function<void(const VulkanBuffer &)> &&onMoved)
+    {
+        assert(vulkanBuffer.vkBuffer);
+        assert(defragmenter.context == VK_NULL_HANDLE);
+
+        defragmenter.registrations.push_back({&vulkanBuffer, std::move(onMoved)});
+    }
+
+    void unregisterDefragmentableBuffer(Defragmenter &defragmenter, const VulkanBuffer &vulkanBuffer)
+    {
+        assert(defragmenter.context == VK_NULL_HANDLE);
+
+        auto &registrations = defragmenter.registrations;
+        registrations.erase(std::remove_if(registrations.begin(), registrations.end(), [&vulkanBuffer](const auto &registration) {
+            return registration.pBuffer == &vulkanBuffer;
+        }), registrations.end());
+    }
+
+    void registerDefragmentableImage(Defragmenter &defragmenter, VulkanImage &vulkanImage, const VkImageCreateFlags createFlags, 
+                const VkImageViewType viewType, std::function<void(const VulkanImage &)> &&onMoved)
+    {
+        assert(vulkanImage.vkImage);
+        assert((vulkanImage.usage & (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT)) == 
+                (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+        assert(defragmenter.context == VK_NULL_HANDLE);
+
+        defragmenter.imageRegistrations.push_back({&vulkanImage, createFlags, viewType, std::move(onMoved)});
+    }
+
+    void unregisterDefragmentableImage(Defragmenter &defragmenter, const VulkanImage &vulkanImage)
+    {
+        assert(defragmenter.context == VK_NULL_HANDLE);
+
+        auto &imageRegistrations = defragmenter.imageRegistrations;
+        imageRegistrations.erase(std::remove_if(imageRegistrations.begin(), imageRegistrations.end(), [&vulkanImage](const auto &imageRegistration) {
+            return imageRegistration.pImage == &vulkanImage;
+        }), imageRegistrations.end());
+    }
+
+    // The allocations a cycle may move, mapped buffers stay where the CPU writes them
+    static void collectMovableAllocations(const Defragmenter &defragmenter, std::vector<VmaAllocation> &allocations)
+    {
+        for (const Defragmenter::Registration &registration : defragmenter.registrations) {
+            if (registration.pBuffer->pMappedPointer == nullptr) {
+                allocations.push_back(registration.pBuffer->vmaAllocation);
+            }
+        }
+
+        for (const Defragmenter::ImageRegistration &imageRegistration : defragmenter.imageRegistrations) {
+            allocations.push_back(imageRegistration.pImage->vmaAllocation);
+        }
+    }
+
+    bool isDefragmentationWorthwhile(const VulkanContext &vulkanContext, const Defragmenter &defragmenter)
+    {
+        std::vector<VmaAllocation> allocations;
+        collectMovableAllocations(defragmenter, allocations);
+
+        std::array<VkDeviceSize, VK_MAX_MEMORY_TYPES> movableBytes = {};
+
+        for (const VmaAllocation allocation : allocations) {
+            VmaAllocationInfo allocationInfo = {};
+            vmaGetAllocationInfo(vulkanContext.vmaAllocator, allocation, &allocationInfo);
+            movableBytes[allocationInfo.memoryType] += allocationInfo.size;
+        }
+
+        VmaStats stats = {};
+        vmaCalculateStats(vulkanContext.vmaAllocator, &stats);
+
+        VkDeviceSize blockBytes = 0;
+        VkDeviceSize wastedBytes = 0;
+
+        for (uint32_t memoryType = 0; memoryType != VK_MAX_MEMORY_TYPES; ++memoryType) {
+            if (movableBytes[memoryType] == 0) {
+                continue;
+            }
+
+            // Moving the allocations fills at most as many unused bytes as they occupy
+            const VmaStatInfo &statInfo = stats.memoryType[memoryType];
+            blockBytes += statInfo.usedBytes + statInfo.unusedBytes;
+            wastedBytes += std::min(statInfo.unusedBytes, movableBytes[memoryType]);
+        }
+
+        const DefragmentationDesc &desc = defragmenter.desc;
+
+        return wastedBytes >= desc.minWastedBytes && static_cast<float>(wastedBytes) >= desc.minWastedRatio * static_cast<float>(blockBytes);
+    }
+
+    // Binds a new image to the destination of move, copies every level and layer into it and leaves it in the layout the old one had
+    static void cmdMoveImage(const VulkanContext &vulkanContext, Defragmenter::ImageRegistration &imageRegistration, 
+                    const VmaDefragmentationPassMoveInfo &move, DeletionQueue &deletionQueue, const VkCommandBuffer commandBuffer, 
+                    const uint64_t retireValue)
+    {
+        VulkanImage &vulkanImage = *imageRegistration.pImage;
+        assert(vulkanImage.imageLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+
+        VkImageCreateInfo imageCI = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        imageCI.flags = imageRegistration.createFlags;
+        imageCI.imageType = VK_IMAGE_TYPE_2D;
+        imageCI.format = vulkanImage.format;
+        imageCI.extent = {vulkanImage.extent.width, vulkanImage.extent.height, 1};
+        imageCI.mipLevels = vulkanImage.mipLevels;
+        imageCI.arrayLayers = vulkanImage.arrayLayers;
+        imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCI.usage = vulkanImage.usage;
+        imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VkImage newImage = VK_NULL_HANDLE;
+        checkVkResult(vkCreateImage(vulkanContext.device, &imageCI, getHostAllocationCallbacks(HostAllocationTag::Allocator), &newImage));
+        checkVkResult(vkBindImageMemory(vulkanContext.device, newImage, move.memory, move.offset));
+
+        const VkImageSubresourceRange subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, vulkanImage.mipLevels, 0, vulkanImage.arrayLayers};
+
+        std::array<VkImageMemoryBarrier, 2> imageMemoryBarriers = {};
+        imageMemoryBarriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageMemoryBarriers[0].srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        imageMemoryBarriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        imageMemoryBarriers[0].oldLayout = vulkanImage.imageLayout;
+        imageMemoryBarriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        imageMemoryBarriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageMemoryBarriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageMemoryBarriers[0].image = vulkanImage.vkImage;
+        imageMemoryBarriers[0].subresourceRange = subresourceRange;
+
+        imageMemoryBarriers[1] = imageMemoryBarriers[0];
+        imageMemoryBarriers[1].srcAccessMask = 0;
+        imageMemoryBarriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        imageMemoryBarriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageMemoryBarriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        imageMemoryBarriers[1].image = newImage;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 
+                        0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageMemoryBarriers.size()), imageMemoryBarriers.data());
+
+        std::vector<VkImageCopy> imageCopies(vulkanImage.mipLevels);
+
+        for (uint32_t mipLevel = 0; mipLevel != vulkanImage.mipLevels; ++mipLevel) {
+            VkImageCopy &imageCopy = imageCopies[mipLevel];
+            imageCopy.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 0, vulkanImage.arrayLayers};
+            imageCopy.dstSubresource = imageCopy.srcSubresource;
+            imageCopy.extent = {std::max(vulkanImage.extent.width >> mipLevel, 1u), std::max(vulkanImage.extent.height >> mipLevel, 1u), 1};
+        }
+
+        vkCmdCopyImage(commandBuffer, vulkanImage.vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, newImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    static_cast<uint32_t>(imageCopies.size()), imageCopies.data());
+
+        imageMemoryBarriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        imageMemoryBarriers[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        imageMemoryBarriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        imageMemoryBarriers[1].newLayout = vulkanImage.imageLayout;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 
+                        0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarriers[1]);
+
+        // The old image is left in transfer src, nothing uses it again before it is destroyed
+        deferDestroy(deletionQueue, [oldImage = vulkanImage.vkImage, oldImageView = vulkanImage.vkImageView](const VulkanContext &vulkanContext) {
+            vkDestroyImageView(vulkanContext.device, oldImageView, getHostAllocationCallbacks(HostAllocationTag::Resource));
+            vkDestroyImage(vulkanContext.device, oldImage, getHostAllocationCallbacks(HostAllocationTag::Allocator));
+        }, retireValue);
+
+        vulkanImage.vkImage = newImage;
+        vulkanImage.vkImageView = createImageView(vulkanContext, newImage, imageRegistration.viewType, vulkanImage.format, VK_IMAGE_ASPECT_COLOR_BIT,
+                                    0, vulkanImage.arrayLayers, 0, vulkanImage.mipLevels, VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        if (imageRegistration.onMoved) {
+            imageRegistration.onMoved(vulkanImage);
+        }
+    }
+
+    bool beginDefragmentation(const VulkanContext &vulkanContext, Defragmenter &defragmenter)
+    {
+        if (defragmenter.context != VK_NULL_HANDLE) {
+            return true;
+        }
+
+        defragmenter.allocations.clear();
+        collectMovableAllocations(defragmenter, defragmenter.allocations);
+
+        if (defragmenter.allocations.empty()) {
+            return false;
+        }
+
+        // Moves are only ever done with GPU copies, so the CPU budget stays at 0
+        VmaDefragmentationInfo2 defragmentationInfo = {};
+        defragmentationInfo.flags = VMA_DEFRAGMENTATION_FLAG_INCREMENTAL;
+        defragmentationInfo.allocationCount = static_cast<uint32_t>(defragmenter.allocations.size());
+        defragmentationInfo.pAllocations = defragmenter.allocations.data();
+        defragmentationInfo.maxGpuBytesToMove = VK_WHOLE_SIZE;
+        defragmentationInfo.maxGpuAllocationsToMove = std::numeric_limits<uint32_t>::max();
+
+        const VkResult result = vmaDefragmentationBegin(vulkanContext.vmaAllocator, &defragmentationInfo, nullptr, &defragmenter.context);
+        checkVkResult(result);
+
+        if (result != VK_NOT_READY) {
+            vmaDefragmentationEnd(vulkanContext.vmaAllocator, defragmenter.context);
+            defragmenter.context = VK_NULL_HANDLE;
+            defragmenter.allocations.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void cmdStepDefragmentation(const VulkanContext &vulkanContext, Defragmenter &defragmenter, DeletionQueue &deletionQueue, 
+                    const VkCommandBuffer commandBuffer)
+    {
+        if (defragmenter.context == VK_NULL_HANDLE) {
+            return;
+        }
+
+        if (defragmenter.passPending) {
+            if (getCompletedTimelineValue(vulkanContext.device, vulkanContext.graphicsTimeline) < defragmenter.passRetireValue) {
+                return;
+            }
+
+            // Committing frees the source ranges, which nothing on the GPU reads anymore
+            defragmenter.passPending = false;
+
+            if (vmaEndDefragmentationPass(vulkanContext.vmaAllocator, defragmenter.context) == VK_SUCCESS) {
+                endDefragmentation(vulkanContext, defragmenter);
+                return;
+            }
+        }
+
+        std::vector<VmaDefragmentationPassMoveInfo> moves(defragmenter.desc.maxMovesPerPass);
+
+        VmaDefragmentationPassInfo passInfo = {};
+        passInfo.moveCount = static_cast<uint32_t>(moves.size());
+        passInfo.pMoves = moves.data();
+        checkVkResult(vmaBeginDefragmentationPass(vulkanContext.vmaAllocator, defragmenter.context, &passInfo));
+
+        if (passInfo.moveCount == 0) {
+            vmaEndDefragmentationPass(vulkanContext.vmaAllocator, defragmenter.context);
+            endDefragmentation(vulkanContext, defragmenter);
+            return;
+        }
+
+        const uint64_t retireValue = vulkanContext.graphicsTimeline.submittedValue + 1;
+
+        // Earlier submissions may still write the buffers that are about to be copied
+        VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        memoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 
+                        0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+        for (uint32_t i = 0; i != passInfo.moveCount; ++i) {
+            const VmaDefragmentationPassMoveInfo &move = moves[i];
+
+            auto imageRegistrationIt = std::find_if(defragmenter.imageRegistrations.begin(), defragmenter.imageRegistrations.end(), 
+                                        [&move](const auto &imageRegistration) {
+                return imageRegistration.pImage->vmaAllocation == move.allocation;
+            });
+
+            if (imageRegistrationIt != defragmenter.imageRegistrations.end()) {
+                cmdMoveImage(vulkanContext, *imageRegistrationIt, move, deletionQueue, commandBuffer, retireValue);
+
+                VmaAllocationInfo allocationInfo = {};
+                vmaGetAllocationInfo(vulkanContext.vmaAllocator, move.allocation, &allocationInfo);
+
+                ++defragmenter.movedAllocationCount;
+                defragmenter.movedBytes += allocationInfo.size;
+                continue;
+            }
+
+            auto registrationIt = std::find_if(defragmenter.registrations.begin(), defragmenter.registrations.end(), [&move](const auto &registration) {
+                return registration.pBuffer->vmaAllocation == move.allocation;
+            });
+            assert(registrationIt != defragmenter.registrations.end());
+
+            VulkanBuffer &vulkanBuffer = *registrationIt->pBuffer;
+
+            VkBufferCreateInfo bufferCI = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+            bufferCI.size = vulkanBuffer.size;
+            bufferCI.usage = vulkanBuffer.bufferUsages;
+            bufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            VkBuffer newBuffer = VK_NULL_HANDLE;
+            checkVkResult(vkCreateBuffer(vulkanContext.device, &bufferCI, getHostAllocationCallbacks(HostAllocationTag::Allocator), &newBuffer));
+            checkVkResult(vkBindBufferMemory(vulkanContext.device, newBuffer, move.memory, move.offset));
+
+            VkBufferCopy bufferCopy = {};
+            bufferCopy.size = vulkanBuffer.size;
+            vkCmdCopyBuffer(commandBuffer, vulkanBuffer.vkBuffer, newBuffer, 1, &bufferCopy);
+
+            deferDestroy(deletionQueue, [oldBuffer = vulkanBuffer.vkBuffer](const VulkanContext &vulkanContext) {
+                vkDestroyBuffer(vulkanContext.device, oldBuffer, getHostAllocationCallbacks(HostAllocationTag::Allocator));
+            }, retireValue);
+
+            vulkanBuffer.vkBuffer = newBuffer;
+
+            if (vulkanBuffer.bufferUsages & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+                VkBufferDeviceAddressInfo bufferDeviceAddressInfo = {VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+                bufferDeviceAddressInfo.buffer = newBuffer;
+                vulkanBuffer.deviceAddress = vkGetBufferDeviceAddress(vulkanContext.device, &bufferDeviceAddressInfo);
+            }
+
+            if (registrationIt->onMoved) {
+                registrationIt->onMoved(vulkanBuffer);
+            }
+
+            ++defragmenter.movedAllocationCount;
+            defragmenter.movedBytes += vulkanBuffer.size;
+        }
+
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 
+                        0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+        defragmenter.passPending = true;
+        defragmenter.passRetireValue = retireValue;
+    }
+
+    void endDefragmentation(const VulkanContext &vulkanContext, Defragmenter &defragmenter)
+    {
+        if (defragmenter.context == VK_NULL_HANDLE) {
+            return;
+        }
+
+        if (defragmenter.passPending) {
+            vmaEndDefragmentationPass(vulkanContext.vmaAllocator, defragmenter.context);
+            defragmenter.passPending = false;
+        }
+
+        vmaDefragmentationEnd(vulkanContext.vmaAllocator, defragmenter.context);
+        defragmenter.context = VK_NULL_HANDLE;
+        defragmenter.allocations.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/VulkanImage.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    struct DeletionQueue;
+
+    struct DefragmentationDesc
+    {
+        uint32_t maxMovesPerPass = 8;
+        // A cycle is only worth starting once this much of the blocks registered allocations can move within is unused
+        VkDeviceSize minWastedBytes = 16 * 1024 * 1024;
+        float minWastedRatio = 0.25f;
+    };
+
+    // Incremental VMA defragmentation of registered device local buffers and images.
+    // Every step moves at most maxMovesPerPass allocations with GPU copies recorded into the frame's command buffer,
+    // the registered VulkanBuffer or VulkanImage is switched to the new location right away and the old memory is released once
+    // the copy has completed. Mapped buffers are never moved
+    struct Defragmenter
+    {
+        struct Registration
+        {
+            VulkanBuffer *pBuffer;
+            // Called after pBuffer has been moved, owners of buffers referenced by descriptor sets must not rewrite
+            // sets that are still in use by submitted frames
+            std::function<void(const VulkanBuffer &)> onMoved;
+        };
+
+        struct ImageRegistration
+        {
+            VulkanImage *pImage;
+            // What the image and its view were created with, the moved image gets one view over all its levels and layers
+            VkImageCreateFlags createFlags;
+            VkImageViewType viewType;
+            // Same contract as for buffers, the old view stays valid until the copy has completed
+            std::function<void(const VulkanImage &)> onMoved;
+        };
+
+        DefragmentationDesc desc;
+        std::vector<Registration> registrations;
+        std::vector<ImageRegistration> imageRegistrations;
+
+        VmaDefragmentationContext context = VK_NULL_HANDLE;
+        std::vector<VmaAllocation> allocations;
+        bool passPending = false;
+        uint64_t passRetireValue = 0;
+
+        uint64_t movedAllocationCount = 0;
+        VkDeviceSize movedBytes = 0;
+    };
+
+    // vulkanBuffer must keep its address until it is unregistered, which is not allowed while a cycle is running
+    void registerDefragmentableBuffer(Defragmenter &defragmenter, VulkanBuffer &vulkanBuffer, 
+                std::function<void(const VulkanBuffer &)> &&onMoved = {});
+    void unregisterDefragmentableBuffer(Defragmenter &defragmenter, const VulkanBuffer &vulkanBuffer);
+
+    // Same rules as for buffers. vulkanImage has to be a sampled 2D color image usable as transfer source and destination,
+    // in the layout its imageLayout records whenever a step is recorded
+    void registerDefragmentableImage(Defragmenter &defragmenter, VulkanImage &vulkanImage, const VkImageCreateFlags createFlags, 
+                const VkImageViewType viewType, std::function<void(const VulkanImage &)> &&onMoved = {});
+    void unregisterDefragmentableImage(Defragmenter &defragmenter, const VulkanImage &vulkanImage);
+
+    // Only counts the unused bytes of the memory types registered allocations live in, and no more of them than those allocations
+    // occupy, the rest of the heap cannot be compacted by moving them
+    bool isDefragmentationWorthwhile(const VulkanContext &vulkanContext, const Defragmenter &defragmenter);
+
+    // Returns false when there is nothing to move
+    bool beginDefragmentation(const VulkanContext &vulkanContext, Defragmenter &defragmenter);
+
+    // commandBuffer must be the next submission on the graphics timeline and is expected to be recorded before
+    // anything in it uses the registered buffers and images
+    void cmdStepDefragmentation(const VulkanContext &vulkanContext, Defragmenter &defragmenter, DeletionQueue &deletionQueue, 
+                const VkCommandBuffer commandBuffer);
+
+    // Commits or abandons the running cycle, the caller has to make sure the device is idle
+    void endDefragmentation(const VulkanContext &vulkanContext, Defragmenter &defragmenter);
+}
\ No newline at end of file
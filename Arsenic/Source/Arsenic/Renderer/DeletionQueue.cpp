@@ -0,0 +1,82 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/DeletionQueue.hpp"
+
+namespace arsenic
+{
+    template <typename T>
+    static uint64_t getOrderedRetireValue(const std::deque<T> &pendings, const uint64_t retireValue)
+    {
+        return pendings.empty() ? retireValue : std::max(pendings.back().retireValue, retireValue);
+    }
+
+    void deferDestroyBuffer(DeletionQueue &deletionQueue, VulkanBuffer &vulkanBuffer, const uint64_t retireValue)
+    {
+        assert(vulkanBuffer.vkBuffer);
+
+        deletionQueue.buffers.push_back({vulkanBuffer, getOrderedRetireValue(deletionQueue.buffers, retireValue)});
+        vulkanBuffer = {};
+    }
+
+    void deferDestroyImage(DeletionQueue &deletionQueue, VulkanImage &vulkanImage, const uint64_t retireValue)
+    {
+        assert(vulkanImage.vkImage);
+
+        deletionQueue.images.push_back({vulkanImage, getOrderedRetireValue(deletionQueue.images, retireValue)});
+        vulkanImage = {};
+    }
+
+    void deferDestroy(DeletionQueue &deletionQueue, std::function<void(const VulkanContext &)> &&destroy, const uint64_t retireValue)
+    {
+        assert(destroy);
+
+        deletionQueue.callbacks.push_back({std::move(destroy), getOrderedRetireValue(deletionQueue.callbacks, retireValue), {}});
+    }
+
+    void deferDestroyWhenReleased(DeletionQueue &deletionQueue, std::function<bool()> &&isReleased, 
+                std::function<void(const VulkanContext &)> &&destroy, const uint64_t retireValue)
+    {
+        assert(isReleased && destroy);
+
+        deletionQueue.callbacks.push_back({std::move(destroy), getOrderedRetireValue(deletionQueue.callbacks, retireValue), std::move(isReleased)});
+    }
+
+    void flushDeletionQueue(const VulkanContext &vulkanContext, DeletionQueue &deletionQueue, const uint64_t completedValue)
+    {
+        while (!deletionQueue.buffers.empty() && deletionQueue.buffers.front().retireValue <= completedValue) {
+            destroyBuffer(vulkanContext, deletionQueue.buffers.front().buffer);
+            deletionQueue.buffers.pop_front();
+        }
+
+        while (!deletionQueue.images.empty() && deletionQueue.images.front().retireValue <= completedValue) {
+            destroyImage(vulkanContext, deletionQueue.images.front().image);
+            deletionQueue.images.pop_front();
+        }
+
+        // An unreleased callback holds back its whole retire value, so the flush stops at the first one
+        uint64_t heldValue = std::numeric_limits<uint64_t>::max();
+
+        for (const DeletionQueue::PendingCallback &pendingCallback : deletionQueue.callbacks) {
+            if (pendingCallback.retireValue > completedValue) {
+                break;
+            }
+
+            if (pendingCallback.isReleased && !pendingCallback.isReleased()) {
+                heldValue = pendingCallback.retireValue;
+                break;
+            }
+        }
+
+        while (!deletionQueue.callbacks.empty() && deletionQueue.callbacks.front().retireValue <= completedValue && 
+               deletionQueue.callbacks.front().retireValue < heldValue) {
+            deletionQueue.callbacks.front().destroy(vulkanContext);
+            deletionQueue.callbacks.pop_front();
+        }
+    }
+
+    void drainDeletionQueue(const VulkanContext &vulkanContext, DeletionQueue &deletionQueue)
+    {
+        flushDeletionQueue(vulkanContext, deletionQueue, std::numeric_limits<uint64_t>::max());
+    }
+}
\ No newline at end of file
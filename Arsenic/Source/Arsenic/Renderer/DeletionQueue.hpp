@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/VulkanImage.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    // Resources released while the GPU may still be reading them are tagged with a retire value, the timeline value
+    // of the last submission that may use them, and only destroyed once the timeline has reached that value.
+    // Producers push with different retire values, e.g. the defragmenter retires one submission ahead while upload batches
+    // retire at their own older token. A value lower than the last one pushed is raised to it, which only delays the destruction
+    // and keeps every queue sorted so flushing stops at the first entry still in use
+    struct DeletionQueue
+    {
+        struct PendingBuffer
+        {
+            VulkanBuffer buffer;
+            uint64_t retireValue;
+        };
+
+        struct PendingImage
+        {
+            VulkanImage image;
+            uint64_t retireValue;
+        };
+
+        struct PendingCallback
+        {
+            std::function<void(const VulkanContext &)> destroy;
+            uint64_t retireValue;
+            // Empty unless pushed by deferDestroyWhenReleased
+            std::function<bool()> isReleased;
+        };
+
+        std::deque<PendingBuffer> buffers;
+        std::deque<PendingImage> images;
+        std::deque<PendingCallback> callbacks;
+    };
+
+    void deferDestroyBuffer(DeletionQueue &deletionQueue, VulkanBuffer &vulkanBuffer, const uint64_t retireValue);
+    void deferDestroyImage(DeletionQueue &deletionQueue, VulkanImage &vulkanImage, const uint64_t retireValue);
+    void deferDestroy(DeletionQueue &deletionQueue, std::function<void(const VulkanContext &)> &&destroy, const uint64_t retireValue);
+    // Also waits for isReleased to return true, for work a CPU thread may still be doing, and holds back every callback with the same
+    // retire value until then, including the ones pushed before it. E.g. a background pipeline compile whose shader modules were
+    // retired at that value
+    void deferDestroyWhenReleased(DeletionQueue &deletionQueue, std::function<bool()> &&isReleased, 
+                std::function<void(const VulkanContext &)> &&destroy, const uint64_t retireValue);
+
+    // Destroys every resource whose retire value is less than or equal to completedValue
+    void flushDeletionQueue(const VulkanContext &vulkanContext, DeletionQueue &deletionQueue, const uint64_t completedValue);
+
+    // Destroys everything regardless of its retire value, the caller has to make sure the device is idle and that every entry
+    // pushed by deferDestroyWhenReleased is released, otherwise the callbacks from its retire value on are left in the queue
+    void drainDeletionQueue(const VulkanContext &vulkanContext, DeletionQueue &deletionQueue);
+}
\ No newline at end of file
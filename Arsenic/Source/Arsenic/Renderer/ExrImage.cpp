@@ -0,0 +1,1097 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/Inflate.hpp"
+#include "Arsenic/Core/ThreadPool.hpp"
+#include "Arsenic/Renderer/ExrImage.hpp"
+
+namespace arsenic
+{
+    static constexpr uint32_t exrMagic = 20000630;
+    static constexpr uint32_t exrVersionTiledBit = 0x200;
+    static constexpr uint32_t exrVersionDeepBit = 0x800;
+    static constexpr uint32_t exrVersionMultiPartBit = 0x1000;
+    // Larger data windows are rejected as corrupt, the decoded image would not fit any staging buffer anyway
+    static constexpr int64_t exrMaxDimension = 1 << 16;
+
+    // PIZ stores a bitmap of the 16 bit values present in a chunk and its Huffman coder works on those values
+    static constexpr uint32_t pizBitmapSize = 8192;
+    static constexpr uint32_t pizUshortRange = 1 << 16;
+
+    static constexpr uint32_t hufEncodingBits = 16;
+    static constexpr uint32_t hufDecodingBits = 14;
+    static constexpr uint32_t hufEncodingSize = (1 << hufEncodingBits) + 1;
+    static constexpr uint32_t hufDecodingSize = 1 << hufDecodingBits;
+    static constexpr uint32_t hufDecodingMask = hufDecodingSize - 1;
+    static constexpr uint32_t hufShortZeroCodeRun = 59;
+    static constexpr uint32_t hufLongZeroCodeRun = 63;
+    static constexpr uint32_t hufShortestLongRun = 2 + hufLongZeroCodeRun - hufShortZeroCodeRun;
+
+    // Output components a channel is written to, luminance goes to the three color components
+    static constexpr int32_t unusedComponent = -1;
+    static constexpr int32_t luminanceComponent = 4;
+
+    struct HufDecodingEntry
+    {
+        uint32_t length;
+        uint32_t literal;
+        // Symbols of codes longer than hufDecodingBits sharing this prefix
+        std::vector<uint32_t> longCodes;
+    };
+
+    // Reused across the chunks a thread decodes, so large buffers and the PIZ tables are only allocated once per thread
+    struct ExrChunkScratch
+    {
+        std::vector<uint8_t> uncompressed;
+        std::vector<uint8_t> temp;
+        std::vector<uint16_t> pizData;
+        std::vector<uint16_t> pizLut;
+        std::vector<uint64_t> hufCodes;
+        std::vector<HufDecodingEntry> hufDecodingTable;
+        std::vector<float> texels;
+    };
+
+    // Reads past the end return zeroes and set overrun instead of touching memory outside the range
+    struct ExrReader
+    {
+        const uint8_t *pData;
+        const uint8_t *pEnd;
+        bool overrun = false;
+
+        template<typename T>
+        T read()
+        {
+            if (static_cast<std::size_t>(pEnd - pData) < sizeof(T)) {
+                overrun = true;
+                pData = pEnd;
+                return T{};
+            }
+
+            T value;
+            std::memcpy(&value, pData, sizeof(T));
+            pData += sizeof(T);
+
+            return value;
+        }
+
+        std::string readString()
+        {
+            const uint8_t *pStringEnd = std::find(pData, pEnd, uint8_t(0));
+            if (pStringEnd == pEnd) {
+                overrun = true;
+                pData = pEnd;
+                return {};
+            }
+
+            std::string string(reinterpret_cast<const char *>(pData), pStringEnd - pData);
+            pData = pStringEnd + 1;
+
+            return string;
+        }
+    };
+
+    static uint32_t getPixelTypeSize(const ExrPixelType pixelType)
+    {
+        return pixelType == ExrPixelType::Half ? 2 : 4;
+    }
+
+    static uint32_t getLinesPerChunk(const ExrCompression compression)
+    {
+        switch (compression) {
+        case ExrCompression::Zip:
+            return 16;
+        case ExrCompression::Piz:
+            return 32;
+        default:
+            return 1;
+        }
+    }
+
+    static float halfToFloat(const uint16_t half)
+    {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+        uint32_t exponent = (half >> 10) & 0x1f;
+        uint32_t mantissa = half & 0x3ff;
+        uint32_t bits = 0;
+
+        if (exponent == 0x1f) {
+            bits = sign | 0x7f800000 | mantissa << 13;
+        }
+        else if (exponent != 0) {
+            bits = sign | (exponent + 112) << 23 | mantissa << 13;
+        }
+        else if (mantissa != 0) {
+            // Subnormal halfs are normal floats, shift the leading one into the implicit bit
+            exponent = 113;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+
+            bits = sign | exponent << 23 | (mantissa & 0x3ff) << 13;
+        }
+        else {
+            bits = sign;
+        }
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+
+    // Rounds to nearest even, out of range values become infinity
+    static uint16_t floatToHalf(const float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const uint32_t exponent = (bits >> 23) & 0xff;
+        uint32_t mantissa = bits & 0x7fffff;
+
+        if (exponent == 0xff) {
+            return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+        }
+
+        const int32_t halfExponent = static_cast<int32_t>(exponent) - 112;
+
+        if (halfExponent >= 0x1f) {
+            return static_cast<uint16_t>(sign | 0x7c00);
+        }
+
+        if (halfExponent <= 0) {
+            if (halfExponent < -10) {
+                return static_cast<uint16_t>(sign);
+            }
+
+            mantissa |= 0x800000;
+            const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            const uint32_t halfMantissa = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            const uint32_t rounded = halfMantissa + ((remainder > halfway || (remainder == halfway && (halfMantissa & 1))) ? 1 : 0);
+
+            return static_cast<uint16_t>(sign | rounded);
+        }
+
+        const uint32_t halfBits = static_cast<uint32_t>(halfExponent) << 10 | mantissa >> 13;
+        const uint32_t remainder = mantissa & 0x1fff;
+        const uint32_t rounded = halfBits + ((remainder > 0x1000 || (remainder == 0x1000 && (halfBits & 1))) ? 1 : 0);
+
+        // A carry out of the mantissa bumps the exponent, possibly up to infinity, which is the correct result
+        return static_cast<uint16_t>(sign | rounded);
+    }
+
+    // ZIP, ZIPS and RLE store delta encoded bytes, the even ones first and the odd ones after them.
+    // The deltas are resolved in place in pData before the halves are interleaved into pDst
+    static void reconstructPredictedBytes(uint8_t *pData, uint8_t *pDst, const std::size_t size)
+    {
+        for (std::size_t i = 1; i < size; ++i) {
+            pData[i] = static_cast<uint8_t>(pData[i - 1] + pData[i] - 128);
+        }
+
+        const uint8_t *pFirstHalf = pData;
+        const uint8_t *pSecondHalf = pData + (size + 1) / 2;
+
+        for (std::size_t i = 0; i + 1 < size; i += 2) {
+            pDst[i] = *pFirstHalf++;
+            pDst[i + 1] = *pSecondHalf++;
+        }
+
+        if (size & 1) {
+            pDst[size - 1] = *pFirstHalf;
+        }
+    }
+
+    static bool decompressRle(const uint8_t *pSrc, const std::size_t srcSize, uint8_t *pDst, const std::size_t dstSize,
+                    std::vector<uint8_t> &temp)
+    {
+        temp.resize(dstSize);
+
+        const uint8_t *pEnd = pSrc + srcSize;
+        std::size_t size = 0;
+
+        while (pSrc < pEnd) {
+            const int32_t count = static_cast<int8_t>(*pSrc++);
+
+            if (count < 0) {
+                const std::size_t literalCount = static_cast<std::size_t>(-count);
+                if (static_cast<std::size_t>(pEnd - pSrc) < literalCount || size + literalCount > dstSize) {
+                    return false;
+                }
+
+                std::memcpy(temp.data() + size, pSrc, literalCount);
+                pSrc += literalCount;
+                size += literalCount;
+            }
+            else {
+                const std::size_t runLength = static_cast<std::size_t>(count) + 1;
+                if (pSrc == pEnd || size + runLength > dstSize) {
+                    return false;
+                }
+
+                std::fill_n(temp.data() + size, runLength, *pSrc++);
+                size += runLength;
+            }
+        }
+
+        if (size != dstSize) {
+            return false;
+        }
+
+        reconstructPredictedBytes(temp.data(), pDst, dstSize);
+
+        return true;
+    }
+
+    static bool decompressZip(const uint8_t *pSrc, const std::size_t srcSize, uint8_t *pDst, const std::size_t dstSize,
+                    std::vector<uint8_t> &temp)
+    {
+        temp.resize(dstSize);
+
+        if (!inflateZlib(pSrc, srcSize, temp.data(), dstSize)) {
+            return false;
+        }
+
+        reconstructPredictedBytes(temp.data(), pDst, dstSize);
+
+        return true;
+    }
+
+    // Huffman codes are stored as code << 6 | length, with lengths of up to 58 bits
+    static uint64_t getHufCode(const uint64_t hufCode)
+    {
+        return hufCode >> 6;
+    }
+
+    static uint32_t getHufLength(const uint64_t hufCode)
+    {
+        return static_cast<uint32_t>(hufCode & 63);
+    }
+
+    // Bits are read MSB first, bytes past pEnd read as zero
+    struct HufBitReader
+    {
+        const uint8_t *pData;
+        const uint8_t *pEnd;
+        uint64_t bits = 0;
+        int32_t bitCount = 0;
+
+        void readByte()
+        {
+            bits = bits << 8 | (pData < pEnd ? *pData : 0);
+            ++pData;
+            bitCount += 8;
+        }
+
+        uint32_t read(const int32_t count)
+        {
+            while (bitCount < count) {
+                readByte();
+            }
+
+            bitCount -= count;
+
+            return static_cast<uint32_t>((bits >> bitCount) & ((1ull << count) - 1));
+        }
+    };
+
+    static void buildCanonicalHufCodes(std::vector<uint64_t> &hufCodes)
+    {
+        std::array<uint64_t, 59> lengthCounts = {};
+        for (const uint64_t length : hufCodes) {
+            ++lengthCounts[length];
+        }
+
+        uint64_t code = 0;
+        for (int32_t length = 58; length > 0; --length) {
+            const uint64_t nextCode = (code + lengthCounts[length]) >> 1;
+            lengthCounts[length] = code;
+            code = nextCode;
+        }
+
+        for (uint64_t &hufCode : hufCodes) {
+            const uint64_t length = hufCode;
+            if (length > 0) {
+                hufCode = length | lengthCounts[length]++ << 6;
+            }
+        }
+    }
+
+    static bool unpackHufCodes(const uint8_t *&pData, const uint8_t *pEnd, uint32_t minSymbol, const uint32_t maxSymbol,
+                    std::vector<uint64_t> &hufCodes)
+    {
+        hufCodes.assign(hufEncodingSize, 0);
+
+        HufBitReader bitReader = {pData, pEnd};
+
+        for (; minSymbol <= maxSymbol; ++minSymbol) {
+            if (bitReader.pData >= pEnd) {
+                return false;
+            }
+
+            const uint32_t length = bitReader.read(6);
+            hufCodes[minSymbol] = length;
+
+            uint32_t zeroRun = 0;
+            if (length == hufLongZeroCodeRun) {
+                zeroRun = bitReader.read(8) + hufShortestLongRun;
+            }
+            else if (length >= hufShortZeroCodeRun) {
+                zeroRun = length - hufShortZeroCodeRun + 2;
+            }
+
+            if (zeroRun != 0) {
+                if (minSymbol + zeroRun > maxSymbol + 1) {
+                    return false;
+                }
+
+                std::fill_n(hufCodes.begin() + minSymbol, zeroRun, 0);
+                minSymbol += zeroRun - 1;
+            }
+        }
+
+        pData = bitReader.pData;
+        buildCanonicalHufCodes(hufCodes);
+
+        return true;
+    }
+
+    static bool buildHufDecodingTable(const std::vector<uint64_t> &hufCodes, uint32_t minSymbol, const uint32_t maxSymbol,
+                    std::vector<HufDecodingEntry> &decodingTable)
+    {
+        decodingTable.resize(hufDecodingSize);
+        for (HufDecodingEntry &entry : decodingTable) {
+            entry.length = 0;
+            entry.literal = 0;
+            entry.longCodes.clear();
+        }
+
+        for (; minSymbol <= maxSymbol; ++minSymbol) {
+            const uint64_t code = getHufCode(hufCodes[minSymbol]);
+            const uint32_t length = getHufLength(hufCodes[minSymbol]);
+
+            if (code >> length) {
+                return false;
+            }
+
+            if (length > hufDecodingBits) {
+                HufDecodingEntry &entry = decodingTable[code >> (length - hufDecodingBits)];
+                if (entry.length != 0) {
+                    return false;
+                }
+
+                entry.longCodes.push_back(minSymbol);
+            }
+            else if (length != 0) {
+                const uint64_t first = code << (hufDecodingBits - length);
+                const uint64_t count = 1ull << (hufDecodingBits - length);
+
+                for (uint64_t i = first; i != first + count; ++i) {
+                    HufDecodingEntry &entry = decodingTable[i];
+                    if (entry.length != 0 || !entry.longCodes.empty()) {
+                        return false;
+                    }
+
+                    entry.length = length;
+                    entry.literal = minSymbol;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // The largest symbol is a run length code repeating the previous value
+    static bool emitHufSymbol(const uint32_t symbol, const uint32_t runLengthSymbol, HufBitReader &bitReader,
+                    uint16_t *&pOut, const uint16_t *pOutBegin, const uint16_t *pOutEnd)
+    {
+        if (symbol != runLengthSymbol) {
+            if (pOut >= pOutEnd) {
+                return false;
+            }
+
+            *pOut++ = static_cast<uint16_t>(symbol);
+            return true;
+        }
+
+        if (bitReader.bitCount < 8) {
+            bitReader.readByte();
+        }
+
+        bitReader.bitCount -= 8;
+        const uint32_t runLength = static_cast<uint8_t>(bitReader.bits >> bitReader.bitCount);
+
+        if (pOut + runLength > pOutEnd || pOut == pOutBegin) {
+            return false;
+        }
+
+        const uint16_t value = pOut[-1];
+        pOut = std::fill_n(pOut, runLength, value);
+
+        return true;
+    }
+
+    static bool decodeHuf(const std::vector<uint64_t> &hufCodes, const std::vector<HufDecodingEntry> &decodingTable,
+                    const uint8_t *pData, const uint8_t *pEnd, const uint32_t bitLength, const uint32_t runLengthSymbol,
+                    uint16_t *pOut, const std::size_t outCount)
+    {
+        const uint16_t *pOutBegin = pOut;
+        const uint16_t *pOutEnd = pOut + outCount;
+        const uint8_t *pDataEnd = pData + (bitLength + 7) / 8;
+
+        HufBitReader bitReader = {pData, pEnd};
+
+        while (bitReader.pData < pDataEnd) {
+            bitReader.readByte();
+
+            while (bitReader.bitCount >= static_cast<int32_t>(hufDecodingBits)) {
+                const HufDecodingEntry &entry = decodingTable[(bitReader.bits >> (bitReader.bitCount - hufDecodingBits)) & hufDecodingMask];
+
+                if (entry.length != 0) {
+                    bitReader.bitCount -= entry.length;
+                    if (!emitHufSymbol(entry.literal, runLengthSymbol, bitReader, pOut, pOutBegin, pOutEnd)) {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                if (entry.longCodes.empty()) {
+                    return false;
+                }
+
+                bool found = false;
+                for (const uint32_t symbol : entry.longCodes) {
+                    const int32_t length = static_cast<int32_t>(getHufLength(hufCodes[symbol]));
+
+                    while (bitReader.bitCount < length && bitReader.pData < pDataEnd) {
+                        bitReader.readByte();
+                    }
+
+                    if (bitReader.bitCount >= length &&
+                        getHufCode(hufCodes[symbol]) == ((bitReader.bits >> (bitReader.bitCount - length)) & ((1ull << length) - 1))) {
+                        bitReader.bitCount -= length;
+                        if (!emitHufSymbol(symbol, runLengthSymbol, bitReader, pOut, pOutBegin, pOutEnd)) {
+                            return false;
+                        }
+
+                        found = true;
+                        break;
+                    }
+                }
+
+                if (!found) {
+                    return false;
+                }
+            }
+        }
+
+        // The stream is padded to a whole byte, drop the padding and decode the short codes left in the buffer
+        const int32_t paddingBits = (8 - static_cast<int32_t>(bitLength)) & 7;
+        bitReader.bits >>= paddingBits;
+        bitReader.bitCount -= paddingBits;
+
+        while (bitReader.bitCount > 0) {
+            const HufDecodingEntry &entry = decodingTable[(bitReader.bits << (hufDecodingBits - bitReader.bitCount)) & hufDecodingMask];
+
+            if (entry.length == 0 || static_cast<int32_t>(entry.length) > bitReader.bitCount) {
+                return false;
+            }
+
+            bitReader.bitCount -= entry.length;
+            if (!emitHufSymbol(entry.literal, runLengthSymbol, bitReader, pOut, pOutBegin, pOutEnd)) {
+                return false;
+            }
+        }
+
+        return pOut == pOutEnd;
+    }
+
+    static bool decompressHuf(const uint8_t *pData, const std::size_t size, uint16_t *pOut, const std::size_t outCount,
+                    ExrChunkScratch &scratch)
+    {
+        if (size < 20) {
+            return outCount == 0;
+        }
+
+        ExrReader reader = {pData, pData + size};
+        const uint32_t minSymbol = reader.read<uint32_t>();
+        const uint32_t maxSymbol = reader.read<uint32_t>();
+        reader.read<uint32_t>();
+        const uint32_t bitLength = reader.read<uint32_t>();
+        reader.read<uint32_t>();
+
+        if (minSymbol >= hufEncodingSize || maxSymbol >= hufEncodingSize || minSymbol > maxSymbol) {
+            return false;
+        }
+
+        const uint8_t *pEnd = pData + size;
+        const uint8_t *pCodes = reader.pData;
+
+        if (!unpackHufCodes(pCodes, pEnd, minSymbol, maxSymbol, scratch.hufCodes)) {
+            return false;
+        }
+
+        if (bitLength > 8 * static_cast<uint64_t>(pEnd - pCodes)) {
+            return false;
+        }
+
+        if (!buildHufDecodingTable(scratch.hufCodes, minSymbol, maxSymbol, scratch.hufDecodingTable)) {
+            return false;
+        }
+
+        return decodeHuf(scratch.hufCodes, scratch.hufDecodingTable, pCodes, pEnd, bitLength, maxSymbol, pOut, outCount);
+    }
+
+    // Inverse of the 14 bit wavelet, used when every value fits in 14 bits
+    static void decodeWavelet14(const uint16_t l, const uint16_t h, uint16_t &a, uint16_t &b)
+    {
+        const int32_t hi = static_cast<int16_t>(h);
+        const int32_t ai = static_cast<int16_t>(l) + (hi & 1) + (hi >> 1);
+
+        a = static_cast<uint16_t>(static_cast<int16_t>(ai));
+        b = static_cast<uint16_t>(static_cast<int16_t>(ai - hi));
+    }
+
+    // Inverse of the modulo 2^16 wavelet
+    static void decodeWavelet16(const uint16_t l, const uint16_t h, uint16_t &a, uint16_t &b)
+    {
+        constexpr int32_t offset = 1 << 15;
+        constexpr int32_t modMask = (1 << 16) - 1;
+
+        const int32_t m = l;
+        const int32_t d = h;
+        const int32_t bb = (m - (d >> 1)) & modMask;
+        const int32_t aa = (d + bb - offset) & modMask;
+
+        a = static_cast<uint16_t>(aa);
+        b = static_cast<uint16_t>(bb);
+    }
+
+    static void decodeWavelet(const bool wavelet14, const uint16_t l, const uint16_t h, uint16_t &a, uint16_t &b)
+    {
+        if (wavelet14) {
+            decodeWavelet14(l, h, a, b);
+        }
+        else {
+            decodeWavelet16(l, h, a, b);
+        }
+    }
+
+    // 2D Haar wavelet reconstruction of an nx * ny block with element stride ox and row stride oy
+    static void decodeWavelet2D(uint16_t *pData, const int32_t nx, const int32_t ox, const int32_t ny, const int32_t oy, const uint16_t maxValue)
+    {
+        const bool wavelet14 = maxValue < (1 << 14);
+        const int32_t n = std::min(nx, ny);
+
+        int32_t p = 1;
+        while (p <= n) {
+            p <<= 1;
+        }
+
+        p >>= 1;
+        int32_t p2 = p;
+        p >>= 1;
+
+        while (p >= 1) {
+            const int32_t oy1 = oy * p;
+            const int32_t oy2 = oy * p2;
+            const int32_t ox1 = ox * p;
+            const int32_t ox2 = ox * p2;
+
+            uint16_t i00;
+            uint16_t i01;
+            uint16_t i10;
+            uint16_t i11;
+
+            int32_t y = 0;
+            for (; y <= ny - p2; y += p2) {
+                uint16_t *pRow = pData + y * oy;
+
+                int32_t x = 0;
+                for (; x <= nx - p2; x += p2) {
+                    uint16_t *p00 = pRow + x * ox;
+                    uint16_t *p01 = p00 + ox1;
+                    uint16_t *p10 = p00 + oy1;
+                    uint16_t *p11 = p10 + ox1;
+
+                    decodeWavelet(wavelet14, *p00, *p10, i00, i10);
+                    decodeWavelet(wavelet14, *p01, *p11, i01, i11);
+                    decodeWavelet(wavelet14, i00, i01, *p00, *p01);
+                    decodeWavelet(wavelet14, i10, i11, *p10, *p11);
+                }
+
+                // Odd column
+                if (nx & p) {
+                    uint16_t *p00 = pRow + x * ox;
+                    uint16_t *p10 = p00 + oy1;
+
+                    decodeWavelet(wavelet14, *p00, *p10, i00, *p10);
+                    *p00 = i00;
+                }
+            }
+
+            // Odd line
+            if (ny & p) {
+                uint16_t *pRow = pData + y * oy;
+
+                for (int32_t x = 0; x <= nx - p2; x += p2) {
+                    uint16_t *p00 = pRow + x * ox;
+                    uint16_t *p01 = p00 + ox1;
+
+                    decodeWavelet(wavelet14, *p00, *p01, i00, *p01);
+                    *p00 = i00;
+                }
+            }
+
+            p2 = p;
+            p >>= 1;
+        }
+    }
+
+    static bool decompressPiz(const ExrImage &exrImage, const uint8_t *pSrc, const std::size_t srcSize, uint8_t *pDst,
+                    const std::size_t dstSize, const uint32_t chunkWidth, const uint32_t chunkHeight, ExrChunkScratch &scratch)
+    {
+        ExrReader reader = {pSrc, pSrc + srcSize};
+
+        if (srcSize < 4) {
+            return false;
+        }
+
+        const uint16_t minNonZero = reader.read<uint16_t>();
+        const uint16_t maxNonZero = reader.read<uint16_t>();
+
+        if (maxNonZero >= pizBitmapSize) {
+            return false;
+        }
+
+        std::array<uint8_t, pizBitmapSize> bitmap = {};
+        if (minNonZero <= maxNonZero) {
+            const std::size_t bitmapSize = maxNonZero - minNonZero + 1;
+            if (static_cast<std::size_t>(reader.pEnd - reader.pData) < bitmapSize) {
+                return false;
+            }
+
+            std::memcpy(bitmap.data() + minNonZero, reader.pData, bitmapSize);
+            reader.pData += bitmapSize;
+        }
+
+        // Maps the dense indices the data was coded with back to the 16 bit values present in the bitmap
+        scratch.pizLut.assign(pizUshortRange, 0);
+        uint32_t lutSize = 0;
+
+        for (uint32_t i = 0; i != pizUshortRange; ++i) {
+            if (i == 0 || (bitmap[i >> 3] & (1 << (i & 7)))) {
+                scratch.pizLut[lutSize++] = static_cast<uint16_t>(i);
+            }
+        }
+
+        const uint16_t maxValue = static_cast<uint16_t>(lutSize - 1);
+
+        if (reader.pEnd - reader.pData < 4) {
+            return false;
+        }
+
+        const uint32_t hufSize = reader.read<uint32_t>();
+        if (hufSize > static_cast<std::size_t>(reader.pEnd - reader.pData)) {
+            return false;
+        }
+
+        const std::size_t ushortCount = dstSize / 2;
+        scratch.pizData.resize(ushortCount);
+
+        if (!decompressHuf(reader.pData, hufSize, scratch.pizData.data(), ushortCount, scratch)) {
+            return false;
+        }
+
+        // Every channel is stored as its own block of 16 bit values, 32 bit channels as two interleaved ones
+        std::size_t channelOffset = 0;
+        for (const ExrChannel &channel : exrImage.channels) {
+            const int32_t ushortsPerSample = static_cast<int32_t>(getPixelTypeSize(channel.pixelType) / 2);
+
+            for (int32_t i = 0; i != ushortsPerSample; ++i) {
+                decodeWavelet2D(scratch.pizData.data() + channelOffset + i, static_cast<int32_t>(chunkWidth), ushortsPerSample,
+                        static_cast<int32_t>(chunkHeight), static_cast<int32_t>(chunkWidth) * ushortsPerSample, maxValue);
+            }
+
+            channelOffset += static_cast<std::size_t>(chunkWidth) * chunkHeight * ushortsPerSample;
+        }
+
+        for (uint16_t &value : scratch.pizData) {
+            value = scratch.pizLut[value];
+        }
+
+        // Interleave the channel blocks back into lines
+        std::vector<const uint16_t *> channelData;
+        channelData.reserve(exrImage.channels.size());
+
+        channelOffset = 0;
+        for (const ExrChannel &channel : exrImage.channels) {
+            channelData.push_back(scratch.pizData.data() + channelOffset);
+            channelOffset += static_cast<std::size_t>(chunkWidth) * chunkHeight * (getPixelTypeSize(channel.pixelType) / 2);
+        }
+
+        uint8_t *pOut = pDst;
+        for (uint32_t y = 0; y != chunkHeight; ++y) {
+            for (std::size_t i = 0; i != exrImage.channels.size(); ++i) {
+                const std::size_t count = static_cast<std::size_t>(chunkWidth) * (getPixelTypeSize(exrImage.channels[i].pixelType) / 2);
+
+                std::memcpy(pOut, channelData[i], count * sizeof(uint16_t));
+                channelData[i] += count;
+                pOut += count * sizeof(uint16_t);
+            }
+        }
+
+        return true;
+    }
+
+    static std::vector<int32_t> getOutputComponents(const ExrImage &exrImage)
+    {
+        std::vector<int32_t> components;
+        components.reserve(exrImage.channels.size());
+
+        for (const ExrChannel &channel : exrImage.channels) {
+            if (channel.name == "R") {
+                components.push_back(0);
+            }
+            else if (channel.name == "G") {
+                components.push_back(1);
+            }
+            else if (channel.name == "B") {
+                components.push_back(2);
+            }
+            else if (channel.name == "A") {
+                components.push_back(3);
+            }
+            else if (channel.name == "Y") {
+                components.push_back(luminanceComponent);
+            }
+            else {
+                components.push_back(unusedComponent);
+            }
+        }
+
+        return components;
+    }
+
+    static float readSample(const uint8_t *pSample, const ExrPixelType pixelType)
+    {
+        switch (pixelType) {
+        case ExrPixelType::Half: {
+            uint16_t half;
+            std::memcpy(&half, pSample, sizeof(half));
+            return halfToFloat(half);
+        }
+        case ExrPixelType::Float: {
+            float value;
+            std::memcpy(&value, pSample, sizeof(value));
+            return value;
+        }
+        default: {
+            uint32_t value;
+            std::memcpy(&value, pSample, sizeof(value));
+            return static_cast<float>(value);
+        }
+        }
+    }
+
+    static bool decodeChunk(const ExrImage &exrImage, const std::vector<int32_t> &components, const uint32_t chunkIndex,
+                    void *pDst, const bool halfOutput, ExrChunkScratch &scratch)
+    {
+        const uint64_t chunkOffset = exrImage.chunkOffsets[chunkIndex];
+        const uint8_t *pFileEnd = exrImage.file.pData + exrImage.file.size;
+
+        ExrReader reader = {exrImage.file.pData + chunkOffset, pFileEnd};
+
+        uint32_t chunkX = 0;
+        uint32_t chunkY = 0;
+        uint32_t chunkWidth = exrImage.width;
+        uint32_t chunkHeight = exrImage.tileHeight;
+
+        if (static_cast<std::size_t>(pFileEnd - reader.pData) < (exrImage.tiled ? 20u : 8u)) {
+            return false;
+        }
+
+        // The offset table is ordered by position whatever the line order, so a chunk has to sit where its index says.
+        // Otherwise duplicated chunks would leave regions unwritten and have workers write the same rows concurrently
+        if (exrImage.tiled) {
+            const uint32_t tileCountX = (exrImage.width + exrImage.tileWidth - 1) / exrImage.tileWidth;
+
+            const int32_t tileX = reader.read<int32_t>();
+            const int32_t tileY = reader.read<int32_t>();
+            const int32_t levelX = reader.read<int32_t>();
+            const int32_t levelY = reader.read<int32_t>();
+
+            if (tileX < 0 || tileY < 0 || levelX != 0 || levelY != 0 || static_cast<uint32_t>(tileX) >= tileCountX ||
+                static_cast<uint64_t>(tileY) * tileCountX + static_cast<uint32_t>(tileX) != chunkIndex) {
+                return false;
+            }
+
+            chunkX = static_cast<uint32_t>(tileX) * exrImage.tileWidth;
+            chunkY = static_cast<uint32_t>(tileY) * exrImage.tileHeight;
+            chunkWidth = exrImage.tileWidth;
+        }
+        else {
+            const int64_t y = static_cast<int64_t>(reader.read<int32_t>()) - exrImage.dataWindowMinY;
+            if (y != static_cast<int64_t>(chunkIndex) * exrImage.tileHeight) {
+                return false;
+            }
+
+            chunkY = static_cast<uint32_t>(y);
+        }
+
+        if (chunkX >= exrImage.width || chunkY >= exrImage.height) {
+            return false;
+        }
+
+        chunkWidth = std::min(chunkWidth, exrImage.width - chunkX);
+        chunkHeight = std::min(chunkHeight, exrImage.height - chunkY);
+
+        const uint32_t dataSize = reader.read<uint32_t>();
+        if (dataSize > static_cast<std::size_t>(pFileEnd - reader.pData)) {
+            return false;
+        }
+
+        std::size_t lineSize = 0;
+        for (const ExrChannel &channel : exrImage.channels) {
+            lineSize += static_cast<std::size_t>(chunkWidth) * getPixelTypeSize(channel.pixelType);
+        }
+
+        const std::size_t uncompressedSize = lineSize * chunkHeight;
+        const uint8_t *pChunkData = reader.pData;
+
+        // Chunks that did not shrink are stored as is whatever the compression
+        if (dataSize != uncompressedSize) {
+            scratch.uncompressed.resize(uncompressedSize);
+
+            bool decompressed = false;
+            switch (exrImage.compression) {
+            case ExrCompression::Rle:
+                decompressed = decompressRle(reader.pData, dataSize, scratch.uncompressed.data(), uncompressedSize, scratch.temp);
+                break;
+            case ExrCompression::Zips:
+            case ExrCompression::Zip:
+                decompressed = decompressZip(reader.pData, dataSize, scratch.uncompressed.data(), uncompressedSize, scratch.temp);
+                break;
+            case ExrCompression::Piz:
+                decompressed = decompressPiz(exrImage, reader.pData, dataSize, scratch.uncompressed.data(), uncompressedSize,
+                                    chunkWidth, chunkHeight, scratch);
+                break;
+            default:
+                break;
+            }
+
+            if (!decompressed) {
+                return false;
+            }
+
+            pChunkData = scratch.uncompressed.data();
+        }
+
+        // Lines are converted to RGBA in scratch first so the destination, usually staging memory, is only written sequentially
+        scratch.texels.resize(static_cast<std::size_t>(chunkWidth) * 4);
+
+        for (uint32_t y = 0; y != chunkHeight; ++y) {
+            for (uint32_t x = 0; x != chunkWidth; ++x) {
+                scratch.texels[x * 4 + 0] = 0.0f;
+                scratch.texels[x * 4 + 1] = 0.0f;
+                scratch.texels[x * 4 + 2] = 0.0f;
+                scratch.texels[x * 4 + 3] = 1.0f;
+            }
+
+            const uint8_t *pSample = pChunkData + y * lineSize;
+
+            for (std::size_t i = 0; i != exrImage.channels.size(); ++i) {
+                const ExrPixelType pixelType = exrImage.channels[i].pixelType;
+                const uint32_t sampleSize = getPixelTypeSize(pixelType);
+                const int32_t component = components[i];
+
+                if (component == luminanceComponent) {
+                    for (uint32_t x = 0; x != chunkWidth; ++x) {
+                        const float value = readSample(pSample + x * sampleSize, pixelType);
+                        scratch.texels[x * 4 + 0] = value;
+                        scratch.texels[x * 4 + 1] = value;
+                        scratch.texels[x * 4 + 2] = value;
+                    }
+                }
+                else if (component != unusedComponent) {
+                    for (uint32_t x = 0; x != chunkWidth; ++x) {
+                        scratch.texels[x * 4 + component] = readSample(pSample + x * sampleSize, pixelType);
+                    }
+                }
+
+                pSample += static_cast<std::size_t>(chunkWidth) * sampleSize;
+            }
+
+            const std::size_t dstTexel = (static_cast<std::size_t>(chunkY + y) * exrImage.width + chunkX) * 4;
+
+            if (halfOutput) {
+                uint16_t *pDstLine = static_cast<uint16_t *>(pDst) + dstTexel;
+                for (std::size_t j = 0; j != scratch.texels.size(); ++j) {
+                    pDstLine[j] = floatToHalf(scratch.texels[j]);
+                }
+            }
+            else {
+                std::memcpy(static_cast<float *>(pDst) + dstTexel, scratch.texels.data(), scratch.texels.size() * sizeof(float));
+            }
+        }
+
+        return true;
+    }
+
+    bool openExrImage(const char *exrFilePath, ExrImage &exrImage)
+    {
+        exrImage = {};
+        exrImage.file = readFile(exrFilePath);
+
+        if (!exrImage.file.isValid()) {
+            return false;
+        }
+
+        ExrReader reader = {exrImage.file.pData, exrImage.file.pData + exrImage.file.size};
+
+        const uint32_t magic = reader.read<uint32_t>();
+        const uint32_t version = reader.read<uint32_t>();
+
+        if (reader.overrun || magic != exrMagic || (version & 0xff) != 2 || (version & (exrVersionDeepBit | exrVersionMultiPartBit)) != 0) {
+            return false;
+        }
+
+        exrImage.tiled = (version & exrVersionTiledBit) != 0;
+
+        bool hasCompression = false;
+        bool hasDataWindow = false;
+        bool hasTiles = false;
+
+        for (;;) {
+            const std::string name = reader.readString();
+            if (name.empty()) {
+                break;
+            }
+
+            const std::string type = reader.readString();
+            const uint32_t size = reader.read<uint32_t>();
+
+            if (reader.overrun || size > static_cast<std::size_t>(reader.pEnd - reader.pData)) {
+                return false;
+            }
+
+            ExrReader attributeReader = {reader.pData, reader.pData + size};
+            reader.pData += size;
+
+            if (name == "channels" && type == "chlist") {
+                while (attributeReader.pData < attributeReader.pEnd && *attributeReader.pData != 0) {
+                    ExrChannel channel = {};
+                    channel.name = attributeReader.readString();
+                    channel.pixelType = static_cast<ExrPixelType>(attributeReader.read<uint32_t>());
+                    attributeReader.read<uint32_t>();
+
+                    const int32_t xSampling = attributeReader.read<int32_t>();
+                    const int32_t ySampling = attributeReader.read<int32_t>();
+
+                    if (attributeReader.overrun || channel.pixelType > ExrPixelType::Float || xSampling != 1 || ySampling != 1) {
+                        return false;
+                    }
+
+                    exrImage.channels.push_back(std::move(channel));
+                }
+            }
+            else if (name == "compression" && type == "compression") {
+                exrImage.compression = static_cast<ExrCompression>(attributeReader.read<uint8_t>());
+                hasCompression = !attributeReader.overrun;
+            }
+            else if (name == "dataWindow" && type == "box2i") {
+                const int32_t minX = attributeReader.read<int32_t>();
+                const int32_t minY = attributeReader.read<int32_t>();
+                const int32_t maxX = attributeReader.read<int32_t>();
+                const int32_t maxY = attributeReader.read<int32_t>();
+
+                const int64_t width = static_cast<int64_t>(maxX) - minX + 1;
+                const int64_t height = static_cast<int64_t>(maxY) - minY + 1;
+
+                if (attributeReader.overrun || width <= 0 || height <= 0 || width > exrMaxDimension || height > exrMaxDimension) {
+                    return false;
+                }
+
+                exrImage.dataWindowMinX = minX;
+                exrImage.dataWindowMinY = minY;
+                exrImage.width = static_cast<uint32_t>(width);
+                exrImage.height = static_cast<uint32_t>(height);
+                hasDataWindow = true;
+            }
+            else if (name == "tiles" && type == "tiledesc") {
+                exrImage.tileWidth = attributeReader.read<uint32_t>();
+                exrImage.tileHeight = attributeReader.read<uint32_t>();
+                hasTiles = !attributeReader.overrun;
+            }
+        }
+
+        if (reader.overrun || !hasCompression || !hasDataWindow || exrImage.channels.empty() || exrImage.compression > ExrCompression::Piz ||
+            (exrImage.tiled && (!hasTiles || exrImage.tileWidth == 0 || exrImage.tileHeight == 0))) {
+            return false;
+        }
+
+        uint32_t chunkCount = 0;
+
+        if (exrImage.tiled) {
+            chunkCount = ((exrImage.width + exrImage.tileWidth - 1) / exrImage.tileWidth) *
+                         ((exrImage.height + exrImage.tileHeight - 1) / exrImage.tileHeight);
+        }
+        else {
+            exrImage.tileHeight = getLinesPerChunk(exrImage.compression);
+            chunkCount = (exrImage.height + exrImage.tileHeight - 1) / exrImage.tileHeight;
+        }
+
+        // The offsets of the full resolution tiles come first, the ones of lower levels are never needed
+        if (static_cast<uint64_t>(chunkCount) * sizeof(uint64_t) > static_cast<std::size_t>(reader.pEnd - reader.pData)) {
+            return false;
+        }
+
+        exrImage.chunkOffsets.resize(chunkCount);
+        std::memcpy(exrImage.chunkOffsets.data(), reader.pData, chunkCount * sizeof(uint64_t));
+
+        return std::all_of(exrImage.chunkOffsets.begin(), exrImage.chunkOffsets.end(), [&exrImage](const uint64_t chunkOffset) {
+            return chunkOffset < exrImage.file.size;
+        });
+    }
+
+    bool decodeExrImage(const ExrImage &exrImage, void *pDst, const bool halfOutput, const uint32_t threadCount)
+    {
+        const std::vector<int32_t> components = getOutputComponents(exrImage);
+        const uint32_t chunkCount = static_cast<uint32_t>(exrImage.chunkOffsets.size());
+
+        // The calling thread decodes too, so the shared pool contributes one worker less
+        uint32_t workerCount = threadCount != 0 ? threadCount : getSharedThreadPool().getThreadCount() + 1;
+        workerCount = std::max(std::min(workerCount, chunkCount), 1u);
+
+        std::atomic<uint32_t> nextChunk = 0;
+        std::atomic<bool> succeeded = true;
+
+        // Chunks are independent, so every worker keeps claiming the next one until all are taken
+        auto decodeChunks = [&]() {
+            ExrChunkScratch scratch;
+
+            for (uint32_t chunkIndex = nextChunk++; chunkIndex < chunkCount && succeeded; chunkIndex = nextChunk++) {
+                if (!decodeChunk(exrImage, components, chunkIndex, pDst, halfOutput, scratch)) {
+                    succeeded = false;
+                }
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        workers.reserve(workerCount - 1);
+
+        for (uint32_t i = 1; i < workerCount; ++i) {
+            workers.push_back(getSharedThreadPool().submit(decodeChunks));
+        }
+
+        decodeChunks();
+
+        for (std::future<void> &worker : workers) {
+            worker.get();
+        }
+
+        return succeeded;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Arsenic/Core/FileSystem.hpp"
+
+namespace arsenic
+{
+    enum class ExrPixelType : uint32_t
+    {
+        Uint = 0,
+        Half = 1,
+        Float = 2
+    };
+
+    enum class ExrCompression : uint8_t
+    {
+        None = 0,
+        Rle = 1,
+        Zips = 2,
+        Zip = 3,
+        Piz = 4
+    };
+
+    struct ExrChannel
+    {
+        std::string name;
+        ExrPixelType pixelType;
+    };
+
+    // Header and chunk offsets of a single part OpenEXR file, the whole file stays mapped until it is decoded
+    struct ExrImage
+    {
+        FileView file;
+        // Sorted by name, which is the order their samples are stored in within a chunk
+        std::vector<ExrChannel> channels;
+        std::vector<uint64_t> chunkOffsets;
+        ExrCompression compression;
+        int32_t dataWindowMinX;
+        int32_t dataWindowMinY;
+        uint32_t width;
+        uint32_t height;
+        // Scanline files are split into chunks of tileHeight lines as wide as the image,
+        // only the full resolution level of mipmapped tiled files is read
+        bool tiled;
+        uint32_t tileWidth;
+        uint32_t tileHeight;
+    };
+
+    // Reads scanline and tiled files with NONE, RLE, ZIPS, ZIP or PIZ compression.
+    // Deep and multi part files, subsampled channels and lossy compressions are not supported.
+    // Returns false when the file is missing, truncated or uses any of those, exrImage is then left unusable
+    bool openExrImage(const char *exrFilePath, ExrImage &exrImage);
+
+    // Writes width * height RGBA texels to pDst, 32 bit floats or halfs when halfOutput is set. A luminance only Y channel
+    // is expanded to gray, missing color channels read 0 and a missing alpha 1.
+    // Chunks are decompressed on threadCount threads straight into pDst, the calling one included, on top of the shared
+    // thread pool. 0 uses every thread of the pool.
+    // Returns false when a chunk is corrupted
+    bool decodeExrImage(const ExrImage &exrImage, void *pDst, const bool halfOutput, const uint32_t threadCount = 0);
+}
\ No newline at end of file
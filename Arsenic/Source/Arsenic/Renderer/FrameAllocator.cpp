@@ -0,0 +1,129 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/MemoryBudget.hpp"
+#include "Arsenic/Renderer/FrameAllocator.hpp"
+
+namespace arsenic
+{
+    FrameAllocator createFrameAllocator(VulkanContext &vulkanContext, const VkDeviceSize frameCapacity, const HostWritePath writePath)
+    {
+        const VkPhysicalDeviceLimits &limits = vulkanContext.physicalDevice.deviceProperties.limits;
+
+        FrameAllocator frameAllocator = {};
+        // All of these are powers of two, so the largest one satisfies uniform and storage bindings as well as
+        // the 16 byte alignment buffer references are declared with in structures.glsl
+        frameAllocator.alignment = std::max({limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment, VkDeviceSize(16)});
+        frameAllocator.frameCapacity = (frameCapacity + frameAllocator.alignment - 1) & ~(frameAllocator.alignment - 1);
+
+        // Dynamic offsets are 32 bit
+        const VkDeviceSize bufferSize = frameAllocator.frameCapacity * maxFrameInFlight;
+        assert(bufferSize <= std::numeric_limits<uint32_t>::max());
+
+        frameAllocator.writePath = writePath;
+
+        if (writePath == HostWritePath::DeviceLocalHostVisible) {
+            // The host visible device local heap is often only 256 MiB without resizable BAR and shared with the driver,
+            // so check what is left of its budget rather than its size
+            assert(vulkanContext.hostWritePolicy.memoryTypeIndex);
+            const uint32_t heapIndex = vulkanContext.physicalDevice.memoryProperties.memoryTypes[*vulkanContext.hostWritePolicy.memoryTypeIndex].heapIndex;
+            const MemoryHeapBudget heapBudget = queryMemoryBudget(vulkanContext)[heapIndex];
+
+            if (heapBudget.usage + bufferSize > heapBudget.budget) {
+                ARSENIC_WARN("Renderer: Frame allocator of {} bytes exceeds the host visible device local heap budget ({} of {} bytes used), falling back to staging", 
+                        bufferSize, heapBudget.usage, heapBudget.budget);
+                frameAllocator.writePath = HostWritePath::Staging;
+            }
+        }
+
+        constexpr VkBufferUsageFlags bufferUsages = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+        if (frameAllocator.writePath == HostWritePath::DeviceLocalHostVisible) {
+            frameAllocator.buffer = createBuffer(vulkanContext, bufferUsages, 
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                        bufferSize);
+            frameAllocator.pMappedPointer = frameAllocator.buffer.pMappedPointer;
+        }
+        else {
+            frameAllocator.buffer = createBuffer(vulkanContext, bufferUsages, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, bufferSize);
+            frameAllocator.stagingBuffer = createBuffer(vulkanContext, 0, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                bufferSize);
+            frameAllocator.pMappedPointer = frameAllocator.stagingBuffer.pMappedPointer;
+        }
+
+        return frameAllocator;
+    }
+
+    void destroyFrameAllocator(const VulkanContext &vulkanContext, FrameAllocator &frameAllocator)
+    {
+        destroyBuffer(vulkanContext, frameAllocator.buffer);
+
+        if (frameAllocator.stagingBuffer.vkBuffer != VK_NULL_HANDLE) {
+            destroyBuffer(vulkanContext, frameAllocator.stagingBuffer);
+        }
+
+        frameAllocator = {};
+    }
+
+    void resetFrameAllocator(FrameAllocator &frameAllocator, const uint32_t frameIndex)
+    {
+        assert(frameIndex < maxFrameInFlight);
+
+        frameAllocator.frameBegin = frameAllocator.frameCapacity * frameIndex;
+        frameAllocator.head = frameAllocator.frameBegin;
+    }
+
+    FrameAllocation frameAllocate(FrameAllocator &frameAllocator, const VkDeviceSize size, const void *pData)
+    {
+        const VkDeviceSize offset = (frameAllocator.head + frameAllocator.alignment - 1) & ~(frameAllocator.alignment - 1);
+
+        if (offset + size > frameAllocator.frameBegin + frameAllocator.frameCapacity) {
+            ARSENIC_WARN("Renderer: Frame allocator is out of memory, {} bytes requested", size);
+            return {};
+        }
+
+        frameAllocator.head = offset + size;
+
+        FrameAllocation frameAllocation = {};
+        frameAllocation.offset = offset;
+        frameAllocation.size = size;
+        frameAllocation.pMappedPointer = frameAllocator.pMappedPointer + offset;
+        frameAllocation.deviceAddress = frameAllocator.buffer.deviceAddress + offset;
+
+        if (pData != nullptr) {
+            std::memcpy(frameAllocation.pMappedPointer, pData, size);
+        }
+
+        return frameAllocation;
+    }
+
+    void cmdFlushFrameAllocator(const VkCommandBuffer commandBuffer, const FrameAllocator &frameAllocator)
+    {
+        const VkDeviceSize size = frameAllocator.head - frameAllocator.frameBegin;
+
+        if (frameAllocator.writePath != HostWritePath::Staging || size == 0) {
+            return;
+        }
+
+        VkBufferCopy bufferCopy = {};
+        bufferCopy.srcOffset = frameAllocator.frameBegin;
+        bufferCopy.dstOffset = frameAllocator.frameBegin;
+        bufferCopy.size = size;
+
+        vkCmdCopyBuffer(commandBuffer, frameAllocator.stagingBuffer.vkBuffer, frameAllocator.buffer.vkBuffer, 1, &bufferCopy);
+
+        VkBufferMemoryBarrier bufferMemoryBarrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+        bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferMemoryBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferMemoryBarrier.buffer = frameAllocator.buffer.vkBuffer;
+        bufferMemoryBarrier.offset = frameAllocator.frameBegin;
+        bufferMemoryBarrier.size = size;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, 
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                    0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    struct FrameAllocation
+    {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        uint8_t *pMappedPointer = nullptr;
+        VkDeviceAddress deviceAddress = 0;
+
+        bool isValid() const { return pMappedPointer != nullptr; }
+    };
+
+    // Linear allocator over one persistently mapped buffer split into a region per frame in flight.
+    // Sub-ranges are meant to be bound through dynamic uniform/storage descriptors whose base offset is 0,
+    // so FrameAllocation::offset is directly the dynamic offset
+    struct FrameAllocator
+    {
+        // Buffer the descriptors point at, on the staging path host writes land in stagingBuffer instead
+        VulkanBuffer buffer = {};
+        VulkanBuffer stagingBuffer = {};
+        HostWritePath writePath = HostWritePath::Staging;
+        uint8_t *pMappedPointer = nullptr;
+        VkDeviceSize frameCapacity = 0;
+        VkDeviceSize alignment = 0;
+        VkDeviceSize frameBegin = 0;
+        VkDeviceSize head = 0;
+    };
+
+    // Descriptors bound at an allocation's offset must not have a range larger than the allocation,
+    // the buffer ends with the last frame's region
+    FrameAllocator createFrameAllocator(VulkanContext &vulkanContext, const VkDeviceSize frameCapacity, const HostWritePath writePath);
+    void destroyFrameAllocator(const VulkanContext &vulkanContext, FrameAllocator &frameAllocator);
+
+    // Must only be called once the GPU is done with the previous use of frameIndex
+    void resetFrameAllocator(FrameAllocator &frameAllocator, const uint32_t frameIndex);
+
+    // Returns an invalid allocation once the frame's region is full, callers skip or defer what they meant to write
+    FrameAllocation frameAllocate(FrameAllocator &frameAllocator, const VkDeviceSize size, const void *pData = nullptr);
+
+    // Makes this frame's allocations visible to shaders, records a copy out of the staging buffer when there is one
+    void cmdFlushFrameAllocator(const VkCommandBuffer commandBuffer, const FrameAllocator &frameAllocator);
+}
\ No newline at end of file
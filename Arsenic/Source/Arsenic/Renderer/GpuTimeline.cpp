@@ -0,0 +1,83 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/GpuTimeline.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+
+namespace arsenic
+{
+    GpuTimeline createGpuTimeline(const VkDevice device)
+    {
+        VkSemaphoreTypeCreateInfo semaphoreTypeCI = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+        semaphoreTypeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphoreTypeCI.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreCI = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        semaphoreCI.pNext = &semaphoreTypeCI;
+
+        GpuTimeline timeline = {};
+        checkVkResult(vkCreateSemaphore(device, &semaphoreCI, getHostAllocationCallbacks(HostAllocationTag::Sync), &timeline.semaphore));
+
+        return timeline;
+    }
+
+    void destroyGpuTimeline(const VkDevice device, GpuTimeline &timeline)
+    {
+        vkDestroySemaphore(device, timeline.semaphore, getHostAllocationCallbacks(HostAllocationTag::Sync));
+        timeline = {};
+    }
+
+    uint64_t getCompletedTimelineValue(const VkDevice device, const GpuTimeline &timeline)
+    {
+        uint64_t value = 0;
+        checkVkResult(vkGetSemaphoreCounterValue(device, timeline.semaphore, &value));
+
+        return value;
+    }
+
+    void waitForTimelineValue(const VkDevice device, const GpuTimeline &timeline, const uint64_t value)
+    {
+        assert(value <= timeline.submittedValue);
+
+        VkSemaphoreWaitInfo semaphoreWaitInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+        semaphoreWaitInfo.semaphoreCount = 1;
+        semaphoreWaitInfo.pSemaphores = &timeline.semaphore;
+        semaphoreWaitInfo.pValues = &value;
+
+        checkVkResult(vkWaitSemaphores(device, &semaphoreWaitInfo, std::numeric_limits<uint64_t>::max()));
+    }
+
+    uint64_t submitToTimeline(const VkQueue queue, GpuTimeline &timeline, const VkCommandBuffer commandBuffer,
+                    const VkSemaphore waitSemaphore, const VkPipelineStageFlags waitStage, const VkSemaphore signalSemaphore)
+    {
+        const uint64_t signalValue = timeline.submittedValue + 1;
+
+        const std::array<VkSemaphore, 2> signalSemaphores = {timeline.semaphore, signalSemaphore};
+        const std::array<uint64_t, 2> signalValues = {signalValue, 0};
+        const uint32_t signalSemaphoreCount = signalSemaphore != VK_NULL_HANDLE ? 2 : 1;
+
+        // Values of binary semaphores are ignored but the arrays still need to match the semaphore counts
+        const uint64_t waitValue = 0;
+        const uint32_t waitSemaphoreCount = waitSemaphore != VK_NULL_HANDLE ? 1 : 0;
+
+        VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineSubmitInfo.waitSemaphoreValueCount = waitSemaphoreCount;
+        timelineSubmitInfo.pWaitSemaphoreValues = &waitValue;
+        timelineSubmitInfo.signalSemaphoreValueCount = signalSemaphoreCount;
+        timelineSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+
+        VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submitInfo.pNext = &timelineSubmitInfo;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.waitSemaphoreCount = waitSemaphoreCount;
+        submitInfo.pWaitSemaphores = &waitSemaphore;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.signalSemaphoreCount = signalSemaphoreCount;
+        submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+        checkVkResult(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
+        timeline.submittedValue = signalValue;
+
+        return signalValue;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+
+namespace arsenic
+{
+    // A monotonically increasing timeline semaphore owned by a single queue.
+    // Every submission made through submitToTimeline signals the next value, so any point of the
+    // queue's work can be waited on or polled without a fence
+    struct GpuTimeline
+    {
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        uint64_t submittedValue = 0;
+    };
+
+    GpuTimeline createGpuTimeline(const VkDevice device);
+    void destroyGpuTimeline(const VkDevice device, GpuTimeline &timeline);
+
+    uint64_t getCompletedTimelineValue(const VkDevice device, const GpuTimeline &timeline);
+    void waitForTimelineValue(const VkDevice device, const GpuTimeline &timeline, const uint64_t value);
+
+    // Returns the timeline value that is signaled once commandBuffer has finished executing.
+    // waitSemaphore and signalSemaphore are optional binary semaphores, which swapchain acquire and present still require
+    uint64_t submitToTimeline(const VkQueue queue, GpuTimeline &timeline, const VkCommandBuffer commandBuffer,
+                const VkSemaphore waitSemaphore = VK_NULL_HANDLE, const VkPipelineStageFlags waitStage = 0,
+                const VkSemaphore signalSemaphore = VK_NULL_HANDLE);
+}
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/HostAllocator.hpp"
+
+namespace arsenic
+{
+    static constexpr std::size_t hostAllocationTagCount = static_cast<std::size_t>(HostAllocationTag::Count);
+
+    static constexpr std::array<std::size_t, 5> sizeClasses = {64, 128, 256, 512, 1024};
+    static constexpr std::size_t sizeClassAlignment = 64;
+    static constexpr std::size_t chunkSize = 64 * 1024;
+    static constexpr uint32_t unpooledSizeClass = std::numeric_limits<uint32_t>::max();
+
+    // Stored right in front of every pointer handed to the driver
+    struct AllocationHeader
+    {
+        void *pBlock;
+        std::size_t size;
+        uint32_t sizeClass;
+        HostAllocationTag tag;
+    };
+
+    struct HostAllocationTagState
+    {
+        HostAllocationTag tag;
+        VkAllocationCallbacks callbacks;
+
+        std::atomic<uint64_t> allocatedBytes{0};
+        std::atomic<uint64_t> peakAllocatedBytes{0};
+        std::atomic<uint64_t> allocationCount{0};
+        std::atomic<uint64_t> totalAllocationCount{0};
+        std::atomic<uint64_t> internalAllocatedBytes{0};
+        std::atomic<uint64_t> failedAllocationCount{0};
+        std::atomic<uint64_t> limitBytes{0};
+    };
+
+    // Blocks are threaded through an intrusive free list, chunks are only released when the process exits
+    struct SizeClassPool
+    {
+        std::mutex mutex;
+        void *pFreeList = nullptr;
+        std::vector<void *> chunks;
+
+        ~SizeClassPool()
+        {
+            for (void *pChunk : chunks) {
+                ::operator delete(pChunk, std::align_val_t(sizeClassAlignment));
+            }
+        }
+    };
+
+    static std::array<SizeClassPool, sizeClasses.size()> &getSizeClassPools()
+    {
+        static std::array<SizeClassPool, sizeClasses.size()> sizeClassPools;
+        return sizeClassPools;
+    }
+
+    static std::size_t alignUp(const std::size_t value, const std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    static void *allocateBlock(const uint32_t sizeClass)
+    {
+        SizeClassPool &pool = getSizeClassPools()[sizeClass];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+
+        if (pool.pFreeList == nullptr) {
+            const std::size_t blockSize = sizeClasses[sizeClass];
+            uint8_t *pChunk = static_cast<uint8_t *>(::operator new(chunkSize, std::align_val_t(sizeClassAlignment)));
+            pool.chunks.push_back(pChunk);
+
+            for (std::size_t offset = 0; offset + blockSize <= chunkSize; offset += blockSize) {
+                *reinterpret_cast<void **>(pChunk + offset) = pool.pFreeList;
+                pool.pFreeList = pChunk + offset;
+            }
+        }
+
+        void *pBlock = pool.pFreeList;
+        pool.pFreeList = *static_cast<void **>(pBlock);
+
+        return pBlock;
+    }
+
+    static void freeBlock(void *pBlock, const uint32_t sizeClass)
+    {
+        SizeClassPool &pool = getSizeClassPools()[sizeClass];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+
+        *static_cast<void **>(pBlock) = pool.pFreeList;
+        pool.pFreeList = pBlock;
+    }
+
+    static AllocationHeader *getAllocationHeader(void *pMemory)
+    {
+        return reinterpret_cast<AllocationHeader *>(static_cast<uint8_t *>(pMemory) - sizeof(AllocationHeader));
+    }
+
+    static void *hostAllocate(HostAllocationTagState &state, const std::size_t size, std::size_t alignment)
+    {
+        alignment = std::max(alignment, alignof(AllocationHeader));
+
+        // The bytes are reserved before allocating, so concurrent driver allocations cannot all pass the check and overshoot the limit
+        const uint64_t limitBytes = state.limitBytes.load(std::memory_order_relaxed);
+        uint64_t previousBytes = state.allocatedBytes.load(std::memory_order_relaxed);
+
+        do {
+            if (limitBytes != 0 && previousBytes + size > limitBytes) {
+                state.failedAllocationCount.fetch_add(1, std::memory_order_relaxed);
+                ARSENIC_WARN("Renderer: Host allocation of {} bytes for \"{}\" exceeds its limit of {} bytes", 
+                        size, hostAllocationTagToString(state.tag), limitBytes);
+                return nullptr;
+            }
+        } while (!state.allocatedBytes.compare_exchange_weak(previousBytes, previousBytes + size, std::memory_order_relaxed));
+
+        uint32_t sizeClass = unpooledSizeClass;
+        void *pBlock = nullptr;
+        uint8_t *pMemory = nullptr;
+
+        // Pooled blocks start on a 64 byte boundary, so only the header has to be padded to the requested alignment
+        if (alignment <= sizeClassAlignment) {
+            const std::size_t requiredSize = alignUp(sizeof(AllocationHeader), alignment) + size;
+
+            for (uint32_t i = 0; i != sizeClasses.size(); ++i) {
+                if (requiredSize <= sizeClasses[i]) {
+                    sizeClass = i;
+                    break;
+                }
+            }
+        }
+
+        if (sizeClass != unpooledSizeClass) {
+            pBlock = allocateBlock(sizeClass);
+            pMemory = static_cast<uint8_t *>(pBlock) + alignUp(sizeof(AllocationHeader), alignment);
+        }
+        else {
+            pBlock = std::malloc(sizeof(AllocationHeader) + alignment + size);
+
+            if (pBlock == nullptr) {
+                state.allocatedBytes.fetch_sub(size, std::memory_order_relaxed);
+                state.failedAllocationCount.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            pMemory = reinterpret_cast<uint8_t *>(alignUp(reinterpret_cast<std::uintptr_t>(pBlock) + sizeof(AllocationHeader), alignment));
+        }
+
+        AllocationHeader *pHeader = getAllocationHeader(pMemory);
+        pHeader->pBlock = pBlock;
+        pHeader->size = size;
+        pHeader->sizeClass = sizeClass;
+        pHeader->tag = state.tag;
+
+        const uint64_t allocatedBytes = previousBytes + size;
+        uint64_t peakAllocatedBytes = state.peakAllocatedBytes.load(std::memory_order_relaxed);
+        while (allocatedBytes > peakAllocatedBytes && 
+                !state.peakAllocatedBytes.compare_exchange_weak(peakAllocatedBytes, allocatedBytes, std::memory_order_relaxed)) {
+        }
+
+        state.allocationCount.fetch_add(1, std::memory_order_relaxed);
+        state.totalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        return pMemory;
+    }
+
+    static void hostFree(HostAllocationTagState &state, void *pMemory)
+    {
+        if (pMemory == nullptr) {
+            return;
+        }
+
+        const AllocationHeader header = *getAllocationHeader(pMemory);
+        assert(header.tag == state.tag);
+
+        state.allocatedBytes.fetch_sub(header.size, std::memory_order_relaxed);
+        state.allocationCount.fetch_sub(1, std::memory_order_relaxed);
+
+        if (header.sizeClass != unpooledSizeClass) {
+            freeBlock(header.pBlock, header.sizeClass);
+        }
+        else {
+            std::free(header.pBlock);
+        }
+    }
+
+    static VKAPI_ATTR void *VKAPI_CALL allocationCallback(void *pUserData, size_t size, size_t alignment, VkSystemAllocationScope allocationScope)
+    {
+        return hostAllocate(*static_cast<HostAllocationTagState *>(pUserData), size, alignment);
+    }
+
+    static VKAPI_ATTR void *VKAPI_CALL reallocationCallback(void *pUserData, void *pOriginal, size_t size, size_t alignment, 
+                                                        VkSystemAllocationScope allocationScope)
+    {
+        HostAllocationTagState &state = *static_cast<HostAllocationTagState *>(pUserData);
+
+        if (pOriginal == nullptr) {
+            return hostAllocate(state, size, alignment);
+        }
+
+        if (size == 0) {
+            hostFree(state, pOriginal);
+            return nullptr;
+        }
+
+        void *pMemory = hostAllocate(state, size, alignment);
+
+        // The original allocation stays valid when the reallocation fails
+        if (pMemory != nullptr) {
+            std::memcpy(pMemory, pOriginal, std::min(size, getAllocationHeader(pOriginal)->size));
+            hostFree(state, pOriginal);
+        }
+
+        return pMemory;
+    }
+
+    static VKAPI_ATTR void VKAPI_CALL freeCallback(void *pUserData, void *pMemory)
+    {
+        hostFree(*static_cast<HostAllocationTagState *>(pUserData), pMemory);
+    }
+
+    static VKAPI_ATTR void VKAPI_CALL internalAllocationCallback(void *pUserData, size_t size, VkInternalAllocationType allocationType, 
+                                                            VkSystemAllocationScope allocationScope)
+    {
+        static_cast<HostAllocationTagState *>(pUserData)->internalAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    static VKAPI_ATTR void VKAPI_CALL internalFreeCallback(void *pUserData, size_t size, VkInternalAllocationType allocationType, 
+                                                        VkSystemAllocationScope allocationScope)
+    {
+        static_cast<HostAllocationTagState *>(pUserData)->internalAllocatedBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    static std::array<HostAllocationTagState, hostAllocationTagCount> &getTagStates()
+    {
+        static std::array<HostAllocationTagState, hostAllocationTagCount> tagStates;
+        static const bool initialized = [] {
+            for (std::size_t i = 0; i != hostAllocationTagCount; ++i) {
+                HostAllocationTagState &state = tagStates[i];
+                state.tag = static_cast<HostAllocationTag>(i);
+                state.callbacks.pUserData = &state;
+                state.callbacks.pfnAllocation = allocationCallback;
+                state.callbacks.pfnReallocation = reallocationCallback;
+                state.callbacks.pfnFree = freeCallback;
+                state.callbacks.pfnInternalAllocation = internalAllocationCallback;
+                state.callbacks.pfnInternalFree = internalFreeCallback;
+            }
+
+            return true;
+        }();
+        (void)initialized;
+
+        return tagStates;
+    }
+
+    const VkAllocationCallbacks *getHostAllocationCallbacks(const HostAllocationTag tag)
+    {
+        assert(tag != HostAllocationTag::Count);
+
+        return &getTagStates()[static_cast<std::size_t>(tag)].callbacks;
+    }
+
+    HostAllocationStats getHostAllocationStats(const HostAllocationTag tag)
+    {
+        assert(tag != HostAllocationTag::Count);
+
+        const HostAllocationTagState &state = getTagStates()[static_cast<std::size_t>(tag)];
+
+        HostAllocationStats stats = {};
+        stats.allocatedBytes = state.allocatedBytes.load(std::memory_order_relaxed);
+        stats.peakAllocatedBytes = state.peakAllocatedBytes.load(std::memory_order_relaxed);
+        stats.allocationCount = state.allocationCount.load(std::memory_order_relaxed);
+        stats.totalAllocationCount = state.totalAllocationCount.load(std::memory_order_relaxed);
+        stats.internalAllocatedBytes = state.internalAllocatedBytes.load(std::memory_order_relaxed);
+        stats.failedAllocationCount = state.failedAllocationCount.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    void setHostAllocationLimit(const HostAllocationTag tag, const uint64_t limitBytes)
+    {
+        assert(tag != HostAllocationTag::Count);
+
+        getTagStates()[static_cast<std::size_t>(tag)].limitBytes.store(limitBytes, std::memory_order_relaxed);
+    }
+
+    const char *hostAllocationTagToString(const HostAllocationTag tag)
+    {
+        switch (tag) {
+            case HostAllocationTag::Instance: return "Instance";
+            case HostAllocationTag::Device: return "Device";
+            case HostAllocationTag::Allocator: return "Allocator";
+            case HostAllocationTag::Swapchain: return "Swapchain";
+            case HostAllocationTag::Resource: return "Resource";
+            case HostAllocationTag::Shader: return "Shader";
+            case HostAllocationTag::Pipeline: return "Pipeline";
+            case HostAllocationTag::Descriptor: return "Descriptor";
+            case HostAllocationTag::Command: return "Command";
+            case HostAllocationTag::Sync: return "Sync";
+            default: break;
+        }
+
+        return "Unknown";
+    }
+}
\ No newline at end of file
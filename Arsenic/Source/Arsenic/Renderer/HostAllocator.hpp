@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+
+namespace arsenic
+{
+    // Every object created through Vulkan passes the callbacks of the subsystem that owns it,
+    // objects have to be destroyed with the callbacks of the same tag
+    enum class HostAllocationTag : uint32_t
+    {
+        Instance,
+        Device,
+        Allocator,
+        Swapchain,
+        Resource,
+        Shader,
+        Pipeline,
+        Descriptor,
+        Command,
+        Sync,
+        Count
+    };
+
+    struct HostAllocationStats
+    {
+        uint64_t allocatedBytes = 0;
+        uint64_t peakAllocatedBytes = 0;
+        uint64_t allocationCount = 0;
+        uint64_t totalAllocationCount = 0;
+        // Memory the driver allocated on its own and only reported through the internal notifications
+        uint64_t internalAllocatedBytes = 0;
+        uint64_t failedAllocationCount = 0;
+    };
+
+    // Small allocations are served from size class pools, larger ones go straight to malloc
+    const VkAllocationCallbacks *getHostAllocationCallbacks(const HostAllocationTag tag);
+
+    HostAllocationStats getHostAllocationStats(const HostAllocationTag tag);
+
+    // Allocations that would exceed limitBytes fail and surface as VK_ERROR_OUT_OF_HOST_MEMORY, 0 removes the limit
+    void setHostAllocationLimit(const HostAllocationTag tag, const uint64_t limitBytes);
+
+    const char *hostAllocationTagToString(const HostAllocationTag tag);
+}
\ No newline at end of file
@@ -0,0 +1,527 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Core/Hash.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/UploadBatch.hpp"
+#include "Arsenic/Renderer/Ktx2Loader.hpp"
+#include "Arsenic/Renderer/MipDownsampler.hpp"
+#include "Arsenic/Renderer/IblBaker.hpp"
+
+namespace arsenic
+{
+    static constexpr VkFormat iblFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+    // Every ibl*.comp shader runs 8x8 workgroups
+    static constexpr uint32_t bakeGroupSize = 8;
+    // Bumped whenever the shaders change what they bake, so stale cache files are not picked up
+    static constexpr uint32_t bakeVersion = 1;
+
+    // Matches the push constant block in iblPrefilterSpecular.comp
+    struct PrefilterSpecularPushConstant
+    {
+        float roughness;
+        uint32_t sampleCount;
+    };
+
+    // Matches the push constant blocks in iblIrradiance.comp and iblBrdfLut.comp
+    struct SampleCountPushConstant
+    {
+        uint32_t sampleCount;
+    };
+
+    static void destroyBakeShader(const VulkanContext &vulkanContext, ShaderEffect &shaderEffect, ShaderPass &shaderPass)
+    {
+        vkDestroyPipeline(vulkanContext.device, shaderPass.pipeline, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+        destroyShaderEffect(vulkanContext, shaderEffect);
+    }
+
+    // Sampled source in binding 0 and storage destination in binding 1, or only the destination in binding 0 without a source
+    static VkDescriptorSet allocateBakeDescriptorSet(const VulkanContext &vulkanContext, const VkDescriptorPool descriptorPool,
+                            const ShaderEffect &shaderEffect, const VkSampler sampler, const VkImageView sourceView, const VkImageView destinationView)
+    {
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        descriptorSetAllocateInfo.descriptorPool = descriptorPool;
+        descriptorSetAllocateInfo.descriptorSetCount = 1;
+        descriptorSetAllocateInfo.pSetLayouts = &shaderEffect.descriptorSetLayouts[0];
+        checkVkResult(vkAllocateDescriptorSets(vulkanContext.device, &descriptorSetAllocateInfo, &descriptorSet));
+
+        VkDescriptorImageInfo sourceImageInfo = {};
+        sourceImageInfo.sampler = sampler;
+        sourceImageInfo.imageView = sourceView;
+        sourceImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkDescriptorImageInfo destinationImageInfo = {};
+        destinationImageInfo.imageView = destinationView;
+        destinationImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 2> writeDescriptors = {};
+        uint32_t writeDescriptorCount = 0;
+
+        if (sourceView != VK_NULL_HANDLE) {
+            VkWriteDescriptorSet &writeDescriptor = writeDescriptors[writeDescriptorCount++];
+            writeDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptor.dstSet = descriptorSet;
+            writeDescriptor.dstBinding = 0;
+            writeDescriptor.descriptorCount = 1;
+            writeDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writeDescriptor.pImageInfo = &sourceImageInfo;
+        }
+
+        VkWriteDescriptorSet &writeDescriptor = writeDescriptors[writeDescriptorCount++];
+        writeDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptor.dstSet = descriptorSet;
+        writeDescriptor.dstBinding = writeDescriptorCount - 1;
+        writeDescriptor.descriptorCount = 1;
+        writeDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writeDescriptor.pImageInfo = &destinationImageInfo;
+
+        vkUpdateDescriptorSets(vulkanContext.device, writeDescriptorCount, writeDescriptors.data(), 0, nullptr);
+
+        return descriptorSet;
+    }
+
+    static void cmdImageLayoutBarrier(const VkCommandBuffer commandBuffer, const VulkanImage &vulkanImage, const uint32_t baseMipLevel,
+                    const uint32_t mipLevelCount, const VkImageLayout oldLayout, const VkImageLayout newLayout,
+                    const VkAccessFlags srcAccessMask, const VkAccessFlags dstAccessMask,
+                    const VkPipelineStageFlags srcStageMask, const VkPipelineStageFlags dstStageMask)
+    {
+        VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+        imageMemoryBarrier.image = vulkanImage.vkImage;
+        imageMemoryBarrier.srcAccessMask = srcAccessMask;
+        imageMemoryBarrier.dstAccessMask = dstAccessMask;
+        imageMemoryBarrier.oldLayout = oldLayout;
+        imageMemoryBarrier.newLayout = newLayout;
+        imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+        imageMemoryBarrier.subresourceRange.layerCount = vulkanImage.arrayLayers;
+        imageMemoryBarrier.subresourceRange.baseMipLevel = baseMipLevel;
+        imageMemoryBarrier.subresourceRange.levelCount = mipLevelCount;
+        imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+    }
+
+    static void cmdDispatchBake(const VkCommandBuffer commandBuffer, const ShaderEffect &shaderEffect, const ShaderPass &shaderPass,
+                    const VkDescriptorSet descriptorSet, const void *pPushConstant, const uint32_t pushConstantSize,
+                    const uint32_t size, const uint32_t layerCount)
+    {
+        const uint32_t groupCount = (size + bakeGroupSize - 1) / bakeGroupSize;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, shaderPass.pipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, shaderEffect.pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+
+        if (pPushConstant != nullptr) {
+            vkCmdPushConstants(commandBuffer, shaderEffect.pipelineLayout, VK_SHADER_STAGE_ALL, 0, pushConstantSize, pPushConstant);
+        }
+
+        vkCmdDispatch(commandBuffer, groupCount, groupCount, layerCount);
+    }
+
+    // Halves the levels one after the other with linear blits, mip 0 has to be in VK_IMAGE_LAYOUT_GENERAL.
+    // Every level is in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL afterwards
+    static void cmdBlitMipLevels(const VkCommandBuffer commandBuffer, const VulkanImage &vulkanImage)
+    {
+        cmdImageLayoutBarrier(commandBuffer, vulkanImage, 0, 1, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        for (uint32_t i = 1; i != vulkanImage.mipLevels; ++i) {
+            cmdImageLayoutBarrier(commandBuffer, vulkanImage, i, 1, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+            const int32_t srcSize = static_cast<int32_t>(std::max(vulkanImage.extent.width >> (i - 1), 1u));
+            const int32_t dstSize = static_cast<int32_t>(std::max(vulkanImage.extent.width >> i, 1u));
+
+            VkImageBlit imageBlit = {};
+            imageBlit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 0, vulkanImage.arrayLayers};
+            imageBlit.srcOffsets[1] = {srcSize, srcSize, 1};
+            imageBlit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i, 0, vulkanImage.arrayLayers};
+            imageBlit.dstOffsets[1] = {dstSize, dstSize, 1};
+
+            vkCmdBlitImage(commandBuffer, vulkanImage.vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vulkanImage.vkImage,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_LINEAR);
+
+            cmdImageLayoutBarrier(commandBuffer, vulkanImage, i, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        }
+
+        cmdImageLayoutBarrier(commandBuffer, vulkanImage, 0, vulkanImage.mipLevels, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    }
+
+    static void submitAndWait(VulkanContext &vulkanContext)
+    {
+        checkVkResult(vkEndCommandBuffer(vulkanContext.tempCommandBuffer));
+
+        const uint64_t submitValue = submitToTimeline(vulkanContext.graphicsQueue, vulkanContext.graphicsTimeline, vulkanContext.tempCommandBuffer);
+        waitForTimelineValue(vulkanContext.device, vulkanContext.graphicsTimeline, submitValue);
+    }
+
+    static void beginTempCommandBuffer(VulkanContext &vulkanContext)
+    {
+        VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        checkVkResult(vkResetCommandPool(vulkanContext.device, vulkanContext.tempCommandPool, 0));
+        checkVkResult(vkBeginCommandBuffer(vulkanContext.tempCommandBuffer, &commandBufferBeginInfo));
+    }
+
+    IblBaker createIblBaker(VulkanContext &vulkanContext, const char *equirectToCubeSpvFilePath, const char *prefilterSpecularSpvFilePath,
+                    const char *irradianceSpvFilePath, const char *brdfLutSpvFilePath)
+    {
+        IblBaker iblBaker = {};
+        iblBaker.equirectToCubeEffect = buildComputeShaderEffect(vulkanContext, equirectToCubeSpvFilePath);
+        iblBaker.equirectToCubePass = buildComputeShaderPass(vulkanContext, &iblBaker.equirectToCubeEffect);
+        iblBaker.prefilterSpecularEffect = buildComputeShaderEffect(vulkanContext, prefilterSpecularSpvFilePath);
+        iblBaker.prefilterSpecularPass = buildComputeShaderPass(vulkanContext, &iblBaker.prefilterSpecularEffect);
+        iblBaker.irradianceEffect = buildComputeShaderEffect(vulkanContext, irradianceSpvFilePath);
+        iblBaker.irradiancePass = buildComputeShaderPass(vulkanContext, &iblBaker.irradianceEffect);
+        iblBaker.brdfLutEffect = buildComputeShaderEffect(vulkanContext, brdfLutSpvFilePath);
+        iblBaker.brdfLutPass = buildComputeShaderPass(vulkanContext, &iblBaker.brdfLutEffect);
+
+        VkSamplerCreateInfo samplerCI = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+        samplerCI.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCI.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCI.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCI.minFilter = VK_FILTER_LINEAR;
+        samplerCI.magFilter = VK_FILTER_LINEAR;
+        samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerCI.maxLod = VK_LOD_CLAMP_NONE;
+        checkVkResult(vkCreateSampler(vulkanContext.device, &samplerCI, getHostAllocationCallbacks(HostAllocationTag::Resource), &iblBaker.sampler));
+
+        return iblBaker;
+    }
+
+    void destroyIblBaker(const VulkanContext &vulkanContext, IblBaker &iblBaker)
+    {
+        vkDestroySampler(vulkanContext.device, iblBaker.sampler, getHostAllocationCallbacks(HostAllocationTag::Resource));
+
+        destroyBakeShader(vulkanContext, iblBaker.equirectToCubeEffect, iblBaker.equirectToCubePass);
+        destroyBakeShader(vulkanContext, iblBaker.prefilterSpecularEffect, iblBaker.prefilterSpecularPass);
+        destroyBakeShader(vulkanContext, iblBaker.irradianceEffect, iblBaker.irradiancePass);
+        destroyBakeShader(vulkanContext, iblBaker.brdfLutEffect, iblBaker.brdfLutPass);
+
+        iblBaker = {};
+    }
+
+    IblMaps bakeIblMaps(VulkanContext &vulkanContext, const IblBaker &iblBaker, const VulkanImage &equirectImage, const IblBakeDesc &bakeDesc,
+                    const MipDownsampler *pMipDownsampler)
+    {
+        assert(equirectImage.imageLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        assert(bakeDesc.specularMipLevels > 1 && bakeDesc.specularMipLevels <= calculateMipLevels(bakeDesc.specularSize, bakeDesc.specularSize));
+
+        // Transfers read the maps back for the cache and let the defragmenter move them
+        constexpr VkImageUsageFlags bakedUsage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                                VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        // The downsampler cannot cover larger cubes, those blit their mips instead
+        if (bakeDesc.environmentSize > maxDownsampleExtent) {
+            pMipDownsampler = nullptr;
+        }
+
+        VkImageUsageFlags environmentUsage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (pMipDownsampler == nullptr) {
+            environmentUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
+
+        VulkanImage environmentMap = createCubeImage2D(vulkanContext, VulkanImageDesc::create(environmentUsage,
+                                        {bakeDesc.environmentSize, bakeDesc.environmentSize, 1}, iblFormat, 6, true));
+
+        VulkanImageDesc specularDesc = VulkanImageDesc::create(bakedUsage, {bakeDesc.specularSize, bakeDesc.specularSize, 1}, iblFormat, 6, true);
+        specularDesc.mipLevelCount = bakeDesc.specularMipLevels;
+
+        IblMaps iblMaps = {};
+        iblMaps.specularMap = createCubeImage2D(vulkanContext, specularDesc);
+        iblMaps.irradianceMap = createCubeImage2D(vulkanContext, VulkanImageDesc::create(bakedUsage,
+                                    {bakeDesc.irradianceSize, bakeDesc.irradianceSize, 1}, iblFormat, 6, false));
+        iblMaps.brdfLut = createImage2D(vulkanContext, VulkanImageDesc::create(bakedUsage,
+                                    {bakeDesc.brdfLutSize, bakeDesc.brdfLutSize, 1}, iblFormat, 1, false));
+
+        // Views only the bake needs, the storage ones address a single level of all six faces
+        const VkImageView equirectView = createImageView(vulkanContext, equirectImage.vkImage, VK_IMAGE_VIEW_TYPE_2D, equirectImage.format,
+                                            VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1, VK_IMAGE_USAGE_SAMPLED_BIT);
+        const VkImageView environmentStorageView = createImageView(vulkanContext, environmentMap.vkImage, VK_IMAGE_VIEW_TYPE_2D_ARRAY, iblFormat,
+                                                    VK_IMAGE_ASPECT_COLOR_BIT, 0, 6, 0, 1, VK_IMAGE_USAGE_STORAGE_BIT);
+        const VkImageView environmentCubeView = createImageView(vulkanContext, environmentMap.vkImage, VK_IMAGE_VIEW_TYPE_CUBE, iblFormat,
+                                                    VK_IMAGE_ASPECT_COLOR_BIT, 0, 6, 0, environmentMap.mipLevels, VK_IMAGE_USAGE_SAMPLED_BIT);
+        const VkImageView irradianceStorageView = createImageView(vulkanContext, iblMaps.irradianceMap.vkImage, VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+                                                    iblFormat, VK_IMAGE_ASPECT_COLOR_BIT, 0, 6, 0, 1, VK_IMAGE_USAGE_STORAGE_BIT);
+        const VkImageView brdfLutStorageView = createImageView(vulkanContext, iblMaps.brdfLut.vkImage, VK_IMAGE_VIEW_TYPE_2D, iblFormat,
+                                                    VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1, VK_IMAGE_USAGE_STORAGE_BIT);
+
+        std::vector<VkImageView> specularStorageViews(bakeDesc.specularMipLevels);
+        for (uint32_t i = 0; i != bakeDesc.specularMipLevels; ++i) {
+            specularStorageViews[i] = createImageView(vulkanContext, iblMaps.specularMap.vkImage, VK_IMAGE_VIEW_TYPE_2D_ARRAY, iblFormat,
+                                        VK_IMAGE_ASPECT_COLOR_BIT, 0, 6, i, 1, VK_IMAGE_USAGE_STORAGE_BIT);
+        }
+
+        // Freed all at once with the pool once the bake has completed
+        const uint32_t descriptorSetCount = bakeDesc.specularMipLevels + 3;
+
+        std::array<VkDescriptorPoolSize, 2> poolSizes = {
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, descriptorSetCount},
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, descriptorSetCount}
+        };
+
+        VkDescriptorPoolCreateInfo descriptorPoolCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+        descriptorPoolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        descriptorPoolCI.pPoolSizes = poolSizes.data();
+        descriptorPoolCI.maxSets = descriptorSetCount;
+
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        checkVkResult(vkCreateDescriptorPool(vulkanContext.device, &descriptorPoolCI, getHostAllocationCallbacks(HostAllocationTag::Descriptor),
+                        &descriptorPool));
+
+        const VkDescriptorSet equirectToCubeSet = allocateBakeDescriptorSet(vulkanContext, descriptorPool, iblBaker.equirectToCubeEffect,
+                                                    iblBaker.sampler, equirectView, environmentStorageView);
+        const VkDescriptorSet irradianceSet = allocateBakeDescriptorSet(vulkanContext, descriptorPool, iblBaker.irradianceEffect,
+                                                    iblBaker.sampler, environmentCubeView, irradianceStorageView);
+        const VkDescriptorSet brdfLutSet = allocateBakeDescriptorSet(vulkanContext, descriptorPool, iblBaker.brdfLutEffect,
+                                                    VK_NULL_HANDLE, VK_NULL_HANDLE, brdfLutStorageView);
+
+        std::vector<VkDescriptorSet> prefilterSpecularSets(bakeDesc.specularMipLevels);
+        for (uint32_t i = 0; i != bakeDesc.specularMipLevels; ++i) {
+            prefilterSpecularSets[i] = allocateBakeDescriptorSet(vulkanContext, descriptorPool, iblBaker.prefilterSpecularEffect,
+                                            iblBaker.sampler, environmentCubeView, specularStorageViews[i]);
+        }
+
+        MipDownsampleTarget mipDownsampleTarget = {};
+        if (pMipDownsampler != nullptr) {
+            mipDownsampleTarget = createMipDownsampleTarget(vulkanContext, *pMipDownsampler, environmentMap);
+        }
+
+        const VkCommandBuffer commandBuffer = vulkanContext.tempCommandBuffer;
+        beginTempCommandBuffer(vulkanContext);
+
+        // Equirect to cube, then the mip chain prefiltering reads to keep its sample count low
+        cmdImageLayoutBarrier(commandBuffer, environmentMap, 0, 1, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                    0, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+        cmdDispatchBake(commandBuffer, iblBaker.equirectToCubeEffect, iblBaker.equirectToCubePass, equirectToCubeSet, nullptr, 0,
+                    bakeDesc.environmentSize, 6);
+
+        if (pMipDownsampler != nullptr) {
+            cmdImageLayoutBarrier(commandBuffer, environmentMap, 0, 1, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            cmdDownsampleMipLevels(commandBuffer, *pMipDownsampler, mipDownsampleTarget, environmentMap);
+        }
+        else {
+            cmdBlitMipLevels(commandBuffer, environmentMap);
+        }
+
+        for (const VulkanImage *pBakedImage : {&iblMaps.specularMap, &iblMaps.irradianceMap, &iblMaps.brdfLut}) {
+            cmdImageLayoutBarrier(commandBuffer, *pBakedImage, 0, pBakedImage->mipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                        0, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        }
+
+        for (uint32_t i = 0; i != bakeDesc.specularMipLevels; ++i) {
+            PrefilterSpecularPushConstant pushConstant = {};
+            pushConstant.roughness = static_cast<float>(i) / static_cast<float>(bakeDesc.specularMipLevels - 1);
+            pushConstant.sampleCount = bakeDesc.specularSampleCount;
+
+            cmdDispatchBake(commandBuffer, iblBaker.prefilterSpecularEffect, iblBaker.prefilterSpecularPass, prefilterSpecularSets[i],
+                        &pushConstant, sizeof(pushConstant), std::max(bakeDesc.specularSize >> i, 1u), 6);
+        }
+
+        SampleCountPushConstant irradiancePushConstant = {bakeDesc.irradianceSampleCount};
+        cmdDispatchBake(commandBuffer, iblBaker.irradianceEffect, iblBaker.irradiancePass, irradianceSet,
+                    &irradiancePushConstant, sizeof(irradiancePushConstant), bakeDesc.irradianceSize, 6);
+
+        SampleCountPushConstant brdfLutPushConstant = {bakeDesc.brdfLutSampleCount};
+        cmdDispatchBake(commandBuffer, iblBaker.brdfLutEffect, iblBaker.brdfLutPass, brdfLutSet,
+                    &brdfLutPushConstant, sizeof(brdfLutPushConstant), bakeDesc.brdfLutSize, 1);
+
+        for (VulkanImage *pBakedImage : {&iblMaps.specularMap, &iblMaps.irradianceMap, &iblMaps.brdfLut}) {
+            cmdImageLayoutBarrier(commandBuffer, *pBakedImage, 0, pBakedImage->mipLevels, VK_IMAGE_LAYOUT_GENERAL,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+            pBakedImage->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+
+        submitAndWait(vulkanContext);
+
+        if (pMipDownsampler != nullptr) {
+            destroyMipDownsampleTarget(vulkanContext, *pMipDownsampler, mipDownsampleTarget);
+        }
+
+        vkDestroyDescriptorPool(vulkanContext.device, descriptorPool, getHostAllocationCallbacks(HostAllocationTag::Descriptor));
+
+        for (const VkImageView imageView : specularStorageViews) {
+            vkDestroyImageView(vulkanContext.device, imageView, getHostAllocationCallbacks(HostAllocationTag::Resource));
+        }
+
+        for (const VkImageView imageView : {equirectView, environmentStorageView, environmentCubeView, irradianceStorageView, brdfLutStorageView}) {
+            vkDestroyImageView(vulkanContext.device, imageView, getHostAllocationCallbacks(HostAllocationTag::Resource));
+        }
+
+        destroyImage(vulkanContext, environmentMap);
+
+        return iblMaps;
+    }
+
+    // Hashes the source file and the bake parameters
+    static uint64_t hashIblSource(const char *hdrImageFilePath, const IblBakeDesc &bakeDesc)
+    {
+        const FileView file = readFile(hdrImageFilePath);
+        assert(file.isValid());
+
+        const std::array<uint32_t, 9> parameters = {
+            bakeVersion, bakeDesc.environmentSize, bakeDesc.specularSize, bakeDesc.specularMipLevels, bakeDesc.irradianceSize,
+            bakeDesc.brdfLutSize, bakeDesc.specularSampleCount, bakeDesc.irradianceSampleCount, bakeDesc.brdfLutSampleCount
+        };
+
+        return hashBytes(parameters.data(), sizeof(parameters), hashBytes(file.pData, file.size));
+    }
+
+    // Reads every level of vulkanImage back and writes it as a KTX2 file
+    static bool writeIblMapToFile(VulkanContext &vulkanContext, const VulkanImage &vulkanImage, const std::string &ktx2FilePath)
+    {
+        constexpr VkDeviceSize texelSize = 4 * sizeof(uint16_t);
+
+        std::vector<ImageMipLevelData> mipLevels(vulkanImage.mipLevels);
+        std::vector<VkBufferImageCopy> bufferImageCopies(vulkanImage.mipLevels);
+        VkDeviceSize readbackSize = 0;
+
+        for (uint32_t i = 0; i != vulkanImage.mipLevels; ++i) {
+            const uint32_t width = std::max(vulkanImage.extent.width >> i, 1u);
+            const uint32_t height = std::max(vulkanImage.extent.height >> i, 1u);
+
+            mipLevels[i] = {readbackSize, texelSize * width * height};
+
+            bufferImageCopies[i].bufferOffset = readbackSize;
+            bufferImageCopies[i].imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i, 0, vulkanImage.arrayLayers};
+            bufferImageCopies[i].imageExtent = {width, height, 1};
+
+            readbackSize += mipLevels[i].layerSize * vulkanImage.arrayLayers;
+        }
+
+        VulkanBuffer readbackBuffer = createBuffer(vulkanContext, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, 
+                                        readbackSize);
+
+        const VkCommandBuffer commandBuffer = vulkanContext.tempCommandBuffer;
+        beginTempCommandBuffer(vulkanContext);
+
+        cmdImageLayoutBarrier(commandBuffer, vulkanImage, 0, vulkanImage.mipLevels, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, 0, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        vkCmdCopyImageToBuffer(commandBuffer, vulkanImage.vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer.vkBuffer,
+                    static_cast<uint32_t>(bufferImageCopies.size()), bufferImageCopies.data());
+
+        cmdImageLayoutBarrier(commandBuffer, vulkanImage, 0, vulkanImage.mipLevels, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+        VkBufferMemoryBarrier bufferMemoryBarrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+        bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferMemoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferMemoryBarrier.buffer = readbackBuffer.vkBuffer;
+        bufferMemoryBarrier.size = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr);
+
+        submitAndWait(vulkanContext);
+
+        checkVkResult(vmaInvalidateAllocation(vulkanContext.vmaAllocator, readbackBuffer.vmaAllocation, 0, VK_WHOLE_SIZE));
+
+        const bool written = writeKtx2ImageToFile(ktx2FilePath.c_str(), vulkanImage.format, {vulkanImage.extent.width, vulkanImage.extent.height},
+                                vulkanImage.arrayLayers, readbackBuffer.pMappedPointer, mipLevels);
+
+        destroyBuffer(vulkanContext, readbackBuffer);
+
+        return written;
+    }
+
+    // A cached map is only used when it is exactly what the bake would produce, anything else is baked again
+    static bool isIblMapFileValid(const std::string &ktx2FilePath, const uint32_t faceCount, const uint32_t size, const uint32_t levelCount)
+    {
+        Ktx2ImageInfo imageInfo = {};
+        if (!readKtx2ImageInfo(ktx2FilePath.c_str(), imageInfo)) {
+            return false;
+        }
+
+        return imageInfo.format == iblFormat && imageInfo.faceCount == faceCount && imageInfo.extent.width == size &&
+               imageInfo.extent.height == size && imageInfo.levelCount == levelCount;
+    }
+
+    IblMaps loadIblMaps(VulkanContext &vulkanContext, const IblBaker &iblBaker, const char *hdrImageFilePath, const char *cacheDirectory,
+                    const IblBakeDesc &bakeDesc, const MipDownsampler *pMipDownsampler)
+    {
+        std::ostringstream cacheKeyStream;
+        cacheKeyStream << std::hex << std::setw(16) << std::setfill('0') << hashIblSource(hdrImageFilePath, bakeDesc);
+
+        const std::string cacheKey = cacheKeyStream.str();
+        const std::filesystem::path cachePath(cacheDirectory);
+        const std::string specularFilePath = (cachePath / (cacheKey + "_specular.ktx2")).string();
+        const std::string irradianceFilePath = (cachePath / (cacheKey + "_irradiance.ktx2")).string();
+        const std::string brdfLutFilePath = (cachePath / (cacheKey + "_brdfLut.ktx2")).string();
+
+        IblMaps iblMaps = {};
+
+        // A pack may ship the maps already baked, a fresh bake is written next to the working directory and found there
+        const bool cachedMapsExist = fileExists(specularFilePath.c_str()) && fileExists(irradianceFilePath.c_str()) && fileExists(brdfLutFilePath.c_str());
+        const bool cachedMapsValid = cachedMapsExist &&
+                                     isIblMapFileValid(specularFilePath, 6, bakeDesc.specularSize, bakeDesc.specularMipLevels) &&
+                                     isIblMapFileValid(irradianceFilePath, 6, bakeDesc.irradianceSize, 1) &&
+                                     isIblMapFileValid(brdfLutFilePath, 1, bakeDesc.brdfLutSize, 1);
+
+        if (cachedMapsExist && !cachedMapsValid) {
+            ARSENIC_WARN("Renderer: The maps cached for {} in {} are corrupted, they are baked again", hdrImageFilePath, cacheDirectory);
+        }
+
+        if (cachedMapsValid) {
+            UploadBatch uploadBatch = beginUploadBatch(vulkanContext);
+            iblMaps.specularMap = loadKtx2ImageFromFile(vulkanContext, uploadBatch, specularFilePath.c_str());
+            iblMaps.irradianceMap = loadKtx2ImageFromFile(vulkanContext, uploadBatch, irradianceFilePath.c_str());
+            iblMaps.brdfLut = loadKtx2ImageFromFile(vulkanContext, uploadBatch, brdfLutFilePath.c_str());
+            submitUploadBatch(vulkanContext, uploadBatch);
+            destroyUploadBatch(vulkanContext, uploadBatch);
+        }
+        else {
+            // R32G32B32A32 is what both the stb_image and the OpenEXR paths can decode to
+            const VkFormat equirectFormat = vulkanContext.findSupportedFormat({VK_FORMAT_R32G32B32A32_SFLOAT}, VK_IMAGE_TILING_OPTIMAL,
+                                                VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+            assert(equirectFormat != VK_FORMAT_UNDEFINED);
+
+            VulkanImage equirectImage = loadHDRImage2DFromFile(vulkanContext, VulkanImageDesc::create(VK_IMAGE_USAGE_SAMPLED_BIT |
+                                            VK_IMAGE_USAGE_TRANSFER_DST_BIT, {}, equirectFormat, 1, false), hdrImageFilePath);
+
+            iblMaps = bakeIblMaps(vulkanContext, iblBaker, equirectImage, bakeDesc, pMipDownsampler);
+            destroyImage(vulkanContext, equirectImage);
+
+            std::error_code errorCode;
+            std::filesystem::create_directories(cachePath, errorCode);
+
+            if (!writeIblMapToFile(vulkanContext, iblMaps.specularMap, specularFilePath) ||
+                !writeIblMapToFile(vulkanContext, iblMaps.irradianceMap, irradianceFilePath) ||
+                !writeIblMapToFile(vulkanContext, iblMaps.brdfLut, brdfLutFilePath)) {
+                ARSENIC_WARN("Renderer: Could not cache the maps baked from {} in {}, they are baked again next time", hdrImageFilePath, cacheDirectory);
+            }
+        }
+
+        iblMaps.specularMap.vkImageView = createImageView(vulkanContext, iblMaps.specularMap.vkImage, VK_IMAGE_VIEW_TYPE_CUBE,
+                                            iblMaps.specularMap.format, VK_IMAGE_ASPECT_COLOR_BIT, 0, 6, 0, iblMaps.specularMap.mipLevels,
+                                            VK_IMAGE_USAGE_SAMPLED_BIT);
+        iblMaps.irradianceMap.vkImageView = createImageView(vulkanContext, iblMaps.irradianceMap.vkImage, VK_IMAGE_VIEW_TYPE_CUBE,
+                                            iblMaps.irradianceMap.format, VK_IMAGE_ASPECT_COLOR_BIT, 0, 6, 0, 1, VK_IMAGE_USAGE_SAMPLED_BIT);
+        iblMaps.brdfLut.vkImageView = createImageView(vulkanContext, iblMaps.brdfLut.vkImage, VK_IMAGE_VIEW_TYPE_2D,
+                                            iblMaps.brdfLut.format, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1, VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        return iblMaps;
+    }
+
+    void destroyIblMaps(const VulkanContext &vulkanContext, IblMaps &iblMaps)
+    {
+        destroyImage(vulkanContext, iblMaps.specularMap);
+        destroyImage(vulkanContext, iblMaps.irradianceMap);
+        destroyImage(vulkanContext, iblMaps.brdfLut);
+    }
+}
\ No newline at end of file
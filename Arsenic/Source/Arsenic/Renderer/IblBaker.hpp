@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanImage.hpp"
+#include "Arsenic/Renderer/Shader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    struct MipDownsampler;
+
+    // Split sum image based lighting, every map is VK_FORMAT_R16G16B16A16_SFLOAT and in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    struct IblMaps
+    {
+        // GGX prefiltered radiance, mip m holds roughness m / (mipLevels - 1) so mip 0 is the environment itself
+        VulkanImage specularMap;
+        // Cosine convolved radiance, what a white lambertian surface facing each direction reflects
+        VulkanImage irradianceMap;
+        // Scale and bias applied to F0, indexed by (NdotV, roughness)
+        VulkanImage brdfLut;
+    };
+
+    struct IblBakeDesc
+    {
+        // Faces of the intermediate cube the equirect image is converted to, prefiltering reads its mips
+        uint32_t environmentSize = 512;
+        uint32_t specularSize = 512;
+        uint32_t specularMipLevels = 6;
+        uint32_t irradianceSize = 32;
+        uint32_t brdfLutSize = 256;
+        uint32_t specularSampleCount = 1024;
+        uint32_t irradianceSampleCount = 2048;
+        uint32_t brdfLutSampleCount = 1024;
+    };
+
+    struct IblBaker
+    {
+        ShaderEffect equirectToCubeEffect;
+        ShaderPass equirectToCubePass;
+        ShaderEffect prefilterSpecularEffect;
+        ShaderPass prefilterSpecularPass;
+        ShaderEffect irradianceEffect;
+        ShaderPass irradiancePass;
+        ShaderEffect brdfLutEffect;
+        ShaderPass brdfLutPass;
+        // Linear, clamped to edge and with every mip level, also the sampler the baked maps are meant to be read with
+        VkSampler sampler = VK_NULL_HANDLE;
+    };
+
+    IblBaker createIblBaker(VulkanContext &vulkanContext, const char *equirectToCubeSpvFilePath, const char *prefilterSpecularSpvFilePath,
+                    const char *irradianceSpvFilePath, const char *brdfLutSpvFilePath);
+    void destroyIblBaker(const VulkanContext &vulkanContext, IblBaker &iblBaker);
+
+    // Bakes the maps out of an equirectangular image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL and waits for the GPU.
+    // The mips of the intermediate cube are built by pMipDownsampler when given and the cube is no larger than maxDownsampleExtent,
+    // blitted level by level otherwise
+    IblMaps bakeIblMaps(VulkanContext &vulkanContext, const IblBaker &iblBaker, const VulkanImage &equirectImage, const IblBakeDesc &bakeDesc,
+                    const MipDownsampler *pMipDownsampler = nullptr);
+
+    // Loads the maps baked out of hdrImageFilePath from cacheDirectory, baking and writing them there first when they are missing
+    // or do not match bakeDesc. Cached files are named after a hash of the source file and of bakeDesc, so changing either of them bakes again
+    IblMaps loadIblMaps(VulkanContext &vulkanContext, const IblBaker &iblBaker, const char *hdrImageFilePath, const char *cacheDirectory,
+                    const IblBakeDesc &bakeDesc = {}, const MipDownsampler *pMipDownsampler = nullptr);
+    void destroyIblMaps(const VulkanContext &vulkanContext, IblMaps &iblMaps);
+}
\ No newline at end of file
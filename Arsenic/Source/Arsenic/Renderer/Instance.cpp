@@ -2,6 +2,7 @@
 
 #include "Arsenic/Renderer/VulkanHeader.hpp"
 #include "Arsenic/Renderer/Instance.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
 
 #include <GLFW/glfw3.h>
 
@@ -108,7 +109,8 @@ namespace arsenic
             debugUtilsMessengerCI.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
             debugUtilsMessengerCI.pfnUserCallback = debugCallback;
 
-            checkVkResult(createDebugUtilsMessengerEXT(instance.vkinstance, &debugUtilsMessengerCI, nullptr, &instance.debugMessenger));
+            checkVkResult(createDebugUtilsMessengerEXT(instance.vkinstance, &debugUtilsMessengerCI, getHostAllocationCallbacks(HostAllocationTag::Instance), 
+                        &instance.debugMessenger));
         }
     }
 
@@ -121,7 +123,7 @@ namespace arsenic
         applicationCI.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         applicationCI.pEngineName = "Arsenic";
         applicationCI.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        applicationCI.apiVersion = VK_API_VERSION_1_1;
+        applicationCI.apiVersion = VK_API_VERSION_1_2;
 
         constexpr uint32_t i = VK_API_VERSION_1_0;
         constexpr uint32_t k = VK_MAKE_VERSION(1, 0, 108);
@@ -151,7 +153,7 @@ namespace arsenic
         }
 
         Instance instance = {};
-        checkVkResult(vkCreateInstance(&instanceCI, nullptr, &instance.vkinstance));
+        checkVkResult(vkCreateInstance(&instanceCI, getHostAllocationCallbacks(HostAllocationTag::Instance), &instance.vkinstance));
         createDebugUtilsMessenger(instance);
 
         return instance;
@@ -160,9 +162,9 @@ namespace arsenic
     void Instance::destroyVulkanInstance(Instance *pInstance)
     {
         if constexpr (enableValidation){
-            destroyDebugUtilsMessengerEXT(pInstance->vkinstance, pInstance->debugMessenger, nullptr);
+            destroyDebugUtilsMessengerEXT(pInstance->vkinstance, pInstance->debugMessenger, getHostAllocationCallbacks(HostAllocationTag::Instance));
         }
 
-        vkDestroyInstance(pInstance->vkinstance, nullptr);
+        vkDestroyInstance(pInstance->vkinstance, getHostAllocationCallbacks(HostAllocationTag::Instance));
     }
 }
\ No newline at end of file
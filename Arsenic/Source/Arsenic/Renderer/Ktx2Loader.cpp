@@ -0,0 +1,326 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/UploadBatch.hpp"
+#include "Arsenic/Renderer/Ktx2Loader.hpp"
+
+namespace arsenic
+{
+    static constexpr std::array<uint8_t, 12> ktx2Identifier = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    struct Ktx2Header
+    {
+        std::array<uint8_t, 12> identifier;
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct Ktx2LevelIndex
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header has to match the file layout");
+    static_assert(sizeof(Ktx2LevelIndex) == 24, "Ktx2LevelIndex has to match the file layout");
+
+    // Basic data format descriptor of VK_FORMAT_R16G16B16A16_SFLOAT: linear RGBSDA color model, four signed 16 bit float samples
+    static std::array<uint32_t, 23> buildRgba16FloatDataFormatDescriptor()
+    {
+        constexpr uint32_t colorModelRgbsda = 1;
+        constexpr uint32_t primariesBT709 = 1;
+        constexpr uint32_t transferLinear = 1;
+        constexpr uint32_t sampleDatatypeSignedFloat = 0x40 | 0x80;
+        constexpr uint32_t blockByteSize = 24 + 16 * 4;
+        constexpr std::array<uint32_t, 4> channelTypes = {0, 1, 2, 15};
+
+        std::array<uint32_t, 23> words = {};
+        words[0] = 4 + blockByteSize;
+        // Khronos vendor, basic descriptor type
+        words[1] = 0;
+        words[2] = 2 | (blockByteSize << 16);
+        words[3] = colorModelRgbsda | (primariesBT709 << 8) | (transferLinear << 16);
+        // 1x1x1x1 texel blocks, stored minus one
+        words[4] = 0;
+        words[5] = 4 * sizeof(uint16_t);
+        words[6] = 0;
+
+        for (uint32_t i = 0; i != channelTypes.size(); ++i) {
+            words[7 + 4 * i] = (16 * i) | (15 << 16) | ((channelTypes[i] | sampleDatatypeSignedFloat) << 24);
+            words[8 + 4 * i] = 0;
+            // -1.0f and 1.0f
+            words[9 + 4 * i] = 0xBF800000;
+            words[10 + 4 * i] = 0x3F800000;
+        }
+
+        return words;
+    }
+
+    // Checks everything the loader relies on without touching the device, levelIndices receives at least one level
+    static bool parseKtx2File(const FileView &file, Ktx2Header &header, std::vector<Ktx2LevelIndex> &levelIndices)
+    {
+        if (!file.isValid() || file.size < sizeof(Ktx2Header)) {
+            return false;
+        }
+
+        std::memcpy(&header, file.pData, sizeof(header));
+
+        if (header.identifier != ktx2Identifier || header.supercompressionScheme != 0 || header.pixelDepth != 0 || header.layerCount > 1 ||
+            (header.faceCount != 1 && header.faceCount != 6) || header.pixelWidth == 0 || header.pixelHeight == 0) {
+            return false;
+        }
+
+        // A level count of 0 asks the loader to generate the chain
+        const uint32_t fileLevelCount = std::max(header.levelCount, 1u);
+
+        if ((header.levelCount == 0 && isBlockCompressedFormat(static_cast<VkFormat>(header.vkFormat))) ||
+            fileLevelCount > calculateMipLevels(header.pixelWidth, header.pixelHeight) ||
+            sizeof(Ktx2Header) + static_cast<uint64_t>(fileLevelCount) * sizeof(Ktx2LevelIndex) > file.size) {
+            return false;
+        }
+
+        // Levels are uploaded with the size the format implies, so a file disagreeing with it would be read past its levels
+        const VkFormat format = static_cast<VkFormat>(header.vkFormat);
+        const uint32_t blockSize = getFormatTexelBlockSize(format);
+        const uint32_t blockExtent = isBlockCompressedFormat(format) ? 4 : 1;
+
+        if (blockSize == 0) {
+            return false;
+        }
+
+        levelIndices.resize(fileLevelCount);
+        std::memcpy(levelIndices.data(), file.pData + sizeof(Ktx2Header), fileLevelCount * sizeof(Ktx2LevelIndex));
+
+        for (uint32_t level = 0; level != fileLevelCount; ++level) {
+            const Ktx2LevelIndex &levelIndex = levelIndices[level];
+            const uint64_t blockCountX = (std::max(header.pixelWidth >> level, 1u) + blockExtent - 1) / blockExtent;
+            const uint64_t blockCountY = (std::max(header.pixelHeight >> level, 1u) + blockExtent - 1) / blockExtent;
+
+            if (levelIndex.byteLength != blockCountX * blockCountY * blockSize * header.faceCount || levelIndex.byteLength > file.size ||
+                levelIndex.byteOffset > file.size - levelIndex.byteLength) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool readKtx2ImageInfo(const char *ktx2FilePath, Ktx2ImageInfo &imageInfo)
+    {
+        Ktx2Header header = {};
+        std::vector<Ktx2LevelIndex> levelIndices;
+
+        if (!parseKtx2File(readFile(ktx2FilePath), header, levelIndices)) {
+            return false;
+        }
+
+        imageInfo.format = static_cast<VkFormat>(header.vkFormat);
+        imageInfo.extent = {header.pixelWidth, header.pixelHeight};
+        imageInfo.faceCount = header.faceCount;
+        imageInfo.levelCount = header.levelCount;
+
+        return true;
+    }
+
+    bool readKtx2MipChain(const char *ktx2FilePath, Ktx2ImageInfo &imageInfo, std::vector<uint8_t> &mipChain, 
+                std::vector<ImageMipLevelData> &mipLevels)
+    {
+        const FileView file = readFile(ktx2FilePath);
+
+        Ktx2Header header = {};
+        std::vector<Ktx2LevelIndex> levelIndices;
+
+        if (!parseKtx2File(file, header, levelIndices) || header.faceCount != 1 || header.levelCount == 0) {
+            return false;
+        }
+
+        imageInfo.format = static_cast<VkFormat>(header.vkFormat);
+        imageInfo.extent = {header.pixelWidth, header.pixelHeight};
+        imageInfo.faceCount = header.faceCount;
+        imageInfo.levelCount = header.levelCount;
+
+        // Every level starts where uploadImageMipLevels can copy from, texel sizes like 3 bytes would misalign the packed ones
+        const VkDeviceSize levelAlignment = std::lcm(VkDeviceSize(getFormatTexelBlockSize(imageInfo.format)), VkDeviceSize(4));
+
+        mipLevels.clear();
+        mipLevels.reserve(levelIndices.size());
+
+        VkDeviceSize chainSize = 0;
+        for (const Ktx2LevelIndex &levelIndex : levelIndices) {
+            chainSize = (chainSize + levelAlignment - 1) / levelAlignment * levelAlignment;
+            mipLevels.push_back({chainSize, levelIndex.byteLength});
+            chainSize += levelIndex.byteLength;
+        }
+
+        mipChain.resize(static_cast<std::size_t>(chainSize));
+
+        for (std::size_t level = 0; level != levelIndices.size(); ++level) {
+            std::memcpy(mipChain.data() + mipLevels[level].offset, file.pData + levelIndices[level].byteOffset, 
+                    static_cast<std::size_t>(levelIndices[level].byteLength));
+        }
+
+        return true;
+    }
+
+    VulkanImage loadKtx2ImageFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const char *ktx2FilePath)
+    {
+        // Levels are uploaded straight out of the mapped file
+        const FileView file = readFile(ktx2FilePath);
+
+        Ktx2Header header = {};
+        std::vector<Ktx2LevelIndex> levelIndices;
+
+        const bool parsed = parseKtx2File(file, header, levelIndices);
+        assert(parsed);
+        (void)parsed;
+
+        const bool generateMipLevels = header.levelCount == 0;
+        const uint32_t fileLevelCount = static_cast<uint32_t>(levelIndices.size());
+        const VkFormat fileFormat = static_cast<VkFormat>(header.vkFormat);
+
+        VkFormatFeatureFlags formatFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+        if (generateMipLevels) {
+            formatFeatures |= VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+        }
+
+        const VkFormat format = vulkanContext.findSupportedFormat({fileFormat}, VK_IMAGE_TILING_OPTIMAL, formatFeatures);
+        assert(format != VK_FORMAT_UNDEFINED);
+
+        // Levels are stored smallest first, so the whole image data is the range spanned by all of them
+        uint64_t dataBegin = std::numeric_limits<uint64_t>::max();
+        uint64_t dataEnd = 0;
+
+        for (const Ktx2LevelIndex &levelIndex : levelIndices) {
+            dataBegin = std::min(dataBegin, levelIndex.byteOffset);
+            dataEnd = std::max(dataEnd, levelIndex.byteOffset + levelIndex.byteLength);
+        }
+
+        std::vector<ImageMipLevelData> mipLevels;
+        mipLevels.reserve(fileLevelCount);
+
+        for (const Ktx2LevelIndex &levelIndex : levelIndices) {
+            mipLevels.push_back({levelIndex.byteOffset - dataBegin, levelIndex.byteLength / header.faceCount});
+        }
+
+        // Copyable both ways for the mip blits and so the defragmenter can move the image
+        const VkImageUsageFlags imageUsageFlags = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        VulkanImageDesc imageDesc = VulkanImageDesc::create(imageUsageFlags, {header.pixelWidth, header.pixelHeight, 1}, format, 
+                                        header.faceCount, generateMipLevels);
+        imageDesc.mipLevelCount = generateMipLevels ? 0 : fileLevelCount;
+
+        VulkanImage vulkanImage = header.faceCount == 6 ? createCubeImage2D(vulkanContext, imageDesc) : createImage2D(vulkanContext, imageDesc);
+
+        if (generateMipLevels) {
+            uploadImage(vulkanContext, uploadBatch, vulkanImage, file.pData + dataBegin, mipLevels[0].layerSize, true);
+        }
+        else {
+            uploadImageMipLevels(vulkanContext, uploadBatch, vulkanImage, file.pData + dataBegin, dataEnd - dataBegin, mipLevels);
+        }
+
+        return vulkanImage;
+    }
+
+    VulkanImage loadKtx2ImageFromFile(VulkanContext &vulkanContext, const char *ktx2FilePath)
+    {
+        UploadBatch uploadBatch = beginUploadBatch(vulkanContext);
+        VulkanImage vulkanImage = loadKtx2ImageFromFile(vulkanContext, uploadBatch, ktx2FilePath);
+        submitUploadBatch(vulkanContext, uploadBatch);
+        destroyUploadBatch(vulkanContext, uploadBatch);
+
+        return vulkanImage;
+    }
+
+    bool writeKtx2ImageToFile(const char *ktx2FilePath, const VkFormat format, const VkExtent2D extent, const uint32_t faceCount, 
+                const void *pData, const std::vector<ImageMipLevelData> &mipLevels)
+    {
+        assert(format == VK_FORMAT_R16G16B16A16_SFLOAT);
+        assert(faceCount == 1 || faceCount == 6);
+        assert(!mipLevels.empty());
+
+        constexpr uint64_t texelSize = 4 * sizeof(uint16_t);
+
+        const std::array<uint32_t, 23> dfd = buildRgba16FloatDataFormatDescriptor();
+        const uint32_t levelCount = static_cast<uint32_t>(mipLevels.size());
+        const uint32_t dfdOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + levelCount * sizeof(Ktx2LevelIndex));
+        const uint32_t dfdLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+        Ktx2Header header = {};
+        header.identifier = ktx2Identifier;
+        header.vkFormat = static_cast<uint32_t>(format);
+        header.typeSize = sizeof(uint16_t);
+        header.pixelWidth = extent.width;
+        header.pixelHeight = extent.height;
+        header.faceCount = faceCount;
+        header.levelCount = levelCount;
+        header.dfdByteOffset = dfdOffset;
+        header.dfdByteLength = dfdLength;
+
+        // The smallest level comes first in the file, every level aligned to the texel size
+        std::vector<Ktx2LevelIndex> levelIndices(levelCount);
+        uint64_t offset = dfdOffset + dfdLength;
+
+        for (uint32_t level = levelCount; level-- != 0;) {
+            offset = (offset + texelSize - 1) / texelSize * texelSize;
+            levelIndices[level].byteOffset = offset;
+            levelIndices[level].byteLength = mipLevels[level].layerSize * faceCount;
+            levelIndices[level].uncompressedByteLength = levelIndices[level].byteLength;
+            offset += levelIndices[level].byteLength;
+        }
+
+        std::vector<uint8_t> fileData(offset, 0);
+        std::memcpy(fileData.data(), &header, sizeof(header));
+        std::memcpy(fileData.data() + sizeof(header), levelIndices.data(), levelCount * sizeof(Ktx2LevelIndex));
+        std::memcpy(fileData.data() + dfdOffset, dfd.data(), dfdLength);
+
+        for (uint32_t level = 0; level != levelCount; ++level) {
+            std::memcpy(fileData.data() + levelIndices[level].byteOffset, static_cast<const uint8_t *>(pData) + mipLevels[level].offset, 
+                    levelIndices[level].byteLength);
+        }
+
+        // Written next to the destination and renamed over it, so an interrupted write never leaves a truncated file behind
+        const std::filesystem::path ktx2Path(ktx2FilePath);
+        const std::filesystem::path tempPath = ktx2Path.string() + ".tmp";
+
+        std::error_code errorCode;
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char *>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+            file.close();
+
+            if (!file.good()) {
+                std::filesystem::remove(tempPath, errorCode);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, ktx2Path, errorCode);
+        if (errorCode) {
+            std::filesystem::remove(tempPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanImage.hpp"
+#include "Arsenic/Renderer/UploadBatch.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    // Loads a KTX2 container as written by ArsenicCooker: any sampleable VkFormat getFormatTexelBlockSize knows, block compressed
+    // ones included, 2D or cube, with its precomputed mip chain uploaded as is. Supercompressed files are not supported, neither are
+    // levels whose byte length differs from what the format and extent imply.
+    // A file without mip levels gets them generated when its format is not block compressed
+    VulkanImage loadKtx2ImageFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const char *ktx2FilePath);
+    VulkanImage loadKtx2ImageFromFile(VulkanContext &vulkanContext, const char *ktx2FilePath);
+
+    struct Ktx2ImageInfo
+    {
+        VkFormat format;
+        VkExtent2D extent;
+        uint32_t faceCount;
+        // 0 when the loader generates the mip chain
+        uint32_t levelCount;
+    };
+
+    // Returns false when the file is missing or would be rejected by loadKtx2ImageFromFile. Whether the device supports
+    // the format is not checked
+    bool readKtx2ImageInfo(const char *ktx2FilePath, Ktx2ImageInfo &imageInfo);
+
+    // Reads the mip chain of a 2D file into system memory for callers that upload it themselves, laid out as for uploadImageMipLevels.
+    // Returns false for cube maps and files leaving their mip chain to the loader, besides whatever readKtx2ImageInfo rejects
+    bool readKtx2MipChain(const char *ktx2FilePath, Ktx2ImageInfo &imageInfo, std::vector<uint8_t> &mipChain, 
+                std::vector<ImageMipLevelData> &mipLevels);
+
+    // Writes data read back from the GPU as a KTX2 file loadKtx2ImageFromFile accepts. mipLevels is laid out as for uploadImageMipLevels,
+    // level 0 being the largest. Only VK_FORMAT_R16G16B16A16_SFLOAT is supported, the one format the data format descriptor is built for.
+    // The file is replaced atomically, readers see either the previous one or the complete new one
+    bool writeKtx2ImageToFile(const char *ktx2FilePath, const VkFormat format, const VkExtent2D extent, const uint32_t faceCount, 
+                const void *pData, const std::vector<ImageMipLevelData> &mipLevels);
+
+    constexpr bool isBlockCompressedFormat(const VkFormat format)
+    {
+        return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK;
+    }
+}
\ No newline at end of file
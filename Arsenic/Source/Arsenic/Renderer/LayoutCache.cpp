@@ -0,0 +1,168 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/Hash.hpp"
+#include "Arsenic/Renderer/LayoutCache.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/BindlessTable.hpp"
+
+namespace arsenic
+{
+    bool DescriptorSetLayoutKey::operator==(const DescriptorSetLayoutKey &other) const
+    {
+        if (bindless != other.bindless || bindings.size() != other.bindings.size()) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i != bindings.size(); ++i) {
+            const VkDescriptorSetLayoutBinding &a = bindings[i];
+            const VkDescriptorSetLayoutBinding &b = other.bindings[i];
+
+            if (a.binding != b.binding || a.descriptorType != b.descriptorType || a.descriptorCount != b.descriptorCount || 
+                a.stageFlags != b.stageFlags || a.pImmutableSamplers != b.pImmutableSamplers) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool PipelineLayoutKey::operator==(const PipelineLayoutKey &other) const
+    {
+        return descriptorSetLayouts == other.descriptorSetLayouts && descriptorSetLayoutCount == other.descriptorSetLayoutCount &&
+            pushConstantSize == other.pushConstantSize;
+    }
+
+    std::size_t DescriptorSetLayoutKeyHash::operator()(const DescriptorSetLayoutKey &key) const
+    {
+        uint64_t hash = hashValue(key.bindless ? 1 : 0);
+
+        for (const VkDescriptorSetLayoutBinding &binding : key.bindings) {
+            hash = hashValue(binding.binding, hash);
+            hash = hashValue(binding.descriptorType, hash);
+            hash = hashValue(binding.descriptorCount, hash);
+            hash = hashValue(binding.stageFlags, hash);
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+
+    std::size_t PipelineLayoutKeyHash::operator()(const PipelineLayoutKey &key) const
+    {
+        uint64_t hash = fnv1aOffsetBasis;
+
+        for (uint32_t i = 0; i != key.descriptorSetLayoutCount; ++i) {
+            hash = hashValue(reinterpret_cast<uint64_t>(key.descriptorSetLayouts[i]), hash);
+        }
+
+        hash = hashValue(key.descriptorSetLayoutCount, hash);
+        hash = hashValue(key.pushConstantSize, hash);
+
+        return static_cast<std::size_t>(hash);
+    }
+
+    // Expects the cache to be locked
+    static VkDescriptorSetLayout getDescriptorSetLayoutLocked(const VulkanContext &vulkanContext, LayoutCache &layoutCache, DescriptorSetLayoutKey &&key)
+    {
+        if (const auto it = layoutCache.descriptorSetLayouts.find(key); it != layoutCache.descriptorSetLayouts.end()) {
+            return it->second;
+        }
+
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+
+        if (key.bindless) {
+            descriptorSetLayout = createBindlessDescriptorSetLayout(vulkanContext);
+        }
+        else {
+            VkDescriptorSetLayoutCreateInfo layoutCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+            layoutCI.bindingCount = static_cast<uint32_t>(key.bindings.size());
+            layoutCI.pBindings = key.bindings.data();
+
+            checkVkResult(vkCreateDescriptorSetLayout(vulkanContext.device, &layoutCI, getHostAllocationCallbacks(HostAllocationTag::Descriptor), &descriptorSetLayout));
+        }
+
+        layoutCache.descriptorSetLayouts.emplace(std::move(key), descriptorSetLayout);
+        return descriptorSetLayout;
+    }
+
+    VkDescriptorSetLayout getDescriptorSetLayout(const VulkanContext &vulkanContext, std::vector<VkDescriptorSetLayoutBinding> bindings, const bool bindless)
+    {
+        assert(vulkanContext.layoutCache);
+
+        DescriptorSetLayoutKey key = {};
+        key.bindless = bindless;
+
+        if (!bindless) {
+            std::sort(bindings.begin(), bindings.end(), [](const VkDescriptorSetLayoutBinding &a, const VkDescriptorSetLayoutBinding &b) {
+                return a.binding < b.binding;
+            });
+
+            key.bindings = std::move(bindings);
+        }
+
+        LayoutCache &layoutCache = *vulkanContext.layoutCache;
+        std::lock_guard<std::mutex> lock(layoutCache.mutex);
+
+        return getDescriptorSetLayoutLocked(vulkanContext, layoutCache, std::move(key));
+    }
+
+    VkPipelineLayout getPipelineLayout(const VulkanContext &vulkanContext, const std::array<VkDescriptorSetLayout, maxDescriptorSets> &descriptorSetLayouts,
+                                    const uint32_t pushConstantSize)
+    {
+        assert(vulkanContext.layoutCache);
+
+        LayoutCache &layoutCache = *vulkanContext.layoutCache;
+        std::lock_guard<std::mutex> lock(layoutCache.mutex);
+
+        PipelineLayoutKey key = {};
+
+        for (uint32_t i = 0; i != maxDescriptorSets; ++i) {
+            if (descriptorSetLayouts[i] != VK_NULL_HANDLE) {
+                key.descriptorSetLayoutCount = i + 1;
+            }
+        }
+
+        for (uint32_t i = 0; i != key.descriptorSetLayoutCount; ++i) {
+            key.descriptorSetLayouts[i] = descriptorSetLayouts[i] != VK_NULL_HANDLE ? descriptorSetLayouts[i] : 
+                                        getDescriptorSetLayoutLocked(vulkanContext, layoutCache, {});
+        }
+
+        key.pushConstantSize = pushConstantSize;
+
+        if (const auto it = layoutCache.pipelineLayouts.find(key); it != layoutCache.pipelineLayouts.end()) {
+            return it->second;
+        }
+
+        VkPushConstantRange pushConstantRange = {};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_ALL;
+        pushConstantRange.size = pushConstantSize;
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCI = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+        pipelineLayoutCI.setLayoutCount = key.descriptorSetLayoutCount;
+        pipelineLayoutCI.pSetLayouts = key.descriptorSetLayouts.data();
+        pipelineLayoutCI.pushConstantRangeCount = pushConstantSize != 0 ? 1 : 0;
+        pipelineLayoutCI.pPushConstantRanges = &pushConstantRange;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        checkVkResult(vkCreatePipelineLayout(vulkanContext.device, &pipelineLayoutCI, getHostAllocationCallbacks(HostAllocationTag::Pipeline), &pipelineLayout));
+
+        layoutCache.pipelineLayouts.emplace(key, pipelineLayout);
+        return pipelineLayout;
+    }
+
+    void destroyLayoutCache(const VulkanContext &vulkanContext, LayoutCache &layoutCache)
+    {
+        std::lock_guard<std::mutex> lock(layoutCache.mutex);
+
+        for (const auto &[key, pipelineLayout] : layoutCache.pipelineLayouts) {
+            vkDestroyPipelineLayout(vulkanContext.device, pipelineLayout, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+        }
+
+        for (const auto &[key, descriptorSetLayout] : layoutCache.descriptorSetLayouts) {
+            vkDestroyDescriptorSetLayout(vulkanContext.device, descriptorSetLayout, getHostAllocationCallbacks(HostAllocationTag::Descriptor));
+        }
+
+        layoutCache.pipelineLayouts.clear();
+        layoutCache.descriptorSetLayouts.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    constexpr uint32_t maxDescriptorSets = 4;
+
+    struct DescriptorSetLayoutKey
+    {
+        // Sorted by binding
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        bool bindless;
+
+        bool operator==(const DescriptorSetLayoutKey &other) const;
+    };
+
+    struct PipelineLayoutKey
+    {
+        std::array<VkDescriptorSetLayout, maxDescriptorSets> descriptorSetLayouts;
+        uint32_t descriptorSetLayoutCount;
+        uint32_t pushConstantSize;
+
+        bool operator==(const PipelineLayoutKey &other) const;
+    };
+
+    struct DescriptorSetLayoutKeyHash
+    {
+        std::size_t operator()(const DescriptorSetLayoutKey &key) const;
+    };
+
+    struct PipelineLayoutKeyHash
+    {
+        std::size_t operator()(const PipelineLayoutKey &key) const;
+    };
+
+    // Descriptor set layouts and pipeline layouts keyed by what they are created from, so effects with the same binding
+    // lists share one object and their sets stay compatible between pipelines. Shared by every thread building effects,
+    // the layouts are owned by the cache and live until destroyLayoutCache
+    struct LayoutCache
+    {
+        std::mutex mutex;
+        std::unordered_map<DescriptorSetLayoutKey, VkDescriptorSetLayout, DescriptorSetLayoutKeyHash> descriptorSetLayouts;
+        std::unordered_map<PipelineLayoutKey, VkPipelineLayout, PipelineLayoutKeyHash> pipelineLayouts;
+    };
+
+    // Bindings do not have to be sorted. A bindless layout is the one of createBindlessDescriptorSetLayout and ignores bindings
+    VkDescriptorSetLayout getDescriptorSetLayout(const VulkanContext &vulkanContext, std::vector<VkDescriptorSetLayoutBinding> bindings, 
+                                        const bool bindless = false);
+    // Sets missing in between the ones used are given an empty layout, as pipeline layouts can not have holes
+    VkPipelineLayout getPipelineLayout(const VulkanContext &vulkanContext, const std::array<VkDescriptorSetLayout, maxDescriptorSets> &descriptorSetLayouts,
+                                    const uint32_t pushConstantSize);
+
+    void destroyLayoutCache(const VulkanContext &vulkanContext, LayoutCache &layoutCache);
+}
\ No newline at end of file
@@ -2,15 +2,45 @@
 
 #include "Arsenic/Renderer/VulkanContext.hpp"
 #include "Arsenic/Renderer/MaterialManager.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
 
 namespace arsenic
 {
+    static bool isSameSampler(const VkSamplerCreateInfo &a, const VkSamplerCreateInfo &b)
+    {
+        return a.flags == b.flags && a.magFilter == b.magFilter && a.minFilter == b.minFilter && a.mipmapMode == b.mipmapMode &&
+            a.addressModeU == b.addressModeU && a.addressModeV == b.addressModeV && a.addressModeW == b.addressModeW &&
+            a.mipLodBias == b.mipLodBias && a.anisotropyEnable == b.anisotropyEnable && a.maxAnisotropy == b.maxAnisotropy &&
+            a.compareEnable == b.compareEnable && a.compareOp == b.compareOp && a.minLod == b.minLod && a.maxLod == b.maxLod &&
+            a.borderColor == b.borderColor && a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+    }
+
     void MaterialManager::initialize(const VulkanContext &renderContext)
     {
+        m_bindlessTable = createBindlessTable(renderContext);
+
+        VkSamplerCreateInfo samplerCI = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+        samplerCI.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerCI.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerCI.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerCI.minFilter = VK_FILTER_NEAREST;
+        samplerCI.magFilter = VK_FILTER_LINEAR;
+        samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerCI.maxLod = VK_LOD_CLAMP_NONE;
+
+        m_defaultSamplerIndex = getSamplerIndex(renderContext, samplerCI);
     }
 
     void MaterialManager::deInitialize(const VulkanContext &renderContext)
     {        
+        for (const VkSampler sampler : m_samplers) {
+            vkDestroySampler(renderContext.device, sampler, getHostAllocationCallbacks(HostAllocationTag::Resource));
+        }
+
+        destroyBindlessTable(renderContext, m_bindlessTable);
+        m_textureIndices.clear();
+        m_samplerCIs.clear();
+        m_samplers.clear();
     }
 
     Material MaterialManager::createMaterial(const float roughness, const float metalness, const math::vec3f baseColor, const math::vec3f emissiveColor)
@@ -25,7 +55,7 @@ namespace arsenic
         material.roughness = roughness;
         material.metalness = metalness;
         material.emissiveColor = math::vec4f(emissiveColor, 0.0f);
-        material.samplerIndex = 0;
+        material.samplerIndex = m_defaultSamplerIndex;
 
         return material;
     }
@@ -42,25 +72,81 @@ namespace arsenic
         material.roughness = 1.0f;
         material.metalness = 1.0f;
         material.emissiveColor = math::vec4f(0.0f);
-        material.samplerIndex = 0;
+        material.samplerIndex = m_defaultSamplerIndex;
 
         return material;
     }
 
-    VkSampler MaterialManager::createSampler(const VulkanContext &renderContext)
+    int32_t MaterialManager::registerTexture(const TextureHandle textureHandle, const VkImageView imageView)
     {
-        VkSamplerCreateInfo samplerCI = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
-        samplerCI.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        samplerCI.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        samplerCI.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        samplerCI.minFilter = VK_FILTER_NEAREST;
-        samplerCI.magFilter = VK_FILTER_LINEAR;
-        samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-        
+        assert(textureHandle != invalidHandle);
+
+        const auto it = m_textureIndices.find(textureHandle);
+        if (it != m_textureIndices.end()) {
+            return it->second;
+        }
+
+        if (m_textureIndices.size() == maxBindlessTextures) {
+            ARSENIC_ERROR("Renderer: Bindless texture table is full, texture {} is left without a map index", static_cast<uint32_t>(textureHandle));
+            return -1;
+        }
+
+        const int32_t textureIndex = static_cast<int32_t>(m_textureIndices.size());
+        m_textureIndices.emplace(textureHandle, textureIndex);
+        writeBindlessTexture(m_bindlessTable, static_cast<uint32_t>(textureIndex), imageView);
+
+        return textureIndex;
+    }
+
+    void MaterialManager::updateTexture(const TextureHandle textureHandle, const VkImageView imageView)
+    {
+        const int32_t textureIndex = getTextureIndex(textureHandle);
+
+        if (textureIndex >= 0) {
+            writeBindlessTexture(m_bindlessTable, static_cast<uint32_t>(textureIndex), imageView);
+        }
+    }
+
+    int32_t MaterialManager::getTextureIndex(const TextureHandle textureHandle) const
+    {
+        const auto it = m_textureIndices.find(textureHandle);
+        return it != m_textureIndices.end() ? it->second : -1;
+    }
+
+    int32_t MaterialManager::getSamplerIndex(const VulkanContext &renderContext, const VkSamplerCreateInfo &samplerCI)
+    {
+        assert(samplerCI.pNext == nullptr);
+
+        for (std::size_t i = 0; i != m_samplerCIs.size(); ++i) {
+            if (isSameSampler(m_samplerCIs[i], samplerCI)) {
+                return static_cast<int32_t>(i);
+            }
+        }
+
+        if (m_samplers.size() == maxBindlessSamplers) {
+            ARSENIC_ERROR("Renderer: Bindless sampler table is full, falling back to the default sampler");
+            return m_defaultSamplerIndex;
+        }
+
         VkSampler sampler = VK_NULL_HANDLE;
-        checkVkResult(vkCreateSampler(renderContext.device, &samplerCI, nullptr, &sampler));
+        checkVkResult(vkCreateSampler(renderContext.device, &samplerCI, getHostAllocationCallbacks(HostAllocationTag::Resource), &sampler));
+
+        const int32_t samplerIndex = static_cast<int32_t>(m_samplers.size());
+        m_samplerCIs.emplace_back(samplerCI);
+        m_samplers.emplace_back(sampler);
+        writeBindlessSampler(m_bindlessTable, static_cast<uint32_t>(samplerIndex), sampler);
 
-        return sampler;
+        return samplerIndex;
     }
 
+    VkSampler MaterialManager::getSampler(const int32_t samplerIndex) const
+    {
+        assert(samplerIndex >= 0 && static_cast<std::size_t>(samplerIndex) < m_samplers.size());
+        return m_samplers[samplerIndex];
+    }
+
+    void MaterialManager::flushDescriptorWrites(const VulkanContext &renderContext, const uint32_t frameIndex)
+    {
+        flushBindlessWrites(renderContext, m_bindlessTable, frameIndex);
+    }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Arsenic/Math/Math.hpp"
 #include "Arsenic/Renderer/Structure.hpp"
 #include "Arsenic/Renderer/Handle.hpp"
+#include "Arsenic/Renderer/BindlessTable.hpp"
 
 namespace arsenic
 {
@@ -10,6 +11,7 @@ namespace arsenic
     class TextureManager;
     class BufferManager;
 
+    // Turns TextureHandles and sampler descriptions into the indices Material carries, both refer to slots of a BindlessTable
     class MaterialManager
     {
     public:
@@ -27,7 +29,28 @@ namespace arsenic
         Material createMaterial(const float roughness, const float metalness, const math::vec3f baseColor, const math::vec3f emissiveColor = math::vec3f(0.0f));
         Material createMaterial();
 
-        VkSampler createSampler(const VulkanContext &renderContext);
+        // Gives textureHandle a bindless slot, registering the same handle again returns the slot it already has
+        int32_t registerTexture(const TextureHandle textureHandle, const VkImageView imageView);
+        // Points the slot of an already registered texture at another view, e.g. once a streamed texture is resident
+        void updateTexture(const TextureHandle textureHandle, const VkImageView imageView);
+        // -1 for textures that were never registered, which is also what Material treats as no map
+        int32_t getTextureIndex(const TextureHandle textureHandle) const;
+
+        // Samplers are deduplicated by their create info and owned by the manager
+        int32_t getSamplerIndex(const VulkanContext &renderContext, const VkSamplerCreateInfo &samplerCI);
+        VkSampler getSampler(const int32_t samplerIndex) const;
+
+        // The repeating linear sampler every material starts out with
+        VkSampler getDefaultSampler() const { return getSampler(m_defaultSamplerIndex); }
+
+        // Call once the GPU is done with frameIndex, before binding getDescriptorSet(frameIndex) at bindlessDescriptorSet
+        void flushDescriptorWrites(const VulkanContext &renderContext, const uint32_t frameIndex);
+        VkDescriptorSet getDescriptorSet(const uint32_t frameIndex) const { return m_bindlessTable.descriptorSets.value[frameIndex]; }
     private:
+        BindlessTable m_bindlessTable = {};
+        std::unordered_map<TextureHandle, int32_t> m_textureIndices;
+        std::vector<VkSamplerCreateInfo> m_samplerCIs;
+        std::vector<VkSampler> m_samplers;
+        int32_t m_defaultSamplerIndex = 0;
     };
 }
\ No newline at end of file
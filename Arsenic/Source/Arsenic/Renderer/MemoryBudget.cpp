@@ -0,0 +1,29 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/MemoryBudget.hpp"
+
+namespace arsenic
+{
+    std::vector<MemoryHeapBudget> queryMemoryBudget(const VulkanContext &vulkanContext)
+    {
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = vulkanContext.physicalDevice.memoryProperties;
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> vmaBudgets = {};
+        vmaGetBudget(vulkanContext.vmaAllocator, vmaBudgets.data());
+
+        std::vector<MemoryHeapBudget> memoryHeapBudgets(memoryProperties.memoryHeapCount);
+
+        for (uint32_t i = 0; i != memoryProperties.memoryHeapCount; ++i) {
+            MemoryHeapBudget &memoryHeapBudget = memoryHeapBudgets[i];
+            memoryHeapBudget.heapSize = memoryProperties.memoryHeaps[i].size;
+            memoryHeapBudget.heapFlags = memoryProperties.memoryHeaps[i].flags;
+            memoryHeapBudget.blockBytes = vmaBudgets[i].blockBytes;
+            memoryHeapBudget.allocationBytes = vmaBudgets[i].allocationBytes;
+            memoryHeapBudget.usage = vmaBudgets[i].usage;
+            memoryHeapBudget.budget = vmaBudgets[i].budget;
+        }
+
+        return memoryHeapBudgets;
+    }
+}
\ No newline at end of file
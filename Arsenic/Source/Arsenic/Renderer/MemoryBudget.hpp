@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    struct MemoryHeapBudget
+    {
+        VkDeviceSize heapSize = 0;
+        VkMemoryHeapFlags heapFlags = 0;
+        // Bytes of VkDeviceMemory blocks VMA owns in this heap and bytes actually handed out from them
+        VkDeviceSize blockBytes = 0;
+        VkDeviceSize allocationBytes = 0;
+        // Process wide usage and budget, only reported by the driver when VK_EXT_memory_budget is enabled,
+        // otherwise VMA estimates them from its own blocks and 80% of the heap size
+        VkDeviceSize usage = 0;
+        VkDeviceSize budget = 0;
+    };
+
+    // One entry per memory heap, indexed like VkPhysicalDeviceMemoryProperties::memoryHeaps
+    std::vector<MemoryHeapBudget> queryMemoryBudget(const VulkanContext &vulkanContext);
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/MipDownsampler.hpp"
+
+namespace arsenic
+{
+    // Every workgroup of spdDownsample.comp reduces a 64x64 tile of mip 0
+    static constexpr uint32_t downsampleTileSize = 64;
+
+    // Matches the push constant block in spdDownsample.comp
+    struct DownsamplePushConstant
+    {
+        VkDeviceAddress counters;
+        uint32_t sourceExtent[2];
+        uint32_t mipLevelCount;
+        uint32_t workGroupCount;
+        uint32_t srgb;
+    };
+
+    MipDownsampler createMipDownsampler(VulkanContext &vulkanContext, const char *spdSpvFilePath)
+    {
+        assert(vulkanContext.storageImageWithoutFormatEnabled);
+
+        MipDownsampler mipDownsampler = {};
+        mipDownsampler.shaderEffect = buildComputeShaderEffect(vulkanContext, spdSpvFilePath);
+        mipDownsampler.shaderPass = buildComputeShaderPass(vulkanContext, &mipDownsampler.shaderEffect);
+
+        VkSamplerCreateInfo samplerCI = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+        samplerCI.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCI.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCI.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCI.minFilter = VK_FILTER_LINEAR;
+        samplerCI.magFilter = VK_FILTER_LINEAR;
+        samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        checkVkResult(vkCreateSampler(vulkanContext.device, &samplerCI, getHostAllocationCallbacks(HostAllocationTag::Resource), &mipDownsampler.sampler));
+
+        std::array<VkDescriptorPoolSize, 2> poolSizes = {
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxMipDownsampleTargets},
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxMipDownsampleTargets * maxDownsampleMipLevels}
+        };
+
+        VkDescriptorPoolCreateInfo descriptorPoolCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+        descriptorPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        descriptorPoolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        descriptorPoolCI.pPoolSizes = poolSizes.data();
+        descriptorPoolCI.maxSets = maxMipDownsampleTargets;
+        checkVkResult(vkCreateDescriptorPool(vulkanContext.device, &descriptorPoolCI, getHostAllocationCallbacks(HostAllocationTag::Descriptor), 
+                        &mipDownsampler.descriptorPool));
+
+        mipDownsampler.counterBuffer = createBuffer(vulkanContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                                            VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 
+                                            maxDownsampleArrayLayers * sizeof(uint32_t));
+
+        return mipDownsampler;
+    }
+
+    void destroyMipDownsampler(const VulkanContext &vulkanContext, MipDownsampler &mipDownsampler)
+    {
+        destroyBuffer(vulkanContext, mipDownsampler.counterBuffer);
+        vkDestroyDescriptorPool(vulkanContext.device, mipDownsampler.descriptorPool, getHostAllocationCallbacks(HostAllocationTag::Descriptor));
+        vkDestroySampler(vulkanContext.device, mipDownsampler.sampler, getHostAllocationCallbacks(HostAllocationTag::Resource));
+
+        vkDestroyPipeline(vulkanContext.device, mipDownsampler.shaderPass.pipeline, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+        destroyShaderEffect(vulkanContext, mipDownsampler.shaderEffect);
+
+        mipDownsampler = {};
+    }
+
+    MipDownsampleTarget createMipDownsampleTarget(const VulkanContext &vulkanContext, const MipDownsampler &mipDownsampler, 
+                            const VulkanImage &vulkanImage)
+    {
+        assert(vulkanImage.usage & VK_IMAGE_USAGE_SAMPLED_BIT);
+        assert(vulkanImage.usage & VK_IMAGE_USAGE_STORAGE_BIT);
+        assert(vulkanImage.mipLevels > 1 && std::max(vulkanImage.extent.width, vulkanImage.extent.height) <= maxDownsampleExtent);
+        assert(vulkanImage.arrayLayers <= maxDownsampleArrayLayers);
+
+        MipDownsampleTarget mipDownsampleTarget = {};
+        mipDownsampleTarget.mipViewCount = vulkanImage.mipLevels - 1;
+        mipDownsampleTarget.sourceView = createImageView(vulkanContext, vulkanImage.vkImage, VK_IMAGE_VIEW_TYPE_2D_ARRAY, vulkanImage.format, 
+                                            VK_IMAGE_ASPECT_COLOR_BIT, 0, vulkanImage.arrayLayers, 0, 1, VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        const VkFormat storageFormat = getStorageViewFormat(vulkanImage.format);
+
+        for (uint32_t i = 0; i != mipDownsampleTarget.mipViewCount; ++i) {
+            mipDownsampleTarget.mipViews[i] = createImageView(vulkanContext, vulkanImage.vkImage, VK_IMAGE_VIEW_TYPE_2D_ARRAY, storageFormat, 
+                                                VK_IMAGE_ASPECT_COLOR_BIT, 0, vulkanImage.arrayLayers, i + 1, 1, VK_IMAGE_USAGE_STORAGE_BIT);
+        }
+
+        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        descriptorSetAllocateInfo.descriptorPool = mipDownsampler.descriptorPool;
+        descriptorSetAllocateInfo.descriptorSetCount = 1;
+        descriptorSetAllocateInfo.pSetLayouts = &mipDownsampler.shaderEffect.descriptorSetLayouts[0];
+        checkVkResult(vkAllocateDescriptorSets(vulkanContext.device, &descriptorSetAllocateInfo, &mipDownsampleTarget.descriptorSet));
+
+        VkDescriptorImageInfo sourceImageInfo = {};
+        sourceImageInfo.sampler = mipDownsampler.sampler;
+        sourceImageInfo.imageView = mipDownsampleTarget.sourceView;
+        sourceImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        // The shader indexes the array dynamically, so levels the image does not have repeat its last one and are never touched
+        std::array<VkDescriptorImageInfo, maxDownsampleMipLevels> mipImageInfos = {};
+        for (uint32_t i = 0; i != maxDownsampleMipLevels; ++i) {
+            mipImageInfos[i].imageView = mipDownsampleTarget.mipViews[std::min(i, mipDownsampleTarget.mipViewCount - 1)];
+            mipImageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+
+        std::array<VkWriteDescriptorSet, 2> writeDescriptors = {};
+        writeDescriptors[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptors[0].dstSet = mipDownsampleTarget.descriptorSet;
+        writeDescriptors[0].dstBinding = 0;
+        writeDescriptors[0].descriptorCount = 1;
+        writeDescriptors[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writeDescriptors[0].pImageInfo = &sourceImageInfo;
+
+        writeDescriptors[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptors[1].dstSet = mipDownsampleTarget.descriptorSet;
+        writeDescriptors[1].dstBinding = 1;
+        writeDescriptors[1].descriptorCount = maxDownsampleMipLevels;
+        writeDescriptors[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writeDescriptors[1].pImageInfo = mipImageInfos.data();
+
+        vkUpdateDescriptorSets(vulkanContext.device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr);
+
+        return mipDownsampleTarget;
+    }
+
+    void destroyMipDownsampleTarget(const VulkanContext &vulkanContext, const MipDownsampler &mipDownsampler, 
+                            MipDownsampleTarget &mipDownsampleTarget)
+    {
+        checkVkResult(vkFreeDescriptorSets(vulkanContext.device, mipDownsampler.descriptorPool, 1, &mipDownsampleTarget.descriptorSet));
+
+        for (uint32_t i = 0; i != mipDownsampleTarget.mipViewCount; ++i) {
+            vkDestroyImageView(vulkanContext.device, mipDownsampleTarget.mipViews[i], getHostAllocationCallbacks(HostAllocationTag::Resource));
+        }
+
+        vkDestroyImageView(vulkanContext.device, mipDownsampleTarget.sourceView, getHostAllocationCallbacks(HostAllocationTag::Resource));
+        mipDownsampleTarget = {};
+    }
+
+    void cmdDownsampleMipLevels(const VkCommandBuffer commandBuffer, const MipDownsampler &mipDownsampler, 
+                            const MipDownsampleTarget &mipDownsampleTarget, const VulkanImage &vulkanImage)
+    {
+        // Earlier dispatches may still use the counters, and the levels being written may still be read by earlier work
+        VkMemoryBarrier counterBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        counterBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        counterBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+        imageMemoryBarrier.image = vulkanImage.vkImage;
+        imageMemoryBarrier.srcAccessMask = 0;
+        imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+        imageMemoryBarrier.subresourceRange.layerCount = vulkanImage.arrayLayers;
+        imageMemoryBarrier.subresourceRange.baseMipLevel = 1;
+        imageMemoryBarrier.subresourceRange.levelCount = mipDownsampleTarget.mipViewCount;
+        imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        0, 1, &counterBarrier, 0, nullptr, 1, &imageMemoryBarrier);
+
+        vkCmdFillBuffer(commandBuffer, mipDownsampler.counterBuffer.vkBuffer, 0, vulkanImage.arrayLayers * sizeof(uint32_t), 0);
+
+        counterBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        counterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &counterBarrier, 0, nullptr, 0, nullptr);
+
+        const uint32_t workGroupCountX = (vulkanImage.extent.width + downsampleTileSize - 1) / downsampleTileSize;
+        const uint32_t workGroupCountY = (vulkanImage.extent.height + downsampleTileSize - 1) / downsampleTileSize;
+
+        DownsamplePushConstant pushConstant = {};
+        pushConstant.counters = mipDownsampler.counterBuffer.deviceAddress;
+        pushConstant.sourceExtent[0] = vulkanImage.extent.width;
+        pushConstant.sourceExtent[1] = vulkanImage.extent.height;
+        pushConstant.mipLevelCount = mipDownsampleTarget.mipViewCount;
+        pushConstant.workGroupCount = workGroupCountX * workGroupCountY;
+        pushConstant.srgb = getStorageViewFormat(vulkanImage.format) != vulkanImage.format ? 1 : 0;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mipDownsampler.shaderPass.pipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mipDownsampler.shaderEffect.pipelineLayout, 0, 1, 
+                        &mipDownsampleTarget.descriptorSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, mipDownsampler.shaderEffect.pipelineLayout, VK_SHADER_STAGE_ALL, 0, sizeof(pushConstant), &pushConstant);
+        vkCmdDispatch(commandBuffer, workGroupCountX, workGroupCountY, vulkanImage.arrayLayers);
+
+        imageMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 
+                        0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/VulkanImage.hpp"
+#include "Arsenic/Renderer/Shader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    // Matches maxMipLevels in spdDownsample.comp, mip 0 plus 12 levels covers a 4096 wide image
+    constexpr uint32_t maxDownsampleMipLevels = 12;
+    // The last workgroup folds a single 64x64 block of mip 6, so wider images would leave the rest of the tail undefined even when
+    // their mip count fits. Larger images have to generate their mips with cmdGenerateMipLevels
+    constexpr uint32_t maxDownsampleExtent = 4096;
+    constexpr uint32_t maxDownsampleArrayLayers = 64;
+    constexpr uint32_t maxMipDownsampleTargets = 64;
+
+    // Generates a whole mip chain with a single compute dispatch instead of one blit and two barriers per level
+    struct MipDownsampler
+    {
+        ShaderEffect shaderEffect;
+        ShaderPass shaderPass;
+        VkSampler sampler = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        // One workgroup counter per array layer, zeroed before every dispatch
+        VulkanBuffer counterBuffer;
+    };
+
+    // Views and descriptors of one image, images downsampled every frame keep theirs around
+    struct MipDownsampleTarget
+    {
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkImageView sourceView = VK_NULL_HANDLE;
+        std::array<VkImageView, maxDownsampleMipLevels> mipViews = {};
+        uint32_t mipViewCount = 0;
+    };
+
+    MipDownsampler createMipDownsampler(VulkanContext &vulkanContext, const char *spdSpvFilePath);
+    void destroyMipDownsampler(const VulkanContext &vulkanContext, MipDownsampler &mipDownsampler);
+
+    // vulkanImage needs VK_IMAGE_USAGE_SAMPLED_BIT and VK_IMAGE_USAGE_STORAGE_BIT, and at most maxDownsampleExtent texels on either side
+    MipDownsampleTarget createMipDownsampleTarget(const VulkanContext &vulkanContext, const MipDownsampler &mipDownsampler, 
+                            const VulkanImage &vulkanImage);
+    void destroyMipDownsampleTarget(const VulkanContext &vulkanContext, const MipDownsampler &mipDownsampler, 
+                            MipDownsampleTarget &mipDownsampleTarget);
+
+    // Mip 0 has to be in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, whatever the other levels hold is discarded.
+    // Every level is in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL afterwards
+    void cmdDownsampleMipLevels(const VkCommandBuffer commandBuffer, const MipDownsampler &mipDownsampler, 
+                            const MipDownsampleTarget &mipDownsampleTarget, const VulkanImage &vulkanImage);
+}
\ No newline at end of file
@@ -91,12 +91,34 @@ namespace arsenic
 		return score;
 	}
 
+	static bool checkPhysicalDeviceFeatureSupport(VkPhysicalDevice physicalDevice)
+	{
+		VkPhysicalDeviceProperties props = {};
+		vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+		if (props.apiVersion < VK_API_VERSION_1_2) {
+			return false;
+		}
+
+		VkPhysicalDeviceVulkan12Features vulkan12Features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+		VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+		features2.pNext = &vulkan12Features;
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+		// Materials index the bindless tables with per-hit indices, and slots are only written once they are used
+		const bool bindlessSupported = vulkan12Features.shaderSampledImageArrayNonUniformIndexing && vulkan12Features.descriptorBindingPartiallyBound &&
+				vulkan12Features.descriptorBindingSampledImageUpdateAfterBind;
+
+		return vulkan12Features.timelineSemaphore && vulkan12Features.bufferDeviceAddress && bindlessSupported;
+	}
+
 	static bool isDeviceSuitable(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, const char* const* ppPhysicalDeviceExtensions, const std::size_t physicalDeviceExtensionCount)
 	{
 		const bool extensionSupported = checkPhysicalDeviceExtensionSupport(physicalDevice, ppPhysicalDeviceExtensions, physicalDeviceExtensionCount);
+		const bool featureSupported = checkPhysicalDeviceFeatureSupport(physicalDevice);
 		const QueueFamilies queueFamiles = findQueueFamilies(physicalDevice, surface);
 
-		return extensionSupported && queueFamiles.isComplete();
+		return extensionSupported && featureSupported && queueFamiles.isComplete();
 	}
 	
 	PhysicalDevice PhysicalDevice::chooseOptimalPhysicalDevice(const Instance& vulkanInstance, VkSurfaceKHR surfaceVk,
@@ -125,7 +147,12 @@ namespace arsenic
 			selectedPhysicalDevice.queueFamilies = findQueueFamilies(selectedPhysicalDevice.vkPhysicalDevice, surfaceVk);
 			
 			vkGetPhysicalDeviceProperties(selectedPhysicalDevice.vkPhysicalDevice, &selectedPhysicalDevice.deviceProperties);
-			vkGetPhysicalDeviceFeatures(selectedPhysicalDevice.vkPhysicalDevice, &selectedPhysicalDevice.deviceFeatures);
+
+			VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+			features2.pNext = &selectedPhysicalDevice.vulkan12Features;
+			vkGetPhysicalDeviceFeatures2(selectedPhysicalDevice.vkPhysicalDevice, &features2);
+			selectedPhysicalDevice.deviceFeatures = features2.features;
+
 			vkGetPhysicalDeviceMemoryProperties(selectedPhysicalDevice.vkPhysicalDevice, &selectedPhysicalDevice.memoryProperties);
 		
 			return selectedPhysicalDevice;
@@ -23,7 +23,7 @@ namespace arsenic
         VkPhysicalDeviceMemoryProperties memoryProperties = {};
         VkPhysicalDeviceProperties deviceProperties = {};
         VkPhysicalDeviceFeatures deviceFeatures = {};
-        
+        VkPhysicalDeviceVulkan12Features vulkan12Features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
 
         static PhysicalDevice chooseOptimalPhysicalDevice(const Instance &vulkanInstance, VkSurfaceKHR surface,
                                             const char *const* ppPhysicalDeviceExtensions, const std::size_t physicalDeviceExtensionCount);
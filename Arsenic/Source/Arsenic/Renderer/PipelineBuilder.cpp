@@ -0,0 +1,87 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/ThreadPool.hpp"
+#include "Arsenic/Renderer/PipelineBuilder.hpp"
+#include "Arsenic/Renderer/ShaderBundle.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+
+namespace arsenic
+{
+    PipelineBuilder::PipelineBuilder() = default;
+    PipelineBuilder::~PipelineBuilder() = default;
+
+    void PipelineBuilder::initialize(const VulkanContext &vulkanContext, const uint32_t workerCount)
+    {
+        assert(!m_threadPool);
+
+        m_threadPool = std::make_unique<ThreadPool>(workerCount);
+        m_pVulkanContext = &vulkanContext;
+    }
+
+    void PipelineBuilder::deInitialize()
+    {
+        m_threadPool.reset();
+
+        // Effects whose build was dropped are still zeroed
+        for (const std::unique_ptr<ShaderEffect> &shaderEffect : m_shaderEffects) {
+            destroyShaderEffect(*m_pVulkanContext, *shaderEffect);
+        }
+
+        m_pVulkanContext = nullptr;
+        m_shaderEffects.clear();
+    }
+
+    std::future<ShaderPass> PipelineBuilder::buildComputeShaderPass(const std::string &compSpvFilePath)
+    {
+        assert(m_threadPool);
+
+        ShaderEffect *pShaderEffect = m_shaderEffects.emplace_back(std::make_unique<ShaderEffect>()).get();
+
+        return m_threadPool->submit([pVulkanContext = m_pVulkanContext, pShaderEffect, compSpvFilePath]() {
+            *pShaderEffect = buildComputeShaderEffect(*pVulkanContext, compSpvFilePath.c_str());
+            return arsenic::buildComputeShaderPass(*pVulkanContext, pShaderEffect);
+        });
+    }
+
+    std::future<ShaderPass> PipelineBuilder::buildGraphicsShaderPass(const std::string &psoJsonFilePath, const VkRenderPass renderpass, 
+                                                            const uint32_t subpassIndex)
+    {
+        assert(m_threadPool);
+
+        ShaderEffect *pShaderEffect = m_shaderEffects.emplace_back(std::make_unique<ShaderEffect>()).get();
+
+        return m_threadPool->submit([pVulkanContext = m_pVulkanContext, pShaderEffect, psoJsonFilePath, renderpass, subpassIndex]() {
+            *pShaderEffect = buildGraphicsShaderEffect(*pVulkanContext, psoJsonFilePath.c_str());
+            return arsenic::buildGraphicsShaderPass(*pVulkanContext, renderpass, subpassIndex, pShaderEffect);
+        });
+    }
+
+    std::future<ShaderPass> PipelineBuilder::buildShaderPassFromBundle(const std::string &bundleFilePath, const std::string &sourceFilePath, 
+                                                                const VkRenderPass renderpass, const uint32_t subpassIndex)
+    {
+        assert(m_threadPool);
+
+        ShaderEffect *pShaderEffect = m_shaderEffects.emplace_back(std::make_unique<ShaderEffect>()).get();
+
+        return m_threadPool->submit([pVulkanContext = m_pVulkanContext, pShaderEffect, bundleFilePath, sourceFilePath, renderpass, subpassIndex]() {
+            const bool isCompute = renderpass == VK_NULL_HANDLE;
+
+            // A bundle of the other kind is as unusable as a broken one
+            if (!loadShaderEffectBundle(*pVulkanContext, bundleFilePath.c_str(), *pShaderEffect) || 
+                isCompute != (pShaderEffect->shaderStages[0].stage == VK_SHADER_STAGE_COMPUTE_BIT)) {
+                destroyShaderEffect(*pVulkanContext, *pShaderEffect);
+                *pShaderEffect = isCompute ? buildComputeShaderEffect(*pVulkanContext, sourceFilePath.c_str()) : 
+                                            buildGraphicsShaderEffect(*pVulkanContext, sourceFilePath.c_str());
+            }
+
+            return isCompute ? arsenic::buildComputeShaderPass(*pVulkanContext, pShaderEffect) : 
+                            arsenic::buildGraphicsShaderPass(*pVulkanContext, renderpass, subpassIndex, pShaderEffect);
+        });
+    }
+
+    void PipelineBuilder::waitIdle()
+    {
+        assert(m_threadPool);
+        m_threadPool->waitIdle();
+    }
+}
\ No newline at end of file
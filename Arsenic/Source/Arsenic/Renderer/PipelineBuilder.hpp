@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/Shader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    class ThreadPool;
+
+    // Builds ShaderEffects and their pipelines on a worker pool. Reading the files, parsing the PSO, reflecting and compiling
+    // all happen on the workers, so builds run concurrently with each other and with whatever the calling thread does.
+    // The effects are owned by the builder and live until deInitialize, a pass is usable once its future is ready
+    class PipelineBuilder
+    {
+    public:
+        PipelineBuilder();
+        ~PipelineBuilder();
+
+        PipelineBuilder(const PipelineBuilder &) = delete;
+        PipelineBuilder &operator=(const PipelineBuilder &) = delete;
+        PipelineBuilder(PipelineBuilder &&) = delete;
+        PipelineBuilder &operator=(PipelineBuilder &&) = delete;
+
+        // vulkanContext has to outlive the builder. workerCount of 0 uses one worker per hardware thread but the main one
+        void initialize(const VulkanContext &vulkanContext, const uint32_t workerCount = 0);
+        // Builds that have not started yet are dropped and their futures left broken, the ones running are finished first
+        void deInitialize();
+
+        std::future<ShaderPass> buildComputeShaderPass(const std::string &compSpvFilePath);
+        // renderpass has to stay alive until the future is ready
+        std::future<ShaderPass> buildGraphicsShaderPass(const std::string &psoJsonFilePath, const VkRenderPass renderpass, const uint32_t subpassIndex);
+        // Loads the bundle cooked by ArsenicCooker --shader-bundle and builds from sourceFilePath instead when it is missing or invalid.
+        // A renderpass of VK_NULL_HANDLE makes it a compute pass with sourceFilePath the compute .spv, otherwise sourceFilePath is the PSO json
+        std::future<ShaderPass> buildShaderPassFromBundle(const std::string &bundleFilePath, const std::string &sourceFilePath, 
+                                                    const VkRenderPass renderpass = VK_NULL_HANDLE, const uint32_t subpassIndex = 0);
+
+        // Blocks until every build submitted so far has finished, running queued ones on the calling thread meanwhile
+        void waitIdle();
+    private:
+        std::unique_ptr<ThreadPool> m_threadPool;
+        const VulkanContext *m_pVulkanContext = nullptr;
+        // Each effect is written by the worker building it only, the pointers handed out stay valid as more are added
+        std::vector<std::unique_ptr<ShaderEffect>> m_shaderEffects;
+    };
+
+    // Never blocks, false for futures that are not valid
+    inline bool isShaderPassReady(const std::future<ShaderPass> &shaderPassFuture)
+    {
+        return shaderPassFuture.valid() && shaderPassFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Core/Hash.hpp"
+#include "Arsenic/Renderer/PipelineCache.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+
+namespace arsenic
+{
+    static PipelineCacheFileHeader createFileHeader(const VkPhysicalDeviceProperties &deviceProperties)
+    {
+        PipelineCacheFileHeader header = {};
+        header.magic = pipelineCacheMagic;
+        header.version = pipelineCacheVersion;
+        header.vendorID = deviceProperties.vendorID;
+        header.deviceID = deviceProperties.deviceID;
+        header.driverVersion = deviceProperties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        return header;
+    }
+
+    VkPipelineCache createPipelineCache(const VulkanContext &vulkanContext, const char *cacheFilePath)
+    {
+        const VkPhysicalDeviceProperties &deviceProperties = vulkanContext.physicalDevice.deviceProperties;
+        const FileView cacheFile = readFile(cacheFilePath);
+
+        VkPipelineCacheCreateInfo pipelineCacheCI = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+
+        if (cacheFile.isValid() && cacheFile.size >= sizeof(PipelineCacheFileHeader)) {
+            PipelineCacheFileHeader header = {};
+            std::memcpy(&header, cacheFile.pData, sizeof(header));
+
+            const PipelineCacheFileHeader expectedHeader = createFileHeader(deviceProperties);
+            const uint8_t *pCacheData = cacheFile.pData + sizeof(header);
+
+            if (header.magic != expectedHeader.magic || header.version != expectedHeader.version || header.vendorID != expectedHeader.vendorID ||
+                header.deviceID != expectedHeader.deviceID || header.driverVersion != expectedHeader.driverVersion ||
+                std::memcmp(header.pipelineCacheUUID, expectedHeader.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+                ARSENIC_INFO("Renderer: {} was written by another device or driver, pipelines are compiled from scratch", cacheFilePath);
+            }
+            else if (header.dataSize != cacheFile.size - sizeof(header) || header.dataHash != hashBytes(pCacheData, header.dataSize)) {
+                ARSENIC_WARN("Renderer: {} is corrupted, pipelines are compiled from scratch", cacheFilePath);
+            }
+            else {
+                pipelineCacheCI.initialDataSize = static_cast<std::size_t>(header.dataSize);
+                pipelineCacheCI.pInitialData = pCacheData;
+            }
+        }
+
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+        checkVkResult(vkCreatePipelineCache(vulkanContext.device, &pipelineCacheCI, getHostAllocationCallbacks(HostAllocationTag::Pipeline), 
+                                        &pipelineCache));
+
+        return pipelineCache;
+    }
+
+    bool savePipelineCache(const VulkanContext &vulkanContext, const VkPipelineCache pipelineCache, const char *cacheFilePath)
+    {
+        std::size_t dataSize = 0;
+        checkVkResult(vkGetPipelineCacheData(vulkanContext.device, pipelineCache, &dataSize, nullptr));
+
+        std::vector<uint8_t> fileData(sizeof(PipelineCacheFileHeader) + dataSize);
+        checkVkResult(vkGetPipelineCacheData(vulkanContext.device, pipelineCache, &dataSize, fileData.data() + sizeof(PipelineCacheFileHeader)));
+        fileData.resize(sizeof(PipelineCacheFileHeader) + dataSize);
+
+        PipelineCacheFileHeader header = createFileHeader(vulkanContext.physicalDevice.deviceProperties);
+        header.dataSize = dataSize;
+        header.dataHash = hashBytes(fileData.data() + sizeof(header), dataSize);
+        std::memcpy(fileData.data(), &header, sizeof(header));
+
+        const std::filesystem::path cachePath(cacheFilePath);
+        const std::filesystem::path tempPath = cachePath.string() + ".tmp";
+
+        std::error_code errorCode;
+        if (cachePath.has_parent_path()) {
+            std::filesystem::create_directories(cachePath.parent_path(), errorCode);
+        }
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char *>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+            file.close();
+
+            if (!file.good()) {
+                std::filesystem::remove(tempPath, errorCode);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, cachePath, errorCode);
+        if (errorCode) {
+            std::filesystem::remove(tempPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    // Prefixed to the data vkGetPipelineCacheData returns. The driver validates its own header too, but not the driver version,
+    // and a cache written by another driver build is best thrown away before the driver ever sees it
+    constexpr uint32_t pipelineCacheMagic = 0x43504141;
+    constexpr uint32_t pipelineCacheVersion = 1;
+
+    struct PipelineCacheFileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint32_t reserved;
+        uint64_t dataSize;
+        // FNV-1a of the cache data, catches a file truncated or corrupted behind the driver's back
+        uint64_t dataHash;
+    };
+
+    // Seeds the cache with cacheFilePath when it was written on the same device and driver, otherwise the cache starts empty
+    VkPipelineCache createPipelineCache(const VulkanContext &vulkanContext, const char *cacheFilePath);
+
+    // Writes to a temporary file first and renames it over cacheFilePath, so a crash while saving never leaves a torn cache behind
+    bool savePipelineCache(const VulkanContext &vulkanContext, const VkPipelineCache pipelineCache, const char *cacheFilePath);
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/FrameAllocator.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/ScatterUpload.hpp"
+
+namespace arsenic
+{
+    // Matches local_size_x in scatterUpload.comp
+    static constexpr uint32_t scatterGroupSize = 64;
+
+    // Matches the push constant block in scatterUpload.comp
+    struct ScatterPushConstant
+    {
+        VkDeviceAddress records;
+        VkDeviceAddress destination;
+        uint32_t recordCount;
+        uint32_t elementWordCount;
+    };
+
+    ScatterUploader createScatterUploader(const VulkanContext &vulkanContext, const char *scatterSpvFilePath)
+    {
+        ScatterUploader scatterUploader = {};
+        scatterUploader.shaderEffect = buildComputeShaderEffect(vulkanContext, scatterSpvFilePath);
+        scatterUploader.shaderPass = buildComputeShaderPass(vulkanContext, &scatterUploader.shaderEffect);
+
+        return scatterUploader;
+    }
+
+    void destroyScatterUploader(const VulkanContext &vulkanContext, ScatterUploader &scatterUploader)
+    {
+        vkDestroyPipeline(vulkanContext.device, scatterUploader.shaderPass.pipeline, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+        destroyShaderEffect(vulkanContext, scatterUploader.shaderEffect);
+
+        scatterUploader = {};
+    }
+
+    ScatterBuffer createScatterBuffer(VulkanContext &vulkanContext, const uint32_t elementSize, const uint32_t capacity)
+    {
+        assert(elementSize != 0 && elementSize % sizeof(uint32_t) == 0);
+        assert(capacity != 0);
+
+        ScatterBuffer scatterBuffer = {};
+        scatterBuffer.elementSize = elementSize;
+        scatterBuffer.capacity = capacity;
+        scatterBuffer.buffer = createBuffer(vulkanContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, static_cast<VkDeviceSize>(elementSize) * capacity);
+        scatterBuffer.shadow.resize(static_cast<std::size_t>(elementSize) * capacity);
+        scatterBuffer.shadowValid.resize(capacity, false);
+
+        return scatterBuffer;
+    }
+
+    void destroyScatterBuffer(const VulkanContext &vulkanContext, ScatterBuffer &scatterBuffer)
+    {
+        destroyBuffer(vulkanContext, scatterBuffer.buffer);
+        scatterBuffer = {};
+    }
+
+    void invalidateScatterBuffer(ScatterBuffer &scatterBuffer)
+    {
+        std::fill(scatterBuffer.shadowValid.begin(), scatterBuffer.shadowValid.end(), false);
+    }
+
+    bool packScatterRecords(FrameAllocator &frameAllocator, ScatterBuffer &scatterBuffer, const void *pElements, const uint32_t elementCount)
+    {
+        assert(elementCount <= scatterBuffer.capacity);
+
+        const uint32_t elementSize = scatterBuffer.elementSize;
+        const uint8_t *pSource = static_cast<const uint8_t *>(pElements);
+
+        std::vector<uint32_t> changedIndices;
+
+        for (uint32_t i = 0; i != elementCount; ++i) {
+            const uint8_t *pShadow = scatterBuffer.shadow.data() + static_cast<std::size_t>(i) * elementSize;
+            const uint8_t *pElement = pSource + static_cast<std::size_t>(i) * elementSize;
+
+            if (!scatterBuffer.shadowValid[i] || std::memcmp(pShadow, pElement, elementSize) != 0) {
+                changedIndices.push_back(i);
+            }
+        }
+
+        scatterBuffer.pendingRecordCount = 0;
+        scatterBuffer.pendingRecords = 0;
+
+        if (changedIndices.empty()) {
+            return true;
+        }
+
+        // Every record is the element index followed by the element, both as 32 bit words
+        const std::size_t recordSize = sizeof(uint32_t) + elementSize;
+        const FrameAllocation frameAllocation = frameAllocate(frameAllocator, recordSize * changedIndices.size());
+
+        // The shadow is only updated once the records have a place, so the changes are found again next time
+        if (!frameAllocation.isValid()) {
+            return false;
+        }
+
+        uint8_t *pRecord = frameAllocation.pMappedPointer;
+
+        for (const uint32_t index : changedIndices) {
+            const uint8_t *pElement = pSource + static_cast<std::size_t>(index) * elementSize;
+
+            std::memcpy(pRecord, &index, sizeof(uint32_t));
+            std::memcpy(pRecord + sizeof(uint32_t), pElement, elementSize);
+            pRecord += recordSize;
+
+            std::memcpy(scatterBuffer.shadow.data() + static_cast<std::size_t>(index) * elementSize, pElement, elementSize);
+            scatterBuffer.shadowValid[index] = true;
+        }
+
+        scatterBuffer.pendingRecordCount = static_cast<uint32_t>(changedIndices.size());
+        scatterBuffer.pendingRecords = frameAllocation.deviceAddress;
+
+        return true;
+    }
+
+    void cmdScatterUpload(const VkCommandBuffer commandBuffer, ScatterUploader &scatterUploader, 
+                const std::initializer_list<ScatterBuffer *> &scatterBuffers)
+    {
+        scatterUploader.scatteredElementCount = 0;
+
+        for (const ScatterBuffer *pScatterBuffer : scatterBuffers) {
+            scatterUploader.scatteredElementCount += pScatterBuffer->pendingRecordCount;
+        }
+
+        if (scatterUploader.scatteredElementCount == 0) {
+            return;
+        }
+
+        // Shaders of the previous frame may still read or write the elements about to be replaced
+        VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
+                        0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scatterUploader.shaderPass.pipeline);
+
+        for (ScatterBuffer *pScatterBuffer : scatterBuffers) {
+            if (pScatterBuffer->pendingRecordCount == 0) {
+                continue;
+            }
+
+            ScatterPushConstant scatterPushConstant = {};
+            scatterPushConstant.records = pScatterBuffer->pendingRecords;
+            scatterPushConstant.destination = pScatterBuffer->buffer.deviceAddress;
+            scatterPushConstant.recordCount = pScatterBuffer->pendingRecordCount;
+            scatterPushConstant.elementWordCount = pScatterBuffer->elementSize / sizeof(uint32_t);
+
+            vkCmdPushConstants(commandBuffer, scatterUploader.shaderEffect.pipelineLayout, VK_SHADER_STAGE_ALL, 0, 
+                            sizeof(ScatterPushConstant), &scatterPushConstant);
+
+            // One invocation per word of every record
+            const uint32_t wordCount = scatterPushConstant.recordCount * scatterPushConstant.elementWordCount;
+            vkCmdDispatch(commandBuffer, (wordCount + scatterGroupSize - 1) / scatterGroupSize, 1, 1);
+
+            pScatterBuffer->pendingRecordCount = 0;
+            pScatterBuffer->pendingRecords = 0;
+        }
+
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
+                        0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/Shader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    struct FrameAllocator;
+
+    // Device local array that is kept in sync with a CPU array by uploading only the elements that changed.
+    // Changed elements are packed as (index, payload) records into the frame allocator and a compute kernel
+    // scatters them into place, so the upload cost tracks the number of changes rather than the array size
+    struct ScatterBuffer
+    {
+        VulkanBuffer buffer = {};
+        uint32_t elementSize = 0;
+        uint32_t capacity = 0;
+
+        // Last contents uploaded for every element, elements are compared against it to find changes
+        std::vector<uint8_t> shadow;
+        std::vector<bool> shadowValid;
+
+        VkDeviceAddress pendingRecords = 0;
+        uint32_t pendingRecordCount = 0;
+    };
+
+    struct ScatterUploader
+    {
+        ShaderEffect shaderEffect;
+        ShaderPass shaderPass;
+        uint32_t scatteredElementCount = 0;
+    };
+
+    ScatterUploader createScatterUploader(const VulkanContext &vulkanContext, const char *scatterSpvFilePath);
+    void destroyScatterUploader(const VulkanContext &vulkanContext, ScatterUploader &scatterUploader);
+
+    // elementSize has to be a multiple of 4, the kernel moves 32 bit words
+    ScatterBuffer createScatterBuffer(VulkanContext &vulkanContext, const uint32_t elementSize, const uint32_t capacity);
+    void destroyScatterBuffer(const VulkanContext &vulkanContext, ScatterBuffer &scatterBuffer);
+
+    // Forces every element to be uploaded again, e.g. after the buffer contents were lost
+    void invalidateScatterBuffer(ScatterBuffer &scatterBuffer);
+
+    // Packs the elements of pElements that differ from what was last uploaded into frameAllocator.
+    // Has to happen before cmdFlushFrameAllocator so the records reach the device on the staging path. When frameAllocator is full
+    // nothing is packed and false is returned, the changes stay pending and are packed again on the next call
+    bool packScatterRecords(FrameAllocator &frameAllocator, ScatterBuffer &scatterBuffer, const void *pElements, const uint32_t elementCount);
+
+    // Applies the records packed this frame and makes the arrays visible to compute shaders that follow
+    void cmdScatterUpload(const VkCommandBuffer commandBuffer, ScatterUploader &scatterUploader, 
+                const std::initializer_list<ScatterBuffer *> &scatterBuffers);
+}
\ No newline at end of file
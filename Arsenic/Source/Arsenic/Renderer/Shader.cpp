@@ -3,39 +3,65 @@
 #include "Arsenic/Renderer/VulkanContext.hpp"
 #include "Arsenic/Renderer/Structure.hpp"
 #include "Arsenic/Renderer/Shader.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/LayoutCache.hpp"
 
 #include "spirv_reflect.h"
 #include "nlohmann/json.hpp"
 
 namespace arsenic
 {
-    std::vector<char> loadSpvShaderFromFile(const char *spvFilePath)
+    static_assert(vkShaderStageVertexBit == VK_SHADER_STAGE_VERTEX_BIT && vkShaderStageFragmentBit == VK_SHADER_STAGE_FRAGMENT_BIT &&
+                vkShaderStageComputeBit == VK_SHADER_STAGE_COMPUTE_BIT);
+    static_assert(vkDescriptorTypeUniformBuffer == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER && vkDescriptorTypeStorageBuffer == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER &&
+                vkDescriptorTypeUniformBufferDynamic == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC && 
+                vkDescriptorTypeStorageBufferDynamic == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC);
+    static_assert(vkPrimitiveTopologyPointList == VK_PRIMITIVE_TOPOLOGY_POINT_LIST && vkPrimitiveTopologyTriangleList == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST &&
+                vkPolygonModeFill == VK_POLYGON_MODE_FILL && vkPolygonModeLine == VK_POLYGON_MODE_LINE);
+    static_assert(vkCullModeNone == VK_CULL_MODE_NONE && vkCullModeFrontBit == VK_CULL_MODE_FRONT_BIT && vkCullModeBackBit == VK_CULL_MODE_BACK_BIT &&
+                vkFrontFaceCounterClockwise == VK_FRONT_FACE_COUNTER_CLOCKWISE && vkFrontFaceClockwise == VK_FRONT_FACE_CLOCKWISE);
+    static_assert(vkVertexInputRateVertex == VK_VERTEX_INPUT_RATE_VERTEX && vkVertexInputRateInstance == VK_VERTEX_INPUT_RATE_INSTANCE);
+    static_assert(vkColorComponentRBit == VK_COLOR_COMPONENT_R_BIT && vkColorComponentGBit == VK_COLOR_COMPONENT_G_BIT &&
+                vkColorComponentBBit == VK_COLOR_COMPONENT_B_BIT && vkColorComponentABit == VK_COLOR_COMPONENT_A_BIT);
+
+    FileView loadSpvShaderFromFile(const char *spvFilePath)
     {
-        std::ifstream file(spvFilePath, std::ios::ate | std::ios::binary);
-        assert(file.is_open());
+        FileView spvCode = readFile(spvFilePath);
+        assert(spvCode.isValid() && spvCode.size % sizeof(uint32_t) == 0);
 
-        const std::size_t size = static_cast<std::size_t>(file.tellg());
-        file.seekg(0);
-
-        std::vector<char> spvCode(size);
-        file.read(spvCode.data(), size);
-        
-        return std::move(spvCode);
+        return spvCode;
     }
 
-    static VkShaderModule createShaderModule(const VulkanContext &renderContext, const std::vector<char> &spvCode)
+    static VkShaderModule createShaderModule(const VulkanContext &renderContext, const FileView &spvCode)
     {
         VkShaderModuleCreateInfo shaderModuleCI = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-        shaderModuleCI.codeSize = static_cast<uint32_t>(spvCode.size());
-        shaderModuleCI.pCode = reinterpret_cast<const uint32_t*>(spvCode.data());
+        shaderModuleCI.codeSize = spvCode.size;
+        shaderModuleCI.pCode = reinterpret_cast<const uint32_t*>(spvCode.pData);
         
         VkShaderModule shaderModule = VK_NULL_HANDLE;
-        checkVkResult(vkCreateShaderModule(renderContext.device, &shaderModuleCI, nullptr, &shaderModule));
+        checkVkResult(vkCreateShaderModule(renderContext.device, &shaderModuleCI, getHostAllocationCallbacks(HostAllocationTag::Shader), &shaderModule));
 
         return shaderModule;
     }
     
-    static ShaderEffect createShaderEffect(const VulkanContext renderContext, const std::initializer_list<SpvReflectShaderModule> &shaderReflectModules)
+    // Entries point into specializationData, which has to outlive the returned info
+    static VkSpecializationInfo getSpecializationInfo(const ShaderEffect &shaderEffect, const std::vector<uint32_t> &specializationData,
+                                            std::vector<VkSpecializationMapEntry> &mapEntries)
+    {
+        for (uint32_t i = 0; i != shaderEffect.specializationConstants.size(); ++i) {
+            mapEntries.push_back({shaderEffect.specializationConstants[i].constantID, i * static_cast<uint32_t>(sizeof(uint32_t)), sizeof(uint32_t)});
+        }
+
+        VkSpecializationInfo specializationInfo = {};
+        specializationInfo.mapEntryCount = static_cast<uint32_t>(mapEntries.size());
+        specializationInfo.pMapEntries = mapEntries.data();
+        specializationInfo.dataSize = specializationData.size() * sizeof(uint32_t);
+        specializationInfo.pData = specializationData.data();
+
+        return specializationInfo;
+    }
+
+    static ShaderEffect createShaderEffect(const VulkanContext &renderContext, const std::initializer_list<SpvReflectShaderModule> &shaderReflectModules)
     {
         std::unordered_map<uint32_t, std::vector<VkDescriptorSetLayoutBinding>> setLayoutBindings;
 
@@ -78,7 +104,9 @@ namespace arsenic
                         VkDescriptorSetLayoutBinding layoutBinding = {};
                         layoutBinding.binding = spvReflectDescriptorBinding.binding;
                         layoutBinding.descriptorCount = spvReflectDescriptorBinding.count;
-                        layoutBinding.descriptorType = static_cast<VkDescriptorType>(spvReflectDescriptorBinding.descriptor_type);
+                        layoutBinding.descriptorType = static_cast<VkDescriptorType>(getReflectedDescriptorType(spvReflectSet.set, 
+                                                                        static_cast<uint32_t>(spvReflectDescriptorBinding.descriptor_type)));
+
                         layoutBinding.stageFlags = VK_SHADER_STAGE_ALL;
                         layoutBindings.emplace_back(layoutBinding);
                     }
@@ -90,68 +118,43 @@ namespace arsenic
 
         ShaderEffect shaderEffect = {};
 
-        std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
-        descriptorSetLayouts.reserve(4);
-
-        for (uint32_t i = 0; i != setLayoutBindings.size() && i != shaderEffect.descriptorSetLayouts.size(); ++i) {
-            if (setLayoutBindings.find(i) == setLayoutBindings.end()) {
+        // Identical binding lists resolve to the same layout objects, so effects reflected from different shaders stay compatible
+        for (auto &[set, layoutBindings] : setLayoutBindings) {
+            if (set >= shaderEffect.descriptorSetLayouts.size()) {
                 continue;
             }
 
-            const std::vector<VkDescriptorSetLayoutBinding> &layoutBindings = setLayoutBindings[i];
-
-            VkDescriptorSetLayoutCreateInfo layoutCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-            layoutCI.bindingCount = static_cast<uint32_t>(layoutBindings.size());
-            layoutCI.pBindings = layoutBindings.data();
-
-            VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
-            checkVkResult(vkCreateDescriptorSetLayout(renderContext.device, &layoutCI, nullptr, &descriptorSetLayout));
-
-            shaderEffect.descriptorSetLayouts[i] = descriptorSetLayout;
-            descriptorSetLayouts.emplace_back(descriptorSetLayout);
+            shaderEffect.descriptorSetLayouts[set] = getDescriptorSetLayout(renderContext, std::move(layoutBindings), set == bindlessDescriptorSet);
         }
 
-        VkPushConstantRange pushConstantRange = {};
-        pushConstantRange.stageFlags = VK_SHADER_STAGE_ALL;
-        pushConstantRange.size = 128;
-
-        VkPipelineLayoutCreateInfo pipelineLayoutCI = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-        pipelineLayoutCI.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
-        pipelineLayoutCI.pSetLayouts = descriptorSetLayouts.data();
-        pipelineLayoutCI.pushConstantRangeCount = 1;
-        pipelineLayoutCI.pPushConstantRanges = &pushConstantRange;
-
-        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-        checkVkResult(vkCreatePipelineLayout(renderContext.device, &pipelineLayoutCI, nullptr, &pipelineLayout));
-        shaderEffect.pipelineLayout = pipelineLayout;
+        shaderEffect.pipelineLayout = getPipelineLayout(renderContext, shaderEffect.descriptorSetLayouts, pushConstantRangeSize);
 
         return std::move(shaderEffect);
     }
 
     ShaderEffect buildGraphicsShaderEffect(const VulkanContext &renderContext, const char *psoJsonFilePath)
     {
-        std::ifstream file(psoJsonFilePath);
-        assert(file.is_open());
+        const FileView psoJsonFile = readFile(psoJsonFilePath);
+        assert(psoJsonFile.isValid());
 
-        nlohmann::json psoJson;
-        file >> psoJson;
+        const nlohmann::json psoJson = nlohmann::json::parse(psoJsonFile.pData, psoJsonFile.pData + psoJsonFile.size);
 
         const std::string vertSpvFilePath = psoJson["vertSpvFilePath"].get<std::string>();
         const std::string fragSpvFilePath = psoJson["fragSpvFilePath"].get<std::string>();
 
-        std::vector<char> vertSpvCode = loadSpvShaderFromFile(vertSpvFilePath.c_str());
-        std::vector<char> fragSpvCode = loadSpvShaderFromFile(fragSpvFilePath.c_str());
+        const FileView vertSpvCode = loadSpvShaderFromFile(vertSpvFilePath.c_str());
+        const FileView fragSpvCode = loadSpvShaderFromFile(fragSpvFilePath.c_str());
 
         SpvReflectShaderModule vertSpvReflectModule = {};
         SpvReflectShaderModule fragSpvReflectModule = {};
 
         {
-            SpvReflectResult result = spvReflectCreateShaderModule(static_cast<std::size_t>(vertSpvCode.size()), vertSpvCode.data(), &vertSpvReflectModule);
+            SpvReflectResult result = spvReflectCreateShaderModule(vertSpvCode.size, vertSpvCode.pData, &vertSpvReflectModule);
             assert(result == SPV_REFLECT_RESULT_SUCCESS);
         }
 
         {
-            SpvReflectResult result = spvReflectCreateShaderModule(static_cast<std::size_t>(fragSpvCode.size()), fragSpvCode.data(), &fragSpvReflectModule);
+            SpvReflectResult result = spvReflectCreateShaderModule(fragSpvCode.size, fragSpvCode.pData, &fragSpvReflectModule);
             assert(result == SPV_REFLECT_RESULT_SUCCESS);
         }
 
@@ -170,19 +173,27 @@ namespace arsenic
         shaderEffect.shaderStages.emplace_back(vertShaderStage);
         shaderEffect.shaderStages.emplace_back(fragShaderStage);
 
-        shaderEffect.psoJson = std::move(psoJson);  
+        reflectSpecializationConstants(reinterpret_cast<const uint32_t *>(vertSpvCode.pData), vertSpvCode.size / sizeof(uint32_t), 
+                                shaderEffect.specializationConstants);
+        reflectSpecializationConstants(reinterpret_cast<const uint32_t *>(fragSpvCode.pData), fragSpvCode.size / sizeof(uint32_t), 
+                                shaderEffect.specializationConstants);
+
+        if (!parsePipelineState(psoJson, shaderEffect.pipelineState)) {
+            ARSENIC_ERROR("Renderer: {} has more than {} color attachments", psoJsonFilePath, maxColorAttachments);
+            assert(false);
+        }
 
         return std::move(shaderEffect);
     }
 
     ShaderEffect buildComputeShaderEffect(const VulkanContext &renderContext, const char *compSpvFilePath)
     {
-        std::vector<char> computeSpvCode = loadSpvShaderFromFile(compSpvFilePath);
+        const FileView computeSpvCode = loadSpvShaderFromFile(compSpvFilePath);
 
         SpvReflectShaderModule computeSpvReflectModule = {};
 
         {
-            SpvReflectResult result = spvReflectCreateShaderModule(static_cast<std::size_t>(computeSpvCode.size()), computeSpvCode.data(), &computeSpvReflectModule);
+            SpvReflectResult result = spvReflectCreateShaderModule(computeSpvCode.size, computeSpvCode.pData, &computeSpvReflectModule);
             assert(result == SPV_REFLECT_RESULT_SUCCESS);
         }
 
@@ -193,17 +204,55 @@ namespace arsenic
         computeShaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
         
         shaderEffect.shaderStages.emplace_back(computeShaderStage);
+        reflectSpecializationConstants(reinterpret_cast<const uint32_t *>(computeSpvCode.pData), computeSpvCode.size / sizeof(uint32_t), 
+                                shaderEffect.specializationConstants);
 
         return std::move(shaderEffect);
     }
 
-    ShaderPass buildGraphicsShaderPass(const VulkanContext &renderContext, const VkRenderPass renderpass, const uint32_t subpassIndex, ShaderEffect *pShaderEffect)
+    void destroyShaderEffect(const VulkanContext &renderContext, ShaderEffect &shaderEffect)
+    {
+        for (const ShaderStage &shaderStage : shaderEffect.shaderStages) {
+            vkDestroyShaderModule(renderContext.device, shaderStage.shaderModule, getHostAllocationCallbacks(HostAllocationTag::Shader));
+        }
+
+        shaderEffect = {};
+    }
+
+    std::vector<uint32_t> resolveSpecializationValues(const ShaderEffect &shaderEffect, const std::vector<SpecializationValue> &specializationValues)
+    {
+        std::vector<uint32_t> specializationData;
+        specializationData.reserve(shaderEffect.specializationConstants.size());
+
+        for (const SpecializationConstant &constant : shaderEffect.specializationConstants) {
+            specializationData.push_back(constant.defaultValue);
+        }
+
+        for (const SpecializationValue &specializationValue : specializationValues) {
+            const auto it = std::find_if(shaderEffect.specializationConstants.begin(), shaderEffect.specializationConstants.end(), 
+                                    [&specializationValue](const SpecializationConstant &constant) { return constant.name == specializationValue.name; });
+
+            if (it == shaderEffect.specializationConstants.end()) {
+                ARSENIC_WARN("Renderer: The shader has no specialization constant named {}", specializationValue.name);
+                continue;
+            }
+
+            specializationData[it - shaderEffect.specializationConstants.begin()] = specializationValue.value;
+        }
+
+        return specializationData;
+    }
+
+    ShaderPass buildGraphicsShaderPass(const VulkanContext &renderContext, const VkRenderPass renderpass, const uint32_t subpassIndex, ShaderEffect *pShaderEffect,
+                                const std::vector<SpecializationValue> &specializationValues)
     {
         assert(pShaderEffect);
 
+        const PipelineState &pipelineState = pShaderEffect->pipelineState;
+
         VkVertexInputBindingDescription vertexInputBindingDesc = {};
         vertexInputBindingDesc.binding = 0;
-        vertexInputBindingDesc.inputRate = (pShaderEffect->psoJson["inputRate"].get<std::string>() == "vertex") ? VK_VERTEX_INPUT_RATE_VERTEX : VK_VERTEX_INPUT_RATE_INSTANCE;
+        vertexInputBindingDesc.inputRate = static_cast<VkVertexInputRate>(pipelineState.vertexInputRate);
         vertexInputBindingDesc.stride = sizeof(Vertex);
 
         // TODO: use spv_reflect for this
@@ -225,7 +274,7 @@ namespace arsenic
         
         VkPipelineVertexInputStateCreateInfo vertexInputCI = {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
 
-        if (pShaderEffect->psoJson["enableVertexAttribs"].get<bool>()) {
+        if (pipelineState.vertexAttribsEnabled) {
             vertexInputCI.vertexBindingDescriptionCount = 1;
             vertexInputCI.pVertexBindingDescriptions = &vertexInputBindingDesc;
             vertexInputCI.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttribDescs.size());
@@ -235,32 +284,14 @@ namespace arsenic
         
         VkPipelineInputAssemblyStateCreateInfo inputAssemblerCI = {VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
         inputAssemblerCI.primitiveRestartEnable = VK_FALSE;
-        
-        if (const std::string topology = pShaderEffect->psoJson["topology"].get<std::string>(); topology == "triangle") {
-            inputAssemblerCI.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        }
+        inputAssemblerCI.topology = static_cast<VkPrimitiveTopology>(pipelineState.topology);
 
         VkPipelineRasterizationStateCreateInfo rasterStateCI = {VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
         rasterStateCI.rasterizerDiscardEnable = VK_FALSE;
         rasterStateCI.lineWidth = 1.0f;
-        rasterStateCI.cullMode = VK_CULL_MODE_NONE;
-        rasterStateCI.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-        rasterStateCI.polygonMode = VK_POLYGON_MODE_FILL;
-
-        if (const std::string cullMode = pShaderEffect->psoJson["cullMode"].get<std::string>(); cullMode == "back") {
-            rasterStateCI.cullMode = VK_CULL_MODE_BACK_BIT;
-        }
-        else if (cullMode == "front") {
-            rasterStateCI.cullMode = VK_CULL_MODE_FRONT_BIT;
-        }
-
-        if (const std::string frontFace = pShaderEffect->psoJson["frontFace"].get<std::string>(); frontFace == "clockWise") {
-            rasterStateCI.frontFace = VK_FRONT_FACE_CLOCKWISE;
-        }
-
-        if (const std::string polygonMode = pShaderEffect->psoJson["polygonMode"].get<std::string>(); polygonMode == "wireframe") {
-            rasterStateCI.polygonMode = VK_POLYGON_MODE_LINE;
-        }
+        rasterStateCI.cullMode = pipelineState.cullMode;
+        rasterStateCI.frontFace = static_cast<VkFrontFace>(pipelineState.frontFace);
+        rasterStateCI.polygonMode = static_cast<VkPolygonMode>(pipelineState.polygonMode);
 
         VkPipelineMultisampleStateCreateInfo multiSampleCI = {VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
         multiSampleCI.sampleShadingEnable = VK_FALSE;
@@ -268,23 +299,12 @@ namespace arsenic
 
     
         std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachStates;
-        const std::size_t numColorAttachment = pShaderEffect->psoJson["colorAttachmentDescs"].size();
-        colorBlendAttachStates.reserve(numColorAttachment);
+        colorBlendAttachStates.reserve(pipelineState.colorAttachmentCount);
 
-        for (auto colorAttachmentJson : pShaderEffect->psoJson["colorAttachmentDescs"]) {
+        for (uint32_t i = 0; i != pipelineState.colorAttachmentCount; ++i) {
             VkPipelineColorBlendAttachmentState colorBlendState = {};
             colorBlendState.blendEnable = VK_FALSE;
-            colorBlendState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-
-            if (int numColorComponent = colorAttachmentJson["numColorComponent"].get<int>(); numColorComponent == 1) {
-                colorBlendState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
-            }
-            else if (numColorComponent == 2) {
-                colorBlendState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT;
-            }
-            else if (numColorComponent == 3) {
-                colorBlendState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT;
-            }
+            colorBlendState.colorWriteMask = pipelineState.colorWriteMasks[i];
 
             colorBlendAttachStates.emplace_back(colorBlendState);
         }
@@ -295,7 +315,7 @@ namespace arsenic
         colorBlendCI.logicOpEnable = VK_FALSE;
         
         VkPipelineDepthStencilStateCreateInfo depthStencilCI = {VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO};
-        depthStencilCI.depthTestEnable = pShaderEffect->psoJson["depthTest"].get<bool>() ? VK_TRUE : VK_FALSE;
+        depthStencilCI.depthTestEnable = pipelineState.depthTestEnable;
         depthStencilCI.depthWriteEnable = VK_TRUE;
         depthStencilCI.depthCompareOp = VK_COMPARE_OP_GREATER_OR_EQUAL;  
 
@@ -317,6 +337,10 @@ namespace arsenic
         dynamicStateCI.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
         dynamicStateCI.pDynamicStates = dynamicStates.data();
         
+        const std::vector<uint32_t> specializationData = resolveSpecializationValues(*pShaderEffect, specializationValues);
+        std::vector<VkSpecializationMapEntry> specializationMapEntries;
+        const VkSpecializationInfo specializationInfo = getSpecializationInfo(*pShaderEffect, specializationData, specializationMapEntries);
+
         std::vector<VkPipelineShaderStageCreateInfo> shaderStageCIS;
         shaderStageCIS.reserve(pShaderEffect->shaderStages.size());
 
@@ -327,7 +351,7 @@ namespace arsenic
             shaderStageCI.module = shaderStage.shaderModule;
             shaderStageCI.stage = shaderStage.stage;
             shaderStageCI.pName = "main";
-            shaderStageCI.pSpecializationInfo = nullptr;
+            shaderStageCI.pSpecializationInfo = specializationValues.empty() ? nullptr : &specializationInfo;
 
             shaderStageCIS.emplace_back(shaderStageCI);
         }
@@ -350,7 +374,8 @@ namespace arsenic
         pipelineCI.basePipelineHandle = VK_NULL_HANDLE;
 
         VkPipeline pipeline = VK_NULL_HANDLE;
-        checkVkResult(vkCreateGraphicsPipelines(renderContext.device, VK_NULL_HANDLE, 1, &pipelineCI, nullptr, &pipeline));
+        checkVkResult(vkCreateGraphicsPipelines(renderContext.device, renderContext.pipelineCache, 1, &pipelineCI, getHostAllocationCallbacks(HostAllocationTag::Pipeline), 
+                    &pipeline));
 
         ShaderPass shaderPass = {};
         shaderPass.pipeline = pipeline;
@@ -359,14 +384,19 @@ namespace arsenic
         return shaderPass;
     }
 
-    ShaderPass buildComputeShaderPass(const VulkanContext &renderContext, ShaderEffect *pShaderEffect)
+    ShaderPass buildComputeShaderPass(const VulkanContext &renderContext, ShaderEffect *pShaderEffect, const std::vector<SpecializationValue> &specializationValues)
     {
         assert(pShaderEffect);
 
+        const std::vector<uint32_t> specializationData = resolveSpecializationValues(*pShaderEffect, specializationValues);
+        std::vector<VkSpecializationMapEntry> specializationMapEntries;
+        const VkSpecializationInfo specializationInfo = getSpecializationInfo(*pShaderEffect, specializationData, specializationMapEntries);
+
         VkPipelineShaderStageCreateInfo shaderStageCI = {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
         shaderStageCI.module = pShaderEffect->shaderStages[0].shaderModule;
         shaderStageCI.stage = pShaderEffect->shaderStages[0].stage;
         shaderStageCI.pName = "main";
+        shaderStageCI.pSpecializationInfo = specializationValues.empty() ? nullptr : &specializationInfo;
         
         VkComputePipelineCreateInfo pipelineCI = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
         pipelineCI.layout = pShaderEffect->pipelineLayout;
@@ -375,7 +405,8 @@ namespace arsenic
         pipelineCI.basePipelineIndex = -1;
 
         VkPipeline pipeline = VK_NULL_HANDLE;
-        checkVkResult(vkCreateComputePipelines(renderContext.device, VK_NULL_HANDLE, 1, &pipelineCI, nullptr, &pipeline));
+        checkVkResult(vkCreateComputePipelines(renderContext.device, renderContext.pipelineCache, 1, &pipelineCI, getHostAllocationCallbacks(HostAllocationTag::Pipeline), 
+                    &pipeline));
 
         ShaderPass shaderPass = {};
         shaderPass.pipeline = pipeline;
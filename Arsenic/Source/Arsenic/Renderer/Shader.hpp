@@ -1,25 +1,36 @@
 #pragma once
 
 #include "Arsenic/Renderer/VulkanHeader.hpp"
-
-#include "nlohmann/json.hpp"
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Renderer/LayoutCache.hpp"
+#include "Arsenic/Renderer/ShaderMetadata.hpp"
 
 namespace arsenic
 {
     struct VulkanContext;
 
+    // Looked up by the name the constant has in the shader source
+    struct SpecializationValue
+    {
+        const char *name;
+        uint32_t value;
+    };
+
     struct ShaderStage 
     {
         VkShaderModule shaderModule;
         VkShaderStageFlagBits stage;
     };
 
+    // The layouts come from the LayoutCache of the context and are shared with other effects, they are never destroyed through the effect
     struct ShaderEffect
     {
         VkPipelineLayout pipelineLayout;
-        std::array<VkDescriptorSetLayout, 4> descriptorSetLayouts;
+        std::array<VkDescriptorSetLayout, maxDescriptorSets> descriptorSetLayouts;
         std::vector<ShaderStage> shaderStages;
-        nlohmann::json psoJson;
+        // Union over the stages, stages that do not declare a constant ignore its value
+        std::vector<SpecializationConstant> specializationConstants;
+        PipelineState pipelineState;
     };
 
     struct ShaderPass
@@ -28,11 +39,20 @@ namespace arsenic
         VkPipeline pipeline;
     };
 
-    std::vector<char> loadSpvShaderFromFile(const char *spvFilePath);
+    // The code is a view of the mapped file, SPIR-V is read in place without being copied
+    FileView loadSpvShaderFromFile(const char *spvFilePath);
 
     ShaderEffect buildGraphicsShaderEffect(const VulkanContext &renderContext, const char *psoJsonFilePath);
     ShaderEffect buildComputeShaderEffect(const VulkanContext &renderContext, const char *compSpvFilePath);
+    // Destroys the shader modules only, see ShaderEffect
+    void destroyShaderEffect(const VulkanContext &renderContext, ShaderEffect &shaderEffect);
+
+    // One value per entry of specializationConstants in the same order, constants not named in specializationValues keep their default
+    std::vector<uint32_t> resolveSpecializationValues(const ShaderEffect &shaderEffect, const std::vector<SpecializationValue> &specializationValues);
 
-    ShaderPass buildGraphicsShaderPass(const VulkanContext &renderContext, const VkRenderPass renderpass, const uint32_t subpassIndex, ShaderEffect *pShaderEffect);
-    ShaderPass buildComputeShaderPass(const VulkanContext &renderContext, ShaderEffect *pShaderEffect);
+    // Without specializationValues the pipeline uses the defaults the shaders were compiled with
+    ShaderPass buildGraphicsShaderPass(const VulkanContext &renderContext, const VkRenderPass renderpass, const uint32_t subpassIndex, ShaderEffect *pShaderEffect,
+                                const std::vector<SpecializationValue> &specializationValues = {});
+    ShaderPass buildComputeShaderPass(const VulkanContext &renderContext, ShaderEffect *pShaderEffect, 
+                                const std::vector<SpecializationValue> &specializationValues = {});
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/LayoutCache.hpp"
+#include "Arsenic/Renderer/ShaderBundle.hpp"
+
+namespace arsenic
+{
+    static bool isValidShaderBundle(const FileView &bundleFile)
+    {
+        if (bundleFile.size < sizeof(ShaderBundleHeader)) {
+            return false;
+        }
+
+        const ShaderBundleHeader &header = *reinterpret_cast<const ShaderBundleHeader *>(bundleFile.pData);
+
+        const auto isTableInBounds = [&bundleFile](const uint64_t offset, const uint64_t count, const std::size_t elementSize, const std::size_t alignment) {
+            return offset % alignment == 0 && offset <= bundleFile.size && count <= (bundleFile.size - offset) / elementSize;
+        };
+
+        if (header.magic != shaderBundleMagic || header.version != shaderBundleVersion || header.pushConstantSize > pushConstantRangeSize || 
+            header.pipelineState.colorAttachmentCount > maxColorAttachments ||
+            !isTableInBounds(header.stagesOffset, header.stageCount, sizeof(ShaderBundleStage), alignof(ShaderBundleStage)) ||
+            !isTableInBounds(header.bindingsOffset, header.bindingCount, sizeof(ShaderBundleBinding), alignof(ShaderBundleBinding)) ||
+            !isTableInBounds(header.specializationConstantsOffset, header.specializationConstantCount, sizeof(ShaderBundleSpecializationConstant), 
+                        alignof(ShaderBundleSpecializationConstant))) {
+            return false;
+        }
+
+        const ShaderBundleStage *pStages = reinterpret_cast<const ShaderBundleStage *>(bundleFile.pData + header.stagesOffset);
+
+        // Either a lone compute stage or a vertex and a fragment stage, which is all the sources can describe
+        const bool isCompute = header.stageCount == 1 && pStages[0].stage == vkShaderStageComputeBit;
+        const bool isGraphics = header.stageCount == 2 && pStages[0].stage == vkShaderStageVertexBit && pStages[1].stage == vkShaderStageFragmentBit;
+
+        if (!isCompute && !isGraphics) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i != header.stageCount; ++i) {
+            if (pStages[i].codeSize == 0 || pStages[i].codeSize % sizeof(uint32_t) != 0 ||
+                !isTableInBounds(pStages[i].codeOffset, pStages[i].codeSize, 1, sizeof(uint32_t))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool loadShaderEffectBundle(const VulkanContext &vulkanContext, const char *bundleFilePath, ShaderEffect &shaderEffect)
+    {
+        if (!fileExists(bundleFilePath)) {
+            return false;
+        }
+
+        const FileView bundleFile = readFile(bundleFilePath);
+
+        if (!bundleFile.isValid() || !isValidShaderBundle(bundleFile)) {
+            ARSENIC_WARN("Renderer: {} is not a version {} shader bundle, building from the sources", bundleFilePath, shaderBundleVersion);
+            return false;
+        }
+
+        const ShaderBundleHeader &header = *reinterpret_cast<const ShaderBundleHeader *>(bundleFile.pData);
+        const ShaderBundleStage *pStages = reinterpret_cast<const ShaderBundleStage *>(bundleFile.pData + header.stagesOffset);
+        const ShaderBundleBinding *pBindings = reinterpret_cast<const ShaderBundleBinding *>(bundleFile.pData + header.bindingsOffset);
+        const ShaderBundleSpecializationConstant *pSpecializationConstants = 
+            reinterpret_cast<const ShaderBundleSpecializationConstant *>(bundleFile.pData + header.specializationConstantsOffset);
+
+        shaderEffect = {};
+
+        std::array<std::vector<VkDescriptorSetLayoutBinding>, maxDescriptorSets> setLayoutBindings;
+        std::array<bool, maxDescriptorSets> setUsed = {};
+
+        for (uint32_t i = 0; i != header.bindingCount; ++i) {
+            const ShaderBundleBinding &bundleBinding = pBindings[i];
+
+            if (bundleBinding.set >= maxDescriptorSets) {
+                continue;
+            }
+
+            VkDescriptorSetLayoutBinding layoutBinding = {};
+            layoutBinding.binding = bundleBinding.binding;
+            layoutBinding.descriptorType = static_cast<VkDescriptorType>(bundleBinding.descriptorType);
+            layoutBinding.descriptorCount = bundleBinding.descriptorCount;
+            layoutBinding.stageFlags = VK_SHADER_STAGE_ALL;
+
+            setLayoutBindings[bundleBinding.set].push_back(layoutBinding);
+            setUsed[bundleBinding.set] = true;
+        }
+
+        for (uint32_t set = 0; set != maxDescriptorSets; ++set) {
+            if (setUsed[set]) {
+                shaderEffect.descriptorSetLayouts[set] = getDescriptorSetLayout(vulkanContext, std::move(setLayoutBindings[set]), set == bindlessDescriptorSet);
+            }
+        }
+
+        shaderEffect.pipelineLayout = getPipelineLayout(vulkanContext, shaderEffect.descriptorSetLayouts, pushConstantRangeSize);
+
+        shaderEffect.shaderStages.reserve(header.stageCount);
+
+        for (uint32_t i = 0; i != header.stageCount; ++i) {
+            VkShaderModuleCreateInfo shaderModuleCI = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+            shaderModuleCI.codeSize = static_cast<std::size_t>(pStages[i].codeSize);
+            shaderModuleCI.pCode = reinterpret_cast<const uint32_t *>(bundleFile.pData + pStages[i].codeOffset);
+
+            ShaderStage shaderStage = {};
+            shaderStage.stage = static_cast<VkShaderStageFlagBits>(pStages[i].stage);
+            checkVkResult(vkCreateShaderModule(vulkanContext.device, &shaderModuleCI, getHostAllocationCallbacks(HostAllocationTag::Shader), 
+                        &shaderStage.shaderModule));
+
+            shaderEffect.shaderStages.emplace_back(shaderStage);
+        }
+
+        shaderEffect.specializationConstants.reserve(header.specializationConstantCount);
+
+        for (uint32_t i = 0; i != header.specializationConstantCount; ++i) {
+            const ShaderBundleSpecializationConstant &constant = pSpecializationConstants[i];
+            shaderEffect.specializationConstants.push_back({std::string(constant.name, strnlen(constant.name, shaderBundleNameSize)), constant.constantID, 
+                                                    constant.defaultValue});
+        }
+
+        shaderEffect.pipelineState = header.pipelineState;
+
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/Shader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    // Creates the effect from the mapped bundle, see ShaderBundleHeader, without parsing JSON or reflecting SPIR-V. Layouts come from
+    // the LayoutCache like those of every other effect. Returns false and leaves shaderEffect untouched when the file is missing,
+    // truncated or from another version, callers then build from the sources. Cook it again after changing its shaders or PSO
+    bool loadShaderEffectBundle(const VulkanContext &vulkanContext, const char *bundleFilePath, ShaderEffect &shaderEffect);
+}
\ No newline at end of file
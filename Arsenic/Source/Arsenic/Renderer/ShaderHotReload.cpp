@@ -0,0 +1,367 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/ThreadPool.hpp"
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Core/Logger.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/DeletionQueue.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/ShaderHotReload.hpp"
+
+#include "nlohmann/json.hpp"
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace arsenic
+{
+    // Where the file the runtime loads from assetFilePath, under Assets/, is edited
+    static std::string getSourceAssetPath(const std::string &sourceAssetDirectory, const std::filesystem::path &assetFilePath)
+    {
+        return (std::filesystem::path(sourceAssetDirectory) / assetFilePath.lexically_relative("Assets")).lexically_normal().generic_string();
+    }
+
+    // Assets/Shaders/Spv/X.spv is compiled from <source>/Shaders/X
+    static std::string getShaderSourcePath(const std::string &sourceAssetDirectory, const std::string &spvFilePath)
+    {
+        const std::filesystem::path spvPath(spvFilePath);
+        return getSourceAssetPath(sourceAssetDirectory, spvPath.parent_path().parent_path() / spvPath.stem());
+    }
+
+    // Adds sourceFilePath and everything it includes with quotes, include paths are relative to the including file
+    static void collectShaderDependencies(const std::string &sourceFilePath, std::unordered_set<std::string> &dependencies)
+    {
+        if (!dependencies.insert(sourceFilePath).second) {
+            return;
+        }
+
+        std::ifstream sourceFile(sourceFilePath);
+        const std::filesystem::path directory = std::filesystem::path(sourceFilePath).parent_path();
+
+        std::string line;
+        while (std::getline(sourceFile, line)) {
+            const std::size_t directiveBegin = line.find_first_not_of(" \t");
+
+            if (directiveBegin == std::string::npos || line.compare(directiveBegin, 8, "#include") != 0) {
+                continue;
+            }
+
+            const std::size_t pathBegin = line.find('"', directiveBegin);
+            const std::size_t pathEnd = pathBegin != std::string::npos ? line.find('"', pathBegin + 1) : std::string::npos;
+
+            if (pathEnd != std::string::npos) {
+                const std::string includePath = (directory / line.substr(pathBegin + 1, pathEnd - pathBegin - 1)).lexically_normal().generic_string();
+                collectShaderDependencies(includePath, dependencies);
+            }
+        }
+    }
+
+    // SPIR-V files the pass is built from
+    static std::vector<std::string> getPassSpvFilePaths(const std::string &psoJsonFilePath, const std::string &compSpvFilePath)
+    {
+        if (psoJsonFilePath.empty()) {
+            return {compSpvFilePath};
+        }
+
+        const FileView psoJsonFile = readFile(psoJsonFilePath.c_str());
+        if (!psoJsonFile.isValid()) {
+            return {};
+        }
+
+        const nlohmann::json psoJson = nlohmann::json::parse(psoJsonFile.pData, psoJsonFile.pData + psoJsonFile.size);
+        return {psoJson["vertSpvFilePath"].get<std::string>(), psoJson["fragSpvFilePath"].get<std::string>()};
+    }
+
+    static std::unordered_set<std::string> getPassDependencies(const std::string &sourceAssetDirectory, const std::string &psoJsonFilePath, 
+                                                    const std::string &compSpvFilePath)
+    {
+        std::unordered_set<std::string> dependencies;
+
+        if (!psoJsonFilePath.empty()) {
+            dependencies.insert(getSourceAssetPath(sourceAssetDirectory, psoJsonFilePath));
+        }
+
+        for (const std::string &spvFilePath : getPassSpvFilePaths(psoJsonFilePath, compSpvFilePath)) {
+            collectShaderDependencies(getShaderSourcePath(sourceAssetDirectory, spvFilePath), dependencies);
+        }
+
+        return dependencies;
+    }
+
+    // Writes next to spvFilePath first, a failed compile leaves the previous SPIR-V in place.
+    // Runs on the reload worker, the frame does not wait for glslc
+    static bool compileShader(const std::string &glslcExecutable, const std::string &sourceFilePath, const std::string &spvFilePath)
+    {
+        const std::string tempFilePath = spvFilePath + ".tmp";
+        const std::string command = "\"" + glslcExecutable + "\" \"" + sourceFilePath + "\" -o \"" + tempFilePath + "\"";
+
+        if (std::system(command.c_str()) != 0) {
+            ARSENIC_WARN("Renderer: Failed to compile {}", sourceFilePath);
+            return false;
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tempFilePath, spvFilePath, errorCode);
+        return !errorCode;
+    }
+
+    template<typename T>
+    static bool isFutureReady(const std::future<T> &future)
+    {
+        return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    static void destroyRebuiltPass(const VulkanContext &vulkanContext, const VkPipeline pipeline, ShaderEffect &shaderEffect)
+    {
+        vkDestroyPipeline(vulkanContext.device, pipeline, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+        destroyShaderEffect(vulkanContext, shaderEffect);
+    }
+
+    ShaderHotReloader::ShaderHotReloader() = default;
+
+    ShaderHotReloader::~ShaderHotReloader()
+    {
+        assert(!m_threadPool);
+    }
+
+    void ShaderHotReloader::initialize(const VulkanContext &vulkanContext, const std::string &sourceAssetDirectory, const std::string &glslcExecutable)
+    {
+        assert(!m_threadPool);
+
+        m_pVulkanContext = &vulkanContext;
+        m_sourceAssetDirectory = sourceAssetDirectory;
+        m_glslcExecutable = glslcExecutable;
+        // Rebuilds are rare and each compiles its stages one after another, a single worker keeps them off the frame
+        m_threadPool = std::make_unique<ThreadPool>(1);
+
+#ifdef __linux__
+        m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (m_inotifyFd < 0) {
+            ARSENIC_WARN("Renderer: Could not create an inotify instance, shader hot reload is disabled");
+            return;
+        }
+
+        const std::filesystem::path sourceAssetPath(sourceAssetDirectory);
+
+        for (const std::string &directory : {(sourceAssetPath / "Shaders").generic_string(), (sourceAssetPath / "Pso").generic_string()}) {
+            // Editors either rewrite a file in place or rename a new one over it
+            const int watchDescriptor = inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+            if (watchDescriptor < 0) {
+                ARSENIC_WARN("Renderer: Could not watch {} for shader hot reload", directory);
+                continue;
+            }
+
+            m_watchedDirectories[watchDescriptor] = directory;
+        }
+#else
+        ARSENIC_WARN("Renderer: Shader hot reload needs inotify and is disabled on this platform");
+#endif
+    }
+
+    void ShaderHotReloader::deInitialize()
+    {
+        m_threadPool.reset();
+
+        // Rebuilds dropped from the queue leave a broken promise behind
+        for (const std::unique_ptr<WatchedPass> &watchedPass : m_watchedPasses) {
+            try {
+                if (isFutureReady(watchedPass->rebuild)) {
+                    RebuiltPass rebuiltPass = watchedPass->rebuild.get();
+
+                    if (rebuiltPass.succeeded) {
+                        destroyRebuiltPass(*m_pVulkanContext, rebuiltPass.pipeline, rebuiltPass.shaderEffect);
+                    }
+                }
+            }
+            catch (const std::exception &) {
+            }
+        }
+
+#ifdef __linux__
+        if (m_inotifyFd >= 0) {
+            close(m_inotifyFd);
+        }
+#endif
+
+        m_inotifyFd = -1;
+        m_watchedDirectories.clear();
+        m_watchedPasses.clear();
+        m_pVulkanContext = nullptr;
+    }
+
+    void ShaderHotReloader::watchComputeShaderPass(ShaderPass &shaderPass, const std::string &compSpvFilePath)
+    {
+        std::unique_ptr<WatchedPass> &watchedPass = m_watchedPasses.emplace_back(std::make_unique<WatchedPass>());
+        watchedPass->pShaderPass = &shaderPass;
+        watchedPass->compSpvFilePath = compSpvFilePath;
+        watchedPass->renderpass = VK_NULL_HANDLE;
+        watchedPass->subpassIndex = 0;
+        watchedPass->dependencies = getPassDependencies(m_sourceAssetDirectory, {}, compSpvFilePath);
+    }
+
+    void ShaderHotReloader::watchGraphicsShaderPass(ShaderPass &shaderPass, const std::string &psoJsonFilePath, const VkRenderPass renderpass, 
+                                            const uint32_t subpassIndex)
+    {
+        std::unique_ptr<WatchedPass> &watchedPass = m_watchedPasses.emplace_back(std::make_unique<WatchedPass>());
+        watchedPass->pShaderPass = &shaderPass;
+        watchedPass->psoJsonFilePath = psoJsonFilePath;
+        watchedPass->renderpass = renderpass;
+        watchedPass->subpassIndex = subpassIndex;
+        watchedPass->dependencies = getPassDependencies(m_sourceAssetDirectory, psoJsonFilePath, {});
+    }
+
+    bool ShaderHotReloader::update(DeletionQueue &deletionQueue, const uint64_t retireValue)
+    {
+        if (!m_threadPool) {
+            return false;
+        }
+
+        for (const std::string &changedFilePath : readChangedFiles()) {
+            for (const std::unique_ptr<WatchedPass> &watchedPass : m_watchedPasses) {
+                if (watchedPass->dependencies.count(changedFilePath) != 0) {
+                    watchedPass->dirty = true;
+                }
+            }
+        }
+
+        bool passChanged = false;
+
+        for (const std::unique_ptr<WatchedPass> &watchedPass : m_watchedPasses) {
+            if (isFutureReady(watchedPass->rebuild)) {
+                RebuiltPass rebuiltPass = {};
+
+                try {
+                    rebuiltPass = watchedPass->rebuild.get();
+                }
+                catch (const std::exception &exception) {
+                    ARSENIC_WARN("Renderer: Shader hot reload failed: {}", exception.what());
+                }
+
+                ShaderPass &shaderPass = *watchedPass->pShaderPass;
+
+                if (rebuiltPass.succeeded && rebuiltPass.shaderEffect.pipelineLayout != shaderPass.pShaderEffect->pipelineLayout) {
+                    // Descriptor sets already allocated with the old layouts would not be compatible with the new pipeline
+                    ARSENIC_WARN("Renderer: A reloaded shader changed its descriptor bindings or push constants, restart to apply it");
+                    destroyRebuiltPass(*m_pVulkanContext, rebuiltPass.pipeline, rebuiltPass.shaderEffect);
+                }
+                else if (rebuiltPass.succeeded) {
+                    ShaderEffect retiredEffect = std::move(*shaderPass.pShaderEffect);
+                    const VkPipeline retiredPipeline = shaderPass.pipeline;
+
+                    *shaderPass.pShaderEffect = std::move(rebuiltPass.shaderEffect);
+                    shaderPass.pipeline = rebuiltPass.pipeline;
+                    watchedPass->dependencies = std::move(rebuiltPass.dependencies);
+
+                    deferDestroy(deletionQueue, [retiredPipeline, retiredEffect = std::move(retiredEffect)](const VulkanContext &vulkanContext) mutable {
+                        destroyRebuiltPass(vulkanContext, retiredPipeline, retiredEffect);
+                    }, retireValue);
+
+                    ARSENIC_INFO("Renderer: Reloaded {}", watchedPass->psoJsonFilePath.empty() ? watchedPass->compSpvFilePath : watchedPass->psoJsonFilePath);
+                    passChanged = true;
+                }
+            }
+
+            // Changes made while a rebuild runs start another one once it is done
+            if (watchedPass->dirty && !watchedPass->rebuild.valid()) {
+                watchedPass->dirty = false;
+                watchedPass->rebuild = m_threadPool->submit([pVulkanContext = m_pVulkanContext, sourceAssetDirectory = m_sourceAssetDirectory,
+                                                    glslcExecutable = m_glslcExecutable, psoJsonFilePath = watchedPass->psoJsonFilePath,
+                                                    compSpvFilePath = watchedPass->compSpvFilePath, renderpass = watchedPass->renderpass,
+                                                    subpassIndex = watchedPass->subpassIndex]() {
+                    return rebuildPass(*pVulkanContext, sourceAssetDirectory, glslcExecutable, psoJsonFilePath, compSpvFilePath, renderpass, 
+                                subpassIndex);
+                });
+            }
+        }
+
+        return passChanged;
+    }
+
+    ShaderHotReloader::RebuiltPass ShaderHotReloader::rebuildPass(const VulkanContext &vulkanContext, const std::string &sourceAssetDirectory, 
+                                                        const std::string &glslcExecutable, const std::string &psoJsonFilePath, 
+                                                        const std::string &compSpvFilePath, const VkRenderPass renderpass, const uint32_t subpassIndex)
+    {
+        RebuiltPass rebuiltPass = {};
+
+        // The PSO file is read where the runtime loads it from, so an edited source replaces that copy first
+        if (!psoJsonFilePath.empty()) {
+            const std::filesystem::path sourcePsoPath(getSourceAssetPath(sourceAssetDirectory, psoJsonFilePath));
+            std::error_code errorCode;
+
+            if (!std::filesystem::equivalent(sourcePsoPath, psoJsonFilePath, errorCode)) {
+                std::filesystem::copy_file(sourcePsoPath, psoJsonFilePath, std::filesystem::copy_options::overwrite_existing, errorCode);
+
+                if (errorCode) {
+                    ARSENIC_WARN("Renderer: Failed to copy {} over {}", sourcePsoPath.generic_string(), psoJsonFilePath);
+                    return rebuiltPass;
+                }
+            }
+        }
+
+        const std::vector<std::string> spvFilePaths = getPassSpvFilePaths(psoJsonFilePath, compSpvFilePath);
+        if (spvFilePaths.empty()) {
+            return rebuiltPass;
+        }
+
+        for (const std::string &spvFilePath : spvFilePaths) {
+            if (!compileShader(glslcExecutable, getShaderSourcePath(sourceAssetDirectory, spvFilePath), spvFilePath)) {
+                return rebuiltPass;
+            }
+        }
+
+        if (psoJsonFilePath.empty()) {
+            rebuiltPass.shaderEffect = buildComputeShaderEffect(vulkanContext, compSpvFilePath.c_str());
+            rebuiltPass.pipeline = buildComputeShaderPass(vulkanContext, &rebuiltPass.shaderEffect).pipeline;
+        }
+        else {
+            rebuiltPass.shaderEffect = buildGraphicsShaderEffect(vulkanContext, psoJsonFilePath.c_str());
+            rebuiltPass.pipeline = buildGraphicsShaderPass(vulkanContext, renderpass, subpassIndex, &rebuiltPass.shaderEffect).pipeline;
+        }
+
+        // An edit may have added or removed includes
+        rebuiltPass.dependencies = getPassDependencies(sourceAssetDirectory, psoJsonFilePath, compSpvFilePath);
+        rebuiltPass.succeeded = true;
+
+        return rebuiltPass;
+    }
+
+    std::vector<std::string> ShaderHotReloader::readChangedFiles()
+    {
+        std::vector<std::string> changedFilePaths;
+
+#ifdef __linux__
+        if (m_inotifyFd < 0) {
+            return changedFilePaths;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+
+        for (;;) {
+            const ssize_t size = read(m_inotifyFd, buffer, sizeof(buffer));
+
+            // Non blocking, EAGAIN once every pending event has been read
+            if (size <= 0) {
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < size; ) {
+                const inotify_event *pEvent = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += sizeof(inotify_event) + pEvent->len;
+
+                const auto it = m_watchedDirectories.find(pEvent->wd);
+                if (it == m_watchedDirectories.end() || pEvent->len == 0) {
+                    continue;
+                }
+
+                changedFilePaths.push_back((std::filesystem::path(it->second) / pEvent->name).lexically_normal().generic_string());
+            }
+        }
+#endif
+
+        return changedFilePaths;
+    }
+}
\ No newline at end of file
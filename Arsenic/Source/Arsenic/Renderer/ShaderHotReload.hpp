@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/Shader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    struct DeletionQueue;
+    class ThreadPool;
+
+    // Watches the shader sources and PSO files of registered passes and rebuilds a pass when one of them, or a file its
+    // sources #include, is written. Sources are compiled with glslc and the pass rebuilt on a worker, update swaps the result in.
+    // Passes are registered with the paths the runtime loads, under Assets/. The files edited are looked up under a source asset
+    // directory instead, usually the Assets tree of the checkout the build copies from: Assets/Shaders/Spv/X.spv is compiled from
+    // <source>/Shaders/X and Assets/Pso/X.json is refreshed from <source>/Pso/X.json before the rebuild. Only the runtime copies
+    // are written, the next build compiles the sources again. The rebuilt SPIR-V is read through readFile, so assets have to be
+    // served from a directory rather than a pack. Uses inotify and does nothing on other platforms
+    class ShaderHotReloader
+    {
+    public:
+        ShaderHotReloader();
+        ~ShaderHotReloader();
+
+        ShaderHotReloader(const ShaderHotReloader &) = delete;
+        ShaderHotReloader &operator=(const ShaderHotReloader &) = delete;
+        ShaderHotReloader(ShaderHotReloader &&) = delete;
+        ShaderHotReloader &operator=(ShaderHotReloader &&) = delete;
+
+        // sourceAssetDirectory/Shaders and sourceAssetDirectory/Pso are watched without their subdirectories. The default edits
+        // the runtime copies in place. vulkanContext has to outlive the reloader
+        void initialize(const VulkanContext &vulkanContext, const std::string &sourceAssetDirectory = "Assets", 
+                    const std::string &glslcExecutable = "glslc");
+        // Waits for a running rebuild and throws its result away
+        void deInitialize();
+
+        // shaderPass has to keep its address while it is watched. Its effect is rebuilt in place, whoever owns it still destroys it
+        void watchComputeShaderPass(ShaderPass &shaderPass, const std::string &compSpvFilePath);
+        // renderpass has to stay alive while the pass is watched
+        void watchGraphicsShaderPass(ShaderPass &shaderPass, const std::string &psoJsonFilePath, const VkRenderPass renderpass, 
+                    const uint32_t subpassIndex);
+
+        // Call at a frame boundary, before recording. Starts rebuilding passes whose files changed and swaps in the ones
+        // that finished, the pipelines and shader modules they replace are destroyed once the timeline reaches retireValue.
+        // Rebuilds that fail to compile or that change the pipeline layout are dropped and the pass keeps its current pipeline.
+        // Returns true if a pass was swapped
+        bool update(DeletionQueue &deletionQueue, const uint64_t retireValue);
+    private:
+        struct RebuiltPass
+        {
+            bool succeeded;
+            ShaderEffect shaderEffect;
+            VkPipeline pipeline;
+            std::unordered_set<std::string> dependencies;
+        };
+
+        struct WatchedPass
+        {
+            ShaderPass *pShaderPass;
+            // Empty for compute passes
+            std::string psoJsonFilePath;
+            std::string compSpvFilePath;
+            VkRenderPass renderpass;
+            uint32_t subpassIndex;
+
+            // Sources, the files they include and the PSO file
+            std::unordered_set<std::string> dependencies;
+            bool dirty = false;
+            std::future<RebuiltPass> rebuild;
+        };
+
+        static RebuiltPass rebuildPass(const VulkanContext &vulkanContext, const std::string &sourceAssetDirectory, const std::string &glslcExecutable,
+                                const std::string &psoJsonFilePath, const std::string &compSpvFilePath, const VkRenderPass renderpass, 
+                                const uint32_t subpassIndex);
+        // Paths of the files written since the last call
+        std::vector<std::string> readChangedFiles();
+    private:
+        std::unique_ptr<ThreadPool> m_threadPool;
+        const VulkanContext *m_pVulkanContext = nullptr;
+        std::string m_sourceAssetDirectory;
+        std::string m_glslcExecutable;
+        std::vector<std::unique_ptr<WatchedPass>> m_watchedPasses;
+
+        int m_inotifyFd = -1;
+        // Watch descriptor to the directory it watches
+        std::unordered_map<int, std::string> m_watchedDirectories;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/ShaderMetadata.hpp"
+
+#include "spirv.h"
+#include "nlohmann/json.hpp"
+
+namespace arsenic
+{
+    uint32_t getReflectedDescriptorType(const uint32_t set, const uint32_t descriptorType)
+    {
+        if (set != frameDataDescriptorSet) {
+            return descriptorType;
+        }
+
+        if (descriptorType == vkDescriptorTypeUniformBuffer) {
+            return vkDescriptorTypeUniformBufferDynamic;
+        }
+
+        if (descriptorType == vkDescriptorTypeStorageBuffer) {
+            return vkDescriptorTypeStorageBufferDynamic;
+        }
+
+        return descriptorType;
+    }
+
+    void reflectSpecializationConstants(const uint32_t *pCode, const std::size_t wordCount, std::vector<SpecializationConstant> &specializationConstants)
+    {
+        std::unordered_map<uint32_t, std::string> names;
+        std::unordered_map<uint32_t, uint32_t> constantIDs;
+        std::vector<std::pair<uint32_t, uint32_t>> constants;
+
+        // Instructions start after the five word header
+        for (std::size_t i = 5; i < wordCount; ) {
+            const uint32_t opcode = pCode[i] & 0xffff;
+            const uint32_t instructionWordCount = pCode[i] >> 16;
+
+            if (instructionWordCount == 0 || i + instructionWordCount > wordCount) {
+                break;
+            }
+
+            if (opcode == SpvOpName && instructionWordCount > 2) {
+                const char *pName = reinterpret_cast<const char *>(pCode + i + 2);
+                names[pCode[i + 1]] = std::string(pName, strnlen(pName, (instructionWordCount - 2) * sizeof(uint32_t)));
+            }
+            else if (opcode == SpvOpDecorate && instructionWordCount == 4 && pCode[i + 2] == SpvDecorationSpecId) {
+                constantIDs[pCode[i + 1]] = pCode[i + 3];
+            }
+            else if (opcode == SpvOpSpecConstantTrue || opcode == SpvOpSpecConstantFalse) {
+                constants.emplace_back(pCode[i + 2], opcode == SpvOpSpecConstantTrue ? 1 : 0);
+            }
+            else if (opcode == SpvOpSpecConstant && instructionWordCount == 4) {
+                constants.emplace_back(pCode[i + 2], pCode[i + 3]);
+            }
+
+            i += instructionWordCount;
+        }
+
+        for (const auto &[resultID, defaultValue] : constants) {
+            const auto it = constantIDs.find(resultID);
+            if (it == constantIDs.end()) {
+                continue;
+            }
+
+            const bool reflected = std::any_of(specializationConstants.begin(), specializationConstants.end(), [constantID = it->second](const SpecializationConstant &constant) {
+                return constant.constantID == constantID;
+            });
+
+            if (!reflected) {
+                specializationConstants.push_back({names[resultID], it->second, defaultValue});
+            }
+        }
+    }
+
+    bool parsePipelineState(const nlohmann::json &psoJson, PipelineState &pipelineState)
+    {
+        pipelineState = {};
+        pipelineState.vertexInputRate = psoJson["inputRate"].get<std::string>() == "vertex" ? vkVertexInputRateVertex : vkVertexInputRateInstance;
+        pipelineState.vertexAttribsEnabled = psoJson["enableVertexAttribs"].get<bool>() ? 1 : 0;
+        pipelineState.depthTestEnable = psoJson["depthTest"].get<bool>() ? 1 : 0;
+        pipelineState.topology = vkPrimitiveTopologyPointList;
+        pipelineState.cullMode = vkCullModeNone;
+        pipelineState.frontFace = vkFrontFaceCounterClockwise;
+        pipelineState.polygonMode = vkPolygonModeFill;
+
+        if (const std::string topology = psoJson["topology"].get<std::string>(); topology == "triangle") {
+            pipelineState.topology = vkPrimitiveTopologyTriangleList;
+        }
+
+        if (const std::string cullMode = psoJson["cullMode"].get<std::string>(); cullMode == "back") {
+            pipelineState.cullMode = vkCullModeBackBit;
+        }
+        else if (cullMode == "front") {
+            pipelineState.cullMode = vkCullModeFrontBit;
+        }
+
+        if (const std::string frontFace = psoJson["frontFace"].get<std::string>(); frontFace == "clockWise") {
+            pipelineState.frontFace = vkFrontFaceClockwise;
+        }
+
+        if (const std::string polygonMode = psoJson["polygonMode"].get<std::string>(); polygonMode == "wireframe") {
+            pipelineState.polygonMode = vkPolygonModeLine;
+        }
+
+        for (const nlohmann::json &colorAttachmentJson : psoJson["colorAttachmentDescs"]) {
+            if (pipelineState.colorAttachmentCount == maxColorAttachments) {
+                return false;
+            }
+
+            uint32_t &colorWriteMask = pipelineState.colorWriteMasks[pipelineState.colorAttachmentCount++];
+            colorWriteMask = vkColorComponentRBit | vkColorComponentGBit | vkColorComponentBBit | vkColorComponentABit;
+
+            if (const int numColorComponent = colorAttachmentJson["numColorComponent"].get<int>(); numColorComponent == 1) {
+                colorWriteMask = vkColorComponentRBit;
+            }
+            else if (numColorComponent == 2) {
+                colorWriteMask = vkColorComponentRBit | vkColorComponentGBit;
+            }
+            else if (numColorComponent == 3) {
+                colorWriteMask = vkColorComponentRBit | vkColorComponentGBit | vkColorComponentBBit;
+            }
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json_fwd.hpp"
+
+// Everything both the runtime and ArsenicCooker need to describe a shader effect. It does not include Vulkan, so the cooker
+// builds ShaderMetadata.cpp without linking the renderer, and the values the runtime casts to Vulkan enums are spelled out below
+namespace arsenic
+{
+    // Every uniform and storage buffer in this set is reflected as its dynamic variant so per-frame data can be bound
+    // out of a FrameAllocator with dynamic offsets. There is no opt out, buffers bound once belong in another set
+    constexpr uint32_t frameDataDescriptorSet = 0;
+
+    // Shaders that include bindless.glsl get the layout of createBindlessDescriptorSetLayout for this set instead of
+    // a reflected one, so a single BindlessTable binds to every effect
+    constexpr uint32_t bindlessDescriptorSet = 1;
+
+    // Every pipeline layout has a single range of this size visible to all stages, so push constants stay compatible between effects
+    constexpr uint32_t pushConstantRangeSize = 128;
+    constexpr uint32_t maxColorAttachments = 8;
+
+    // Vulkan enum values, Shader.cpp checks them against the Vulkan headers
+    constexpr uint32_t vkShaderStageVertexBit = 0x01;
+    constexpr uint32_t vkShaderStageFragmentBit = 0x10;
+    constexpr uint32_t vkShaderStageComputeBit = 0x20;
+    constexpr uint32_t vkDescriptorTypeUniformBuffer = 6;
+    constexpr uint32_t vkDescriptorTypeStorageBuffer = 7;
+    constexpr uint32_t vkDescriptorTypeUniformBufferDynamic = 8;
+    constexpr uint32_t vkDescriptorTypeStorageBufferDynamic = 9;
+    constexpr uint32_t vkPrimitiveTopologyPointList = 0;
+    constexpr uint32_t vkPrimitiveTopologyTriangleList = 3;
+    constexpr uint32_t vkPolygonModeFill = 0;
+    constexpr uint32_t vkPolygonModeLine = 1;
+    constexpr uint32_t vkCullModeNone = 0;
+    constexpr uint32_t vkCullModeFrontBit = 1;
+    constexpr uint32_t vkCullModeBackBit = 2;
+    constexpr uint32_t vkFrontFaceCounterClockwise = 0;
+    constexpr uint32_t vkFrontFaceClockwise = 1;
+    constexpr uint32_t vkVertexInputRateVertex = 0;
+    constexpr uint32_t vkVertexInputRateInstance = 1;
+    constexpr uint32_t vkColorComponentRBit = 0x1;
+    constexpr uint32_t vkColorComponentGBit = 0x2;
+    constexpr uint32_t vkColorComponentBBit = 0x4;
+    constexpr uint32_t vkColorComponentABit = 0x8;
+
+    // Fixed function state of a graphics effect, from its PSO file or a shader bundle. Fields hold Vulkan enum values
+    // and colorWriteMasks holds colorAttachmentCount entries
+    struct PipelineState
+    {
+        uint32_t topology;
+        uint32_t polygonMode;
+        uint32_t cullMode;
+        uint32_t frontFace;
+        uint32_t depthTestEnable;
+        uint32_t vertexInputRate;
+        uint32_t vertexAttribsEnabled;
+        uint32_t colorAttachmentCount;
+        std::array<uint32_t, maxColorAttachments> colorWriteMasks;
+    };
+
+    // Scalar specialization constant reflected from SPIR-V. Every value is 32 bits, bools are VkBool32 and floats are their bits
+    struct SpecializationConstant
+    {
+        std::string name;
+        uint32_t constantID;
+        uint32_t defaultValue;
+    };
+
+    // Layout of a shader bundle written by ArsenicCooker --shader-bundle, all fields little endian. A bundle holds the SPIR-V of
+    // every stage of an effect together with what buildGraphicsShaderEffect and buildComputeShaderEffect would otherwise reflect
+    // and parse at startup. The tables follow the header, stage code sits at 4 byte aligned offsets after them
+    constexpr uint32_t shaderBundleMagic = 0x42534141;
+    constexpr uint32_t shaderBundleVersion = 1;
+    constexpr uint32_t shaderBundleNameSize = 56;
+
+    struct ShaderBundleHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t stageCount;
+        uint32_t bindingCount;
+        uint32_t specializationConstantCount;
+        // Reflected size of the push constant block, the pipeline layout still uses pushConstantRangeSize
+        uint32_t pushConstantSize;
+        uint64_t stagesOffset;
+        uint64_t bindingsOffset;
+        uint64_t specializationConstantsOffset;
+        PipelineState pipelineState;
+    };
+
+    struct ShaderBundleStage
+    {
+        uint32_t stage;
+        uint32_t reserved;
+        uint64_t codeOffset;
+        uint64_t codeSize;
+    };
+
+    // Descriptor types already went through getReflectedDescriptorType
+    struct ShaderBundleBinding
+    {
+        uint32_t set;
+        uint32_t binding;
+        uint32_t descriptorType;
+        uint32_t descriptorCount;
+    };
+
+    struct ShaderBundleSpecializationConstant
+    {
+        uint32_t constantID;
+        uint32_t defaultValue;
+        char name[shaderBundleNameSize];
+    };
+
+    // The structs are written and read in place, these are the sizes of the version above
+    static_assert(sizeof(PipelineState) == 64 && sizeof(ShaderBundleHeader) == 112 && sizeof(ShaderBundleStage) == 24 && 
+                sizeof(ShaderBundleBinding) == 16 && sizeof(ShaderBundleSpecializationConstant) == 64);
+
+    // The type a reflected binding gets in the effect's layout, see frameDataDescriptorSet
+    uint32_t getReflectedDescriptorType(const uint32_t set, const uint32_t descriptorType);
+
+    // spirv_reflect does not cover specialization constants, so they are read from the instruction stream. Only scalar
+    // constants of up to 32 bits are collected, composites and OpSpecConstantOp results can not be set by the host.
+    // Constants already in specializationConstants are skipped, so calling it for every stage collects their union
+    void reflectSpecializationConstants(const uint32_t *pCode, const std::size_t wordCount, std::vector<SpecializationConstant> &specializationConstants);
+
+    // Throws nlohmann::json::exception for missing or mistyped fields, false when the PSO has more than maxColorAttachments
+    bool parsePipelineState(const nlohmann::json &psoJson, PipelineState &pipelineState);
+}
\ No newline at end of file
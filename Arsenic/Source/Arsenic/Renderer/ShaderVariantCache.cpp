@@ -0,0 +1,158 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/Hash.hpp"
+#include "Arsenic/Core/ThreadPool.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/DeletionQueue.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/PipelineBuilder.hpp"
+#include "Arsenic/Renderer/ShaderVariantCache.hpp"
+
+namespace arsenic
+{
+    std::size_t ShaderVariantCache::VariantKeyHash::operator()(const std::vector<uint32_t> &specializationData) const
+    {
+        return static_cast<std::size_t>(hashBytes(specializationData.data(), specializationData.size() * sizeof(uint32_t)));
+    }
+
+    ShaderVariantCache::ShaderVariantCache() = default;
+
+    ShaderVariantCache::~ShaderVariantCache()
+    {
+        assert(!m_threadPool);
+    }
+
+    void ShaderVariantCache::initialize(const VulkanContext &vulkanContext, ShaderEffect *pShaderEffect, const VkRenderPass renderpass, 
+                                const uint32_t subpassIndex)
+    {
+        assert(!m_threadPool && pShaderEffect);
+
+        // Variants are requested one at a time as settings change, a single worker is plenty
+        m_threadPool = std::make_unique<ThreadPool>(1);
+        m_pVulkanContext = &vulkanContext;
+        m_pShaderEffect = pShaderEffect;
+        m_renderpass = renderpass;
+        m_subpassIndex = subpassIndex;
+    }
+
+    void ShaderVariantCache::deInitialize()
+    {
+        if (!m_threadPool) {
+            return;
+        }
+
+        // Lets running compiles finish, so every future left is either ready or broken
+        m_threadPool.reset();
+
+        for (auto &[specializationData, shaderVariant] : m_variants) {
+            if (isShaderPassReady(shaderVariant.build)) {
+                try {
+                    shaderVariant.shaderPass = shaderVariant.build.get();
+                }
+                catch (const std::future_error &) {
+                }
+            }
+
+            vkDestroyPipeline(m_pVulkanContext->device, shaderVariant.shaderPass.pipeline, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+        }
+
+        m_variants.clear();
+        m_pVulkanContext = nullptr;
+        m_pShaderEffect = nullptr;
+    }
+
+    const ShaderPass *ShaderVariantCache::requestVariant(const std::vector<SpecializationValue> &specializationValues)
+    {
+        assert(m_threadPool);
+
+        const std::vector<uint32_t> specializationData = resolveSpecializationValues(*m_pShaderEffect, specializationValues);
+
+        const bool defaultValues = std::equal(specializationData.begin(), specializationData.end(), m_pShaderEffect->specializationConstants.begin(),
+                                        [](const uint32_t value, const SpecializationConstant &constant) { return value == constant.defaultValue; });
+
+        if (defaultValues) {
+            return nullptr;
+        }
+
+        auto it = m_variants.find(specializationData);
+
+        if (it == m_variants.end()) {
+            // The worker builds from a copy, so the effect can be rebuilt in place while a variant compiles. The copy
+            // shares its shader modules, clear holds back their retirement until the compile has landed
+            it = m_variants.emplace(specializationData, ShaderVariant{}).first;
+            it->second.build = m_threadPool->submit([pVulkanContext = m_pVulkanContext, shaderEffect = *m_pShaderEffect, renderpass = m_renderpass, 
+                                            subpassIndex = m_subpassIndex, specializationData]() mutable {
+                // Named after the copy, the names the caller passed do not have to outlive the request
+                std::vector<SpecializationValue> specializationValues;
+                for (std::size_t i = 0; i != specializationData.size(); ++i) {
+                    specializationValues.push_back({shaderEffect.specializationConstants[i].name.c_str(), specializationData[i]});
+                }
+
+                if (renderpass == VK_NULL_HANDLE) {
+                    return buildComputeShaderPass(*pVulkanContext, &shaderEffect, specializationValues);
+                }
+
+                return buildGraphicsShaderPass(*pVulkanContext, renderpass, subpassIndex, &shaderEffect, specializationValues);
+            });
+
+            return nullptr;
+        }
+
+        ShaderVariant &shaderVariant = it->second;
+
+        if (isShaderPassReady(shaderVariant.build)) {
+            shaderVariant.shaderPass = shaderVariant.build.get();
+        }
+
+        if (shaderVariant.shaderPass.pipeline == VK_NULL_HANDLE) {
+            return nullptr;
+        }
+
+        shaderVariant.shaderPass.pShaderEffect = m_pShaderEffect;
+        return &shaderVariant.shaderPass;
+    }
+
+    void ShaderVariantCache::clear(DeletionQueue &deletionQueue, const uint64_t retireValue)
+    {
+        assert(m_threadPool);
+
+        std::vector<VkPipeline> retiredPipelines;
+
+        for (auto &[specializationData, shaderVariant] : m_variants) {
+            if (isShaderPassReady(shaderVariant.build)) {
+                shaderVariant.shaderPass = shaderVariant.build.get();
+            }
+
+            // Still compiling, its pipeline was never handed out and is destroyed as soon as it lands. Until then the retired
+            // shader modules the worker reads stay alive, they were pushed with the same retire value
+            if (shaderVariant.build.valid()) {
+                const std::shared_future<ShaderPass> staleBuild = shaderVariant.build.share();
+
+                deferDestroyWhenReleased(deletionQueue, [staleBuild]() {
+                    return staleBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                }, [staleBuild](const VulkanContext &vulkanContext) {
+                    // Compiles dropped from the queue by deInitialize leave a broken promise behind
+                    try {
+                        vkDestroyPipeline(vulkanContext.device, staleBuild.get().pipeline, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+                    }
+                    catch (const std::future_error &) {
+                    }
+                }, retireValue);
+            }
+
+            if (shaderVariant.shaderPass.pipeline != VK_NULL_HANDLE) {
+                retiredPipelines.push_back(shaderVariant.shaderPass.pipeline);
+            }
+        }
+
+        m_variants.clear();
+
+        if (!retiredPipelines.empty()) {
+            deferDestroy(deletionQueue, [retiredPipelines](const VulkanContext &vulkanContext) {
+                for (const VkPipeline pipeline : retiredPipelines) {
+                    vkDestroyPipeline(vulkanContext.device, pipeline, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+                }
+            }, retireValue);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/Shader.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    struct DeletionQueue;
+    class ThreadPool;
+
+    // Pipelines of one ShaderEffect specialized with different constant values, keyed by the full set of values.
+    // A variant is compiled on a worker the first time it is requested, the pipelines share the layout of the effect
+    // so descriptor sets bound for the unspecialized pass stay valid for every variant
+    class ShaderVariantCache
+    {
+    public:
+        ShaderVariantCache();
+        ~ShaderVariantCache();
+
+        ShaderVariantCache(const ShaderVariantCache &) = delete;
+        ShaderVariantCache &operator=(const ShaderVariantCache &) = delete;
+        ShaderVariantCache(ShaderVariantCache &&) = delete;
+        ShaderVariantCache &operator=(ShaderVariantCache &&) = delete;
+
+        // A renderpass of VK_NULL_HANDLE builds compute variants. vulkanContext, the effect and renderpass have to outlive the cache
+        void initialize(const VulkanContext &vulkanContext, ShaderEffect *pShaderEffect, const VkRenderPass renderpass = VK_NULL_HANDLE, 
+                    const uint32_t subpassIndex = 0);
+        // Waits for running compiles, including the ones clear left behind, and destroys every variant. The caller has to make sure
+        // the device is idle
+        void deInitialize();
+
+        // Returns nullptr while the variant is compiling or when the values are the defaults, the unspecialized pass
+        // is the one to use then. Never blocks
+        const ShaderPass *requestVariant(const std::vector<SpecializationValue> &specializationValues);
+
+        // Retires every variant once the timeline reaches retireValue, they are compiled again on request. Never blocks, variants
+        // still compiling are retired when they land and hold back whatever else retires at retireValue until then.
+        // Call after the effect was rebuilt, e.g. by ShaderHotReloader, with the retire value of the shader modules it replaced
+        void clear(DeletionQueue &deletionQueue, const uint64_t retireValue);
+    private:
+        struct ShaderVariant
+        {
+            std::future<ShaderPass> build;
+            ShaderPass shaderPass = {};
+        };
+
+        struct VariantKeyHash
+        {
+            std::size_t operator()(const std::vector<uint32_t> &specializationData) const;
+        };
+    private:
+        std::unique_ptr<ThreadPool> m_threadPool;
+        const VulkanContext *m_pVulkanContext = nullptr;
+        ShaderEffect *m_pShaderEffect = nullptr;
+        VkRenderPass m_renderpass = VK_NULL_HANDLE;
+        uint32_t m_subpassIndex = 0;
+
+        // Keyed by resolveSpecializationValues
+        std::unordered_map<std::vector<uint32_t>, ShaderVariant, VariantKeyHash> m_variants;
+    };
+}
\ No newline at end of file
@@ -15,7 +15,8 @@ namespace arsenic
         VkCommandPool commandPool;
         VkSemaphore imageReadySemaphore;
         VkSemaphore renderFinishSemaphore;
-        VkFence frameInFlightFence;
+        // Graphics timeline value signaled once this frame's commands have finished executing
+        uint64_t timelineValue;
     };
     
     template<typename T>
@@ -106,4 +107,14 @@ namespace arsenic
         int pad1;
         int pad2;
     };
+
+    // Mirrors the push constant block of structures.glsl, scene arrays are passed as buffer device addresses
+    struct ScenePushConstant
+    {
+        VkDeviceAddress sphereMeshes = 0;
+        VkDeviceAddress lights = 0;
+        VkDeviceAddress materials = 0;
+        VkDeviceAddress textureFeedback = 0;
+        int renderObjectIndex = -1;
+    };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Arsenic/Arsenicpch.hpp"
 
 #include "Arsenic/Renderer/Swapchain.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
 
 namespace arsenic
 {
@@ -67,7 +68,8 @@ namespace arsenic
         return surfaceFormats[0];
     }
 
-    Swapchain createSwapchain(const VkDevice device, const VkSurfaceKHR surface, const VkPhysicalDevice physicalDevice, const VkExtent2D desiredExtent)
+    Swapchain createSwapchain(const VkDevice device, const VkSurfaceKHR surface, const VkPhysicalDevice physicalDevice, const VkExtent2D desiredExtent,
+                const VkSwapchainKHR oldSwapchain)
     {
         const auto swapchainDetails = querySwapchainDetails(physicalDevice, surface);
         const auto swapchainExtent = chooseSwapchainExtent(swapchainDetails.surfaceCaps, desiredExtent);
@@ -93,14 +95,14 @@ namespace arsenic
         swapchainCI.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         swapchainCI.preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
         swapchainCI.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        swapchainCI.oldSwapchain = VK_NULL_HANDLE;
+        swapchainCI.oldSwapchain = oldSwapchain;
 
         Swapchain swapchain = {};
         swapchain.imageFormat = swapchainFormat.format;
         swapchain.imageExtent = swapchainExtent;
         swapchain.minImageCount = swapchainCI.minImageCount;
         
-        checkVkResult(vkCreateSwapchainKHR(device, &swapchainCI, nullptr, &swapchain.vkSwapchain));
+        checkVkResult(vkCreateSwapchainKHR(device, &swapchainCI, getHostAllocationCallbacks(HostAllocationTag::Swapchain), &swapchain.vkSwapchain));
 
         checkVkResult(vkGetSwapchainImagesKHR(device, swapchain.vkSwapchain, &swapchain.imageCount, nullptr));
         swapchain.images.resize(swapchain.imageCount);
@@ -114,7 +116,7 @@ namespace arsenic
             imageViewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
             imageViewCI.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
 
-            checkVkResult(vkCreateImageView(device, &imageViewCI, nullptr, &swapchain.imageViews[i]));
+            checkVkResult(vkCreateImageView(device, &imageViewCI, getHostAllocationCallbacks(HostAllocationTag::Swapchain), &swapchain.imageViews[i]));
         }
       
         return std::move(swapchain);
@@ -123,10 +125,10 @@ namespace arsenic
     void destroySwapchain(VkDevice device, Swapchain &swapchain)
     {
         for (auto imageView : swapchain.imageViews) {
-            vkDestroyImageView(device, imageView, nullptr);
+            vkDestroyImageView(device, imageView, getHostAllocationCallbacks(HostAllocationTag::Swapchain));
         }
 
-        vkDestroySwapchainKHR(device, swapchain.vkSwapchain, nullptr);
+        vkDestroySwapchainKHR(device, swapchain.vkSwapchain, getHostAllocationCallbacks(HostAllocationTag::Swapchain));
     } 
 
     uint32_t acquireImageFromSwapchain(const VkDevice device, const VkSemaphore imageReadySemaphore, const Swapchain &swapchain)
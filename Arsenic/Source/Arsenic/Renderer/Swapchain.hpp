@@ -17,7 +17,9 @@ namespace arsenic
         uint32_t imageCount = 0;
     };
 
-    Swapchain createSwapchain(const VkDevice device, const VkSurfaceKHR surface, const VkPhysicalDevice physicalDevice, const VkExtent2D desiredExtent);
+    // Passing the swapchain being replaced as oldSwapchain retires it, it can be destroyed once the frames that used it completed
+    Swapchain createSwapchain(const VkDevice device, const VkSurfaceKHR surface, const VkPhysicalDevice physicalDevice, const VkExtent2D desiredExtent,
+                const VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
     void destroySwapchain(const VkDevice device, Swapchain &swapchain);
 
     uint32_t acquireImageFromSwapchain(const VkDevice, const VkSemaphore imageReadySemaphore, const Swapchain &swapchain);
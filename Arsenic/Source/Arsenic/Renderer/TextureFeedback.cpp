@@ -0,0 +1,71 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/TextureFeedback.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+
+namespace arsenic
+{
+    static constexpr uint32_t unsampledFootprint = 0xffffffff;
+
+    TextureFeedback createTextureFeedback(VulkanContext &vulkanContext)
+    {
+        TextureFeedback textureFeedback = {};
+
+        for (uint32_t i = 0; i != maxFrameInFlight; ++i) {
+            // Read back every frame, so it lives in system memory rather than in the BAR
+            textureFeedback.buffers.value[i] = createBuffer(vulkanContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                    maxBindlessTextures * sizeof(uint32_t));
+            resetTextureFeedback(textureFeedback, i);
+        }
+
+        return textureFeedback;
+    }
+
+    void destroyTextureFeedback(const VulkanContext &vulkanContext, TextureFeedback &textureFeedback)
+    {
+        for (VulkanBuffer &buffer : textureFeedback.buffers.value) {
+            destroyBuffer(vulkanContext, buffer);
+        }
+
+        textureFeedback = {};
+    }
+
+    VkDeviceAddress getTextureFeedbackAddress(const TextureFeedback &textureFeedback, const uint32_t frameIndex)
+    {
+        return textureFeedback.buffers.value[frameIndex].deviceAddress;
+    }
+
+    bool readTextureFootprint(const TextureFeedback &textureFeedback, const uint32_t frameIndex, const int32_t textureIndex, float &uvFootprint)
+    {
+        if (textureIndex < 0) {
+            return false;
+        }
+
+        assert(static_cast<uint32_t>(textureIndex) < maxBindlessTextures);
+
+        uint32_t footprintBits = 0;
+        std::memcpy(&footprintBits, textureFeedback.buffers.value[frameIndex].pMappedPointer + textureIndex * sizeof(uint32_t), sizeof(uint32_t));
+
+        if (footprintBits == unsampledFootprint) {
+            return false;
+        }
+
+        std::memcpy(&uvFootprint, &footprintBits, sizeof(float));
+        return true;
+    }
+
+    void resetTextureFeedback(TextureFeedback &textureFeedback, const uint32_t frameIndex)
+    {
+        std::memset(textureFeedback.buffers.value[frameIndex].pMappedPointer, 0xff, maxBindlessTextures * sizeof(uint32_t));
+    }
+
+    void cmdTextureFeedbackBarrier(const VkCommandBuffer commandBuffer)
+    {
+        VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/Structure.hpp"
+#include "Arsenic/Renderer/BindlessTable.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+
+    // Host visible buffers shaders report texture demand into, one per frame in flight with one entry per bindless texture slot.
+    // An entry holds the bits of the smallest uv distance a pixel covered while sampling the slot, which stay ordered
+    // as unsigned integers for positive floats so shaders can atomicMin them
+    struct TextureFeedback
+    {
+        PerFrame<VulkanBuffer> buffers;
+    };
+
+    TextureFeedback createTextureFeedback(VulkanContext &vulkanContext);
+    void destroyTextureFeedback(const VulkanContext &vulkanContext, TextureFeedback &textureFeedback);
+
+    // Passed to shaders as a buffer reference, entries have to be reset before the frame that writes them is recorded
+    VkDeviceAddress getTextureFeedbackAddress(const TextureFeedback &textureFeedback, const uint32_t frameIndex);
+
+    // Only valid once the GPU is done with frameIndex, returns false when no pixel sampled the slot
+    bool readTextureFootprint(const TextureFeedback &textureFeedback, const uint32_t frameIndex, const int32_t textureIndex, float &uvFootprint);
+    void resetTextureFeedback(TextureFeedback &textureFeedback, const uint32_t frameIndex);
+
+    // Makes the shader writes of a frame visible to readTextureFootprint, record after the last dispatch that reports demand
+    void cmdTextureFeedbackBarrier(const VkCommandBuffer commandBuffer);
+}
\ No newline at end of file
@@ -0,0 +1,552 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Core/ThreadPool.hpp"
+#include "Arsenic/Core/FileSystem.hpp"
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/DeletionQueue.hpp"
+#include "Arsenic/Renderer/Ktx2Loader.hpp"
+#include "Arsenic/Renderer/TextureStreamer.hpp"
+
+#include "stb_image.hpp"
+
+namespace arsenic
+{
+    static bool isSrgbFormat(const VkFormat format)
+    {
+        return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+    }
+
+    static uint8_t linearToSrgb(const float linear)
+    {
+        // Indexed by the linear value quantized to 12 bits, fine enough that averaged 8 bit inputs round trip
+        static const std::array<uint8_t, 4096> table = []() {
+            std::array<uint8_t, 4096> linearToSrgbTable = {};
+
+            for (uint32_t i = 0; i != linearToSrgbTable.size(); ++i) {
+                const float c = static_cast<float>(i) / 4095.0f;
+                const float srgb = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                linearToSrgbTable[i] = static_cast<uint8_t>(srgb * 255.0f + 0.5f);
+            }
+
+            return linearToSrgbTable;
+        }();
+
+        return table[static_cast<uint32_t>(std::clamp(linear, 0.0f, 1.0f) * 4095.0f + 0.5f)];
+    }
+
+    static float srgbToLinear(const uint8_t srgb)
+    {
+        static const std::array<float, 256> table = []() {
+            std::array<float, 256> srgbToLinearTable = {};
+
+            for (uint32_t i = 0; i != srgbToLinearTable.size(); ++i) {
+                const float c = static_cast<float>(i) / 255.0f;
+                srgbToLinearTable[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+
+            return srgbToLinearTable;
+        }();
+
+        return table[srgb];
+    }
+
+    // Box filters RGBA8 texels down to 1x1, odd edges repeat their last texel. Colors of sRGB textures are averaged in linear space
+    static void buildMipChain(const uint8_t *pTexels, const uint32_t width, const uint32_t height, const bool srgb, const bool generateMipLevels,
+                        std::vector<uint8_t> &mipChain, std::vector<ImageMipLevelData> &mipLevels)
+    {
+        const uint32_t mipLevelCount = generateMipLevels ? static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1 : 1;
+
+        VkDeviceSize chainSize = 0;
+        for (uint32_t mipLevel = 0; mipLevel != mipLevelCount; ++mipLevel) {
+            const VkDeviceSize levelSize = 4ull * std::max(width >> mipLevel, 1u) * std::max(height >> mipLevel, 1u);
+            mipLevels.push_back({chainSize, levelSize});
+            chainSize += levelSize;
+        }
+
+        mipChain.resize(static_cast<std::size_t>(chainSize));
+        std::memcpy(mipChain.data(), pTexels, static_cast<std::size_t>(mipLevels[0].layerSize));
+
+        for (uint32_t mipLevel = 1; mipLevel != mipLevelCount; ++mipLevel) {
+            const uint32_t srcWidth = std::max(width >> (mipLevel - 1), 1u);
+            const uint32_t srcHeight = std::max(height >> (mipLevel - 1), 1u);
+            const uint32_t dstWidth = std::max(width >> mipLevel, 1u);
+            const uint32_t dstHeight = std::max(height >> mipLevel, 1u);
+
+            const uint8_t *pSrc = mipChain.data() + mipLevels[mipLevel - 1].offset;
+            uint8_t *pDst = mipChain.data() + mipLevels[mipLevel].offset;
+
+            for (uint32_t y = 0; y != dstHeight; ++y) {
+                const uint32_t y0 = std::min(2 * y, srcHeight - 1);
+                const uint32_t y1 = std::min(2 * y + 1, srcHeight - 1);
+
+                for (uint32_t x = 0; x != dstWidth; ++x) {
+                    const uint32_t x0 = std::min(2 * x, srcWidth - 1);
+                    const uint32_t x1 = std::min(2 * x + 1, srcWidth - 1);
+
+                    const std::array<const uint8_t *, 4> pQuad = {
+                        pSrc + 4 * (y0 * srcWidth + x0), pSrc + 4 * (y0 * srcWidth + x1),
+                        pSrc + 4 * (y1 * srcWidth + x0), pSrc + 4 * (y1 * srcWidth + x1)
+                    };
+
+                    uint8_t *pTexel = pDst + 4 * (y * dstWidth + x);
+
+                    for (uint32_t channel = 0; channel != 4; ++channel) {
+                        // Alpha is always linear
+                        if (srgb && channel != 3) {
+                            float sum = 0.0f;
+                            for (const uint8_t *pQuadTexel : pQuad) {
+                                sum += srgbToLinear(pQuadTexel[channel]);
+                            }
+
+                            pTexel[channel] = linearToSrgb(sum * 0.25f);
+                        }
+                        else {
+                            uint32_t sum = 2;
+                            for (const uint8_t *pQuadTexel : pQuad) {
+                                sum += pQuadTexel[channel];
+                            }
+
+                            pTexel[channel] = static_cast<uint8_t>(sum / 4);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // The first level no larger than textureMipTailSize in either dimension, or the last level when the chain stops before that
+    static uint32_t getMipTailLevel(const uint32_t width, const uint32_t height, const uint32_t mipLevelCount)
+    {
+        uint32_t mipLevel = 0;
+        while (mipLevel + 1 < mipLevelCount && std::max(width >> mipLevel, height >> mipLevel) > textureMipTailSize) {
+            ++mipLevel;
+        }
+
+        return mipLevel;
+    }
+
+    // Bytes of firstMipLevel and every level below it
+    static VkDeviceSize getMipLevelsSize(const std::vector<ImageMipLevelData> &mipLevels, const uint32_t firstMipLevel)
+    {
+        const ImageMipLevelData &lastMipLevel = mipLevels.back();
+        return lastMipLevel.offset + lastMipLevel.layerSize - mipLevels[firstMipLevel].offset;
+    }
+
+    TextureStreamer::TextureStreamer() = default;
+    TextureStreamer::~TextureStreamer() = default;
+
+    void TextureStreamer::initialize(VulkanContext &vulkanContext, const uint32_t workerCount, const VkDeviceSize streamingBudget,
+                                const VkDeviceSize residencyBudget)
+    {
+        assert(!m_threadPool);
+
+        m_threadPool = std::make_unique<ThreadPool>(workerCount);
+        m_streamingBudget = streamingBudget;
+        m_residencyBudget = residencyBudget;
+
+        const uint32_t whiteTexel = 0xffffffff;
+
+        VulkanImageDesc placeholderDesc = VulkanImageDesc::create(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, 
+                                            {1, 1, 1}, VK_FORMAT_R8G8B8A8_UNORM, 1, false);
+
+        UploadBatch uploadBatch = beginUploadBatch(vulkanContext, sizeof(whiteTexel));
+        m_placeholder = createImage2D(vulkanContext, placeholderDesc);
+        uploadImage(vulkanContext, uploadBatch, m_placeholder, &whiteTexel, sizeof(whiteTexel), false);
+        submitUploadBatch(vulkanContext, uploadBatch);
+        destroyUploadBatch(vulkanContext, uploadBatch);
+
+        m_placeholder.vkImageView = createImageView(vulkanContext, m_placeholder.vkImage, VK_IMAGE_VIEW_TYPE_2D, m_placeholder.format, 
+                                        VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1);
+    }
+
+    void TextureStreamer::deInitialize(const VulkanContext &vulkanContext)
+    {
+        // Joining the workers first guarantees nothing pushes into m_decodedTextures anymore
+        m_threadPool.reset();
+        m_decodedTextures.clear();
+
+        for (InFlightUpload &inFlightUpload : m_inFlightUploads) {
+            destroyUploadBatch(vulkanContext, inFlightUpload.uploadBatch);
+        }
+
+        m_inFlightUploads.clear();
+
+        for (StreamedTexture &streamedTexture : m_textures) {
+            if (streamedTexture.image.vkImage) {
+                destroyImage(vulkanContext, streamedTexture.image);
+            }
+
+            if (streamedTexture.pendingImage.vkImage) {
+                destroyImage(vulkanContext, streamedTexture.pendingImage);
+            }
+        }
+
+        m_textures.clear();
+        m_streamedBytes = 0;
+        m_residentBytes = 0;
+
+        destroyImage(vulkanContext, m_placeholder);
+    }
+
+    TextureHandle TextureStreamer::requestTexture(const std::string &imageFilePath, const VkFormat format, const bool generateMipLevels)
+    {
+        assert(m_threadPool);
+
+        StreamedTexture &streamedTexture = m_textures.emplace_back();
+        streamedTexture.filePath = imageFilePath;
+        streamedTexture.format = format;
+        streamedTexture.generateMipLevels = generateMipLevels;
+        streamedTexture.state = TextureState::Decoding;
+        streamedTexture.image = {};
+
+        const TextureHandle textureHandle = static_cast<TextureHandle>(m_textures.size());
+
+        // Paging starts now, so the worker rarely waits on the disk once it picks the request up
+        prefetchFile(imageFilePath.c_str());
+
+        m_threadPool->enqueue([this, textureHandle, imageFilePath, format, generateMipLevels]() {
+            // Cooked textures carry their format and mip chain, they are copied as is
+            if (std::filesystem::path(imageFilePath).extension() == ".ktx2") {
+                Ktx2ImageInfo imageInfo = {};
+                DecodedTexture decodedTexture = {textureHandle, format, 0, 0, {}, {}};
+
+                if (readKtx2MipChain(imageFilePath.c_str(), imageInfo, decodedTexture.mipChain, decodedTexture.mipLevels)) {
+                    decodedTexture.format = imageInfo.format;
+                    decodedTexture.width = imageInfo.extent.width;
+                    decodedTexture.height = imageInfo.extent.height;
+                }
+                else {
+                    ARSENIC_WARN("Failed to read {}, it has to be a valid 2D KTX2 file with its mip levels", imageFilePath);
+                }
+
+                std::lock_guard<std::mutex> lock(m_decodedMutex);
+                m_decodedTextures.push_back(std::move(decodedTexture));
+                return;
+            }
+
+            int width = 0;
+            int height = 0;
+            int numChannel = 0;
+
+            const FileView file = readFile(imageFilePath.c_str());
+            stbi_uc *pRawImageData = nullptr;
+
+            if (!file.isValid()) {
+                ARSENIC_WARN("Failed to open {}", imageFilePath);
+            }
+            else if ((pRawImageData = stbi_load_from_memory(file.pData, static_cast<int>(file.size), &width, &height, &numChannel, STBI_rgb_alpha)) == nullptr) {
+                ARSENIC_WARN("Failed to decode {}: {}", imageFilePath, stbi_failure_reason());
+            }
+
+            DecodedTexture decodedTexture = {textureHandle, format, static_cast<uint32_t>(width), static_cast<uint32_t>(height), {}, {}};
+
+            // The whole chain is built here so the update thread only ever copies levels into staging memory
+            if (pRawImageData != nullptr) {
+                buildMipChain(pRawImageData, decodedTexture.width, decodedTexture.height, isSrgbFormat(format), generateMipLevels, 
+                            decodedTexture.mipChain, decodedTexture.mipLevels);
+                stbi_image_free(pRawImageData);
+            }
+
+            std::lock_guard<std::mutex> lock(m_decodedMutex);
+            m_decodedTextures.push_back(std::move(decodedTexture));
+        });
+
+        return textureHandle;
+    }
+
+    void TextureStreamer::reportTextureFootprint(const TextureHandle textureHandle, const float uvFootprint)
+    {
+        StreamedTexture &streamedTexture = getTexture(textureHandle);
+
+        // Still decoding or failed, there is no chain to pick a level from yet
+        if (streamedTexture.mipLevels.empty()) {
+            return;
+        }
+
+        const float lastMipLevel = static_cast<float>(streamedTexture.mipLevels.size() - 1);
+        const float texelsPerPixel = uvFootprint * static_cast<float>(std::max(streamedTexture.width, streamedTexture.height));
+
+        streamedTexture.requestedMipLevel = texelsPerPixel > 1.0f ? static_cast<uint32_t>(std::min(std::log2(texelsPerPixel), lastMipLevel)) : 0;
+        streamedTexture.lastRequestUpdate = m_updateIndex;
+    }
+
+    std::vector<TextureHandle> TextureStreamer::update(VulkanContext &vulkanContext, DeletionQueue &deletionQueue)
+    {
+        std::vector<TextureHandle> changedTextures;
+        ++m_updateIndex;
+
+        // Batches complete in submission order, so the first one still pending ends the scan
+        auto firstPending = std::find_if(m_inFlightUploads.begin(), m_inFlightUploads.end(), [&](const InFlightUpload &inFlightUpload) {
+            return !isUploadComplete(vulkanContext, inFlightUpload.uploadBatch.token);
+        });
+
+        for (auto it = m_inFlightUploads.begin(); it != firstPending; ++it) {
+            for (const TextureHandle textureHandle : it->textureHandles) {
+                StreamedTexture &streamedTexture = getTexture(textureHandle);
+
+                // Frames already submitted may still sample the old image, the ones recorded from now on see the new view
+                if (streamedTexture.image.vkImage) {
+                    deferDestroyImage(deletionQueue, streamedTexture.image, vulkanContext.graphicsTimeline.submittedValue);
+                }
+
+                streamedTexture.image = streamedTexture.pendingImage;
+                streamedTexture.pendingImage = {};
+                streamedTexture.image.vkImageView = createImageView(vulkanContext, streamedTexture.image.vkImage, VK_IMAGE_VIEW_TYPE_2D, 
+                                                        streamedTexture.format, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 
+                                                        streamedTexture.image.mipLevels);
+                streamedTexture.residentMipLevel = streamedTexture.pendingMipLevel;
+                streamedTexture.state = TextureState::Resident;
+
+                changedTextures.push_back(textureHandle);
+            }
+
+            retireUploadBatch(vulkanContext, deletionQueue, it->uploadBatch);
+        }
+
+        m_inFlightUploads.erase(m_inFlightUploads.begin(), firstPending);
+
+        // Take what fits in the budget under the lock, only the mip tail is uploaded so that is what counts against it
+        std::vector<DecodedTexture> decodedTextures;
+        {
+            std::lock_guard<std::mutex> lock(m_decodedMutex);
+            VkDeviceSize takenBytes = 0;
+
+            while (!m_decodedTextures.empty()) {
+                const DecodedTexture &decodedTexture = m_decodedTextures.front();
+                const VkDeviceSize textureBytes = decodedTexture.mipLevels.empty() ? 0 : 
+                                                getMipLevelsSize(decodedTexture.mipLevels, getMipTailLevel(decodedTexture.width, 
+                                                    decodedTexture.height, static_cast<uint32_t>(decodedTexture.mipLevels.size())));
+
+                // Always take at least one texture, otherwise one larger than the budget would never be streamed
+                if (!decodedTextures.empty() && takenBytes + textureBytes > m_streamingBudget) {
+                    break;
+                }
+
+                takenBytes += textureBytes;
+                decodedTextures.push_back(std::move(m_decodedTextures.front()));
+                m_decodedTextures.pop_front();
+            }
+        }
+
+        // The batch is only begun by the first upload, most updates have nothing to upload
+        InFlightUpload inFlightUpload = {};
+        VkDeviceSize uploadedBytes = 0;
+
+        for (DecodedTexture &decodedTexture : decodedTextures) {
+            StreamedTexture &streamedTexture = getTexture(decodedTexture.textureHandle);
+
+            if (decodedTexture.mipChain.empty()) {
+                streamedTexture.state = TextureState::Failed;
+                continue;
+            }
+
+            // Only cooked files pick their own format, block compressed ones are not supported everywhere
+            if (decodedTexture.format != streamedTexture.format && vulkanContext.findSupportedFormat({decodedTexture.format}, 
+                    VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT) == VK_FORMAT_UNDEFINED) {
+                ARSENIC_WARN("{} is stored in a format the device cannot sample", streamedTexture.filePath);
+                streamedTexture.state = TextureState::Failed;
+                continue;
+            }
+
+            streamedTexture.format = decodedTexture.format;
+            streamedTexture.width = decodedTexture.width;
+            streamedTexture.height = decodedTexture.height;
+            streamedTexture.mipChain = std::move(decodedTexture.mipChain);
+            streamedTexture.mipLevels = std::move(decodedTexture.mipLevels);
+            streamedTexture.mipTailLevel = getMipTailLevel(streamedTexture.width, streamedTexture.height, 
+                                                static_cast<uint32_t>(streamedTexture.mipLevels.size()));
+            streamedTexture.requestedMipLevel = streamedTexture.mipTailLevel;
+            streamedTexture.state = TextureState::Uploading;
+
+            uploadedBytes += uploadMipLevels(vulkanContext, inFlightUpload, decodedTexture.textureHandle, streamedTexture.mipTailLevel);
+        }
+
+        // Textures holding less than they want are promoted, the ones furthest from their wanted level first.
+        // Textures holding more than they want are only evicted when a promotion would not fit in the residency budget otherwise,
+        // the ones requested the longest time ago first
+        std::vector<TextureHandle> promotions;
+        std::vector<TextureHandle> evictionCandidates;
+
+        for (uint32_t i = 0; i != m_textures.size(); ++i) {
+            const StreamedTexture &streamedTexture = m_textures[i];
+
+            if (streamedTexture.state != TextureState::Resident || streamedTexture.pendingImage.vkImage) {
+                continue;
+            }
+
+            const uint32_t wantedMipLevel = getWantedMipLevel(streamedTexture);
+
+            if (wantedMipLevel < streamedTexture.residentMipLevel) {
+                promotions.push_back(static_cast<TextureHandle>(i + 1));
+            }
+            else if (wantedMipLevel > streamedTexture.residentMipLevel) {
+                evictionCandidates.push_back(static_cast<TextureHandle>(i + 1));
+            }
+        }
+
+        std::sort(promotions.begin(), promotions.end(), [this](const TextureHandle a, const TextureHandle b) {
+            const StreamedTexture &textureA = getTexture(a);
+            const StreamedTexture &textureB = getTexture(b);
+
+            return textureA.residentMipLevel - getWantedMipLevel(textureA) > textureB.residentMipLevel - getWantedMipLevel(textureB);
+        });
+
+        std::sort(evictionCandidates.begin(), evictionCandidates.end(), [this](const TextureHandle a, const TextureHandle b) {
+            return getTexture(a).lastRequestUpdate < getTexture(b).lastRequestUpdate;
+        });
+
+        auto nextEviction = evictionCandidates.begin();
+
+        for (const TextureHandle textureHandle : promotions) {
+            if (uploadedBytes >= m_streamingBudget) {
+                break;
+            }
+
+            const StreamedTexture &streamedTexture = getTexture(textureHandle);
+            uint32_t mipLevel = getWantedMipLevel(streamedTexture);
+
+            // Levels are added one at a time when the whole way up does not fit in what is left of the streaming budget
+            while (mipLevel + 1 < streamedTexture.residentMipLevel && 
+                    uploadedBytes + getMipLevelsSize(streamedTexture.mipLevels, mipLevel) > m_streamingBudget) {
+                ++mipLevel;
+            }
+
+            const VkDeviceSize promotedBytes = getMipLevelsSize(streamedTexture.mipLevels, mipLevel);
+            const VkDeviceSize addedBytes = promotedBytes - getMipLevelsSize(streamedTexture.mipLevels, streamedTexture.residentMipLevel);
+
+            // Even a single level may not fit in what is left, one larger than the whole budget still goes alone in an update
+            if (uploadedBytes != 0 && uploadedBytes + promotedBytes > m_streamingBudget) {
+                continue;
+            }
+
+            // An eviction uploads the levels the texture keeps, so it is paid from the streaming budget together with the promotion
+            // it makes room for
+            while (m_residentBytes + addedBytes > m_residencyBudget && nextEviction != evictionCandidates.end()) {
+                const StreamedTexture &evictedTexture = getTexture(*nextEviction);
+                const VkDeviceSize evictedBytes = getMipLevelsSize(evictedTexture.mipLevels, getWantedMipLevel(evictedTexture));
+
+                if (uploadedBytes + evictedBytes + promotedBytes > m_streamingBudget) {
+                    break;
+                }
+
+                const TextureHandle evictedHandle = *nextEviction++;
+                uploadedBytes += uploadMipLevels(vulkanContext, inFlightUpload, evictedHandle, getWantedMipLevel(getTexture(evictedHandle)));
+            }
+
+            if (m_residentBytes + addedBytes > m_residencyBudget) {
+                continue;
+            }
+
+            uploadedBytes += uploadMipLevels(vulkanContext, inFlightUpload, textureHandle, mipLevel);
+        }
+
+        if (inFlightUpload.textureHandles.empty()) {
+            return changedTextures;
+        }
+
+        submitUploadBatch(vulkanContext, inFlightUpload.uploadBatch);
+        m_inFlightUploads.push_back(std::move(inFlightUpload));
+
+        return changedTextures;
+    }
+
+    VkImageView TextureStreamer::getImageView(const TextureHandle textureHandle) const
+    {
+        const StreamedTexture &streamedTexture = getTexture(textureHandle);
+
+        return streamedTexture.state == TextureState::Resident ? streamedTexture.image.vkImageView : m_placeholder.vkImageView;
+    }
+
+    bool TextureStreamer::isResident(const TextureHandle textureHandle) const
+    {
+        return getTexture(textureHandle).state == TextureState::Resident;
+    }
+
+    TextureStreamingStats TextureStreamer::getStats() const
+    {
+        TextureStreamingStats stats = {};
+        stats.streamedBytes = m_streamedBytes;
+        stats.residentBytes = m_residentBytes;
+
+        for (const StreamedTexture &streamedTexture : m_textures) {
+            switch (streamedTexture.state) {
+            case TextureState::Decoding:
+                ++stats.decodingCount;
+                break;
+            case TextureState::Uploading:
+                ++stats.uploadingCount;
+                break;
+            case TextureState::Resident:
+                ++stats.residentCount;
+                break;
+            case TextureState::Failed:
+                ++stats.failedCount;
+                break;
+            }
+        }
+
+        return stats;
+    }
+
+    uint32_t TextureStreamer::getWantedMipLevel(const StreamedTexture &streamedTexture) const
+    {
+        if (m_updateIndex - streamedTexture.lastRequestUpdate > textureRequestLifetime) {
+            return streamedTexture.mipTailLevel;
+        }
+
+        return std::min(streamedTexture.requestedMipLevel, streamedTexture.mipTailLevel);
+    }
+
+    VkDeviceSize TextureStreamer::uploadMipLevels(VulkanContext &vulkanContext, InFlightUpload &inFlightUpload, const TextureHandle textureHandle, 
+                                            const uint32_t mipLevel)
+    {
+        StreamedTexture &streamedTexture = getTexture(textureHandle);
+        assert(!streamedTexture.pendingImage.vkImage && mipLevel < streamedTexture.mipLevels.size());
+
+        VulkanImageDesc imageDesc = VulkanImageDesc::create(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, 
+                                        {std::max(streamedTexture.width >> mipLevel, 1u), std::max(streamedTexture.height >> mipLevel, 1u), 1}, 
+                                        streamedTexture.format, 1, false);
+        imageDesc.mipLevelCount = static_cast<uint32_t>(streamedTexture.mipLevels.size()) - mipLevel;
+
+        // Offsets are rebased onto the first uploaded level, the levels below it follow it in the chain
+        const VkDeviceSize baseOffset = streamedTexture.mipLevels[mipLevel].offset;
+        const VkDeviceSize uploadSize = getMipLevelsSize(streamedTexture.mipLevels, mipLevel);
+
+        std::vector<ImageMipLevelData> mipLevels(streamedTexture.mipLevels.begin() + mipLevel, streamedTexture.mipLevels.end());
+        for (ImageMipLevelData &mipLevelData : mipLevels) {
+            mipLevelData.offset -= baseOffset;
+        }
+
+        if (inFlightUpload.textureHandles.empty()) {
+            inFlightUpload.uploadBatch = beginUploadBatch(vulkanContext);
+        }
+
+        streamedTexture.pendingImage = createImage2D(vulkanContext, imageDesc);
+        streamedTexture.pendingMipLevel = mipLevel;
+        uploadImageMipLevels(vulkanContext, inFlightUpload.uploadBatch, streamedTexture.pendingImage, streamedTexture.mipChain.data() + baseOffset,
+                        uploadSize, mipLevels);
+
+        // Counted as if the swap had already happened, so an eviction makes room in the residency budget right away
+        const VkDeviceSize replacedSize = streamedTexture.image.vkImage ? getMipLevelsSize(streamedTexture.mipLevels, streamedTexture.residentMipLevel) : 0;
+        m_residentBytes = m_residentBytes + uploadSize - replacedSize;
+        m_streamedBytes += uploadSize;
+
+        inFlightUpload.textureHandles.push_back(textureHandle);
+
+        return uploadSize;
+    }
+
+    TextureStreamer::StreamedTexture &TextureStreamer::getTexture(const TextureHandle textureHandle)
+    {
+        assert(textureHandle != invalidHandle && static_cast<uint32_t>(textureHandle) <= m_textures.size());
+
+        return m_textures[static_cast<uint32_t>(textureHandle) - 1];
+    }
+
+    const TextureStreamer::StreamedTexture &TextureStreamer::getTexture(const TextureHandle textureHandle) const
+    {
+        assert(textureHandle != invalidHandle && static_cast<uint32_t>(textureHandle) <= m_textures.size());
+
+        return m_textures[static_cast<uint32_t>(textureHandle) - 1];
+    }
+}
\ No newline at end of file
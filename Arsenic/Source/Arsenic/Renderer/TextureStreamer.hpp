@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanImage.hpp"
+#include "Arsenic/Renderer/UploadBatch.hpp"
+#include "Arsenic/Renderer/Handle.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    struct DeletionQueue;
+    class ThreadPool;
+
+    // Bytes of decoded texel data handed to the GPU per update, keeps a burst of requests from stalling a frame
+    constexpr VkDeviceSize defaultTextureStreamingBudget = 32 * 1024 * 1024;
+    // Device memory the streamed images may occupy together, finer mips nobody asked for recently are evicted to stay below it
+    constexpr VkDeviceSize defaultTextureResidencyBudget = 256 * 1024 * 1024;
+    // Levels no larger than this in either dimension form the mip tail, which is uploaded as soon as a texture is decoded
+    constexpr uint32_t textureMipTailSize = 64;
+    // Updates a texture keeps its requested level after its last footprint report
+    constexpr uint64_t textureRequestLifetime = 120;
+
+    struct TextureStreamingStats
+    {
+        uint32_t decodingCount;
+        uint32_t uploadingCount;
+        uint32_t residentCount;
+        uint32_t failedCount;
+        VkDeviceSize streamedBytes;
+        VkDeviceSize residentBytes;
+    };
+
+    // Decodes image files or reads cooked KTX2 files on a worker pool and uploads them without blocking the calling thread.
+    // requestTexture returns a handle right away, sampling it yields a 1x1 white placeholder until the mip tail
+    // has been uploaded. Finer levels follow once reportTextureFootprint asks for them, each time the texture gets an image
+    // holding the requested level and everything below it, built from the full mip chain the streamer keeps in system memory
+    class TextureStreamer
+    {
+    public:
+        TextureStreamer();
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer &) = delete;
+        TextureStreamer &operator=(const TextureStreamer &) = delete;
+        TextureStreamer(TextureStreamer &&) = delete;
+        TextureStreamer &operator=(TextureStreamer &&) = delete;
+
+        // workerCount of 0 uses one worker per hardware thread but the main one
+        void initialize(VulkanContext &vulkanContext, const uint32_t workerCount = 0, 
+                    const VkDeviceSize streamingBudget = defaultTextureStreamingBudget,
+                    const VkDeviceSize residencyBudget = defaultTextureResidencyBudget);
+        void deInitialize(const VulkanContext &vulkanContext);
+
+        // A .ktx2 file as written by ArsenicCooker is streamed in its own format with its own mip chain, format and generateMipLevels
+        // only apply to the images stb decodes
+        TextureHandle requestTexture(const std::string &imageFilePath, const VkFormat format = VK_FORMAT_R8G8B8A8_SRGB, 
+                    const bool generateMipLevels = true);
+
+        // uvFootprint is the uv distance one pixel covers where the texture is sampled, e.g. read back from TextureFeedback.
+        // Picks the level whose texels are no smaller than a pixel, which the next update streams in
+        void reportTextureFootprint(const TextureHandle textureHandle, const float uvFootprint);
+
+        // Swaps in uploads that have completed, uploads the mip tail of whatever finished decoding, then promotes textures
+        // to their requested level and evicts levels to stay within the residency budget.
+        // Returns the handles whose image view changed during this call, their descriptors have to be rewritten before
+        // the next submission samples them since the images they replace are retired right away
+        std::vector<TextureHandle> update(VulkanContext &vulkanContext, DeletionQueue &deletionQueue);
+
+        VkImageView getImageView(const TextureHandle textureHandle) const;
+        bool isResident(const TextureHandle textureHandle) const;
+        TextureStreamingStats getStats() const;
+    private:
+        enum class TextureState
+        {
+            Decoding,
+            Uploading,
+            Resident,
+            Failed
+        };
+
+        struct StreamedTexture
+        {
+            std::string filePath;
+            VkFormat format;
+            bool generateMipLevels;
+            TextureState state;
+            VulkanImage image;
+
+            uint32_t width = 0;
+            uint32_t height = 0;
+            // Every level of the texture, tightly packed from mip 0 down, images are filled from a suffix of it
+            std::vector<uint8_t> mipChain;
+            std::vector<ImageMipLevelData> mipLevels;
+            uint32_t mipTailLevel = 0;
+
+            // Level of the full chain that mip 0 of image holds
+            uint32_t residentMipLevel = 0;
+            uint32_t requestedMipLevel = 0;
+            uint64_t lastRequestUpdate = 0;
+
+            // Image being uploaded to replace image, pendingMipLevel is what its mip 0 will hold
+            VulkanImage pendingImage = {};
+            uint32_t pendingMipLevel = 0;
+        };
+
+        struct DecodedTexture
+        {
+            TextureHandle textureHandle;
+            VkFormat format;
+            uint32_t width;
+            uint32_t height;
+            std::vector<uint8_t> mipChain;
+            std::vector<ImageMipLevelData> mipLevels;
+        };
+
+        struct InFlightUpload
+        {
+            UploadBatch uploadBatch;
+            std::vector<TextureHandle> textureHandles;
+        };
+
+        StreamedTexture &getTexture(const TextureHandle textureHandle);
+        const StreamedTexture &getTexture(const TextureHandle textureHandle) const;
+
+        // The level a texture should hold now, its mip tail unless a footprint was reported recently
+        uint32_t getWantedMipLevel(const StreamedTexture &streamedTexture) const;
+        // Creates the pending image holding mipLevel and everything below it, adds its upload to inFlightUpload and returns its size
+        VkDeviceSize uploadMipLevels(VulkanContext &vulkanContext, InFlightUpload &inFlightUpload, const TextureHandle textureHandle, 
+                                const uint32_t mipLevel);
+    private:
+        std::unique_ptr<ThreadPool> m_threadPool;
+        VkDeviceSize m_streamingBudget = defaultTextureStreamingBudget;
+        VkDeviceSize m_residencyBudget = defaultTextureResidencyBudget;
+
+        VulkanImage m_placeholder = {};
+        std::vector<StreamedTexture> m_textures;
+        std::vector<InFlightUpload> m_inFlightUploads;
+        VkDeviceSize m_streamedBytes = 0;
+        // Bytes the streamed images occupy once every pending upload has been swapped in
+        VkDeviceSize m_residentBytes = 0;
+        uint64_t m_updateIndex = 0;
+
+        // Filled by the workers, drained by update on the thread that owns the streamer
+        std::mutex m_decodedMutex;
+        std::deque<DecodedTexture> m_decodedTextures;
+    };
+}
\ No newline at end of file
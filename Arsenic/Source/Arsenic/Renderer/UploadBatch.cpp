@@ -0,0 +1,329 @@
+#include "Arsenic/Arsenicpch.hpp"
+
+#include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/DeletionQueue.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/UploadBatch.hpp"
+
+namespace arsenic
+{
+    // Buffer copies have no alignment requirement, this one keeps them friendly to the copy engine
+    static constexpr VkDeviceSize stagingAlignment = 16;
+
+    // vkCmdCopyBufferToImage wants bufferOffset to be a multiple of both 4 and the texel block size, 12 byte texels included
+    static VkDeviceSize getImageStagingAlignment(const VkFormat format)
+    {
+        const uint32_t texelBlockSize = getFormatTexelBlockSize(format);
+        assert(texelBlockSize != 0);
+
+        return std::lcm(VkDeviceSize(texelBlockSize), stagingAlignment);
+    }
+
+    static UploadBatch::StagingRange reserveStaging(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VkDeviceSize size, 
+                                        const VkDeviceSize alignment, uint8_t *&pStagingData)
+    {
+        assert(uploadBatch.token.timelineValue == 0);
+
+        VkDeviceSize offset = (uploadBatch.stagingHead + alignment - 1) / alignment * alignment;
+
+        if (uploadBatch.stagingBuffers.empty() || offset + size > uploadBatch.stagingBuffers.back().size) {
+            uploadBatch.stagingBuffers.push_back(createBuffer(vulkanContext, 0, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                    std::max(uploadBatch.stagingChunkSize, size)));
+            offset = 0;
+        }
+
+        VulkanBuffer &stagingBuffer = uploadBatch.stagingBuffers.back();
+        pStagingData = stagingBuffer.pMappedPointer + offset;
+
+        uploadBatch.stagingHead = offset + size;
+        uploadBatch.uploadedBytes += size;
+
+        return {stagingBuffer.vkBuffer, offset};
+    }
+
+    static UploadBatch::StagingRange stageData(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const void *pData, const VkDeviceSize size,
+                                    const VkDeviceSize alignment)
+    {
+        uint8_t *pStagingData = nullptr;
+        const UploadBatch::StagingRange stagingRange = reserveStaging(vulkanContext, uploadBatch, size, alignment, pStagingData);
+        std::memcpy(pStagingData, pData, size);
+
+        return stagingRange;
+    }
+
+    UploadBatch beginUploadBatch(const VulkanContext &vulkanContext, const VkDeviceSize stagingChunkSize)
+    {
+        UploadBatch uploadBatch = {};
+        uploadBatch.stagingChunkSize = stagingChunkSize;
+
+        VkCommandPoolCreateInfo commandPoolCI = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        commandPoolCI.queueFamilyIndex = vulkanContext.physicalDevice.queueFamilies.graphicsFamily.value();
+        commandPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        checkVkResult(vkCreateCommandPool(vulkanContext.device, &commandPoolCI, getHostAllocationCallbacks(HostAllocationTag::Command), 
+                        &uploadBatch.commandPool));
+
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        commandBufferAllocateInfo.commandPool = uploadBatch.commandPool;
+        commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        commandBufferAllocateInfo.commandBufferCount = 1;
+        checkVkResult(vkAllocateCommandBuffers(vulkanContext.device, &commandBufferAllocateInfo, &uploadBatch.commandBuffer));
+
+        return uploadBatch;
+    }
+
+    void uploadBuffer(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanBuffer &dstBuffer, const VkDeviceSize dstOffset,
+                const void *pData, const VkDeviceSize size)
+    {
+        assert(dstOffset + size <= dstBuffer.size);
+
+        UploadBatch::BufferUpload bufferUpload = {};
+        bufferUpload.staging = stageData(vulkanContext, uploadBatch, pData, size, stagingAlignment);
+        bufferUpload.dstBuffer = dstBuffer.vkBuffer;
+        bufferUpload.dstOffset = dstOffset;
+        bufferUpload.size = size;
+
+        uploadBatch.bufferUploads.push_back(bufferUpload);
+    }
+
+    void *reserveImageUpload(VulkanContext &vulkanContext, UploadBatch &uploadBatch, VulkanImage &vulkanImage, const VkDeviceSize layerSize, 
+                const bool generateMipLevels)
+    {
+        uint8_t *pStagingData = nullptr;
+
+        UploadBatch::ImageUpload imageUpload = {};
+        imageUpload.staging = reserveStaging(vulkanContext, uploadBatch, layerSize * vulkanImage.arrayLayers, getImageStagingAlignment(vulkanImage.format), 
+                                pStagingData);
+        imageUpload.image = vulkanImage.vkImage;
+        imageUpload.format = vulkanImage.format;
+        imageUpload.usage = vulkanImage.usage;
+        imageUpload.extent = vulkanImage.extent;
+        imageUpload.arrayLayers = vulkanImage.arrayLayers;
+        imageUpload.mipLevels = vulkanImage.mipLevels;
+        imageUpload.mipLevelData.push_back({0, layerSize});
+        imageUpload.generateMipLevels = generateMipLevels && vulkanImage.mipLevels > 1;
+        imageUpload.downsampleMipLevels = imageUpload.generateMipLevels && uploadBatch.pMipDownsampler != nullptr && 
+                                          (vulkanImage.usage & VK_IMAGE_USAGE_STORAGE_BIT) != 0 && 
+                                          std::max(vulkanImage.extent.width, vulkanImage.extent.height) <= maxDownsampleExtent;
+        imageUpload.generateMipLevels = imageUpload.generateMipLevels && !imageUpload.downsampleMipLevels;
+
+        uploadBatch.imageUploads.push_back(imageUpload);
+
+        vulkanImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        return pStagingData;
+    }
+
+    void uploadImage(VulkanContext &vulkanContext, UploadBatch &uploadBatch, VulkanImage &vulkanImage, const void *pData, 
+                const VkDeviceSize layerSize, const bool generateMipLevels)
+    {
+        void *pStagingData = reserveImageUpload(vulkanContext, uploadBatch, vulkanImage, layerSize, generateMipLevels);
+        std::memcpy(pStagingData, pData, layerSize * vulkanImage.arrayLayers);
+    }
+
+    void uploadImageMipLevels(VulkanContext &vulkanContext, UploadBatch &uploadBatch, VulkanImage &vulkanImage, const void *pData, 
+                const VkDeviceSize size, const std::vector<ImageMipLevelData> &mipLevels)
+    {
+        assert(mipLevels.size() == vulkanImage.mipLevels);
+
+        UploadBatch::ImageUpload imageUpload = {};
+        imageUpload.staging = stageData(vulkanContext, uploadBatch, pData, size, getImageStagingAlignment(vulkanImage.format));
+        imageUpload.image = vulkanImage.vkImage;
+        imageUpload.format = vulkanImage.format;
+        imageUpload.usage = vulkanImage.usage;
+        imageUpload.extent = vulkanImage.extent;
+        imageUpload.arrayLayers = vulkanImage.arrayLayers;
+        imageUpload.mipLevels = vulkanImage.mipLevels;
+        imageUpload.mipLevelData = mipLevels;
+        imageUpload.generateMipLevels = false;
+        imageUpload.downsampleMipLevels = false;
+
+        for (const ImageMipLevelData &mipLevel : mipLevels) {
+            assert(mipLevel.offset + mipLevel.layerSize * vulkanImage.arrayLayers <= size);
+            // Relative offsets only need what the copy requires, the staging range itself is aligned further
+            assert(mipLevel.offset % std::lcm(VkDeviceSize(getFormatTexelBlockSize(vulkanImage.format)), VkDeviceSize(4)) == 0);
+            (void)mipLevel;
+        }
+
+        uploadBatch.imageUploads.push_back(std::move(imageUpload));
+
+        vulkanImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    UploadToken submitUploadBatch(VulkanContext &vulkanContext, UploadBatch &uploadBatch)
+    {
+        assert(uploadBatch.token.timelineValue == 0);
+
+        const VkCommandBuffer commandBuffer = uploadBatch.commandBuffer;
+
+        VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        checkVkResult(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+
+        for (const UploadBatch::BufferUpload &bufferUpload : uploadBatch.bufferUploads) {
+            VkBufferCopy bufferCopy = {};
+            bufferCopy.srcOffset = bufferUpload.staging.offset;
+            bufferCopy.dstOffset = bufferUpload.dstOffset;
+            bufferCopy.size = bufferUpload.size;
+
+            vkCmdCopyBuffer(commandBuffer, bufferUpload.staging.buffer, bufferUpload.dstBuffer, 1, &bufferCopy);
+        }
+
+        std::vector<VkImageMemoryBarrier> imageMemoryBarriers;
+        imageMemoryBarriers.reserve(uploadBatch.imageUploads.size());
+
+        for (const UploadBatch::ImageUpload &imageUpload : uploadBatch.imageUploads) {
+            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+            imageMemoryBarrier.image = imageUpload.image;
+            imageMemoryBarrier.srcAccessMask = 0;
+            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+            imageMemoryBarrier.subresourceRange.layerCount = imageUpload.arrayLayers;
+            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+            imageMemoryBarrier.subresourceRange.levelCount = imageUpload.mipLevels;
+            imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            imageMemoryBarriers.push_back(imageMemoryBarrier);
+        }
+
+        if (!imageMemoryBarriers.empty()) {
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 
+                            0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageMemoryBarriers.size()), imageMemoryBarriers.data());
+        }
+
+        std::vector<VkBufferImageCopy> bufferImageCopies;
+
+        for (const UploadBatch::ImageUpload &imageUpload : uploadBatch.imageUploads) {
+            bufferImageCopies.clear();
+
+            for (uint32_t mipLevel = 0; mipLevel != imageUpload.mipLevelData.size(); ++mipLevel) {
+                const ImageMipLevelData &mipLevelData = imageUpload.mipLevelData[mipLevel];
+
+                for (uint32_t i = 0; i != imageUpload.arrayLayers; ++i) {
+                    VkBufferImageCopy bufferImageCopy = {};
+                    bufferImageCopy.bufferOffset = imageUpload.staging.offset + mipLevelData.offset + i * mipLevelData.layerSize;
+                    bufferImageCopy.imageExtent = {std::max(imageUpload.extent.width >> mipLevel, 1u), std::max(imageUpload.extent.height >> mipLevel, 1u), 1};
+                    bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                    bufferImageCopy.imageSubresource.baseArrayLayer = i;
+                    bufferImageCopy.imageSubresource.layerCount = 1;
+                    bufferImageCopy.imageSubresource.mipLevel = mipLevel;
+
+                    bufferImageCopies.push_back(bufferImageCopy);
+                }
+            }
+
+            vkCmdCopyBufferToImage(commandBuffer, imageUpload.staging.buffer, imageUpload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            static_cast<uint32_t>(bufferImageCopies.size()), bufferImageCopies.data());
+
+            if (imageUpload.generateMipLevels) {
+                cmdGenerateMipLevels(commandBuffer, imageUpload.image, 0, imageUpload.arrayLayers, imageUpload.mipLevels, imageUpload.extent);
+            }
+        }
+
+        // Mip generation leaves every level in TRANSFER_SRC, plain uploads are still in TRANSFER_DST
+        for (std::size_t i = 0; i != imageMemoryBarriers.size(); ++i) {
+            VkImageMemoryBarrier &imageMemoryBarrier = imageMemoryBarriers[i];
+            const bool generatedMipLevels = uploadBatch.imageUploads[i].generateMipLevels;
+
+            imageMemoryBarrier.srcAccessMask = generatedMipLevels ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_TRANSFER_WRITE_BIT;
+            imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            imageMemoryBarrier.oldLayout = generatedMipLevels ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+
+        {
+            VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+            const uint32_t memoryBarrierCount = uploadBatch.bufferUploads.empty() ? 0 : 1;
+
+            if (memoryBarrierCount != 0 || !imageMemoryBarriers.empty()) {
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 
+                                0, memoryBarrierCount, &memoryBarrier, 0, nullptr, 
+                                static_cast<uint32_t>(imageMemoryBarriers.size()), imageMemoryBarriers.data());
+            }
+        }
+
+        // Mip 0 of downsampled images is now readable, the rest of their chain is written by one dispatch each
+        for (const UploadBatch::ImageUpload &imageUpload : uploadBatch.imageUploads) {
+            if (!imageUpload.downsampleMipLevels) {
+                continue;
+            }
+
+            VulkanImage vulkanImage = {};
+            vulkanImage.vkImage = imageUpload.image;
+            vulkanImage.format = imageUpload.format;
+            vulkanImage.usage = imageUpload.usage;
+            vulkanImage.extent = imageUpload.extent;
+            vulkanImage.arrayLayers = imageUpload.arrayLayers;
+            vulkanImage.mipLevels = imageUpload.mipLevels;
+
+            uploadBatch.mipDownsampleTargets.push_back(createMipDownsampleTarget(vulkanContext, *uploadBatch.pMipDownsampler, vulkanImage));
+            cmdDownsampleMipLevels(commandBuffer, *uploadBatch.pMipDownsampler, uploadBatch.mipDownsampleTargets.back(), vulkanImage);
+        }
+
+        checkVkResult(vkEndCommandBuffer(commandBuffer));
+
+        uploadBatch.token.timelineValue = submitToTimeline(vulkanContext.graphicsQueue, vulkanContext.graphicsTimeline, commandBuffer);
+
+        return uploadBatch.token;
+    }
+
+    bool isUploadComplete(const VulkanContext &vulkanContext, const UploadToken token)
+    {
+        return getCompletedTimelineValue(vulkanContext.device, vulkanContext.graphicsTimeline) >= token.timelineValue;
+    }
+
+    void waitForUpload(const VulkanContext &vulkanContext, const UploadToken token)
+    {
+        waitForTimelineValue(vulkanContext.device, vulkanContext.graphicsTimeline, token.timelineValue);
+    }
+
+    void destroyUploadBatch(const VulkanContext &vulkanContext, UploadBatch &uploadBatch)
+    {
+        if (uploadBatch.token.timelineValue != 0) {
+            waitForUpload(vulkanContext, uploadBatch.token);
+        }
+
+        for (VulkanBuffer &stagingBuffer : uploadBatch.stagingBuffers) {
+            destroyBuffer(vulkanContext, stagingBuffer);
+        }
+
+        for (MipDownsampleTarget &mipDownsampleTarget : uploadBatch.mipDownsampleTargets) {
+            destroyMipDownsampleTarget(vulkanContext, *uploadBatch.pMipDownsampler, mipDownsampleTarget);
+        }
+
+        vkDestroyCommandPool(vulkanContext.device, uploadBatch.commandPool, getHostAllocationCallbacks(HostAllocationTag::Command));
+        uploadBatch = {};
+    }
+
+    void retireUploadBatch(const VulkanContext &vulkanContext, DeletionQueue &deletionQueue, UploadBatch &uploadBatch)
+    {
+        assert(uploadBatch.token.timelineValue != 0);
+
+        const uint64_t retireValue = std::max(uploadBatch.token.timelineValue, vulkanContext.graphicsTimeline.submittedValue);
+
+        for (VulkanBuffer &stagingBuffer : uploadBatch.stagingBuffers) {
+            deferDestroyBuffer(deletionQueue, stagingBuffer, retireValue);
+        }
+
+        deferDestroy(deletionQueue, [commandPool = uploadBatch.commandPool](const VulkanContext &vulkanContext) {
+            vkDestroyCommandPool(vulkanContext.device, commandPool, getHostAllocationCallbacks(HostAllocationTag::Command));
+        }, retireValue);
+
+        if (!uploadBatch.mipDownsampleTargets.empty()) {
+            deferDestroy(deletionQueue, [pMipDownsampler = uploadBatch.pMipDownsampler, 
+                            mipDownsampleTargets = std::move(uploadBatch.mipDownsampleTargets)](const VulkanContext &vulkanContext) mutable {
+                for (MipDownsampleTarget &mipDownsampleTarget : mipDownsampleTargets) {
+                    destroyMipDownsampleTarget(vulkanContext, *pMipDownsampler, mipDownsampleTarget);
+                }
+            }, retireValue);
+        }
+
+        uploadBatch = {};
+    }
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Arsenic/Renderer/VulkanHeader.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/VulkanImage.hpp"
+#include "Arsenic/Renderer/MipDownsampler.hpp"
+
+namespace arsenic
+{
+    struct VulkanContext;
+    struct DeletionQueue;
+
+    constexpr VkDeviceSize defaultUploadStagingChunkSize = 16 * 1024 * 1024;
+
+    // Where one mip level of every array layer sits in the data passed to uploadImageMipLevels, the layers of a level are tightly packed
+    struct ImageMipLevelData
+    {
+        VkDeviceSize offset;
+        VkDeviceSize layerSize;
+    };
+
+    // Timeline value of the submission that carries a batch, 0 until the batch is submitted
+    struct UploadToken
+    {
+        uint64_t timelineValue = 0;
+    };
+
+    // Collects buffer and image uploads and records them into a single command buffer on submit, so loading
+    // many assets costs one submission instead of one wait per asset.
+    // Data is copied into staging memory when an upload is added, the source can be freed right after
+    struct UploadBatch
+    {
+        struct StagingRange
+        {
+            VkBuffer buffer;
+            VkDeviceSize offset;
+        };
+
+        struct BufferUpload
+        {
+            StagingRange staging;
+            VkBuffer dstBuffer;
+            VkDeviceSize dstOffset;
+            VkDeviceSize size;
+        };
+
+        struct ImageUpload
+        {
+            StagingRange staging;
+            VkImage image;
+            VkFormat format;
+            VkImageUsageFlags usage;
+            VkExtent3D extent;
+            uint32_t arrayLayers;
+            uint32_t mipLevels;
+            // Offsets are relative to staging, a single level means the rest of the chain is either generated or left undefined
+            std::vector<ImageMipLevelData> mipLevelData;
+            bool generateMipLevels;
+            // Mips are generated by pMipDownsampler in one dispatch instead of blitting level by level
+            bool downsampleMipLevels;
+        };
+
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+        // Staging memory is handed out linearly from chunks, uploads larger than a chunk get one of their own
+        std::vector<VulkanBuffer> stagingBuffers;
+        VkDeviceSize stagingChunkSize = defaultUploadStagingChunkSize;
+        VkDeviceSize stagingHead = 0;
+
+        std::vector<BufferUpload> bufferUploads;
+        std::vector<ImageUpload> imageUploads;
+        VkDeviceSize uploadedBytes = 0;
+
+        // Images with VK_IMAGE_USAGE_STORAGE_BIT generate their mips with this when set, it has to outlive the batch
+        const MipDownsampler *pMipDownsampler = nullptr;
+        std::vector<MipDownsampleTarget> mipDownsampleTargets;
+
+        UploadToken token;
+    };
+
+    UploadBatch beginUploadBatch(const VulkanContext &vulkanContext, const VkDeviceSize stagingChunkSize = defaultUploadStagingChunkSize);
+
+    void uploadBuffer(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanBuffer &dstBuffer, const VkDeviceSize dstOffset,
+                const void *pData, const VkDeviceSize size);
+
+    // pData holds mip 0 of every array layer, tightly packed layer after layer.
+    // The image ends up in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL once the batch has completed,
+    // generating mip levels requires VK_IMAGE_USAGE_TRANSFER_SRC_BIT, or VK_IMAGE_USAGE_STORAGE_BIT when the batch has a pMipDownsampler
+    void uploadImage(VulkanContext &vulkanContext, UploadBatch &uploadBatch, VulkanImage &vulkanImage, const void *pData, 
+                const VkDeviceSize layerSize, const bool generateMipLevels);
+
+    // Uploads a precomputed mip chain, one entry of mipLevels per mip level of vulkanImage.
+    // This is the only way to fill block compressed images, which cannot be blitted to generate their mips
+    void uploadImageMipLevels(VulkanContext &vulkanContext, UploadBatch &uploadBatch, VulkanImage &vulkanImage, const void *pData, 
+                const VkDeviceSize size, const std::vector<ImageMipLevelData> &mipLevels);
+
+    // Same as uploadImage but returns the staging memory for the caller to fill, so data can be decoded straight into it.
+    // The memory has to be written before submitUploadBatch and must not be touched afterwards
+    void *reserveImageUpload(VulkanContext &vulkanContext, UploadBatch &uploadBatch, VulkanImage &vulkanImage, const VkDeviceSize layerSize, 
+                const bool generateMipLevels);
+
+    // Records and submits everything collected so far to the graphics queue, nothing can be added afterwards
+    UploadToken submitUploadBatch(VulkanContext &vulkanContext, UploadBatch &uploadBatch);
+
+    bool isUploadComplete(const VulkanContext &vulkanContext, const UploadToken token);
+    void waitForUpload(const VulkanContext &vulkanContext, const UploadToken token);
+
+    // Waits for the batch when it was submitted and releases its staging memory and command pool
+    void destroyUploadBatch(const VulkanContext &vulkanContext, UploadBatch &uploadBatch);
+
+    // Hands the staging memory and command pool of a submitted batch to deletionQueue instead of waiting. They retire no earlier
+    // than the last graphics submission, the value other producers push at, rather than at the batch's own older token
+    void retireUploadBatch(const VulkanContext &vulkanContext, DeletionQueue &deletionQueue, UploadBatch &uploadBatch);
+}
\ No newline at end of file
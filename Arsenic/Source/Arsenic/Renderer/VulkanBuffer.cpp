@@ -5,7 +5,44 @@
 
 namespace arsenic
 {
-    VulkanBuffer createBuffer(const VulkanContext &vulkanContext, const VkBufferUsageFlags bufferUsages, const VkMemoryPropertyFlags memoryProperties,
+    HostWritePolicy selectHostWritePolicy(const PhysicalDevice &physicalDevice)
+    {
+        constexpr VkMemoryPropertyFlags deviceLocalHostVisible = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        constexpr VkDeviceSize legacyBarSize = 256 * 1024 * 1024;
+
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = physicalDevice.memoryProperties;
+
+        HostWritePolicy hostWritePolicy = {};
+
+        for (uint32_t i = 0; i != memoryProperties.memoryTypeCount; ++i) {
+            const VkMemoryType &memoryType = memoryProperties.memoryTypes[i];
+            const VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryType.heapIndex].size;
+
+            if ((memoryType.propertyFlags & deviceLocalHostVisible) == deviceLocalHostVisible && heapSize > hostWritePolicy.heapSize) {
+                hostWritePolicy.path = HostWritePath::DeviceLocalHostVisible;
+                hostWritePolicy.memoryTypeIndex = i;
+                hostWritePolicy.heapSize = heapSize;
+                hostWritePolicy.resizableBar = heapSize > legacyBarSize;
+            }
+        }
+
+        return hostWritePolicy;
+    }
+
+    const char *hostWritePathToString(const HostWritePath hostWritePath)
+    {
+        switch (hostWritePath) {
+        case HostWritePath::DeviceLocalHostVisible:
+            return "Device local host visible";
+        case HostWritePath::Staging:
+            return "Staging";
+        }
+
+        return "Unknown";
+    }
+
+    VulkanBuffer createBuffer(VulkanContext &vulkanContext, const VkBufferUsageFlags bufferUsages, const VkMemoryPropertyFlags memoryProperties,
                         const VkDeviceSize size, const void *pData)
     {
         assert(size);
@@ -27,41 +64,56 @@ namespace arsenic
         if (bufferUsages & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
             bufferCI.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
         }
+        if (bufferUsages & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+            bufferCI.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        }
+
+        const bool deviceLocal = memoryProperties & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        const bool hostVisible = memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
 
         VmaAllocationCreateInfo vmaAllocationCI = {};
-        vmaAllocationCI.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-        vmaAllocationCI.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-        VulkanBuffer stagingBuffer = {};
-        stagingBuffer.size = size;
-        stagingBuffer.bufferUsages = bufferUsages;
+        if (deviceLocal && hostVisible) {
+            vmaAllocationCI.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+            vmaAllocationCI.requiredFlags = memoryProperties;
+            vmaAllocationCI.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        }
+        else if (deviceLocal) {
+            vmaAllocationCI.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        }
+        else {
+            vmaAllocationCI.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+            vmaAllocationCI.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        }
+
+        VulkanBuffer vulkanBuffer = {};
+        vulkanBuffer.size = size;
+        vulkanBuffer.bufferUsages = bufferCI.usage;
 
         VmaAllocationInfo vmaAllocationInfo = {};
-        checkVkResult(vmaCreateBuffer(vulkanContext.vmaAllocator, &bufferCI, &vmaAllocationCI, &stagingBuffer.vkBuffer, &stagingBuffer.vmaAllocation, &vmaAllocationInfo));
+        checkVkResult(vmaCreateBuffer(vulkanContext.vmaAllocator, &bufferCI, &vmaAllocationCI, &vulkanBuffer.vkBuffer, &vulkanBuffer.vmaAllocation, &vmaAllocationInfo));
 
-        stagingBuffer.pMappedPointer = static_cast<uint8_t*>(vmaAllocationInfo.pMappedData);
+        vulkanBuffer.pMappedPointer = static_cast<uint8_t*>(vmaAllocationInfo.pMappedData);
+        vmaGetMemoryTypeProperties(vulkanContext.vmaAllocator, vmaAllocationInfo.memoryType, &vulkanBuffer.memoryProperties);
 
-        if (pData != nullptr) {
-            std::memcpy(stagingBuffer.pMappedPointer, pData, size);
+        if (bufferCI.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+            VkBufferDeviceAddressInfo bufferDeviceAddressInfo = {VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+            bufferDeviceAddressInfo.buffer = vulkanBuffer.vkBuffer;
+            vulkanBuffer.deviceAddress = vkGetBufferDeviceAddress(vulkanContext.device, &bufferDeviceAddressInfo);
         }
 
-        if (memoryProperties & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
-            vmaAllocationCI.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-            vmaAllocationCI.flags = {};
-
-            VulkanBuffer devicalLocalBuffer = {};
-            devicalLocalBuffer.size = size;       
-
-            checkVkResult(vmaCreateBuffer(vulkanContext.vmaAllocator, &bufferCI, &vmaAllocationCI, &devicalLocalBuffer.vkBuffer, &devicalLocalBuffer.vmaAllocation, nullptr));
-
-            if (pData != nullptr) {
-                copyBufferToBufferAndSubmit(vulkanContext, stagingBuffer.vkBuffer, devicalLocalBuffer.vkBuffer, 0, 0, size);
+        if (pData != nullptr) {
+            if (vulkanBuffer.pMappedPointer != nullptr) {
+                std::memcpy(vulkanBuffer.pMappedPointer, pData, size);
+            }
+            else {
+                VulkanBuffer stagingBuffer = createBuffer(vulkanContext, 0, 0, size, pData);
+                copyBufferToBufferAndSubmit(vulkanContext, stagingBuffer.vkBuffer, vulkanBuffer.vkBuffer, 0, 0, size);
+                destroyBuffer(vulkanContext, stagingBuffer);
             }
-
-            vmaDestroyBuffer(vulkanContext.vmaAllocator, stagingBuffer.vkBuffer, stagingBuffer.vmaAllocation);
         }
 
-        return stagingBuffer;
+        return vulkanBuffer;
     }
 
     void destroyBuffer(const VulkanContext &vulkanContext, VulkanBuffer &vulkanBuffer)
@@ -70,7 +122,7 @@ namespace arsenic
         vmaDestroyBuffer(vulkanContext.vmaAllocator, vulkanBuffer.vkBuffer, vulkanBuffer.vmaAllocation);
     }
 
-    void copyBufferToBufferAndSubmit(const VulkanContext &vulkanContext, const VkBuffer srcBuffer, const VkBuffer dstBuffer, const VkDeviceSize srcOffset, 
+    void copyBufferToBufferAndSubmit(VulkanContext &vulkanContext, const VkBuffer srcBuffer, const VkBuffer dstBuffer, const VkDeviceSize srcOffset, 
                         const VkDeviceSize dstOffset, const VkDeviceSize size)
     {
         VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
@@ -87,18 +139,7 @@ namespace arsenic
 
         checkVkResult(vkEndCommandBuffer(vulkanContext.tempCommandBuffer));
 
-        VkSubmitInfo submtInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-        submtInfo.commandBufferCount = 1;
-        submtInfo.pCommandBuffers = &vulkanContext.tempCommandBuffer;
-
-        VkFence fence = VK_NULL_HANDLE;
-
-        VkFenceCreateInfo fenceCI = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-        checkVkResult(vkCreateFence(vulkanContext.device, &fenceCI, nullptr, &fence));
-
-        checkVkResult(vkQueueSubmit(vulkanContext.graphicsQueue, 1, &submtInfo, fence));
-        checkVkResult(vkWaitForFences(vulkanContext.device, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
-
-        vkDestroyFence(vulkanContext.device, fence, nullptr);
+        const uint64_t copyValue = submitToTimeline(vulkanContext.graphicsQueue, vulkanContext.graphicsTimeline, vulkanContext.tempCommandBuffer);
+        waitForTimelineValue(vulkanContext.device, vulkanContext.graphicsTimeline, copyValue);
     }
 }
\ No newline at end of file
@@ -5,25 +5,49 @@
 namespace arsenic
 {
     struct VulkanContext;
+    struct PhysicalDevice;
+
+    // How frequently updated data reaches device local memory
+    enum class HostWritePath
+    {
+        DeviceLocalHostVisible,     // CPU writes straight into DEVICE_LOCAL | HOST_VISIBLE memory (ReBAR / UMA)
+        Staging                     // CPU writes into system memory and a transfer copies it to device local memory
+    };
+
+    struct HostWritePolicy
+    {
+        HostWritePath path = HostWritePath::Staging;
+        std::optional<uint32_t> memoryTypeIndex;
+        VkDeviceSize heapSize = 0;
+        // False when only the legacy 256 MiB BAR window is host visible
+        bool resizableBar = false;
+    };
+
+    HostWritePolicy selectHostWritePolicy(const PhysicalDevice &physicalDevice);
+    const char *hostWritePathToString(const HostWritePath hostWritePath);
 
     struct VulkanBuffer
     {
         VkBuffer vkBuffer;
         VkDeviceSize size;
         VkBufferUsageFlags bufferUsages;
+        // Property flags of the memory type the buffer was actually allocated from
         VkMemoryPropertyFlags memoryProperties;
+        // Only filled when created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
         VkDeviceAddress deviceAddress;
         uint8_t *pMappedPointer;
         VmaAllocation vmaAllocation;
     };
 
 
-    VulkanBuffer createBuffer(const VulkanContext &vulkanContext, const VkBufferUsageFlags bufferUsages, const VkMemoryPropertyFlags memoryProperties,
+    // DEVICE_LOCAL | HOST_VISIBLE requests a mapped buffer in device local memory, DEVICE_LOCAL alone a GPU only buffer
+    // that pData is staged into, anything else a mapped buffer in system memory
+    VulkanBuffer createBuffer(VulkanContext &vulkanContext, const VkBufferUsageFlags bufferUsages, const VkMemoryPropertyFlags memoryProperties,
                 const std::size_t size, const void *pData = nullptr);
         
     void destroyBuffer(const VulkanContext &vulkanContext, VulkanBuffer &vulkanBuffer);
     
-    void copyBufferToBufferAndSubmit(const VulkanContext &vulkanContext, const VkBuffer src, const VkBuffer dstBuffer, const VkDeviceSize srcOffset, 
+    void copyBufferToBufferAndSubmit(VulkanContext &vulkanContext, const VkBuffer src, const VkBuffer dstBuffer, const VkDeviceSize srcOffset, 
                     const VkDeviceSize dstOffset, const VkDeviceSize size);
 
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "Arsenic/Renderer/VulkanHeader.hpp"
 #include "Arsenic/Renderer/VulkanContext.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
 #include "Arsenic/Renderer/Structure.hpp"
 
 #include "nlohmann/json.hpp"
@@ -22,17 +23,30 @@ namespace arsenic
         //mkVK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME,
     };
 
+    static bool isDeviceExtensionSupported(VkPhysicalDevice physicalDevice, const char *pExtensionName)
+    {
+        uint32_t extensionCount = 0;
+        checkVkResult(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr));
+
+        std::vector<VkExtensionProperties> supportedExtensions(extensionCount);
+        checkVkResult(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, supportedExtensions.data()));
+
+        return std::any_of(supportedExtensions.begin(), supportedExtensions.end(), [pExtensionName](const VkExtensionProperties &extension) {
+            return std::strcmp(extension.extensionName, pExtensionName) == 0;
+        });
+    }
+
 	static VkSurfaceKHR createSurfaceKHR(GLFWwindow* pGLFWwindow, const Instance &instance)
 	{
 		VkSurfaceKHR surfaceVk = VK_NULL_HANDLE;
-		checkVkResult(glfwCreateWindowSurface(instance.vkinstance, pGLFWwindow, nullptr, &surfaceVk));
+		checkVkResult(glfwCreateWindowSurface(instance.vkinstance, pGLFWwindow, getHostAllocationCallbacks(HostAllocationTag::Instance), &surfaceVk));
 
 		return surfaceVk;
 	}
 
 	static void destroySurfaceKHR(VkSurfaceKHR surface, const Instance& instance)
 	{
-		vkDestroySurfaceKHR(instance.vkinstance, surface, nullptr);
+		vkDestroySurfaceKHR(instance.vkinstance, surface, getHostAllocationCallbacks(HostAllocationTag::Instance));
 	}
 
     
@@ -41,7 +55,8 @@ namespace arsenic
         VulkanContext vulkanContext = {};
         vulkanContext.instance = Instance::createVulkanInstance(appName);
 
-        checkVkResult(glfwCreateWindowSurface(vulkanContext.instance.vkinstance, pGLfWwindow, nullptr, &vulkanContext.surface));
+        checkVkResult(glfwCreateWindowSurface(vulkanContext.instance.vkinstance, pGLfWwindow, getHostAllocationCallbacks(HostAllocationTag::Instance), 
+                    &vulkanContext.surface));
 
 		vulkanContext.physicalDevice = PhysicalDevice::chooseOptimalPhysicalDevice(vulkanContext.instance, vulkanContext.surface, deviceExtensions.data(), 
                                                                             static_cast<uint32_t>(deviceExtensions.size()));
@@ -67,17 +82,52 @@ namespace arsenic
             deviceQueueCIS.emplace_back(queueCI);
         }
         
-        VkPhysicalDeviceFeatures features = {};
-        features.fillModeNonSolid = true;
+        std::vector<const char*> enabledExtensions(deviceExtensions.begin(), deviceExtensions.end());
+
+        // Without it VMA can only estimate the budget as a fixed fraction of each heap
+        vulkanContext.memoryBudgetEnabled = isDeviceExtensionSupported(vulkanContext.physicalDevice.vkPhysicalDevice, 
+                                                                VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (vulkanContext.memoryBudgetEnabled) {
+            enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+        else {
+            ARSENIC_WARN("Renderer: {} is not supported, memory budgets are estimated", VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        VkPhysicalDeviceVulkan12Features vulkan12Features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+        vulkan12Features.bufferDeviceAddress = VK_TRUE;
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &vulkan12Features;
+        features2.features.fillModeNonSolid = true;
+
+        // Block compressed KTX2 textures are only loadable when the device samples BC formats
+        vulkanContext.textureCompressionBCEnabled = vulkanContext.physicalDevice.deviceFeatures.textureCompressionBC == VK_TRUE;
+        features2.features.textureCompressionBC = vulkanContext.textureCompressionBCEnabled ? VK_TRUE : VK_FALSE;
+
+        // The single pass mip downsampler reads and writes its storage image array without declaring a format
+        const VkPhysicalDeviceFeatures &deviceFeatures = vulkanContext.physicalDevice.deviceFeatures;
+        vulkanContext.storageImageWithoutFormatEnabled = deviceFeatures.shaderStorageImageReadWithoutFormat == VK_TRUE && 
+                                                         deviceFeatures.shaderStorageImageWriteWithoutFormat == VK_TRUE &&
+                                                         deviceFeatures.shaderStorageImageArrayDynamicIndexing == VK_TRUE;
+        features2.features.shaderStorageImageReadWithoutFormat = vulkanContext.storageImageWithoutFormatEnabled ? VK_TRUE : VK_FALSE;
+        features2.features.shaderStorageImageWriteWithoutFormat = vulkanContext.storageImageWithoutFormatEnabled ? VK_TRUE : VK_FALSE;
+        features2.features.shaderStorageImageArrayDynamicIndexing = vulkanContext.storageImageWithoutFormatEnabled ? VK_TRUE : VK_FALSE;
 
         VkDeviceCreateInfo deviceCreateCI = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+        deviceCreateCI.pNext = &features2;
         deviceCreateCI.queueCreateInfoCount = static_cast<uint32_t>(deviceQueueCIS.size());
         deviceCreateCI.pQueueCreateInfos = deviceQueueCIS.data();
-        deviceCreateCI.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-        deviceCreateCI.ppEnabledExtensionNames = deviceExtensions.data();
-        deviceCreateCI.pEnabledFeatures = &features;
+        deviceCreateCI.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        deviceCreateCI.ppEnabledExtensionNames = enabledExtensions.data();
+        deviceCreateCI.pEnabledFeatures = nullptr;
 
-        checkVkResult(vkCreateDevice(vulkanContext.physicalDevice.vkPhysicalDevice, &deviceCreateCI, nullptr, &vulkanContext.device));
+        checkVkResult(vkCreateDevice(vulkanContext.physicalDevice.vkPhysicalDevice, &deviceCreateCI, getHostAllocationCallbacks(HostAllocationTag::Device), 
+                    &vulkanContext.device));
 
         vkGetDeviceQueue(vulkanContext.device, *vulkanContext.physicalDevice.queueFamilies.graphicsFamily, 0, &vulkanContext.graphicsQueue);
         vkGetDeviceQueue(vulkanContext.device, *vulkanContext.physicalDevice.queueFamilies.presentFamily, 0, &vulkanContext.presentQueue);
@@ -89,12 +139,23 @@ namespace arsenic
         vmaAllocatorCI.instance = vulkanContext.instance.vkinstance;
         vmaAllocatorCI.physicalDevice = vulkanContext.physicalDevice.vkPhysicalDevice;
         vmaAllocatorCI.vulkanApiVersion = VK_API_VERSION_1_2;
+        vmaAllocatorCI.pAllocationCallbacks = getHostAllocationCallbacks(HostAllocationTag::Allocator);
+        vmaAllocatorCI.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+        if (vulkanContext.memoryBudgetEnabled) {
+            vmaAllocatorCI.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
         checkVkResult(vmaCreateAllocator(&vmaAllocatorCI, &vulkanContext.vmaAllocator));
 
+        vulkanContext.hostWritePolicy = selectHostWritePolicy(vulkanContext.physicalDevice);
+        ARSENIC_INFO("Renderer: Host write path \"{}\", host visible device local heap {} MiB{}", 
+                hostWritePathToString(vulkanContext.hostWritePolicy.path), vulkanContext.hostWritePolicy.heapSize / (1024 * 1024),
+                vulkanContext.hostWritePolicy.resizableBar ? " (resizable BAR)" : "");
+
         VkCommandPoolCreateInfo commandPoolCI = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
         commandPoolCI.queueFamilyIndex = vulkanContext.physicalDevice.queueFamilies.graphicsFamily.value();
         commandPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-        checkVkResult(vkCreateCommandPool(vulkanContext.device, &commandPoolCI, nullptr, &vulkanContext.tempCommandPool));
+        checkVkResult(vkCreateCommandPool(vulkanContext.device, &commandPoolCI, getHostAllocationCallbacks(HostAllocationTag::Command), 
+                    &vulkanContext.tempCommandPool));
 
         VkCommandBufferAllocateInfo commandBufferAllocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
         commandBufferAllocateInfo.commandBufferCount = 1;
@@ -102,6 +163,8 @@ namespace arsenic
         commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         checkVkResult(vkAllocateCommandBuffers(vulkanContext.device, &commandBufferAllocateInfo, &vulkanContext.tempCommandBuffer));
 
+        vulkanContext.graphicsTimeline = createGpuTimeline(vulkanContext.device);
+        vulkanContext.layoutCache = std::make_unique<LayoutCache>();
 
         return std::move(vulkanContext);
 	}
@@ -110,11 +173,13 @@ namespace arsenic
 	{
         checkVkResult(vkDeviceWaitIdle(vulkanContext.device));
 
-        
-        vkDestroyCommandPool(vulkanContext.device, vulkanContext.tempCommandPool, nullptr);
+        destroyGpuTimeline(vulkanContext.device, vulkanContext.graphicsTimeline);
+        destroyLayoutCache(vulkanContext, *vulkanContext.layoutCache);
+        vkDestroyPipelineCache(vulkanContext.device, vulkanContext.pipelineCache, getHostAllocationCallbacks(HostAllocationTag::Pipeline));
+        vkDestroyCommandPool(vulkanContext.device, vulkanContext.tempCommandPool, getHostAllocationCallbacks(HostAllocationTag::Command));
         vmaDestroyAllocator(vulkanContext.vmaAllocator);
-		vkDestroySurfaceKHR(vulkanContext.instance.vkinstance, vulkanContext.surface, nullptr);
-        vkDestroyDevice(vulkanContext.device, nullptr);
+		vkDestroySurfaceKHR(vulkanContext.instance.vkinstance, vulkanContext.surface, getHostAllocationCallbacks(HostAllocationTag::Instance));
+        vkDestroyDevice(vulkanContext.device, getHostAllocationCallbacks(HostAllocationTag::Device));
 
 		Instance::destroyVulkanInstance(&vulkanContext.instance);
 
@@ -4,6 +4,9 @@
 #include "Arsenic/Renderer/Instance.hpp"
 #include "Arsenic/Renderer/PhysicalDevice.hpp"
 #include "Arsenic/Renderer/Structure.hpp"
+#include "Arsenic/Renderer/GpuTimeline.hpp"
+#include "Arsenic/Renderer/VulkanBuffer.hpp"
+#include "Arsenic/Renderer/LayoutCache.hpp"
 #include "vk_mem_alloc.hpp"
 
 struct GLFWwindow;
@@ -21,6 +24,19 @@ namespace arsenic
         VkQueue transferQueue = VK_NULL_HANDLE;
         VkQueue computerQueue = VK_NULL_HANDLE;
         VmaAllocator vmaAllocator = VK_NULL_HANDLE;
+        HostWritePolicy hostWritePolicy = {};
+        bool memoryBudgetEnabled = false;
+        bool textureCompressionBCEnabled = false;
+        bool storageImageWithoutFormatEnabled = false;
+
+        // Every submission to graphicsQueue goes through this timeline
+        GpuTimeline graphicsTimeline;
+
+        // Every pipeline is created through this cache, see createPipelineCache. Destroyed with the context
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+        // Descriptor set and pipeline layouts of every ShaderEffect come from here. Destroyed with the context
+        std::unique_ptr<LayoutCache> layoutCache;
 
         VkCommandPool tempCommandPool = VK_NULL_HANDLE;
         VkCommandBuffer tempCommandBuffer = VK_NULL_HANDLE;
@@ -1,24 +1,46 @@
 #include "Arsenic/Arsenicpch.hpp"
 
+#include "Arsenic/Core/FileSystem.hpp"
 #include "Arsenic/Renderer/VulkanContext.hpp"
 #include "Arsenic/Renderer/VulkanBuffer.hpp"
 #include "Arsenic/Renderer/VulkanImage.hpp"
+#include "Arsenic/Renderer/HostAllocator.hpp"
+#include "Arsenic/Renderer/UploadBatch.hpp"
+#include "Arsenic/Renderer/ExrImage.hpp"
 
-#include "nlohmann/json.hpp"
 #include "stb_image.hpp"
 
 namespace arsenic
 {
+    static VkImageCreateFlags getStorageCreateFlags(const VulkanImageDesc &imageDesc)
+    {
+        if ((imageDesc.imageUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) == 0 || getStorageViewFormat(imageDesc.format) == imageDesc.format) {
+            return 0;
+        }
+
+        return VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+    }
+
+    static uint32_t calculateImageMipLevels(const VulkanImageDesc &imageDesc)
+    {
+        if (imageDesc.mipLevelCount != 0) {
+            return imageDesc.mipLevelCount;
+        }
+
+        return imageDesc.setMipLevel ? calculateMipLevels(imageDesc.extent.width, imageDesc.extent.height) : 1;
+    }
+
     VulkanImage createImage2D(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc)
     {        
         const uint32_t arrayLayers = imageDesc.numArrayLayers;
-        const uint32_t mipLevels = calculateMipLevels(imageDesc.extent.width, imageDesc.extent.height);
+        const uint32_t mipLevels = calculateImageMipLevels(imageDesc);
 
         VkImageCreateInfo imageCI = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        imageCI.flags = getStorageCreateFlags(imageDesc);
         imageCI.imageType = VK_IMAGE_TYPE_2D;
         imageCI.format = imageDesc.format;
         imageCI.extent = {imageDesc.extent.width, imageDesc.extent.height, 1};
-        imageCI.mipLevels = imageDesc.setMipLevel ? mipLevels : 1;
+        imageCI.mipLevels = mipLevels;
         imageCI.arrayLayers = arrayLayers;
         imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
         imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -28,12 +50,16 @@ namespace arsenic
 
         VmaAllocationCreateInfo vmaAllocationCI = {};
         vmaAllocationCI.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        if (imageDesc.dedicatedAllocation) {
+            vmaAllocationCI.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        }
 
         VulkanImage vulkanImage = {};
         vulkanImage.arrayLayers =  arrayLayers;
         vulkanImage.mipLevels = mipLevels;
         vulkanImage.extent = imageDesc.extent;
         vulkanImage.format = imageDesc.format;
+        vulkanImage.usage = imageDesc.imageUsageFlags;
         vulkanImage.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
         checkVkResult(vmaCreateImage(vulkanContext.vmaAllocator, &imageCI, &vmaAllocationCI, &vulkanImage.vkImage, &vulkanImage.vmaAllocation, nullptr));
@@ -44,14 +70,14 @@ namespace arsenic
     VulkanImage createCubeImage2D(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc)
     {
         const uint32_t arrayLayers = imageDesc.numArrayLayers;
-        const uint32_t mipLevels = imageDesc.setMipLevel ? calculateMipLevels(imageDesc.extent.width, imageDesc.extent.height) : 1;
+        const uint32_t mipLevels = calculateImageMipLevels(imageDesc);
 
         VkImageCreateInfo imageCI = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-        imageCI.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+        imageCI.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT | getStorageCreateFlags(imageDesc);
         imageCI.imageType = VK_IMAGE_TYPE_2D;
         imageCI.format = imageDesc.format;
         imageCI.extent = {imageDesc.extent.width, imageDesc.extent.height, 1};
-        imageCI.mipLevels = imageDesc.setMipLevel ? mipLevels : 1;
+        imageCI.mipLevels = mipLevels;
         imageCI.arrayLayers = arrayLayers;
         imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
         imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -61,386 +87,152 @@ namespace arsenic
 
         VmaAllocationCreateInfo vmaAllocationCI = {};
         vmaAllocationCI.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        if (imageDesc.dedicatedAllocation) {
+            vmaAllocationCI.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        }
 
         VulkanImage vulkanImage = {};
         vulkanImage.arrayLayers =  arrayLayers;
         vulkanImage.mipLevels = mipLevels;
         vulkanImage.extent = imageDesc.extent;
         vulkanImage.format = imageDesc.format;
+        vulkanImage.usage = imageDesc.imageUsageFlags;
 
         checkVkResult(vmaCreateImage(vulkanContext.vmaAllocator, &imageCI, &vmaAllocationCI, &vulkanImage.vkImage, &vulkanImage.vmaAllocation, nullptr));
         
         return vulkanImage;
     }
 
-    VulkanImage loadImage2DFromFile(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *imageFilePath)
+    VulkanImage loadImage2DFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanImageDesc &imageDesc, const char *imageFilePath)
     {
         int width = 0;
         int height = 0;
         int numChannel = 0;
 
-        auto *pRawImageData = stbi_load(imageFilePath, &width, &height, &numChannel, STBI_rgb_alpha);
-        
-        const uint32_t arrayLayers = imageDesc.numArrayLayers;
-        const uint32_t mipLevels = imageDesc.setMipLevel ? calculateMipLevels(width, height) : 1;
-        const uint32_t arrayLayerBufferSize = 4u * width * height;
+        const FileView file = readFile(imageFilePath);
+        assert(file.isValid());
 
-        VulkanBuffer stagingBuffer = createBuffer(vulkanContext, 0, 0, arrayLayerBufferSize, pRawImageData);
+        auto *pRawImageData = stbi_load_from_memory(file.pData, static_cast<int>(file.size), &width, &height, &numChannel, STBI_rgb_alpha);
+        assert(pRawImageData != nullptr);
+        assert(imageDesc.numArrayLayers == 1);
 
-        VkImageCreateInfo imageCI = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-        imageCI.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-        imageCI.imageType = VK_IMAGE_TYPE_2D;
-        imageCI.format = imageDesc.format;
-        imageCI.extent.width = static_cast<uint32_t>(width);
-        imageCI.extent.height = static_cast<uint32_t>(height);
-        imageCI.extent.depth = 1;
-        imageCI.mipLevels = mipLevels;
-        imageCI.arrayLayers = arrayLayers;
-        imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageCI.usage = imageDesc.imageUsageFlags;
-        imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-        VmaAllocationCreateInfo vmaAllocationCI = {};
-        vmaAllocationCI.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        VulkanImageDesc fileImageDesc = imageDesc;
+        fileImageDesc.extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
 
-        VulkanImage vulkanImage = {};
-        vulkanImage.arrayLayers = arrayLayers;
-        vulkanImage.mipLevels = mipLevels;
-        vulkanImage.extent = imageDesc.extent;
-        vulkanImage.format = imageDesc.format;
+        VulkanImage vulkanImage = createImage2D(vulkanContext, fileImageDesc);
+        uploadImage(vulkanContext, uploadBatch, vulkanImage, pRawImageData, 4ull * width * height, imageDesc.setMipLevel);
 
-        checkVkResult(vmaCreateImage(vulkanContext.vmaAllocator, &imageCI, &vmaAllocationCI, &vulkanImage.vkImage, &vulkanImage.vmaAllocation, nullptr));
-
-        const VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        checkVkResult(vkBeginCommandBuffer(vulkanContext.tempCommandBuffer, &commandBufferBeginInfo));
-        
-        {
-            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-            imageMemoryBarrier.srcAccessMask = 0;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-            imageMemoryBarrier.subresourceRange.layerCount = arrayLayers;
-            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-            imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
-
-            vkCmdPipelineBarrier(vulkanContext.tempCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-        }
-        {
-            VkBufferImageCopy bufferImageCopy = {};
-            bufferImageCopy.imageExtent.width = static_cast<uint32_t>(width);
-            bufferImageCopy.imageExtent.height = static_cast<uint32_t>(height);
-            bufferImageCopy.imageExtent.depth = 1;
-            bufferImageCopy.imageSubresource.baseArrayLayer = 0;
-            bufferImageCopy.imageSubresource.layerCount = arrayLayers;
-            bufferImageCopy.imageSubresource.mipLevel = 0;
-
-            vkCmdCopyBufferToImage(vulkanContext.tempCommandBuffer, stagingBuffer.vkBuffer, vulkanImage.vkImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
-        }
-      
-        cmdGenerateMipLevels(vulkanContext.tempCommandBuffer, vulkanImage.vkImage, 0, arrayLayers, mipLevels, imageCI.extent);
-
-        {
-            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-            imageMemoryBarrier.subresourceRange.layerCount = arrayLayers;
-            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-            imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
-
-            vkCmdPipelineBarrier(vulkanContext.tempCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-            vulkanImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        }
-
-        checkVkResult(vkEndCommandBuffer(vulkanContext.tempCommandBuffer));
-
-        {
-            VkFenceCreateInfo fenceCI = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-            VkFence fence = VK_NULL_HANDLE;
-            checkVkResult(vkCreateFence(vulkanContext.device, &fenceCI, nullptr, &fence));
-
-            VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &vulkanContext.tempCommandBuffer;
-            checkVkResult(vkQueueSubmit(vulkanContext.graphicsQueue, 1, &submitInfo, fence));
-
-            checkVkResult(vkWaitForFences(vulkanContext.device, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
-            vkDestroyFence(vulkanContext.device, fence, nullptr);
-        }
-
-        destroyBuffer(vulkanContext, stagingBuffer);
         stbi_image_free(pRawImageData);
 
         return vulkanImage;
     }
 
-    VulkanImage loadHDRImage2DFromFile(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *hdrImageFilePath)
+    VulkanImage loadHDRImage2DFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanImageDesc &imageDesc, const char *hdrImageFilePath)
     {
+        if (std::filesystem::path(hdrImageFilePath).extension() == ".exr") {
+            return loadExrImage2DFromFile(vulkanContext, uploadBatch, imageDesc, hdrImageFilePath);
+        }
+
         int width = 0;
         int height = 0;
         int numChannel = 0;
 
-        auto *pRawImageData = stbi_loadf(hdrImageFilePath, &width, &height, &numChannel, STBI_rgb_alpha);
-        
-        const uint32_t arrayLayers = imageDesc.numArrayLayers;
-        const uint32_t mipLevels = imageDesc.setMipLevel ? calculateMipLevels(width, height) : 1;
-        const uint32_t arrayLayerBufferSize = 4u * width * height;
-
-        VulkanBuffer stagingBuffer = createBuffer(vulkanContext, 0, 0, arrayLayerBufferSize, pRawImageData);
-
-        VkImageCreateInfo imageCI = {};
-        imageCI.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-        imageCI.imageType = VK_IMAGE_TYPE_2D;
-        imageCI.format = imageDesc.format;
-        imageCI.extent.width = static_cast<uint32_t>(width);
-        imageCI.extent.height = static_cast<uint32_t>(height);
-        imageCI.extent.depth = 1;
-        imageCI.mipLevels = mipLevels;
-        imageCI.arrayLayers = arrayLayers;
-        imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageCI.usage = imageDesc.imageUsageFlags;
-        imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-        VmaAllocationCreateInfo vmaAllocationCI = {};
-        vmaAllocationCI.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        const FileView file = readFile(hdrImageFilePath);
+        assert(file.isValid());
 
-        VulkanImage vulkanImage = {};
-        vulkanImage.arrayLayers = arrayLayers;
-        vulkanImage.mipLevels = mipLevels;
-        vulkanImage.extent = imageDesc.extent;
-        vulkanImage.format = imageDesc.format;
+        auto *pRawImageData = stbi_loadf_from_memory(file.pData, static_cast<int>(file.size), &width, &height, &numChannel, STBI_rgb_alpha);
+        assert(pRawImageData != nullptr);
+        assert(imageDesc.numArrayLayers == 1);
 
-        checkVkResult(vmaCreateImage(vulkanContext.vmaAllocator, &imageCI, &vmaAllocationCI, &vulkanImage.vkImage, &vulkanImage.vmaAllocation, nullptr));
+        VulkanImageDesc fileImageDesc = imageDesc;
+        fileImageDesc.extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
 
-        const VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        checkVkResult(vkBeginCommandBuffer(vulkanContext.tempCommandBuffer, &commandBufferBeginInfo));
-        
-        {
-            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-            imageMemoryBarrier.srcAccessMask = 0;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-            imageMemoryBarrier.subresourceRange.layerCount = arrayLayers;
-            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-            imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
+        VulkanImage vulkanImage = createImage2D(vulkanContext, fileImageDesc);
+        uploadImage(vulkanContext, uploadBatch, vulkanImage, pRawImageData, 4ull * sizeof(float) * width * height, imageDesc.setMipLevel);
 
-            vkCmdPipelineBarrier(vulkanContext.tempCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-        }
-        {
-            VkBufferImageCopy bufferImageCopy = {};
-            bufferImageCopy.imageExtent.width = static_cast<uint32_t>(width);
-            bufferImageCopy.imageExtent.height = static_cast<uint32_t>(height);
-            bufferImageCopy.imageExtent.depth = 1;
-            bufferImageCopy.imageSubresource.baseArrayLayer = 0;
-            bufferImageCopy.imageSubresource.layerCount = arrayLayers;
-            bufferImageCopy.imageSubresource.mipLevel = 0;
-
-            vkCmdCopyBufferToImage(vulkanContext.tempCommandBuffer, stagingBuffer.vkBuffer, vulkanImage.vkImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
-        }
-      
-        cmdGenerateMipLevels(vulkanContext.tempCommandBuffer, vulkanImage.vkImage, 0, arrayLayers, mipLevels, imageCI.extent);
-
-        {
-            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-            imageMemoryBarrier.subresourceRange.layerCount = arrayLayers;
-            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-            imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
-
-            vkCmdPipelineBarrier(vulkanContext.tempCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-            vulkanImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        }
-
-        checkVkResult(vkEndCommandBuffer(vulkanContext.tempCommandBuffer));
-
-        {
-            VkFenceCreateInfo fenceCI = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-            VkFence fence = VK_NULL_HANDLE;
-            checkVkResult(vkCreateFence(vulkanContext.device, &fenceCI, nullptr, &fence));
-
-            VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &vulkanContext.tempCommandBuffer;
-            checkVkResult(vkQueueSubmit(vulkanContext.graphicsQueue, 1, &submitInfo, fence));
-
-            checkVkResult(vkWaitForFences(vulkanContext.device, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
-            vkDestroyFence(vulkanContext.device, fence, nullptr);
-        }
-
-        destroyBuffer(vulkanContext, stagingBuffer);
         stbi_image_free(pRawImageData);
 
         return vulkanImage;
     }
 
-    VulkanImage loadCubeImage2DFromFile(const VulkanContext &vulkanContext, const char *cubeJsonFilePath)
+    VulkanImage loadExrImage2DFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanImageDesc &imageDesc, const char *exrImageFilePath)
     {
-        std::ifstream file(cubeJsonFilePath);
-        assert(file.is_open());
+        assert(imageDesc.numArrayLayers == 1);
+        assert(imageDesc.format == VK_FORMAT_R16G16B16A16_SFLOAT || imageDesc.format == VK_FORMAT_R32G32B32A32_SFLOAT);
 
-        nlohmann::json cubeMapJson;
-        file >> cubeMapJson;
+        const bool halfOutput = imageDesc.format == VK_FORMAT_R16G16B16A16_SFLOAT;
+        const VkDeviceSize texelSize = halfOutput ? 4 * sizeof(uint16_t) : 4 * sizeof(float);
 
-        int width = 0;
-        int height = 0;
-        int numChannels = 0;
-
-        auto *right = stbi_load(cubeMapJson["right"].get<std::string>().c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
-        auto *left = stbi_load(cubeMapJson["left"].get<std::string>().c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
-        auto *top = stbi_load(cubeMapJson["top"].get<std::string>().c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
-        auto *bottom = stbi_load(cubeMapJson["bottom"].get<std::string>().c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
-        auto *forward = stbi_load(cubeMapJson["forward"].get<std::string>().c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
-        auto *backward = stbi_load(cubeMapJson["backward"].get<std::string>().c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
+        VulkanImageDesc fileImageDesc = imageDesc;
 
-        const std::size_t faceSize = 4 * width * height;
-
-        VulkanBuffer stagingBuffer = createBuffer(vulkanContext, 0, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 
-                                            faceSize * 6);  
-        
-        std::memcpy(stagingBuffer.pMappedPointer, right, faceSize);
-        std::memcpy(stagingBuffer.pMappedPointer + faceSize, left, faceSize);
-        std::memcpy(stagingBuffer.pMappedPointer + 2 * faceSize, top, faceSize);
-        std::memcpy(stagingBuffer.pMappedPointer + 3 * faceSize, bottom, faceSize);
-        std::memcpy(stagingBuffer.pMappedPointer + 4 * faceSize, forward, faceSize);
-        std::memcpy(stagingBuffer.pMappedPointer + 5 * faceSize, backward, faceSize);
+        ExrImage exrImage;
+        if (!openExrImage(exrImageFilePath, exrImage)) {
+            ARSENIC_ERROR("Renderer: {} is missing or not a supported OpenEXR file, a black image is used instead", exrImageFilePath);
 
-        const VkFormat format = vulkanContext.findSupportedFormat({VK_FORMAT_R8G8B8A8_SRGB}, VK_IMAGE_TILING_OPTIMAL, 
-                                                        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT_KHR);
-        assert(format != VK_FORMAT_UNDEFINED);
+            fileImageDesc.extent = {1, 1, 1};
+            VulkanImage vulkanImage = createImage2D(vulkanContext, fileImageDesc);
 
-        const VulkanImageDesc cubeImageDesc = VulkanImageDesc::create(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-                                                                VK_IMAGE_USAGE_TRANSFER_DST_BIT, {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1u}, 
-                                                                format, 6, true);
+            void *pStagingData = reserveImageUpload(vulkanContext, uploadBatch, vulkanImage, texelSize, imageDesc.setMipLevel);
+            std::memset(pStagingData, 0, texelSize);
 
-        VulkanImage vulkanImage = createCubeImage2D(vulkanContext, cubeImageDesc);
+            return vulkanImage;
+        }
 
-        VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        checkVkResult(vkBeginCommandBuffer(vulkanContext.tempCommandBuffer, &commandBufferBeginInfo));
+        fileImageDesc.extent = {exrImage.width, exrImage.height, 1};
 
-        {
-            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-            imageMemoryBarrier.image = vulkanImage.vkImage;
-            imageMemoryBarrier.srcAccessMask = 0;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-            imageMemoryBarrier.subresourceRange.layerCount = vulkanImage.arrayLayers;
-            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-            imageMemoryBarrier.subresourceRange.levelCount = vulkanImage.mipLevels;
-            imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-
-            vkCmdPipelineBarrier(vulkanContext.tempCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 
-                            0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+        VulkanImage vulkanImage = createImage2D(vulkanContext, fileImageDesc);
 
-            vulkanImage.imageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        }
+        // Chunks are decompressed on worker threads straight into the staging memory of the upload
+        void *pStagingData = reserveImageUpload(vulkanContext, uploadBatch, vulkanImage, texelSize * exrImage.width * exrImage.height, 
+                                imageDesc.setMipLevel);
 
-        std::array<VkBufferImageCopy, 6> bufferImageCopies = {};
-
-        for (std::size_t i = 0; i != bufferImageCopies.size(); ++i) {
-            VkBufferImageCopy bufferImageCopy = {};
-            bufferImageCopy.bufferOffset = i * faceSize;
-            bufferImageCopy.bufferRowLength = static_cast<uint32_t>(width);
-            bufferImageCopy.bufferImageHeight = static_cast<uint32_t>(height);
-            bufferImageCopy.imageExtent.width = static_cast<uint32_t>(width);
-            bufferImageCopy.imageExtent.height = static_cast<uint32_t>(height);
-            bufferImageCopy.imageExtent.depth = 1;
-            bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            bufferImageCopy.imageSubresource.baseArrayLayer = i;
-            bufferImageCopy.imageSubresource.layerCount = 1;            
-            bufferImageCopy.imageSubresource.mipLevel = 0;
-
-            bufferImageCopies[i] = bufferImageCopy;
+        if (!decodeExrImage(exrImage, pStagingData, halfOutput)) {
+            ARSENIC_ERROR("Renderer: {} has corrupted chunks, they are left undefined", exrImageFilePath);
         }
 
-        vkCmdCopyBufferToImage(vulkanContext.tempCommandBuffer, stagingBuffer.vkBuffer, vulkanImage.vkImage, vulkanImage.imageLayout, 
-                        static_cast<uint32_t>(bufferImageCopies.size()), bufferImageCopies.data());
-        
-        cmdGenerateMipLevels(vulkanContext.tempCommandBuffer, vulkanImage.vkImage, 0, vulkanImage.arrayLayers, vulkanImage.mipLevels, 
-                            {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1});
+        return vulkanImage;
+    }
 
-        {
-            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-            imageMemoryBarrier.image = vulkanImage.vkImage;
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-            imageMemoryBarrier.subresourceRange.layerCount = vulkanImage.arrayLayers;
-            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-            imageMemoryBarrier.subresourceRange.levelCount = vulkanImage.mipLevels;
-            imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    VulkanImage loadImage2DFromFile(VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *imageFilePath)
+    {
+        UploadBatch uploadBatch = beginUploadBatch(vulkanContext);
+        VulkanImage vulkanImage = loadImage2DFromFile(vulkanContext, uploadBatch, imageDesc, imageFilePath);
+        submitUploadBatch(vulkanContext, uploadBatch);
+        destroyUploadBatch(vulkanContext, uploadBatch);
 
-            vkCmdPipelineBarrier(vulkanContext.tempCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 
-                            0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+        return vulkanImage;
+    }
 
-            vulkanImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        }
+    VulkanImage loadHDRImage2DFromFile(VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *hdrImageFilePath)
+    {
+        UploadBatch uploadBatch = beginUploadBatch(vulkanContext);
+        VulkanImage vulkanImage = loadHDRImage2DFromFile(vulkanContext, uploadBatch, imageDesc, hdrImageFilePath);
+        submitUploadBatch(vulkanContext, uploadBatch);
+        destroyUploadBatch(vulkanContext, uploadBatch);
 
-        checkVkResult(vkEndCommandBuffer(vulkanContext.tempCommandBuffer));
+        return vulkanImage;
+    }
 
-        {
-            VkFenceCreateInfo fenceCI = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-            VkFence fence = VK_NULL_HANDLE;
-            checkVkResult(vkCreateFence(vulkanContext.device, &fenceCI, nullptr, &fence));
-
-            VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &vulkanContext.tempCommandBuffer;
-
-            checkVkResult(vkQueueSubmit(vulkanContext.graphicsQueue, 1, &submitInfo, fence));
-            checkVkResult(vkWaitForFences(vulkanContext.device, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
-            vkDestroyFence(vulkanContext.device, fence, nullptr);
-        }   
-
-        destroyBuffer(vulkanContext,stagingBuffer);
-        stbi_image_free(right);
-        stbi_image_free(left);
-        stbi_image_free(top);
-        stbi_image_free(bottom);
-        stbi_image_free(forward);
-        stbi_image_free(backward);
+    VulkanImage loadExrImage2DFromFile(VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *exrImageFilePath)
+    {
+        UploadBatch uploadBatch = beginUploadBatch(vulkanContext);
+        VulkanImage vulkanImage = loadExrImage2DFromFile(vulkanContext, uploadBatch, imageDesc, exrImageFilePath);
+        submitUploadBatch(vulkanContext, uploadBatch);
+        destroyUploadBatch(vulkanContext, uploadBatch);
 
         return vulkanImage;
     }
 
     VkImageView createImageView(const VulkanContext &vulkanContext, const VkImage image, const VkImageViewType viewType, 
                             const VkFormat format, const VkImageAspectFlags imageAspect, const uint32_t baseArrayLayer, 
-                            const uint32_t layerCount, const uint32_t baseMipLevel, const uint32_t levelCount)
+                            const uint32_t layerCount, const uint32_t baseMipLevel, const uint32_t levelCount, 
+                            const VkImageUsageFlags viewUsage)
     {
+        VkImageViewUsageCreateInfo imageViewUsageCI = {VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO};
+        imageViewUsageCI.usage = viewUsage;
+
         VkImageViewCreateInfo imageViewCI = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+        imageViewCI.pNext = viewUsage != 0 ? &imageViewUsageCI : nullptr;
         imageViewCI.image = image;
         imageViewCI.viewType = viewType;
         imageViewCI.format = format;
@@ -451,7 +243,7 @@ namespace arsenic
         imageViewCI.subresourceRange.levelCount = levelCount;
 
         VkImageView imageView = VK_NULL_HANDLE;
-        checkVkResult(vkCreateImageView(vulkanContext.device, &imageViewCI, nullptr, &imageView));
+        checkVkResult(vkCreateImageView(vulkanContext.device, &imageViewCI, getHostAllocationCallbacks(HostAllocationTag::Resource), &imageView));
 
         return imageView;
     }
@@ -459,10 +251,83 @@ namespace arsenic
     void destroyImage(const VulkanContext &vulkanContext, VulkanImage &vulkanImage)
     {
         vmaDestroyImage(vulkanContext.vmaAllocator, vulkanImage.vkImage, vulkanImage.vmaAllocation);
-        vkDestroyImageView(vulkanContext.device, vulkanImage.vkImageView, nullptr);
+        vkDestroyImageView(vulkanContext.device, vulkanImage.vkImageView, getHostAllocationCallbacks(HostAllocationTag::Resource));
         vulkanImage = {};
     }
     
+    VkFormat getStorageViewFormat(const VkFormat format)
+    {
+        switch (format) {
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return VK_FORMAT_B8G8R8A8_UNORM;
+        case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+            return VK_FORMAT_A8B8G8R8_UNORM_PACK32;
+        default:
+            return format;
+        }
+    }
+
+    uint32_t getFormatTexelBlockSize(const VkFormat format)
+    {
+        switch (format) {
+        case VK_FORMAT_R8_UNORM:
+        case VK_FORMAT_R8_SRGB:
+            return 1;
+        case VK_FORMAT_R8G8_UNORM:
+        case VK_FORMAT_R8G8_SRGB:
+        case VK_FORMAT_R16_SFLOAT:
+        case VK_FORMAT_D16_UNORM:
+            return 2;
+        case VK_FORMAT_R8G8B8_UNORM:
+        case VK_FORMAT_R8G8B8_SNORM:
+        case VK_FORMAT_R8G8B8_SRGB:
+            return 3;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
+        case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+        case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+        case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+        case VK_FORMAT_R16G16_SFLOAT:
+        case VK_FORMAT_R32_SFLOAT:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+            return 4;
+        case VK_FORMAT_R16G16B16_SFLOAT:
+            return 6;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+        case VK_FORMAT_R32G32_SFLOAT:
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            return 8;
+        case VK_FORMAT_R32G32B32_SFLOAT:
+            return 12;
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
     void cmdGenerateMipLevels(const VkCommandBuffer commandBuffer, const VkImage vkImage, const uint32_t baseArrayLayer, const uint32_t numArrayLayers,
                     const uint32_t mipLevels, const VkExtent3D extent)
     {
@@ -5,6 +5,7 @@
 namespace arsenic
 {
     struct VulkanContext;
+    struct UploadBatch;
 
     struct VulkanImage
     {
@@ -14,6 +15,7 @@ namespace arsenic
         uint32_t arrayLayers;
         uint32_t mipLevels;
         VkFormat format;
+        VkImageUsageFlags usage;
         VkImageLayout imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         VmaAllocation vmaAllocation;
     };
@@ -25,6 +27,11 @@ namespace arsenic
         VkFormat format;
         uint32_t numArrayLayers;
         bool setMipLevel;
+        // Images recreated on every resize get their own VkDeviceMemory, so freeing them returns the memory
+        // instead of leaving holes in shared blocks
+        bool dedicatedAllocation = false;
+        // Overrides setMipLevel when not 0, for files that ship a shorter precomputed mip chain
+        uint32_t mipLevelCount = 0;
 
         static VulkanImageDesc create(VkImageUsageFlags imageUsageFlags, VkExtent3D extent, VkFormat format, uint32_t numArrayLayers,
                     bool setMipLevel) noexcept
@@ -43,16 +50,34 @@ namespace arsenic
     VulkanImage createImage2D(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc);
     VulkanImage createCubeImage2D(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc);
 
-    VulkanImage loadImage2DFromFile(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *imageFilePath);
-    VulkanImage loadHDRImage2DFromFile(const VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *hdrImageFilePath);
+    // The image is usable once uploadBatch has been submitted and has completed
+    VulkanImage loadImage2DFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanImageDesc &imageDesc, const char *imageFilePath);
+    // .exr files go through loadExrImage2DFromFile, everything else through stb_image as R32G32B32A32 floats
+    VulkanImage loadHDRImage2DFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanImageDesc &imageDesc, const char *hdrImageFilePath);
+    // imageDesc.format has to be VK_FORMAT_R16G16B16A16_SFLOAT or VK_FORMAT_R32G32B32A32_SFLOAT.
+    // A file that cannot be opened is reported and replaced by a black 1x1 image
+    VulkanImage loadExrImage2DFromFile(VulkanContext &vulkanContext, UploadBatch &uploadBatch, const VulkanImageDesc &imageDesc, const char *exrImageFilePath);
 
-    VulkanImage loadCubeImage2DFromFile(const VulkanContext &vulkanContext, const char *cubeJsonFilePath);
+    // Upload through a batch of their own and wait for it
+    VulkanImage loadImage2DFromFile(VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *imageFilePath);
+    VulkanImage loadHDRImage2DFromFile(VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *hdrImageFilePath);
+    VulkanImage loadExrImage2DFromFile(VulkanContext &vulkanContext, const VulkanImageDesc &imageDesc, const char *exrImageFilePath);
     
+    // viewUsage restricts the usage the view inherits from its image when not 0
     VkImageView createImageView(const VulkanContext &vulkanContext, const VkImage image, const VkImageViewType viewType, 
                             const VkFormat format, const VkImageAspectFlags imageAspect, const uint32_t baseArrayLayer, 
-                            const uint32_t layerCount, const uint32_t baseMipLevel, const uint32_t levelCount);
+                            const uint32_t layerCount, const uint32_t baseMipLevel, const uint32_t levelCount, 
+                            const VkImageUsageFlags viewUsage = 0);
   
     void destroyImage(const VulkanContext &vulkanContext, VulkanImage &vulkanImage);
+
+    // sRGB formats cannot be used for storage images, images created with VK_IMAGE_USAGE_STORAGE_BIT and an sRGB format
+    // are mutable and their storage views use the UNORM format returned here.
+    // Views in the sRGB format itself then have to drop the storage usage through createImageView's viewUsage
+    VkFormat getStorageViewFormat(const VkFormat format);
+
+    // Bytes per texel, or per 4x4 block of a block compressed format. 0 for formats no image is created with
+    uint32_t getFormatTexelBlockSize(const VkFormat format);
     
     // All mipLevels from baseArrayLayer to numArrayLayers - 1 image layout needs to be in transfer dst optimal
     // After returning, all mipLevels from baseArrayLayer to numArrayLayers - 1 image layout is in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
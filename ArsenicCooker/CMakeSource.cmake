@@ -0,0 +1,18 @@
+set(ARSENIC_COOKER_SOURCE
+"Source/CookerApp.cpp"
+"Source/SourceImage.hpp"
+"Source/SourceImage.cpp"
+"Source/BlockCompression.hpp"
+"Source/BlockCompression.cpp"
+"Source/Ktx2Writer.hpp"
+"Source/Ktx2Writer.cpp"
+"Source/PackWriter.hpp"
+"Source/PackWriter.cpp"
+"Source/ShaderBundleWriter.hpp"
+"Source/ShaderBundleWriter.cpp"
+${CMAKE_SOURCE_DIR}/Arsenic/Source/Arsenic/Renderer/ShaderMetadata.hpp
+${CMAKE_SOURCE_DIR}/Arsenic/Source/Arsenic/Renderer/ShaderMetadata.cpp
+${CMAKE_SOURCE_DIR}/External/stb/stb_image.cpp
+${CMAKE_SOURCE_DIR}/External/stb/stb_image.hpp
+${CMAKE_SOURCE_DIR}/External/spv_reflect/spirv_reflect.h
+${CMAKE_SOURCE_DIR}/External/spv_reflect/spirv_reflect.cc)
\ No newline at end of file
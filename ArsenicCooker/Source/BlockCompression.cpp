@@ -0,0 +1,651 @@
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace arsenic
+{
+    template<std::size_t N>
+    using Vector = std::array<float, N>;
+
+    template<std::size_t N>
+    using BlockTexels = std::array<Vector<N>, 16>;
+
+    static constexpr std::array<BlockFormatInfo, 6> blockFormatInfos = {{
+        {"bc1", 8, 131, 132, 128},
+        {"bc3", 16, 137, 138, 130},
+        {"bc4", 8, 139, 139, 131},
+        {"bc5", 16, 141, 141, 132},
+        {"bc6h", 16, 143, 143, 133},
+        {"bc7", 16, 145, 146, 134}
+    }};
+
+    static constexpr std::array<float, 4> bc1Weights = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    static constexpr std::array<uint32_t, 16> weights4Bit = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    // Bits are appended least significant first, which is how BC6H and BC7 blocks are laid out
+    struct BitWriter
+    {
+        std::array<uint8_t, 16> bytes = {};
+        uint32_t position = 0;
+
+        void write(const uint32_t value, const uint32_t bitCount)
+        {
+            for (uint32_t i = 0; i != bitCount; ++i, ++position) {
+                if ((value >> i) & 1) {
+                    bytes[position / 8] |= static_cast<uint8_t>(1 << (position % 8));
+                }
+            }
+        }
+    };
+
+    template<std::size_t N>
+    static float distanceSquared(const Vector<N> &a, const Vector<N> &b)
+    {
+        float distance = 0.0f;
+        for (std::size_t c = 0; c != N; ++c) {
+            distance += (a[c] - b[c]) * (a[c] - b[c]);
+        }
+
+        return distance;
+    }
+
+    // Endpoints at the extremes of the texels projected on their principal axis
+    template<std::size_t N>
+    static void fitPrincipalAxis(const BlockTexels<N> &texels, Vector<N> &endpoint0, Vector<N> &endpoint1)
+    {
+        Vector<N> mean = {};
+        for (const Vector<N> &texel : texels) {
+            for (std::size_t c = 0; c != N; ++c) {
+                mean[c] += texel[c] / 16.0f;
+            }
+        }
+
+        std::array<std::array<float, N>, N> covariance = {};
+        for (const Vector<N> &texel : texels) {
+            for (std::size_t i = 0; i != N; ++i) {
+                for (std::size_t j = 0; j != N; ++j) {
+                    covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+                }
+            }
+        }
+
+        Vector<N> axis;
+        axis.fill(1.0f);
+
+        for (uint32_t iteration = 0; iteration != 8; ++iteration) {
+            Vector<N> nextAxis = {};
+            float length = 0.0f;
+
+            for (std::size_t i = 0; i != N; ++i) {
+                for (std::size_t j = 0; j != N; ++j) {
+                    nextAxis[i] += covariance[i][j] * axis[j];
+                }
+                length = std::max(length, std::abs(nextAxis[i]));
+            }
+
+            if (length == 0.0f) {
+                break;
+            }
+
+            for (std::size_t i = 0; i != N; ++i) {
+                axis[i] = nextAxis[i] / length;
+            }
+        }
+
+        float axisLengthSquared = 0.0f;
+        for (const float value : axis) {
+            axisLengthSquared += value * value;
+        }
+
+        float minProjection = 0.0f;
+        float maxProjection = 0.0f;
+
+        for (const Vector<N> &texel : texels) {
+            float projection = 0.0f;
+            for (std::size_t c = 0; c != N; ++c) {
+                projection += (texel[c] - mean[c]) * axis[c];
+            }
+
+            minProjection = std::min(minProjection, projection / axisLengthSquared);
+            maxProjection = std::max(maxProjection, projection / axisLengthSquared);
+        }
+
+        for (std::size_t c = 0; c != N; ++c) {
+            endpoint0[c] = mean[c] + axis[c] * minProjection;
+            endpoint1[c] = mean[c] + axis[c] * maxProjection;
+        }
+    }
+
+    // Least squares endpoints for fixed indices, each texel being weights[index] of the way from endpoint0 to endpoint1
+    template<std::size_t N, std::size_t W>
+    static bool refitEndpoints(const BlockTexels<N> &texels, const std::array<uint32_t, 16> &indices, const std::array<float, W> &weights, 
+                    Vector<N> &endpoint0, Vector<N> &endpoint1)
+    {
+        float aa = 0.0f;
+        float ab = 0.0f;
+        float bb = 0.0f;
+        Vector<N> ax = {};
+        Vector<N> bx = {};
+
+        for (std::size_t i = 0; i != texels.size(); ++i) {
+            const float b = weights[indices[i]];
+            const float a = 1.0f - b;
+
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+
+            for (std::size_t c = 0; c != N; ++c) {
+                ax[c] += a * texels[i][c];
+                bx[c] += b * texels[i][c];
+            }
+        }
+
+        const float determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1E-6f) {
+            return false;
+        }
+
+        for (std::size_t c = 0; c != N; ++c) {
+            endpoint0[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+            endpoint1[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+        }
+
+        return true;
+    }
+
+    template<std::size_t N, std::size_t P>
+    static float assignIndices(const BlockTexels<N> &texels, const std::array<Vector<N>, P> &palette, std::array<uint32_t, 16> &indices)
+    {
+        float error = 0.0f;
+
+        for (std::size_t i = 0; i != texels.size(); ++i) {
+            float bestDistance = std::numeric_limits<float>::max();
+
+            for (std::size_t p = 0; p != P; ++p) {
+                const float distance = distanceSquared(texels[i], palette[p]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    indices[i] = static_cast<uint32_t>(p);
+                }
+            }
+
+            error += bestDistance;
+        }
+
+        return error;
+    }
+
+    static uint16_t packColor565(const Vector<3> &color)
+    {
+        const auto quantize = [](const float value, const float maxValue) {
+            return static_cast<uint32_t>(std::clamp(std::round(value * maxValue / 255.0f), 0.0f, maxValue));
+        };
+
+        return static_cast<uint16_t>((quantize(color[0], 31.0f) << 11) | (quantize(color[1], 63.0f) << 5) | quantize(color[2], 31.0f));
+    }
+
+    static Vector<3> unpackColor565(const uint16_t color)
+    {
+        const uint32_t r = (color >> 11) & 31;
+        const uint32_t g = (color >> 5) & 63;
+        const uint32_t b = color & 31;
+
+        return {static_cast<float>((r << 3) | (r >> 2)), static_cast<float>((g << 2) | (g >> 4)), static_cast<float>((b << 3) | (b >> 2))};
+    }
+
+    static std::array<Vector<3>, 4> buildBC1Palette(const uint16_t color0, const uint16_t color1)
+    {
+        std::array<Vector<3>, 4> palette = {unpackColor565(color0), unpackColor565(color1)};
+
+        for (std::size_t c = 0; c != 3; ++c) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+
+        return palette;
+    }
+
+    // Always uses the four color mode, so the block decodes the same inside BC1 and BC3
+    static void encodeBC1Block(const BlockTexels<3> &texels, uint8_t *pBlock)
+    {
+        Vector<3> endpoint0;
+        Vector<3> endpoint1;
+        fitPrincipalAxis(texels, endpoint1, endpoint0);
+
+        uint16_t bestColor0 = packColor565(endpoint0);
+        uint16_t bestColor1 = packColor565(endpoint1);
+        std::array<uint32_t, 16> bestIndices = {};
+        float bestError = assignIndices(texels, buildBC1Palette(bestColor0, bestColor1), bestIndices);
+
+        std::array<uint32_t, 16> indices = bestIndices;
+
+        for (uint32_t iteration = 0; iteration != 2; ++iteration) {
+            if (!refitEndpoints(texels, indices, bc1Weights, endpoint0, endpoint1)) {
+                break;
+            }
+
+            const uint16_t color0 = packColor565(endpoint0);
+            const uint16_t color1 = packColor565(endpoint1);
+            const float error = assignIndices(texels, buildBC1Palette(color0, color1), indices);
+
+            if (error >= bestError) {
+                break;
+            }
+
+            bestColor0 = color0;
+            bestColor1 = color1;
+            bestIndices = indices;
+            bestError = error;
+        }
+
+        // color0 <= color1 would switch the decoder to the three color mode
+        if (bestColor0 < bestColor1) {
+            std::swap(bestColor0, bestColor1);
+            for (uint32_t &index : bestIndices) {
+                index ^= 1;
+            }
+        }
+        else if (bestColor0 == bestColor1) {
+            bestIndices.fill(0);
+        }
+
+        uint32_t packedIndices = 0;
+        for (std::size_t i = 0; i != bestIndices.size(); ++i) {
+            packedIndices |= bestIndices[i] << (2 * i);
+        }
+
+        std::memcpy(pBlock, &bestColor0, sizeof(bestColor0));
+        std::memcpy(pBlock + 2, &bestColor1, sizeof(bestColor1));
+        std::memcpy(pBlock + 4, &packedIndices, sizeof(packedIndices));
+    }
+
+    // Eight value mode only, the two extremes of the block become the endpoints
+    static void encodeBC4Block(const std::array<float, 16> &values, uint8_t *pBlock)
+    {
+        const auto [minValue, maxValue] = std::minmax_element(values.begin(), values.end());
+        const uint32_t value0 = static_cast<uint32_t>(std::clamp(std::round(*maxValue), 0.0f, 255.0f));
+        const uint32_t value1 = static_cast<uint32_t>(std::clamp(std::round(*minValue), 0.0f, 255.0f));
+
+        std::array<float, 8> palette = {static_cast<float>(value0), static_cast<float>(value1)};
+        for (uint32_t i = 2; i != 8; ++i) {
+            palette[i] = ((8.0f - i) * value0 + (i - 1.0f) * value1) / 7.0f;
+        }
+
+        uint64_t packedIndices = 0;
+
+        if (value0 != value1) {
+            for (std::size_t i = 0; i != values.size(); ++i) {
+                uint64_t bestIndex = 0;
+                for (uint64_t p = 1; p != palette.size(); ++p) {
+                    if (std::abs(values[i] - palette[p]) < std::abs(values[i] - palette[bestIndex])) {
+                        bestIndex = p;
+                    }
+                }
+
+                packedIndices |= bestIndex << (3 * i);
+            }
+        }
+
+        pBlock[0] = static_cast<uint8_t>(value0);
+        pBlock[1] = static_cast<uint8_t>(value1);
+        for (uint32_t i = 0; i != 6; ++i) {
+            pBlock[2 + i] = static_cast<uint8_t>(packedIndices >> (8 * i));
+        }
+    }
+
+    template<std::size_t N>
+    static std::array<Vector<N>, 16> buildInterpolatedPalette(const std::array<uint32_t, N> &decoded0, const std::array<uint32_t, N> &decoded1)
+    {
+        std::array<Vector<N>, 16> palette = {};
+
+        for (std::size_t p = 0; p != palette.size(); ++p) {
+            for (std::size_t c = 0; c != N; ++c) {
+                palette[p][c] = static_cast<float>(((64 - weights4Bit[p]) * decoded0[c] + weights4Bit[p] * decoded1[c] + 32) >> 6);
+            }
+        }
+
+        return palette;
+    }
+
+    static std::array<float, 16> getWeights4Bit()
+    {
+        std::array<float, 16> weights = {};
+        for (std::size_t i = 0; i != weights.size(); ++i) {
+            weights[i] = weights4Bit[i] / 64.0f;
+        }
+
+        return weights;
+    }
+
+    // BC7 mode 6: one subset, 7 bit RGBA endpoints with a p bit each and 4 bit indices
+    static void quantizeBC7Endpoint(const Vector<4> &endpoint, std::array<uint32_t, 4> &quantized, uint32_t &pBit)
+    {
+        float bestError = std::numeric_limits<float>::max();
+
+        for (uint32_t p = 0; p != 2; ++p) {
+            std::array<uint32_t, 4> candidate = {};
+            float error = 0.0f;
+
+            for (std::size_t c = 0; c != 4; ++c) {
+                candidate[c] = static_cast<uint32_t>(std::clamp(std::round((endpoint[c] - p) / 2.0f), 0.0f, 127.0f));
+                const float decoded = static_cast<float>((candidate[c] << 1) | p);
+                error += (decoded - endpoint[c]) * (decoded - endpoint[c]);
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                quantized = candidate;
+                pBit = p;
+            }
+        }
+    }
+
+    static float evaluateBC7Endpoints(const BlockTexels<4> &texels, const Vector<4> &endpoint0, const Vector<4> &endpoint1,
+                    std::array<std::array<uint32_t, 4>, 2> &quantized, std::array<uint32_t, 2> &pBits, std::array<uint32_t, 16> &indices)
+    {
+        quantizeBC7Endpoint(endpoint0, quantized[0], pBits[0]);
+        quantizeBC7Endpoint(endpoint1, quantized[1], pBits[1]);
+
+        std::array<uint32_t, 4> decoded0 = {};
+        std::array<uint32_t, 4> decoded1 = {};
+        for (std::size_t c = 0; c != 4; ++c) {
+            decoded0[c] = (quantized[0][c] << 1) | pBits[0];
+            decoded1[c] = (quantized[1][c] << 1) | pBits[1];
+        }
+
+        return assignIndices(texels, buildInterpolatedPalette<4>(decoded0, decoded1), indices);
+    }
+
+    static void encodeBC7Block(const BlockTexels<4> &texels, uint8_t *pBlock)
+    {
+        static const std::array<float, 16> weights = getWeights4Bit();
+
+        Vector<4> endpoint0;
+        Vector<4> endpoint1;
+        fitPrincipalAxis(texels, endpoint0, endpoint1);
+
+        std::array<std::array<uint32_t, 4>, 2> bestQuantized = {};
+        std::array<uint32_t, 2> bestPBits = {};
+        std::array<uint32_t, 16> bestIndices = {};
+        float bestError = evaluateBC7Endpoints(texels, endpoint0, endpoint1, bestQuantized, bestPBits, bestIndices);
+
+        std::array<uint32_t, 16> indices = bestIndices;
+
+        for (uint32_t iteration = 0; iteration != 2; ++iteration) {
+            if (!refitEndpoints(texels, indices, weights, endpoint0, endpoint1)) {
+                break;
+            }
+
+            std::array<std::array<uint32_t, 4>, 2> quantized = {};
+            std::array<uint32_t, 2> pBits = {};
+            const float error = evaluateBC7Endpoints(texels, endpoint0, endpoint1, quantized, pBits, indices);
+
+            if (error >= bestError) {
+                break;
+            }
+
+            bestQuantized = quantized;
+            bestPBits = pBits;
+            bestIndices = indices;
+            bestError = error;
+        }
+
+        // The most significant bit of the first index is implied to be 0
+        if (bestIndices[0] >= 8) {
+            std::swap(bestQuantized[0], bestQuantized[1]);
+            std::swap(bestPBits[0], bestPBits[1]);
+            for (uint32_t &index : bestIndices) {
+                index = 15 - index;
+            }
+        }
+
+        BitWriter bitWriter;
+        bitWriter.write(1 << 6, 7);
+
+        for (std::size_t c = 0; c != 4; ++c) {
+            bitWriter.write(bestQuantized[0][c], 7);
+            bitWriter.write(bestQuantized[1][c], 7);
+        }
+
+        bitWriter.write(bestPBits[0], 1);
+        bitWriter.write(bestPBits[1], 1);
+
+        for (std::size_t i = 0; i != bestIndices.size(); ++i) {
+            bitWriter.write(bestIndices[i], i == 0 ? 3 : 4);
+        }
+
+        std::memcpy(pBlock, bitWriter.bytes.data(), bitWriter.bytes.size());
+    }
+
+    static uint16_t floatToHalf(const float value)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (exponent <= 0) {
+            if (exponent < -10) {
+                return static_cast<uint16_t>(sign);
+            }
+
+            mantissa = (mantissa | 0x800000) >> (1 - exponent);
+            return static_cast<uint16_t>(sign | ((mantissa + 0x1000) >> 13));
+        }
+
+        if (exponent >= 31) {
+            return static_cast<uint16_t>(sign | 0x7BFF);
+        }
+
+        const uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        return static_cast<uint16_t>(std::min(half + ((mantissa >> 12) & 1), sign | 0x7BFFu));
+    }
+
+    // BC6H mode 11: one region, 10 bit endpoints without delta transform and 4 bit indices.
+    // Endpoints are fit on the half float bit patterns, which is the space the hardware interpolates in
+    static uint32_t unquantizeBC6H(const uint32_t value)
+    {
+        if (value == 0) {
+            return 0;
+        }
+
+        return value == 1023 ? 0xFFFF : (value << 6) + 32;
+    }
+
+    static float evaluateBC6HEndpoints(const BlockTexels<3> &texels, const Vector<3> &endpoint0, const Vector<3> &endpoint1,
+                    std::array<std::array<uint32_t, 3>, 2> &quantized, std::array<uint32_t, 16> &indices)
+    {
+        std::array<std::array<uint32_t, 3>, 2> unquantized = {};
+
+        for (std::size_t c = 0; c != 3; ++c) {
+            quantized[0][c] = static_cast<uint32_t>(std::clamp(std::round((endpoint0[c] * 64.0f / 31.0f - 32.0f) / 64.0f), 0.0f, 1023.0f));
+            quantized[1][c] = static_cast<uint32_t>(std::clamp(std::round((endpoint1[c] * 64.0f / 31.0f - 32.0f) / 64.0f), 0.0f, 1023.0f));
+            unquantized[0][c] = unquantizeBC6H(quantized[0][c]);
+            unquantized[1][c] = unquantizeBC6H(quantized[1][c]);
+        }
+
+        std::array<Vector<3>, 16> palette = buildInterpolatedPalette<3>(unquantized[0], unquantized[1]);
+        for (Vector<3> &entry : palette) {
+            for (float &value : entry) {
+                value = static_cast<float>((static_cast<uint32_t>(value) * 31) >> 6);
+            }
+        }
+
+        return assignIndices(texels, palette, indices);
+    }
+
+    static void encodeBC6HBlock(const BlockTexels<3> &texels, uint8_t *pBlock)
+    {
+        static const std::array<float, 16> weights = getWeights4Bit();
+
+        Vector<3> endpoint0;
+        Vector<3> endpoint1;
+        fitPrincipalAxis(texels, endpoint0, endpoint1);
+
+        std::array<std::array<uint32_t, 3>, 2> bestQuantized = {};
+        std::array<uint32_t, 16> bestIndices = {};
+        float bestError = evaluateBC6HEndpoints(texels, endpoint0, endpoint1, bestQuantized, bestIndices);
+
+        std::array<uint32_t, 16> indices = bestIndices;
+
+        for (uint32_t iteration = 0; iteration != 2; ++iteration) {
+            if (!refitEndpoints(texels, indices, weights, endpoint0, endpoint1)) {
+                break;
+            }
+
+            std::array<std::array<uint32_t, 3>, 2> quantized = {};
+            const float error = evaluateBC6HEndpoints(texels, endpoint0, endpoint1, quantized, indices);
+
+            if (error >= bestError) {
+                break;
+            }
+
+            bestQuantized = quantized;
+            bestIndices = indices;
+            bestError = error;
+        }
+
+        if (bestIndices[0] >= 8) {
+            std::swap(bestQuantized[0], bestQuantized[1]);
+            for (uint32_t &index : bestIndices) {
+                index = 15 - index;
+            }
+        }
+
+        BitWriter bitWriter;
+        bitWriter.write(0x03, 5);
+
+        for (const std::array<uint32_t, 3> &endpoint : bestQuantized) {
+            for (const uint32_t value : endpoint) {
+                bitWriter.write(value, 10);
+            }
+        }
+
+        for (std::size_t i = 0; i != bestIndices.size(); ++i) {
+            bitWriter.write(bestIndices[i], i == 0 ? 3 : 4);
+        }
+
+        std::memcpy(pBlock, bitWriter.bytes.data(), bitWriter.bytes.size());
+    }
+
+    static void encodeBlock(const SourceImage &image, const BlockFormat blockFormat, const bool srgb, const uint32_t blockX, 
+                    const uint32_t blockY, uint8_t *pBlock)
+    {
+        // LDR channels in the 0-255 range of the stored encoding, BC6H channels as half float bit patterns
+        BlockTexels<4> texels = {};
+
+        for (uint32_t y = 0; y != 4; ++y) {
+            for (uint32_t x = 0; x != 4; ++x) {
+                const float *pTexel = image.getTexel(std::min(blockX * 4 + x, image.width - 1), std::min(blockY * 4 + y, image.height - 1));
+                Vector<4> &texel = texels[y * 4 + x];
+
+                for (std::size_t c = 0; c != 4; ++c) {
+                    if (blockFormat == BlockFormat::BC6H) {
+                        texel[c] = static_cast<float>(floatToHalf(std::max(pTexel[c], 0.0f)));
+                    }
+                    else {
+                        const float value = std::clamp(pTexel[c], 0.0f, 1.0f);
+                        texel[c] = 255.0f * (srgb && c != 3 ? linearToSrgb(value) : value);
+                    }
+                }
+            }
+        }
+
+        const auto getChannel = [&](const std::size_t channel) {
+            std::array<float, 16> values = {};
+            for (std::size_t i = 0; i != texels.size(); ++i) {
+                values[i] = texels[i][channel];
+            }
+
+            return values;
+        };
+
+        const auto getColor = [&]() {
+            BlockTexels<3> colors = {};
+            for (std::size_t i = 0; i != texels.size(); ++i) {
+                colors[i] = {texels[i][0], texels[i][1], texels[i][2]};
+            }
+
+            return colors;
+        };
+
+        switch (blockFormat) {
+        case BlockFormat::BC1:
+            encodeBC1Block(getColor(), pBlock);
+            break;
+        case BlockFormat::BC3:
+            encodeBC4Block(getChannel(3), pBlock);
+            encodeBC1Block(getColor(), pBlock + 8);
+            break;
+        case BlockFormat::BC4:
+            encodeBC4Block(getChannel(0), pBlock);
+            break;
+        case BlockFormat::BC5:
+            encodeBC4Block(getChannel(0), pBlock);
+            encodeBC4Block(getChannel(1), pBlock + 8);
+            break;
+        case BlockFormat::BC6H:
+            encodeBC6HBlock(getColor(), pBlock);
+            break;
+        case BlockFormat::BC7:
+            encodeBC7Block(texels, pBlock);
+            break;
+        }
+    }
+
+    const BlockFormatInfo &getBlockFormatInfo(const BlockFormat blockFormat)
+    {
+        return blockFormatInfos[static_cast<std::size_t>(blockFormat)];
+    }
+
+    bool parseBlockFormat(const char *pName, BlockFormat &blockFormat)
+    {
+        for (std::size_t i = 0; i != blockFormatInfos.size(); ++i) {
+            if (std::strcmp(blockFormatInfos[i].name, pName) == 0) {
+                blockFormat = static_cast<BlockFormat>(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::vector<uint8_t> compressImage(const SourceImage &image, const BlockFormat blockFormat, const bool srgb)
+    {
+        const uint32_t blockSize = getBlockFormatInfo(blockFormat).blockSize;
+        const uint32_t blockCountX = (image.width + 3) / 4;
+        const uint32_t blockCountY = (image.height + 3) / 4;
+
+        std::vector<uint8_t> blocks(static_cast<std::size_t>(blockCountX) * blockCountY * blockSize);
+
+        // Block rows are independent, so they are simply interleaved across the threads
+        const uint32_t threadCount = std::min(std::max(std::thread::hardware_concurrency(), 1u), blockCountY);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+
+        for (uint32_t t = 0; t != threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t blockY = t; blockY < blockCountY; blockY += threadCount) {
+                    for (uint32_t blockX = 0; blockX != blockCountX; ++blockX) {
+                        uint8_t *pBlock = blocks.data() + (static_cast<std::size_t>(blockY) * blockCountX + blockX) * blockSize;
+                        encodeBlock(image, blockFormat, srgb, blockX, blockY, pBlock);
+                    }
+                }
+            });
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        return blocks;
+    }
+}
\ No newline at end of file
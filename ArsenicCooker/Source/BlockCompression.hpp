@@ -0,0 +1,34 @@
+#pragma once
+
+#include "SourceImage.hpp"
+
+namespace arsenic
+{
+    enum class BlockFormat
+    {
+        BC1,
+        BC3,
+        BC4,
+        BC5,
+        BC6H,
+        BC7
+    };
+
+    struct BlockFormatInfo
+    {
+        const char *name;
+        uint32_t blockSize;
+        // VkFormat values, the cooker does not depend on the Vulkan headers
+        uint32_t unormVkFormat;
+        uint32_t srgbVkFormat;
+        // KHR_DF_MODEL_* of the data format descriptor
+        uint32_t colorModel;
+    };
+
+    const BlockFormatInfo &getBlockFormatInfo(const BlockFormat blockFormat);
+    bool parseBlockFormat(const char *pName, BlockFormat &blockFormat);
+
+    // Encodes every 4x4 block of image, edge blocks repeat the last row and column.
+    // LDR formats are encoded in sRGB space when srgb is set, BC6H stores the linear values as unsigned half floats
+    std::vector<uint8_t> compressImage(const SourceImage &image, const BlockFormat blockFormat, const bool srgb);
+}
\ No newline at end of file
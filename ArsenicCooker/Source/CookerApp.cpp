@@ -0,0 +1,287 @@
+#include "BlockCompression.hpp"
+#include "Ktx2Writer.hpp"
+#include "PackWriter.hpp"
+#include "ShaderBundleWriter.hpp"
+
+#include "nlohmann/json.hpp"
+#include "stb_image.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace arsenic
+{
+    struct CookerOptions
+    {
+        std::string inputPath;
+        std::string outputPath;
+        BlockFormat blockFormat = BlockFormat::BC7;
+        bool formatSpecified = false;
+        bool linear = false;
+        bool generateMipLevels = true;
+        MipFilter mipFilter = MipFilter::Kaiser;
+    };
+
+    static void printUsage()
+    {
+        std::cout << "Usage: ArsenicCooker <input> <output.ktx2> [--format bc1|bc3|bc4|bc5|bc6h|bc7] [--linear] [--no-mips] [--mip-filter kaiser|box]\n"
+                  << "  input is a jpg/png/tga/bmp, an hdr, or a cube map json listing six faces like Assets/Scene/enviromentMap.json\n"
+                  << "  --format   defaults to bc6h for hdr input and bc7 otherwise\n"
+                  << "  --linear   stores LDR color without the sRGB transfer, for normal and data maps\n"
+                  << "  --no-mips  writes only the top level\n"
+                  << "  --mip-filter  defaults to kaiser, mips are always filtered in linear space\n"
+                  << "Usage: ArsenicCooker --pack <directory> <output.pack> [--order <list.txt>]\n"
+                  << "  packs every file below directory, mount it with mountPack at the directory's name\n"
+                  << "  --order  text file with one path relative to directory per line, those files are stored first in that order\n"
+                  << "Usage: ArsenicCooker --shader-bundle <pso.json|compute.spv> <output.bundle>\n"
+                  << "  bakes the SPIR-V, descriptor layouts, push constant size, specialization constants and pipeline state of a shader pass\n"
+                  << "  spv paths in a PSO are relative to the working directory, run it from the one the game runs in\n";
+    }
+
+    static bool parseOptions(const int argc, char **argv, CookerOptions &options)
+    {
+        if (argc < 3) {
+            return false;
+        }
+
+        options.inputPath = argv[1];
+        options.outputPath = argv[2];
+
+        for (int i = 3; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+                if (!parseBlockFormat(argv[++i], options.blockFormat)) {
+                    std::cerr << "Unknown format " << argv[i] << "\n";
+                    return false;
+                }
+                options.formatSpecified = true;
+            }
+            else if (std::strcmp(argv[i], "--linear") == 0) {
+                options.linear = true;
+            }
+            else if (std::strcmp(argv[i], "--mip-filter") == 0 && i + 1 < argc) {
+                if (!parseMipFilter(argv[++i], options.mipFilter)) {
+                    std::cerr << "Unknown mip filter " << argv[i] << "\n";
+                    return false;
+                }
+            }
+            else if (std::strcmp(argv[i], "--no-mips") == 0) {
+                options.generateMipLevels = false;
+            }
+            else {
+                std::cerr << "Unknown option " << argv[i] << "\n";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool hasExtension(const std::string &path, const char *pExtension)
+    {
+        const std::size_t extensionLength = std::strlen(pExtension);
+
+        return path.size() >= extensionLength && path.compare(path.size() - extensionLength, extensionLength, pExtension) == 0;
+    }
+
+    // LDR files are converted to linear so mip levels are filtered in linear space
+    static bool loadSourceImage(const std::string &path, const bool srgb, SourceImage &image)
+    {
+        int width = 0;
+        int height = 0;
+        int numChannels = 0;
+
+        if (stbi_is_hdr(path.c_str())) {
+            float *pTexels = stbi_loadf(path.c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
+            if (pTexels == nullptr) {
+                std::cerr << "Failed to load " << path << ": " << stbi_failure_reason() << "\n";
+                return false;
+            }
+
+            image.width = static_cast<uint32_t>(width);
+            image.height = static_cast<uint32_t>(height);
+            image.texels.assign(pTexels, pTexels + 4ull * width * height);
+            stbi_image_free(pTexels);
+
+            return true;
+        }
+
+        stbi_uc *pTexels = stbi_load(path.c_str(), &width, &height, &numChannels, STBI_rgb_alpha);
+        if (pTexels == nullptr) {
+            std::cerr << "Failed to load " << path << ": " << stbi_failure_reason() << "\n";
+            return false;
+        }
+
+        image.width = static_cast<uint32_t>(width);
+        image.height = static_cast<uint32_t>(height);
+        image.texels.resize(4ull * width * height);
+
+        for (std::size_t i = 0; i != image.texels.size(); ++i) {
+            const float value = pTexels[i] / 255.0f;
+            image.texels[i] = srgb && i % 4 != 3 ? srgbToLinear(value) : value;
+        }
+
+        stbi_image_free(pTexels);
+
+        return true;
+    }
+
+    static bool loadFacePaths(const std::string &cubeJsonPath, std::vector<std::string> &facePaths)
+    {
+        std::ifstream file(cubeJsonPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << cubeJsonPath << "\n";
+            return false;
+        }
+
+        nlohmann::json cubeMapJson;
+        file >> cubeMapJson;
+
+        // Vulkan cube layer order
+        constexpr std::array<const char *, 6> faceNames = {"right", "left", "top", "bottom", "forward", "backward"};
+
+        for (const char *pFaceName : faceNames) {
+            facePaths.push_back(cubeMapJson[pFaceName].get<std::string>());
+        }
+
+        return true;
+    }
+
+    static int cook(const CookerOptions &options)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        std::vector<std::string> facePaths;
+        if (hasExtension(options.inputPath, ".json")) {
+            if (!loadFacePaths(options.inputPath, facePaths)) {
+                return 1;
+            }
+        }
+        else {
+            facePaths.push_back(options.inputPath);
+        }
+
+        const bool hdr = stbi_is_hdr(facePaths[0].c_str()) != 0;
+        const BlockFormat blockFormat = options.formatSpecified ? options.blockFormat : (hdr ? BlockFormat::BC6H : BlockFormat::BC7);
+        const BlockFormatInfo &formatInfo = getBlockFormatInfo(blockFormat);
+        const bool srgb = !hdr && !options.linear && formatInfo.srgbVkFormat != formatInfo.unormVkFormat;
+
+        Ktx2Image ktx2Image = {};
+        ktx2Image.blockFormat = blockFormat;
+        ktx2Image.srgb = srgb;
+        ktx2Image.faceCount = static_cast<uint32_t>(facePaths.size());
+
+        for (const std::string &facePath : facePaths) {
+            SourceImage sourceImage;
+            if (!loadSourceImage(facePath, !hdr && !options.linear, sourceImage)) {
+                return 1;
+            }
+
+            if (ktx2Image.levels.empty()) {
+                ktx2Image.width = sourceImage.width;
+                ktx2Image.height = sourceImage.height;
+            }
+            else if (sourceImage.width != ktx2Image.width || sourceImage.height != ktx2Image.height) {
+                std::cerr << facePath << " does not match the size of the first face\n";
+                return 1;
+            }
+
+            const std::vector<SourceImage> mipChain = buildMipChain(std::move(sourceImage), options.generateMipLevels, options.mipFilter);
+            ktx2Image.levels.resize(mipChain.size());
+
+            for (std::size_t level = 0; level != mipChain.size(); ++level) {
+                ktx2Image.levels[level].push_back(compressImage(mipChain[level], blockFormat, srgb));
+            }
+        }
+
+        if (!writeKtx2File(options.outputPath, ktx2Image)) {
+            std::cerr << "Failed to write " << options.outputPath << "\n";
+            return 1;
+        }
+
+        const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << options.outputPath << ": " << formatInfo.name << (srgb ? " srgb" : "") << ", " << ktx2Image.width << "x" << ktx2Image.height 
+                  << ", " << ktx2Image.faceCount << " face(s), " << ktx2Image.levels.size() << " level(s) in " << elapsedMs << " ms\n";
+
+        return 0;
+    }
+
+    static int pack(const int argc, char **argv)
+    {
+        if (argc != 4 && !(argc == 6 && std::strcmp(argv[4], "--order") == 0)) {
+            printUsage();
+            return 1;
+        }
+
+        std::vector<std::string> leadingPaths;
+
+        if (argc == 6) {
+            std::ifstream orderFile(argv[5]);
+            if (!orderFile.is_open()) {
+                std::cerr << "Failed to open " << argv[5] << "\n";
+                return 1;
+            }
+
+            for (std::string line; std::getline(orderFile, line);) {
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+
+                if (!line.empty()) {
+                    leadingPaths.push_back(line);
+                }
+            }
+        }
+
+        PackStats stats = {};
+        if (!writePackFile(argv[3], argv[2], leadingPaths, stats)) {
+            std::cerr << "Failed to write " << argv[3] << "\n";
+            return 1;
+        }
+
+        std::cout << argv[3] << ": " << stats.fileCount << " file(s), " << (stats.packSize >> 10) << " KiB\n";
+
+        return 0;
+    }
+
+    static int shaderBundle(const int argc, char **argv)
+    {
+        if (argc != 4) {
+            printUsage();
+            return 1;
+        }
+
+        ShaderBundleStats stats = {};
+        if (!writeShaderBundle(argv[3], argv[2], stats)) {
+            std::cerr << "Failed to write " << argv[3] << "\n";
+            return 1;
+        }
+
+        std::cout << argv[3] << ": " << stats.stageCount << " stage(s), " << stats.bindingCount << " binding(s), " << stats.specializationConstantCount 
+                  << " specialization constant(s), " << (stats.bundleSize >> 10) << " KiB\n";
+
+        return 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--pack") == 0) {
+        return arsenic::pack(argc, argv);
+    }
+
+    if (argc > 1 && std::strcmp(argv[1], "--shader-bundle") == 0) {
+        return arsenic::shaderBundle(argc, argv);
+    }
+
+    arsenic::CookerOptions options;
+
+    if (!arsenic::parseOptions(argc, argv, options)) {
+        arsenic::printUsage();
+        return 1;
+    }
+
+    return arsenic::cook(options);
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "Ktx2Writer.hpp"
+
+#include <array>
+#include <fstream>
+
+namespace arsenic
+{
+    static constexpr std::array<uint8_t, 12> ktx2Identifier = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    static constexpr uint32_t khrDfPrimariesBT709 = 1;
+    static constexpr uint32_t khrDfTransferLinear = 1;
+    static constexpr uint32_t khrDfTransferSrgb = 2;
+    static constexpr uint32_t khrDfSampleDatatypeFloat = 0x80;
+    static constexpr uint32_t khrDfChannelAlpha = 15;
+
+    struct DfdSample
+    {
+        uint32_t bitOffset;
+        uint32_t bitLength;
+        uint32_t channelType;
+        uint32_t sampleLower;
+        uint32_t sampleUpper;
+    };
+
+    static std::vector<DfdSample> getDfdSamples(const BlockFormat blockFormat)
+    {
+        constexpr uint32_t unormUpper = 0xFFFFFFFF;
+
+        switch (blockFormat) {
+        case BlockFormat::BC1:
+            return {{0, 64, 0, 0, unormUpper}};
+        case BlockFormat::BC3:
+            return {{0, 64, khrDfChannelAlpha, 0, unormUpper}, {64, 64, 0, 0, unormUpper}};
+        case BlockFormat::BC4:
+            return {{0, 64, 0, 0, unormUpper}};
+        case BlockFormat::BC5:
+            return {{0, 64, 0, 0, unormUpper}, {64, 64, 1, 0, unormUpper}};
+        case BlockFormat::BC6H:
+            return {{0, 128, khrDfSampleDatatypeFloat, 0xBF800000, 0x7F800000}};
+        case BlockFormat::BC7:
+            return {{0, 128, 0, 0, unormUpper}};
+        }
+
+        return {};
+    }
+
+    static std::vector<uint32_t> buildDataFormatDescriptor(const Ktx2Image &image)
+    {
+        const BlockFormatInfo &formatInfo = getBlockFormatInfo(image.blockFormat);
+        const std::vector<DfdSample> samples = getDfdSamples(image.blockFormat);
+        const uint32_t blockByteSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+
+        std::vector<uint32_t> words;
+        words.push_back(4 + blockByteSize);
+        // Khronos vendor, basic descriptor type
+        words.push_back(0);
+        words.push_back(2 | (blockByteSize << 16));
+        words.push_back(formatInfo.colorModel | (khrDfPrimariesBT709 << 8) | ((image.srgb ? khrDfTransferSrgb : khrDfTransferLinear) << 16));
+        // 4x4x1x1 texel blocks, stored minus one
+        words.push_back(3 | (3 << 8));
+        words.push_back(formatInfo.blockSize);
+        words.push_back(0);
+
+        for (const DfdSample &sample : samples) {
+            words.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16) | (sample.channelType << 24));
+            words.push_back(0);
+            words.push_back(sample.sampleLower);
+            words.push_back(sample.sampleUpper);
+        }
+
+        return words;
+    }
+
+    static void writeUint32(std::vector<uint8_t> &bytes, const uint32_t value)
+    {
+        for (uint32_t i = 0; i != 4; ++i) {
+            bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    static void writeUint64(std::vector<uint8_t> &bytes, const uint64_t value)
+    {
+        writeUint32(bytes, static_cast<uint32_t>(value));
+        writeUint32(bytes, static_cast<uint32_t>(value >> 32));
+    }
+
+    bool writeKtx2File(const std::string &filePath, const Ktx2Image &image)
+    {
+        const BlockFormatInfo &formatInfo = getBlockFormatInfo(image.blockFormat);
+        const uint32_t levelCount = static_cast<uint32_t>(image.levels.size());
+        const std::vector<uint32_t> dfd = buildDataFormatDescriptor(image);
+
+        const uint32_t levelIndexOffset = 80;
+        const uint32_t dfdOffset = levelIndexOffset + 24 * levelCount;
+        const uint32_t dfdLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+        // Level data is aligned to the texel block size, which is a multiple of 4 for every BC format
+        const auto alignOffset = [&](const uint64_t offset) {
+            return (offset + formatInfo.blockSize - 1) / formatInfo.blockSize * formatInfo.blockSize;
+        };
+
+        // The smallest level comes first in the file
+        std::vector<uint64_t> levelOffsets(levelCount);
+        std::vector<uint64_t> levelLengths(levelCount);
+        uint64_t offset = dfdOffset + dfdLength;
+
+        for (uint32_t level = levelCount; level-- != 0;) {
+            levelLengths[level] = 0;
+            for (const std::vector<uint8_t> &face : image.levels[level]) {
+                levelLengths[level] += face.size();
+            }
+
+            offset = alignOffset(offset);
+            levelOffsets[level] = offset;
+            offset += levelLengths[level];
+        }
+
+        std::vector<uint8_t> bytes(ktx2Identifier.begin(), ktx2Identifier.end());
+        writeUint32(bytes, image.srgb ? formatInfo.srgbVkFormat : formatInfo.unormVkFormat);
+        // typeSize is 1 for block compressed formats
+        writeUint32(bytes, 1);
+        writeUint32(bytes, image.width);
+        writeUint32(bytes, image.height);
+        writeUint32(bytes, 0);
+        writeUint32(bytes, 0);
+        writeUint32(bytes, image.faceCount);
+        writeUint32(bytes, levelCount);
+        writeUint32(bytes, 0);
+
+        writeUint32(bytes, dfdOffset);
+        writeUint32(bytes, dfdLength);
+        writeUint32(bytes, 0);
+        writeUint32(bytes, 0);
+        writeUint64(bytes, 0);
+        writeUint64(bytes, 0);
+
+        for (uint32_t level = 0; level != levelCount; ++level) {
+            writeUint64(bytes, levelOffsets[level]);
+            writeUint64(bytes, levelLengths[level]);
+            writeUint64(bytes, levelLengths[level]);
+        }
+
+        for (const uint32_t word : dfd) {
+            writeUint32(bytes, word);
+        }
+
+        for (uint32_t level = levelCount; level-- != 0;) {
+            bytes.resize(levelOffsets[level], 0);
+
+            for (const std::vector<uint8_t> &face : image.levels[level]) {
+                bytes.insert(bytes.end(), face.begin(), face.end());
+            }
+        }
+
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        return file.good();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "BlockCompression.hpp"
+
+#include <string>
+
+namespace arsenic
+{
+    struct Ktx2Image
+    {
+        BlockFormat blockFormat;
+        bool srgb;
+        uint32_t width;
+        uint32_t height;
+        uint32_t faceCount;
+        // Indexed by mip level then face, level 0 is the largest
+        std::vector<std::vector<std::vector<uint8_t>>> levels;
+    };
+
+    // Writes an uncompressed (no supercompression) KTX2 file with a basic data format descriptor
+    bool writeKtx2File(const std::string &filePath, const Ktx2Image &image);
+}
\ No newline at end of file
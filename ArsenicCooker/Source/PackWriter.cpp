@@ -0,0 +1,159 @@
+#include "PackWriter.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+namespace arsenic
+{
+    static constexpr uint32_t packMagic = 0x4B504141;
+    static constexpr uint32_t packVersion = 1;
+    static constexpr uint64_t packDataAlignment = 64;
+    static constexpr uint64_t packHeaderSize = 32;
+    static constexpr uint64_t packEntrySize = 24;
+
+    struct PackFile
+    {
+        std::string name;
+        std::filesystem::path path;
+        uint64_t size;
+        uint64_t dataOffset;
+        uint32_t nameOffset;
+    };
+
+    static void writeUint32(std::vector<uint8_t> &bytes, const uint32_t value)
+    {
+        for (uint32_t i = 0; i != 4; ++i) {
+            bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    static void writeUint64(std::vector<uint8_t> &bytes, const uint64_t value)
+    {
+        writeUint32(bytes, static_cast<uint32_t>(value));
+        writeUint32(bytes, static_cast<uint32_t>(value >> 32));
+    }
+
+    static uint64_t alignUp(const uint64_t value, const uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool writePackFile(const std::string &packFilePath, const std::string &directoryPath, const std::vector<std::string> &leadingPaths,
+                    PackStats &stats)
+    {
+        std::error_code errorCode;
+        const std::filesystem::path rootPath(directoryPath);
+        const std::filesystem::path outputPath = std::filesystem::absolute(packFilePath, errorCode);
+
+        std::vector<PackFile> files;
+
+        for (auto it = std::filesystem::recursive_directory_iterator(rootPath, errorCode); !errorCode && it != std::filesystem::recursive_directory_iterator();
+            it.increment(errorCode)) {
+            // The pack may be written into the directory it packs
+            if (!it->is_regular_file() || std::filesystem::absolute(it->path(), errorCode) == outputPath) {
+                continue;
+            }
+
+            files.push_back({it->path().lexically_relative(rootPath).generic_string(), it->path(), it->file_size(), 0, 0});
+        }
+
+        if (errorCode) {
+            std::cerr << "Failed to list " << directoryPath << ": " << errorCode.message() << "\n";
+            return false;
+        }
+
+        // Data order: leading paths as given, then everything else by name
+        std::sort(files.begin(), files.end(), [](const PackFile &a, const PackFile &b) { return a.name < b.name; });
+
+        std::vector<PackFile *> dataOrder;
+        std::unordered_set<std::string> leadingNames;
+        dataOrder.reserve(files.size());
+
+        for (const std::string &leadingPath : leadingPaths) {
+            const auto it = std::lower_bound(files.begin(), files.end(), leadingPath, [](const PackFile &file, const std::string &name) {
+                return file.name < name;
+            });
+
+            if (it == files.end() || it->name != leadingPath) {
+                std::cerr << leadingPath << " is not below " << directoryPath << ", ignored\n";
+            }
+            else if (leadingNames.insert(leadingPath).second) {
+                dataOrder.push_back(&*it);
+            }
+        }
+
+        for (PackFile &file : files) {
+            if (leadingNames.count(file.name) == 0) {
+                dataOrder.push_back(&file);
+            }
+        }
+
+        std::vector<uint8_t> names;
+        for (PackFile &file : files) {
+            file.nameOffset = static_cast<uint32_t>(names.size());
+            names.insert(names.end(), file.name.begin(), file.name.end());
+        }
+
+        const uint64_t entriesOffset = packHeaderSize;
+        const uint64_t namesOffset = entriesOffset + files.size() * packEntrySize;
+
+        uint64_t dataOffset = alignUp(namesOffset + names.size(), packDataAlignment);
+        for (PackFile *pFile : dataOrder) {
+            pFile->dataOffset = dataOffset;
+            dataOffset = alignUp(dataOffset + pFile->size, packDataAlignment);
+        }
+
+        std::vector<uint8_t> bytes;
+        bytes.reserve(static_cast<std::size_t>(namesOffset + names.size()));
+
+        writeUint32(bytes, packMagic);
+        writeUint32(bytes, packVersion);
+        writeUint32(bytes, static_cast<uint32_t>(files.size()));
+        writeUint32(bytes, 0);
+        writeUint64(bytes, entriesOffset);
+        writeUint64(bytes, namesOffset);
+
+        // Entries stay sorted by name so the runtime can binary search them
+        for (const PackFile &file : files) {
+            writeUint64(bytes, file.dataOffset);
+            writeUint64(bytes, file.size);
+            writeUint32(bytes, file.nameOffset);
+            writeUint32(bytes, static_cast<uint32_t>(file.name.size()));
+        }
+
+        bytes.insert(bytes.end(), names.begin(), names.end());
+
+        std::ofstream packFile(packFilePath, std::ios::binary);
+        if (!packFile.is_open()) {
+            return false;
+        }
+
+        packFile.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        std::vector<char> fileData;
+        for (const PackFile *pFile : dataOrder) {
+            std::ifstream file(pFile->path, std::ios::binary);
+            fileData.resize(static_cast<std::size_t>(pFile->size));
+
+            if (!file.is_open() || !file.read(fileData.data(), static_cast<std::streamsize>(fileData.size()))) {
+                std::cerr << "Failed to read " << pFile->path.string() << "\n";
+                return false;
+            }
+
+            const std::streamoff padding = static_cast<std::streamoff>(pFile->dataOffset) - packFile.tellp();
+            for (std::streamoff i = 0; i < padding; ++i) {
+                packFile.put(0);
+            }
+
+            packFile.write(fileData.data(), static_cast<std::streamsize>(fileData.size()));
+        }
+
+        stats.fileCount = static_cast<uint32_t>(files.size());
+        stats.packSize = static_cast<uint64_t>(packFile.tellp());
+
+        return packFile.good();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace arsenic
+{
+    struct PackStats
+    {
+        uint32_t fileCount;
+        uint64_t packSize;
+    };
+
+    // Packs every file below directoryPath, stored under its path relative to the directory with forward slashes.
+    // Files named in leadingPaths are stored first and in that order, e.g. the ones read at startup, the rest follows sorted by path.
+    // The layout matches PackHeader and PackEntry in Arsenic/Core/FileSystem.hpp
+    bool writePackFile(const std::string &packFilePath, const std::string &directoryPath, const std::vector<std::string> &leadingPaths,
+                    PackStats &stats);
+}
\ No newline at end of file
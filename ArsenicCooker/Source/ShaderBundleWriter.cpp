@@ -0,0 +1,232 @@
+#include "ShaderBundleWriter.hpp"
+
+#include "Arsenic/Renderer/ShaderMetadata.hpp"
+
+#include "nlohmann/json.hpp"
+#include "spirv_reflect.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace arsenic
+{
+    static constexpr uint64_t shaderBundleCodeAlignment = 64;
+
+    struct CookedStage
+    {
+        uint32_t stage;
+        std::vector<uint32_t> code;
+        uint64_t codeOffset;
+    };
+
+    // The structs of ShaderMetadata.hpp are copied as they are, the bundle is little endian like every host the tools run on
+    static void writeBytes(std::vector<uint8_t> &bytes, const void *pData, const std::size_t size)
+    {
+        const uint8_t *pBytes = static_cast<const uint8_t *>(pData);
+        bytes.insert(bytes.end(), pBytes, pBytes + size);
+    }
+
+    static uint64_t alignUp(const uint64_t value, const uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static bool readSpvCode(const std::string &spvFilePath, std::vector<uint32_t> &code)
+    {
+        std::ifstream spvFile(spvFilePath, std::ios::binary | std::ios::ate);
+        if (!spvFile.is_open()) {
+            std::cerr << "Failed to open " << spvFilePath << "\n";
+            return false;
+        }
+
+        const std::streamsize size = spvFile.tellg();
+        if (size <= 0 || size % sizeof(uint32_t) != 0) {
+            std::cerr << spvFilePath << " is not SPIR-V\n";
+            return false;
+        }
+
+        code.resize(static_cast<std::size_t>(size) / sizeof(uint32_t));
+        spvFile.seekg(0);
+
+        return static_cast<bool>(spvFile.read(reinterpret_cast<char *>(code.data()), size));
+    }
+
+    static bool reflectLayout(const std::vector<uint32_t> &code, std::vector<ShaderBundleBinding> &bindings, uint32_t &pushConstantSize)
+    {
+        SpvReflectShaderModule reflectModule = {};
+        if (spvReflectCreateShaderModule(code.size() * sizeof(uint32_t), code.data(), &reflectModule) != SPV_REFLECT_RESULT_SUCCESS) {
+            return false;
+        }
+
+        uint32_t setCount = 0;
+        spvReflectEnumerateDescriptorSets(&reflectModule, &setCount, nullptr);
+        std::vector<SpvReflectDescriptorSet *> reflectSets(setCount);
+        spvReflectEnumerateDescriptorSets(&reflectModule, &setCount, reflectSets.data());
+
+        for (const SpvReflectDescriptorSet *pReflectSet : reflectSets) {
+            for (uint32_t i = 0; i != pReflectSet->binding_count; ++i) {
+                const SpvReflectDescriptorBinding &reflectBinding = *pReflectSet->bindings[i];
+
+                // Stages of a PSO share bindings, the first one reflected wins like in createShaderEffect
+                const bool bindingExist = std::any_of(bindings.begin(), bindings.end(), [&](const ShaderBundleBinding &binding) {
+                    return binding.set == pReflectSet->set && binding.binding == reflectBinding.binding;
+                });
+
+                if (!bindingExist) {
+                    bindings.push_back({pReflectSet->set, reflectBinding.binding, 
+                                    getReflectedDescriptorType(pReflectSet->set, static_cast<uint32_t>(reflectBinding.descriptor_type)), reflectBinding.count});
+                }
+            }
+        }
+
+        uint32_t pushConstantBlockCount = 0;
+        spvReflectEnumeratePushConstantBlocks(&reflectModule, &pushConstantBlockCount, nullptr);
+        std::vector<SpvReflectBlockVariable *> pushConstantBlocks(pushConstantBlockCount);
+        spvReflectEnumeratePushConstantBlocks(&reflectModule, &pushConstantBlockCount, pushConstantBlocks.data());
+
+        for (const SpvReflectBlockVariable *pBlock : pushConstantBlocks) {
+            pushConstantSize = std::max(pushConstantSize, pBlock->offset + pBlock->size);
+        }
+
+        spvReflectDestroyShaderModule(&reflectModule);
+
+        return true;
+    }
+
+    static bool isPsoJson(const std::string &inputPath)
+    {
+        const std::size_t extensionOffset = inputPath.find_last_of('.');
+        return extensionOffset != std::string::npos && inputPath.compare(extensionOffset, std::string::npos, ".json") == 0;
+    }
+
+    bool writeShaderBundle(const std::string &bundleFilePath, const std::string &inputPath, ShaderBundleStats &stats)
+    {
+        std::vector<CookedStage> stages;
+        PipelineState pipelineState = {};
+
+        if (isPsoJson(inputPath)) {
+            std::ifstream psoFile(inputPath);
+            if (!psoFile.is_open()) {
+                std::cerr << "Failed to open " << inputPath << "\n";
+                return false;
+            }
+
+            try {
+                const nlohmann::json psoJson = nlohmann::json::parse(psoFile);
+
+                stages.push_back({vkShaderStageVertexBit, {}, 0});
+                stages.push_back({vkShaderStageFragmentBit, {}, 0});
+
+                if (!readSpvCode(psoJson["vertSpvFilePath"].get<std::string>(), stages[0].code) ||
+                    !readSpvCode(psoJson["fragSpvFilePath"].get<std::string>(), stages[1].code)) {
+                    return false;
+                }
+
+                if (!parsePipelineState(psoJson, pipelineState)) {
+                    std::cerr << inputPath << " has more than " << maxColorAttachments << " color attachments\n";
+                    return false;
+                }
+            }
+            catch (const nlohmann::json::exception &exception) {
+                std::cerr << inputPath << ": " << exception.what() << "\n";
+                return false;
+            }
+        }
+        else {
+            stages.push_back({vkShaderStageComputeBit, {}, 0});
+
+            if (!readSpvCode(inputPath, stages[0].code)) {
+                return false;
+            }
+        }
+
+        std::vector<ShaderBundleBinding> bindings;
+        std::vector<SpecializationConstant> specializationConstants;
+        uint32_t pushConstantSize = 0;
+
+        for (const CookedStage &stage : stages) {
+            if (!reflectLayout(stage.code, bindings, pushConstantSize)) {
+                std::cerr << "Failed to reflect a stage of " << inputPath << "\n";
+                return false;
+            }
+
+            reflectSpecializationConstants(stage.code.data(), stage.code.size(), specializationConstants);
+        }
+
+        if (pushConstantSize > pushConstantRangeSize) {
+            std::cerr << inputPath << " has " << pushConstantSize << " bytes of push constants, at most " << pushConstantRangeSize << " fit\n";
+            return false;
+        }
+
+        for (const SpecializationConstant &constant : specializationConstants) {
+            if (constant.name.size() >= shaderBundleNameSize) {
+                std::cerr << "Specialization constant name " << constant.name << " is longer than " << shaderBundleNameSize - 1 << " characters\n";
+                return false;
+            }
+        }
+
+        std::sort(bindings.begin(), bindings.end(), [](const ShaderBundleBinding &a, const ShaderBundleBinding &b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+
+        ShaderBundleHeader header = {};
+        header.magic = shaderBundleMagic;
+        header.version = shaderBundleVersion;
+        header.stageCount = static_cast<uint32_t>(stages.size());
+        header.bindingCount = static_cast<uint32_t>(bindings.size());
+        header.specializationConstantCount = static_cast<uint32_t>(specializationConstants.size());
+        header.pushConstantSize = pushConstantSize;
+        header.stagesOffset = sizeof(ShaderBundleHeader);
+        header.bindingsOffset = header.stagesOffset + stages.size() * sizeof(ShaderBundleStage);
+        header.specializationConstantsOffset = header.bindingsOffset + bindings.size() * sizeof(ShaderBundleBinding);
+        header.pipelineState = pipelineState;
+
+        uint64_t codeOffset = alignUp(header.specializationConstantsOffset + specializationConstants.size() * sizeof(ShaderBundleSpecializationConstant), 
+                                shaderBundleCodeAlignment);
+        for (CookedStage &stage : stages) {
+            stage.codeOffset = codeOffset;
+            codeOffset = alignUp(codeOffset + stage.code.size() * sizeof(uint32_t), shaderBundleCodeAlignment);
+        }
+
+        std::vector<uint8_t> bytes;
+        writeBytes(bytes, &header, sizeof(header));
+
+        for (const CookedStage &stage : stages) {
+            const ShaderBundleStage bundleStage = {stage.stage, 0, stage.codeOffset, stage.code.size() * sizeof(uint32_t)};
+            writeBytes(bytes, &bundleStage, sizeof(bundleStage));
+        }
+
+        writeBytes(bytes, bindings.data(), bindings.size() * sizeof(ShaderBundleBinding));
+
+        for (const SpecializationConstant &constant : specializationConstants) {
+            ShaderBundleSpecializationConstant bundleConstant = {};
+            bundleConstant.constantID = constant.constantID;
+            bundleConstant.defaultValue = constant.defaultValue;
+            std::memcpy(bundleConstant.name, constant.name.data(), constant.name.size());
+
+            writeBytes(bytes, &bundleConstant, sizeof(bundleConstant));
+        }
+
+        for (const CookedStage &stage : stages) {
+            bytes.resize(static_cast<std::size_t>(stage.codeOffset), 0);
+            writeBytes(bytes, stage.code.data(), stage.code.size() * sizeof(uint32_t));
+        }
+
+        std::ofstream bundleFile(bundleFilePath, std::ios::binary);
+        if (!bundleFile.is_open()) {
+            return false;
+        }
+
+        bundleFile.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        stats.stageCount = header.stageCount;
+        stats.bindingCount = header.bindingCount;
+        stats.specializationConstantCount = header.specializationConstantCount;
+        stats.bundleSize = bytes.size();
+
+        return bundleFile.good();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace arsenic
+{
+    struct ShaderBundleStats
+    {
+        uint32_t stageCount;
+        uint32_t bindingCount;
+        uint32_t specializationConstantCount;
+        uint64_t bundleSize;
+    };
+
+    // inputPath is either a PSO json like Assets/Pso/fullScreenPSO.json or a compute .spv. The spv paths inside a PSO are
+    // opened relative to the working directory, as the runtime does. Layouts are reflected the way buildGraphicsShaderEffect
+    // and buildComputeShaderEffect do it, the format is the one of ShaderBundleHeader in Arsenic/Renderer/ShaderMetadata.hpp
+    bool writeShaderBundle(const std::string &bundleFilePath, const std::string &inputPath, ShaderBundleStats &stats);
+}
\ No newline at end of file
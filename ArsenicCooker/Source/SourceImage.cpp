@@ -0,0 +1,212 @@
+#include "SourceImage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define ARSENIC_COOKER_SSE
+    #include <xmmintrin.h>
+#endif
+
+namespace arsenic
+{
+    // Half width of the Kaiser filter in destination texels and its window shape, the values nvtt uses for mips
+    static constexpr float kaiserWidth = 3.0f;
+    static constexpr float kaiserAlpha = 4.0f;
+
+    struct FilterTaps
+    {
+        uint32_t first;
+        std::vector<float> weights;
+    };
+
+    float srgbToLinear(const float value)
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(const float value)
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    bool parseMipFilter(const char *pName, MipFilter &mipFilter)
+    {
+        if (std::strcmp(pName, "box") == 0) {
+            mipFilter = MipFilter::Box;
+            return true;
+        }
+
+        if (std::strcmp(pName, "kaiser") == 0) {
+            mipFilter = MipFilter::Kaiser;
+            return true;
+        }
+
+        return false;
+    }
+
+    static float besselI0(const float x)
+    {
+        float sum = 1.0f;
+        float term = 1.0f;
+
+        for (uint32_t k = 1; k != 32 && term > sum * 1E-8f; ++k) {
+            const float halfX = x / (2.0f * k);
+            term *= halfX * halfX;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static float evaluateFilter(const MipFilter mipFilter, const float x)
+    {
+        if (mipFilter == MipFilter::Box) {
+            return std::abs(x) <= 0.5f ? 1.0f : 0.0f;
+        }
+
+        if (std::abs(x) >= kaiserWidth) {
+            return 0.0f;
+        }
+
+        const float sinc = x == 0.0f ? 1.0f : std::sin(3.14159265f * x) / (3.14159265f * x);
+        const float t = x / kaiserWidth;
+
+        return sinc * besselI0(kaiserAlpha * std::sqrt(1.0f - t * t)) / besselI0(kaiserAlpha);
+    }
+
+    // Normalized weights of every destination texel along one axis, the filter is stretched by the downsampling ratio
+    static std::vector<FilterTaps> buildFilterTaps(const MipFilter mipFilter, const uint32_t sourceSize, const uint32_t destinationSize)
+    {
+        const float scale = static_cast<float>(sourceSize) / destinationSize;
+        const float radius = (mipFilter == MipFilter::Box ? 0.5f : kaiserWidth) * scale;
+
+        std::vector<FilterTaps> filterTaps(destinationSize);
+
+        for (uint32_t i = 0; i != destinationSize; ++i) {
+            const float center = (i + 0.5f) * scale;
+            const int32_t first = static_cast<int32_t>(std::floor(center - radius));
+            const int32_t last = static_cast<int32_t>(std::ceil(center + radius));
+
+            // Taps outside the image are folded onto the edge texel
+            const int32_t firstInside = std::max(first, 0);
+            const int32_t lastInside = std::min(last, static_cast<int32_t>(sourceSize) - 1);
+
+            std::vector<float> weights(static_cast<std::size_t>(lastInside - firstInside + 1), 0.0f);
+            float weightSum = 0.0f;
+
+            for (int32_t j = first; j <= last; ++j) {
+                const float weight = evaluateFilter(mipFilter, (j + 0.5f - center) / scale);
+                weights[std::clamp(j, firstInside, lastInside) - firstInside] += weight;
+                weightSum += weight;
+            }
+
+            for (float &weight : weights) {
+                weight /= weightSum;
+            }
+
+            filterTaps[i].first = static_cast<uint32_t>(firstInside);
+            filterTaps[i].weights = std::move(weights);
+        }
+
+        return filterTaps;
+    }
+
+    // Weighted sum of RGBA texels that are stride floats apart, one per weight
+    static void accumulateTexels(const float *pSource, const std::size_t stride, const std::vector<float> &weights, float *pDestination)
+    {
+#ifdef ARSENIC_COOKER_SSE
+        __m128 sum = _mm_setzero_ps();
+
+        for (const float weight : weights) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pSource), _mm_set1_ps(weight)));
+            pSource += stride;
+        }
+
+        _mm_storeu_ps(pDestination, sum);
+#else
+        float sum[4] = {};
+
+        for (const float weight : weights) {
+            for (uint32_t c = 0; c != 4; ++c) {
+                sum[c] += pSource[c] * weight;
+            }
+            pSource += stride;
+        }
+
+        std::memcpy(pDestination, sum, sizeof(sum));
+#endif
+    }
+
+    template<typename F>
+    static void parallelForRows(const uint32_t rowCount, F &&processRow)
+    {
+        const uint32_t threadCount = std::min(std::max(std::thread::hardware_concurrency(), 1u), rowCount);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+
+        for (uint32_t t = 0; t != threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t row = t; row < rowCount; row += threadCount) {
+                    processRow(row);
+                }
+            });
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Separable filter, rows first into an image of the destination width, then columns
+    static SourceImage downsample(const SourceImage &image, const MipFilter mipFilter)
+    {
+        SourceImage rowFiltered = {};
+        rowFiltered.width = std::max(image.width / 2, 1u);
+        rowFiltered.height = image.height;
+        rowFiltered.texels.resize(static_cast<std::size_t>(rowFiltered.width) * rowFiltered.height * 4);
+
+        const std::vector<FilterTaps> rowTaps = buildFilterTaps(mipFilter, image.width, rowFiltered.width);
+
+        parallelForRows(rowFiltered.height, [&](const uint32_t y) {
+            for (uint32_t x = 0; x != rowFiltered.width; ++x) {
+                accumulateTexels(image.getTexel(rowTaps[x].first, y), 4, rowTaps[x].weights, rowFiltered.getTexel(x, y));
+            }
+        });
+
+        SourceImage mipImage = {};
+        mipImage.width = rowFiltered.width;
+        mipImage.height = std::max(image.height / 2, 1u);
+        mipImage.texels.resize(static_cast<std::size_t>(mipImage.width) * mipImage.height * 4);
+
+        const std::vector<FilterTaps> columnTaps = buildFilterTaps(mipFilter, image.height, mipImage.height);
+
+        parallelForRows(mipImage.height, [&](const uint32_t y) {
+            for (uint32_t x = 0; x != mipImage.width; ++x) {
+                float *pTexel = mipImage.getTexel(x, y);
+                accumulateTexels(rowFiltered.getTexel(x, columnTaps[y].first), 4ull * rowFiltered.width, columnTaps[y].weights, pTexel);
+
+                // Negative lobes can ring below zero next to sharp edges
+                for (uint32_t c = 0; c != 4; ++c) {
+                    pTexel[c] = std::max(pTexel[c], 0.0f);
+                }
+            }
+        });
+
+        return mipImage;
+    }
+
+    std::vector<SourceImage> buildMipChain(SourceImage &&image, const bool generateMipLevels, const MipFilter mipFilter)
+    {
+        std::vector<SourceImage> mipChain;
+        mipChain.push_back(std::move(image));
+
+        while (generateMipLevels && (mipChain.back().width > 1 || mipChain.back().height > 1)) {
+            mipChain.push_back(downsample(mipChain.back(), mipFilter));
+        }
+
+        return mipChain;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace arsenic
+{
+    // RGBA texels in linear space, 4 floats per texel row by row
+    struct SourceImage
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> texels;
+
+        const float *getTexel(const uint32_t x, const uint32_t y) const { return &texels[(static_cast<std::size_t>(y) * width + x) * 4]; }
+        float *getTexel(const uint32_t x, const uint32_t y) { return &texels[(static_cast<std::size_t>(y) * width + x) * 4]; }
+    };
+
+    enum class MipFilter
+    {
+        Box,
+        // Kaiser windowed sinc, keeps detail the box filter blurs away at the cost of slight ringing
+        Kaiser
+    };
+
+    float srgbToLinear(const float value);
+    float linearToSrgb(const float value);
+
+    bool parseMipFilter(const char *pName, MipFilter &mipFilter);
+
+    // Halves the image until 1x1, the first entry is image itself.
+    // Filtering happens on the linear values, so sRGB sources have to be converted before
+    std::vector<SourceImage> buildMipChain(SourceImage &&image, const bool generateMipLevels, const MipFilter mipFilter);
+}
\ No newline at end of file
@@ -8,8 +8,20 @@ namespace arsenic
 {
     SandboxLayer::SandboxLayer()
     {      
+        // A cooked pack next to the executable replaces the loose Assets tree
+        if (!std::filesystem::exists("Assets.pack") || !mountPack("Assets", "Assets.pack")) {
+            mountDirectory("Assets", "Assets");
+        }
+
         _vulkanContext = createVulkanContext(Application::getWindow().getNativeWindowHandle(), "Sandbox");
+        _vulkanContext.pipelineCache = createPipelineCache(_vulkanContext, pipelineCacheFilePath);
         _materialManager.initialize(_vulkanContext);
+        _textureStreamer.initialize(_vulkanContext);
+        _textureFeedback = createTextureFeedback(_vulkanContext);
+        // Cooked from kobe.jpg by the ArsenicTextures target
+        _streamedTexture = _textureStreamer.requestTexture("Assets/Textures/kobe.ktx2");
+        // Samples the placeholder until the streamer reports the texture resident
+        _materialManager.registerTexture(_streamedTexture, _textureStreamer.getImageView(_streamedTexture));
         initializeFrame();
 
         _renderTargetExtent.width = 1280;
@@ -19,25 +31,48 @@ namespace arsenic
         _swapchain = createSwapchain(_vulkanContext.device, _vulkanContext.surface, _vulkanContext.physicalDevice.vkPhysicalDevice, _renderTargetExtent);
         createDepthTexture();
         createRenderPass();
+
+        // Started before anything else loads, so compiling overlaps with the IBL bake and texture decoding below
+        _pipelineBuilder.initialize(_vulkanContext);
+        _rtShaderPassFuture = _pipelineBuilder.buildShaderPassFromBundle(rtComputeBundleFilePath, rtComputeSpvFilePath);
+        _fullScreenPassFuture = _pipelineBuilder.buildShaderPassFromBundle(fullScreenBundleFilePath, fullScreenPsoFilePath, _renderpass, 0);
+        _shaderHotReloader.initialize(_vulkanContext, ARSENIC_SOURCE_ASSET_DIRECTORY, ARSENIC_GLSLC_EXECUTABLE);
+
         createFramebuffers();
         setupImGui();
         setupShaderResource();
 
-        _sceneEnviromentMap = loadCubeImage2DFromFile(_vulkanContext, "Assets/Scene/enviromentMap.json");
-        _sceneEnviromentMap.vkImageView = createImageView(_vulkanContext, _sceneEnviromentMap.vkImage, VK_IMAGE_VIEW_TYPE_CUBE, 
-                                                    _sceneEnviromentMap.format, VK_IMAGE_ASPECT_COLOR_BIT,
-                                                    0, _sceneEnviromentMap.arrayLayers, 0, _sceneEnviromentMap.mipLevels);
+        // Without storage images lacking a format the enviroment cube falls back to blitting its mips level by level
+        if (_vulkanContext.storageImageWithoutFormatEnabled) {
+            _mipDownsampler = createMipDownsampler(_vulkanContext, "Assets/Shaders/Spv/spdDownsample.comp.spv");
+        }
+
+        _iblBaker = createIblBaker(_vulkanContext, "Assets/Shaders/Spv/iblEquirectToCube.comp.spv", "Assets/Shaders/Spv/iblPrefilterSpecular.comp.spv",
+                        "Assets/Shaders/Spv/iblIrradiance.comp.spv", "Assets/Shaders/Spv/iblBrdfLut.comp.spv");
+        _iblMaps = loadIblMaps(_vulkanContext, _iblBaker, "Assets/Scene/snowy_field_1k.exr", "Assets/Cache/Ibl", {},
+                        _vulkanContext.storageImageWithoutFormatEnabled ? &_mipDownsampler : nullptr);
+
+        _generalSampler = _materialManager.getDefaultSampler();
 
-        _generalSampler = _materialManager.createSampler(_vulkanContext);
+        _scatterUploader = createScatterUploader(_vulkanContext, "Assets/Shaders/Spv/scatterUpload.comp.spv");
+        _sphereMeshScatterBuffer = createScatterBuffer(_vulkanContext, sizeof(SphereMesh), maxSphereMeshes);
+        _lightScatterBuffer = createScatterBuffer(_vulkanContext, sizeof(Light), maxLights);
+        _materialScatterBuffer = createScatterBuffer(_vulkanContext, sizeof(Material), maxMaterials);
 
-        _rtShaderEffect = buildComputeShaderEffect(_vulkanContext, "Assets/Shaders/Spv/rtCompute.comp.spv");
-        _fullScreenShaderEffect = buildGraphicsShaderEffect(_vulkanContext, "Assets/Pso/fullScreenPSO.json");
+        // rtCompute reaches the arrays through addresses pushed every frame, so moving them needs no fix up
+        registerDefragmentableBuffer(_defragmenter, _sphereMeshScatterBuffer.buffer);
+        registerDefragmentableBuffer(_defragmenter, _lightScatterBuffer.buffer);
+        registerDefragmentableBuffer(_defragmenter, _materialScatterBuffer.buffer);
 
-        _rtShaderPass = buildComputeShaderPass(_vulkanContext, &_rtShaderEffect);
-        _fullScreenPass = buildGraphicsShaderPass(_vulkanContext, _renderpass, 0, &_fullScreenShaderEffect);
+        // The IBL maps live in shared blocks for the whole run, a moved one only needs the global descriptor set to point at its new view.
+        // The render target and depth texture have dedicated memory and streamed textures are replaced by the streamer itself
+        const auto onIblMapMoved = [this](const VulkanImage &) { _globalDescriptorSetStale = true; };
+        registerDefragmentableImage(_defragmenter, _iblMaps.specularMap, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT, VK_IMAGE_VIEW_TYPE_CUBE, onIblMapMoved);
+        registerDefragmentableImage(_defragmenter, _iblMaps.irradianceMap, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT, VK_IMAGE_VIEW_TYPE_CUBE, onIblMapMoved);
+        registerDefragmentableImage(_defragmenter, _iblMaps.brdfLut, 0, VK_IMAGE_VIEW_TYPE_2D, onIblMapMoved);
 
+        // The global descriptor set is allocated with the set 0 layout of rtCompute, once its build has finished
         createEngineDescriptorPool();
-        setupGlobalDescriptorSet();
 
         _camera.initialize(_swapchain.imageExtent.width, _swapchain.imageExtent.height);
         _cameraBuffer.proj = _camera.projMatrix;
@@ -45,7 +80,8 @@ namespace arsenic
     
         _sphereEntity = _scene.createEntity();
         _sphereEntity.addComponent<SphereMesh>();
-        _sphereEntity.addComponent<Material>();
+        Material &sphereMaterial = _sphereEntity.addComponent<Material>(_materialManager.createMaterial(0.5f, 0.0f, math::vec3f(1.0f)));
+        sphereMaterial.baseColorMapIndex = _materialManager.getTextureIndex(_streamedTexture);
 
         _dirLightEntity = _scene.createEntity();
         _dirLightEntity.getComponent<Transform>().position = math::vec3f(0.0f, -1.0f, 0.0f);
@@ -55,17 +91,43 @@ namespace arsenic
     SandboxLayer::~SandboxLayer()
     {      
         checkVkResult(vkDeviceWaitIdle(_vulkanContext.device));
+        _shaderHotReloader.deInitialize();
+        _rtVariantCache.deInitialize();
+        _pipelineBuilder.deInitialize();
+
+        if (!savePipelineCache(_vulkanContext, _vulkanContext.pipelineCache, pipelineCacheFilePath)) {
+            ARSENIC_WARN("Could not save the pipeline cache to {}", pipelineCacheFilePath);
+        }
+
+        endDefragmentation(_vulkanContext, _defragmenter);
+        _textureStreamer.deInitialize(_vulkanContext);
+        destroyTextureFeedback(_vulkanContext, _textureFeedback);
+        _materialManager.deInitialize(_vulkanContext);
+        drainDeletionQueue(_vulkanContext, _deletionQueue);
+        destroyFrameAllocator(_vulkanContext, _frameAllocator);
+        destroyScatterBuffer(_vulkanContext, _sphereMeshScatterBuffer);
+        destroyScatterBuffer(_vulkanContext, _lightScatterBuffer);
+        destroyScatterBuffer(_vulkanContext, _materialScatterBuffer);
+        destroyScatterUploader(_vulkanContext, _scatterUploader);
+
+        destroyIblMaps(_vulkanContext, _iblMaps);
+        destroyIblBaker(_vulkanContext, _iblBaker);
+
+        if (_vulkanContext.storageImageWithoutFormatEnabled) {
+            destroyMipDownsampler(_vulkanContext, _mipDownsampler);
+        }
 
         deInitializeFrame();
         destroyFramebuffers();
         destroyDepthTexture();
         destroyRenderTarget();
-        vkDestroyRenderPass(_vulkanContext.device, _renderpass, nullptr);
+        vkDestroyRenderPass(_vulkanContext.device, _renderpass, getHostAllocationCallbacks(HostAllocationTag::Resource));
         destroySwapchain(_vulkanContext.device, _swapchain);
-        vkDestroyDescriptorPool(_vulkanContext.device, _imguiDescriptorPool, nullptr);
+        vkDestroyDescriptorPool(_vulkanContext.device, _imguiDescriptorPool, getHostAllocationCallbacks(HostAllocationTag::Descriptor));
         ImGui_ImplVulkan_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
+        unmountAll();
     }
 
     void SandboxLayer::onUpdate(const float dt) 
@@ -134,6 +196,57 @@ namespace arsenic
             ImGui::SliderInt("Num reflection", &_sceneBuffer.numIndirectReflect, 0, 8);
         }
         ImGui::Separator();
+        {
+            ImGui::Text("Frame data");
+            ImGui::Text("Write path: %s", hostWritePathToString(_frameAllocator.writePath));
+            ImGui::Text("CPU write: %.3f ms", _frameDataWriteTimeMs);
+            ImGui::Text("GPU upload + ray trace: %.3f ms", _rtComputeGpuTimeMs);
+            ImGui::Text("Scattered elements: %u", _scatterUploader.scatteredElementCount);
+
+            const TextureStreamingStats streamingStats = _textureStreamer.getStats();
+            ImGui::Text("Streamed textures: %u decoding, %u uploading, %u resident, %u failed, %llu KiB", streamingStats.decodingCount,
+                    streamingStats.uploadingCount, streamingStats.residentCount, streamingStats.failedCount, 
+                    static_cast<unsigned long long>(streamingStats.streamedBytes >> 10));
+            ImGui::Text("Resident texture memory: %llu KiB", static_cast<unsigned long long>(streamingStats.residentBytes >> 10));
+
+            if (ImGui::Checkbox("Force staging", &_forceStagingFrameData)) {
+                recreateFrameAllocator(_forceStagingFrameData ? HostWritePath::Staging : _vulkanContext.hostWritePolicy.path);
+            }
+        }
+        ImGui::Separator();
+        {
+            ImGui::Text("Memory%s", _vulkanContext.memoryBudgetEnabled ? "" : " (estimated budget)");
+
+            const std::vector<MemoryHeapBudget> heapBudgets = queryMemoryBudget(_vulkanContext);
+            for (std::size_t i = 0; i != heapBudgets.size(); ++i) {
+                const MemoryHeapBudget &heapBudget = heapBudgets[i];
+                ImGui::Text("Heap %zu%s: %llu / %llu MiB, blocks %llu MiB, allocations %llu MiB", i, 
+                        (heapBudget.heapFlags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " (device local)" : "",
+                        static_cast<unsigned long long>(heapBudget.usage >> 20), static_cast<unsigned long long>(heapBudget.budget >> 20),
+                        static_cast<unsigned long long>(heapBudget.blockBytes >> 20), static_cast<unsigned long long>(heapBudget.allocationBytes >> 20));
+            }
+
+            ImGui::Text("Defragmentation: %s, %llu moves, %llu KiB moved", _defragmenter.context != VK_NULL_HANDLE ? "running" : "idle",
+                    static_cast<unsigned long long>(_defragmenter.movedAllocationCount), static_cast<unsigned long long>(_defragmenter.movedBytes >> 10));
+
+            if (ImGui::Button("Defragment")) {
+                beginDefragmentation(_vulkanContext, _defragmenter);
+            }
+        }
+        ImGui::Separator();
+        {
+            ImGui::Text("Host memory");
+
+            for (std::size_t i = 0; i != static_cast<std::size_t>(HostAllocationTag::Count); ++i) {
+                const HostAllocationTag tag = static_cast<HostAllocationTag>(i);
+                const HostAllocationStats stats = getHostAllocationStats(tag);
+                ImGui::Text("%s: %llu KiB (peak %llu KiB, internal %llu KiB), %llu live / %llu total allocations", hostAllocationTagToString(tag),
+                        static_cast<unsigned long long>(stats.allocatedBytes >> 10), static_cast<unsigned long long>(stats.peakAllocatedBytes >> 10),
+                        static_cast<unsigned long long>(stats.internalAllocatedBytes >> 10), static_cast<unsigned long long>(stats.allocationCount),
+                        static_cast<unsigned long long>(stats.totalAllocationCount));
+            }
+        }
+        ImGui::Separator();
         {
             ImGui::Text("Camera");
             
@@ -210,8 +323,67 @@ namespace arsenic
     {
         Frame &frame = getCurrentFrame();
 
-        checkVkResult(vkWaitForFences(_vulkanContext.device, 1, &frame.frameInFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
-        checkVkResult(vkResetFences(_vulkanContext.device, 1, &frame.frameInFlightFence));
+        waitForTimelineValue(_vulkanContext.device, _vulkanContext.graphicsTimeline, frame.timelineValue);
+
+        if (frame.timelineValue != 0 && _timestampsWritten.value[_currentFrame]) {
+            std::array<uint64_t, 2> timestamps = {};
+            const VkResult result = vkGetQueryPoolResults(_vulkanContext.device, _timestampQueryPool, _currentFrame * 2, 2, 
+                                                    sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+            if (result == VK_SUCCESS) {
+                const float timestampPeriod = _vulkanContext.physicalDevice.deviceProperties.limits.timestampPeriod;
+                const float gpuTimeMs = static_cast<float>((timestamps[1] - timestamps[0]) & _timestampMask) * timestampPeriod / 1E6f;
+                _rtComputeGpuTimeMs += (gpuTimeMs - _rtComputeGpuTimeMs) * timingSmoothing;
+            }
+        }
+        flushDeletionQueue(_vulkanContext, _deletionQueue, getCompletedTimelineValue(_vulkanContext.device, _vulkanContext.graphicsTimeline));
+
+        // What rtCompute sampled in this frame decides which mip levels the streamer keeps resident
+        float uvFootprint = 0.0f;
+        if (readTextureFootprint(_textureFeedback, _currentFrame, _materialManager.getTextureIndex(_streamedTexture), uvFootprint)) {
+            _textureStreamer.reportTextureFootprint(_streamedTexture, uvFootprint);
+        }
+
+        resetTextureFeedback(_textureFeedback, _currentFrame);
+
+        for (const TextureHandle textureHandle : _textureStreamer.update(_vulkanContext, _deletionQueue)) {
+            _materialManager.updateTexture(textureHandle, _textureStreamer.getImageView(textureHandle));
+        }
+
+        // The bindless set of this frame is no longer read by the GPU, so slots written since it was last used can be updated
+        _materialManager.flushDescriptorWrites(_vulkanContext, _currentFrame);
+
+        // Pipelines are built in the background, until both scene passes are ready frames only clear and draw the UI
+        if (!_rtShaderPass.pipeline && isShaderPassReady(_rtShaderPassFuture)) {
+            _rtShaderPass = _rtShaderPassFuture.get();
+            _shaderHotReloader.watchComputeShaderPass(_rtShaderPass, rtComputeSpvFilePath);
+            _rtVariantCache.initialize(_vulkanContext, _rtShaderPass.pShaderEffect);
+            setupGlobalDescriptorSet();
+        }
+
+        if (!_fullScreenPass.pipeline && isShaderPassReady(_fullScreenPassFuture)) {
+            _fullScreenPass = _fullScreenPassFuture.get();
+            _shaderHotReloader.watchGraphicsShaderPass(_fullScreenPass, fullScreenPsoFilePath, _renderpass, 0);
+        }
+
+        // Nothing recorded from here on has bound the passes yet, so swapping them now is safe
+        const VkPipeline rtPipeline = _rtShaderPass.pipeline;
+        _shaderHotReloader.update(_deletionQueue, _vulkanContext.graphicsTimeline.submittedValue);
+
+        // Variants are specialized from the rt pass alone, reloading another pass leaves them valid. The retire value is the one
+        // the reloader retired the old shader modules with, variants still compiling from them keep them alive
+        if (rtPipeline != VK_NULL_HANDLE && _rtShaderPass.pipeline != rtPipeline) {
+            _rtVariantCache.clear(_deletionQueue, _vulkanContext.graphicsTimeline.submittedValue);
+        }
+
+        const bool scenePassesReady = _rtShaderPass.pipeline != VK_NULL_HANDLE && _fullScreenPass.pipeline != VK_NULL_HANDLE;
+
+        // Refreshes the cached budget, VMA only queries the driver again once the frame index changes
+        vmaSetCurrentFrameIndex(_vulkanContext.vmaAllocator, ++_frameCount);
+
+        if (_frameCount % defragmentationCheckInterval == 0 && isDefragmentationWorthwhile(_vulkanContext, _defragmenter)) {
+            beginDefragmentation(_vulkanContext, _defragmenter);
+        }
 
         uint32_t imageIndex = acquireImageFromSwapchain(_vulkanContext.device, frame.imageReadySemaphore, _swapchain);
         
@@ -228,8 +400,21 @@ namespace arsenic
         VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
         checkVkResult(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
 
-        {
-            
+        cmdStepDefragmentation(_vulkanContext, _defragmenter, _deletionQueue, commandBuffer);
+
+        // Frames in flight still bind the global descriptor set, so moved IBL maps are written into a new one and the old one is freed
+        // once those frames are done
+        if (_globalDescriptorSetStale && _globalDescriptorSet != VK_NULL_HANDLE) {
+            deferDestroy(_deletionQueue, [descriptorPool = _descriptorPool, retiredSet = _globalDescriptorSet](const VulkanContext &vulkanContext) {
+                checkVkResult(vkFreeDescriptorSets(vulkanContext.device, descriptorPool, 1, &retiredSet));
+            }, _vulkanContext.graphicsTimeline.submittedValue);
+
+            setupGlobalDescriptorSet();
+        }
+
+        _globalDescriptorSetStale = false;
+
+        if (scenePassesReady) {
             VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
             imageMemoryBarrier.image = _renderTarget.vkImage;
             imageMemoryBarrier.srcAccessMask = 0;
@@ -250,61 +435,114 @@ namespace arsenic
             _renderTarget.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
         }
 
-        const VulkanBuffer &gpuSphereBuffer = _gpuSphereBuffers.value[_currentFrame];
-        const VulkanBuffer &gpuLightBuffer = _gpuLightBuffers.value[_currentFrame];
-        const VulkanBuffer &gpuMaterialBuffer = _gpuMaterialBuffers.value[_currentFrame];
-    
-        _sceneBuffer.numLights = 0;
-        _sceneBuffer.numSphereMeshes = 0;
+        // Both timestamps bracket the ray trace, so they are written together or not at all
+        const bool writeTimestamps = _timestampQueryPool != VK_NULL_HANDLE && scenePassesReady;
+        _timestampsWritten.value[_currentFrame] = writeTimestamps;
 
-        for (std::size_t i = 0; i != _sphereMeshes.size() && i != maxSphereMeshes; ++i) {
-            std::memcpy(gpuSphereBuffer.pMappedPointer + i * sizeof(SphereMesh), &_sphereMeshes[i], sizeof(SphereMesh));
-            ++_sceneBuffer.numSphereMeshes;
+        if (writeTimestamps) {
+            vkCmdResetQueryPool(commandBuffer, _timestampQueryPool, _currentFrame * 2, 2);
         }
-                
-        for (std::size_t i = 0; i != _lights.size() && i != maxLights; ++i) {
-            std::memcpy(gpuLightBuffer.pMappedPointer + i * sizeof(Light), &_lights[i], sizeof(Light));
-            ++_sceneBuffer.numLights;
+
+        _sceneBuffer.numSphereMeshes = static_cast<int>(std::min(_sphereMeshes.size(), maxSphereMeshes));
+        _sceneBuffer.numLights = static_cast<int>(std::min(_lights.size(), maxLights));
+
+        const auto frameDataWriteBegin = std::chrono::steady_clock::now();
+
+        resetFrameAllocator(_frameAllocator, _currentFrame);
+
+        // Dynamic offsets are consumed in binding order of set 0. These are the first allocations after the reset, so they always fit,
+        // 256 is the largest offset alignment a device may require
+        static_assert(sizeof(SceneBuffer) + sizeof(CameraBuffer) + 2 * 256 <= frameDataCapacity);
+        const std::array<uint32_t, 2> dynamicOffsets = {
+            static_cast<uint32_t>(frameAllocate(_frameAllocator, sizeof(SceneBuffer), &_sceneBuffer).offset),
+            static_cast<uint32_t>(frameAllocate(_frameAllocator, sizeof(CameraBuffer), &_cameraBuffer).offset)
+        };
+
+        // Only elements that changed since the last frame are packed, the arrays themselves stay in device local memory.
+        // Changes that do not fit this frame are scattered on a later one, the arrays keep their previous contents meanwhile
+        bool scatterPacked = packScatterRecords(_frameAllocator, _sphereMeshScatterBuffer, _sphereMeshes.data(), 
+                                        static_cast<uint32_t>(_sceneBuffer.numSphereMeshes));
+        scatterPacked &= packScatterRecords(_frameAllocator, _lightScatterBuffer, _lights.data(), static_cast<uint32_t>(_sceneBuffer.numLights));
+        scatterPacked &= packScatterRecords(_frameAllocator, _materialScatterBuffer, _materials.data(), 
+                                    static_cast<uint32_t>(std::min(_materials.size(), maxMaterials)));
+
+        if (!scatterPacked) {
+            ARSENIC_WARN("Scene changes deferred, raise frameDataCapacity");
         }
 
-        for (std::size_t i = 0; i != _materials.size() && i != maxMaterials; ++i) {
-            std::memcpy(gpuMaterialBuffer.pMappedPointer + i * sizeof(Material), &_materials[i], sizeof(Material));
+        ScenePushConstant scenePushConstant = {};
+        scenePushConstant.sphereMeshes = _sphereMeshScatterBuffer.buffer.deviceAddress;
+        scenePushConstant.lights = _lightScatterBuffer.buffer.deviceAddress;
+        scenePushConstant.materials = _materialScatterBuffer.buffer.deviceAddress;
+        scenePushConstant.textureFeedback = getTextureFeedbackAddress(_textureFeedback, _currentFrame);
+
+        {
+            const std::chrono::duration<float, std::milli> writeTime = std::chrono::steady_clock::now() - frameDataWriteBegin;
+            _frameDataWriteTimeMs += (writeTime.count() - _frameDataWriteTimeMs) * timingSmoothing;
         }
-        
-        const VulkanBuffer &gpuSceneBuffer = _gpuSceneBuffers.value[_currentFrame];
-        const VulkanBuffer &gpuCameraBuffer =_gpuCameraBuffers.value[_currentFrame];
 
-        std::memcpy(gpuSceneBuffer.pMappedPointer, &_sceneBuffer, sizeof(SceneBuffer));
-        std::memcpy(gpuCameraBuffer.pMappedPointer, &_cameraBuffer, sizeof(CameraBuffer));
+        // The GPU timing covers the staging copy as well, so both write paths can be compared end to end
+        if (writeTimestamps) {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _timestampQueryPool, _currentFrame * 2);
+        }
 
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _rtShaderPass.pShaderEffect->pipelineLayout,
-                        0, 1, &_globalDescriptorSet.value[_currentFrame], 0, nullptr);
+        cmdFlushFrameAllocator(commandBuffer, _frameAllocator);
+        cmdScatterUpload(commandBuffer, _scatterUploader, {&_sphereMeshScatterBuffer, &_lightScatterBuffer, &_materialScatterBuffer});
 
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _rtShaderPass.pipeline);
+        if (scenePassesReady) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _rtShaderPass.pShaderEffect->pipelineLayout,
+                            0, 1, &_globalDescriptorSet, static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
 
-        int groupCountX = _renderTargetExtent.width / 32 + 1;
-        int groupCountY = _renderTargetExtent.height / 32 + 1; 
-        vkCmdDispatch(commandBuffer, groupCountX, groupCountY, 1);
+            const VkDescriptorSet bindlessDescriptorSetHandle = _materialManager.getDescriptorSet(_currentFrame);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _rtShaderPass.pShaderEffect->pipelineLayout,
+                            bindlessDescriptorSet, 1, &bindlessDescriptorSetHandle, 0, nullptr);
 
-        {
-            VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-            imageMemoryBarrier.image = _renderTarget.vkImage;
-            imageMemoryBarrier.oldLayout = _renderTarget.imageLayout;
-            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-            imageMemoryBarrier.subresourceRange.layerCount = 1;
-            imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-            imageMemoryBarrier.subresourceRange.levelCount = 1;
-            
-            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
-                        0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+            vkCmdPushConstants(commandBuffer, _rtShaderPass.pShaderEffect->pipelineLayout, VK_SHADER_STAGE_ALL, 0, 
+                            sizeof(ScenePushConstant), &scenePushConstant);
+
+            // Specialized for the bounce count and the light types in the scene once compiled, the generic pass runs until then
+            uint32_t lightTypeMask = 0;
+            for (int i = 0; i != _sceneBuffer.numLights; ++i) {
+                lightTypeMask |= 1u << _lights[i].type;
+            }
+
+            const ShaderPass *pRtShaderVariant = _rtVariantCache.requestVariant({
+                {"MAX_REFLECTION", static_cast<uint32_t>(std::max(_sceneBuffer.numIndirectReflect, 1))},
+                {"LIGHT_TYPE_MASK", lightTypeMask}
+            });
+
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pRtShaderVariant ? pRtShaderVariant->pipeline : _rtShaderPass.pipeline);
 
-            _renderTarget.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            int groupCountX = _renderTargetExtent.width / 32 + 1;
+            int groupCountY = _renderTargetExtent.height / 32 + 1; 
+            vkCmdDispatch(commandBuffer, groupCountX, groupCountY, 1);
+
+            if (writeTimestamps) {
+                vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, _timestampQueryPool, _currentFrame * 2 + 1);
+            }
+
+            cmdTextureFeedbackBarrier(commandBuffer);
+
+            {
+                VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+                imageMemoryBarrier.image = _renderTarget.vkImage;
+                imageMemoryBarrier.oldLayout = _renderTarget.imageLayout;
+                imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                imageMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+                imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+                imageMemoryBarrier.subresourceRange.layerCount = 1;
+                imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+                imageMemoryBarrier.subresourceRange.levelCount = 1;
+                
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
+                            0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+
+                _renderTarget.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            }
         }
 
         std::array<VkClearValue, 2> clearValues = {};
@@ -333,12 +571,14 @@ namespace arsenic
         vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _fullScreenPass.pShaderEffect->pipelineLayout,
-                        0, 1, &_globalDescriptorSet.value[_currentFrame], 0, nullptr);
-        
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _fullScreenPass.pipeline);
+        if (scenePassesReady) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _fullScreenPass.pShaderEffect->pipelineLayout,
+                            0, 1, &_globalDescriptorSet, static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _fullScreenPass.pipeline);
 
-        vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+            vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+        }
 
         ImGui::Render();
         ImDrawData* pDrawData = ImGui::GetDrawData();
@@ -348,20 +588,8 @@ namespace arsenic
 
         checkVkResult(vkEndCommandBuffer(commandBuffer));
     
-        {
-            static constexpr VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        
-            VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffer;
-            submitInfo.waitSemaphoreCount = 1;
-            submitInfo.pWaitSemaphores = &frame.imageReadySemaphore;
-            submitInfo.pWaitDstStageMask = &waitStage;
-            submitInfo.signalSemaphoreCount = 1;
-            submitInfo.pSignalSemaphores = &frame.renderFinishSemaphore;
-
-            checkVkResult(vkQueueSubmit(_vulkanContext.graphicsQueue, 1, &submitInfo, frame.frameInFlightFence));
-        }
+        frame.timelineValue = submitToTimeline(_vulkanContext.graphicsQueue, _vulkanContext.graphicsTimeline, commandBuffer, 
+                                        frame.imageReadySemaphore, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, frame.renderFinishSemaphore);
 
         presentSwapchainImage(_vulkanContext.device, _vulkanContext.presentQueue, frame.renderFinishSemaphore, imageIndex, _swapchain);
         _currentFrame = (_currentFrame + 1) % maxFrameInFlight;
@@ -369,173 +597,123 @@ namespace arsenic
 
     void SandboxLayer::setupShaderResource()
     {
-        for (std::size_t i = 0; i != maxFrameInFlight; ++i) {
-            _gpuSceneBuffers.value[i] = createBuffer(_vulkanContext, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
-                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                            sizeof(SceneBuffer));
-
-            _gpuCameraBuffers.value[i] = createBuffer(_vulkanContext, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
-                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                                    sizeof(CameraBuffer));
-
-            _gpuSphereBuffers.value[i] = createBuffer(_vulkanContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 
-                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                                    sizeof(SphereMesh) * maxSphereMeshes);
-
-            _gpuLightBuffers.value[i] = createBuffer(_vulkanContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 
-                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                                    sizeof(Light) * maxLights);
-
-            _gpuMaterialBuffers.value[i] = createBuffer(_vulkanContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 
-                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                                    sizeof(Material) * maxMaterials);
-        }        
+        _frameAllocator = createFrameAllocator(_vulkanContext, frameDataCapacity, _vulkanContext.hostWritePolicy.path);
     }
 
     void SandboxLayer::createEngineDescriptorPool()
     {
         std::array<VkDescriptorPoolSize, 6> poolSizes = {
-            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 100},
-            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 100},
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 100},
+            VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 100},
             VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 100},
             VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 100},
             VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, 100},
             VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100}
         };
 
+        // The global set is replaced when the defragmenter moves an IBL map. A defragmentation pass waits for the previous one
+        // to complete, so no more than two replaced sets wait to be freed next to the current one
         VkDescriptorPoolCreateInfo descriptorPoolCI = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+        descriptorPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
         descriptorPoolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
         descriptorPoolCI.pPoolSizes = poolSizes.data();
         descriptorPoolCI.maxSets = maxFrameInFlight;
 
-        checkVkResult(vkCreateDescriptorPool(_vulkanContext.device, &descriptorPoolCI, nullptr, &_descriptorPool));
+        checkVkResult(vkCreateDescriptorPool(_vulkanContext.device, &descriptorPoolCI, getHostAllocationCallbacks(HostAllocationTag::Descriptor), &_descriptorPool));
     }
 
     void SandboxLayer::setupGlobalDescriptorSet()
     {
-        std::vector<VkDescriptorSetLayout> descriptorSetLayout(maxFrameInFlight, _rtShaderPass.pShaderEffect->descriptorSetLayouts[0]);
-
         VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
         descriptorSetAllocateInfo.descriptorPool = _descriptorPool;
-        descriptorSetAllocateInfo.descriptorSetCount = maxFrameInFlight;
-        descriptorSetAllocateInfo.pSetLayouts = descriptorSetLayout.data();
+        descriptorSetAllocateInfo.descriptorSetCount = 1;
+        descriptorSetAllocateInfo.pSetLayouts = &_rtShaderPass.pShaderEffect->descriptorSetLayouts[frameDataDescriptorSet];
         
-        checkVkResult(vkAllocateDescriptorSets(_vulkanContext.device, &descriptorSetAllocateInfo, _globalDescriptorSet.value.data()));
-
-        for (std::size_t i = 0; i != maxFrameInFlight; ++i) {
-            const VulkanBuffer &gpuSceneBuffer = _gpuSceneBuffers.value[i];
-            const VulkanBuffer &gpuCameraBuffer = _gpuCameraBuffers.value[i];
-            const VulkanBuffer &gpuSphereBuffer = _gpuSphereBuffers.value[i];
-            const VulkanBuffer &gpuLightBuffer = _gpuLightBuffers.value[i];
-            const VulkanBuffer &gpuMaterialBuffer = _gpuMaterialBuffers.value[i];
-
-            std::array<VkWriteDescriptorSet, 8> writeDescriptors = {};
-
-            VkDescriptorBufferInfo gpuSceneDescriptorBufferInfo = {};
-            gpuSceneDescriptorBufferInfo.buffer = gpuSceneBuffer.vkBuffer;
-            gpuSceneDescriptorBufferInfo.range = gpuSceneBuffer.size;
-
-            writeDescriptors[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeDescriptors[0].dstSet = _globalDescriptorSet.value[i];
-            writeDescriptors[0].dstBinding = 0;
-            writeDescriptors[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            writeDescriptors[0].descriptorCount = 1;
-            writeDescriptors[0].dstArrayElement = 0;
-            writeDescriptors[0].pBufferInfo = &gpuSceneDescriptorBufferInfo;
-
-            VkDescriptorBufferInfo gpuCameraDescriptorBufferInfo = {};
-            gpuCameraDescriptorBufferInfo.buffer = gpuCameraBuffer.vkBuffer;
-            gpuCameraDescriptorBufferInfo.range = gpuCameraBuffer.size;
-
-            writeDescriptors[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeDescriptors[1].dstSet = _globalDescriptorSet.value[i];
-            writeDescriptors[1].dstBinding = 1;
-            writeDescriptors[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            writeDescriptors[1].descriptorCount = 1;
-            writeDescriptors[1].dstArrayElement = 0;
-            writeDescriptors[1].pBufferInfo = &gpuCameraDescriptorBufferInfo;
-
-            VkDescriptorBufferInfo gpuSphereDescriptorBufferInfo = {};
-            gpuSphereDescriptorBufferInfo.buffer = gpuSphereBuffer.vkBuffer;
-            gpuSphereDescriptorBufferInfo.range = gpuSphereBuffer.size;
-
-            writeDescriptors[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeDescriptors[3].dstSet = _globalDescriptorSet.value[i];
-            writeDescriptors[3].dstBinding = 2;
-            writeDescriptors[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            writeDescriptors[3].descriptorCount = 1;
-            writeDescriptors[3].dstArrayElement = 0;
-            writeDescriptors[3].pBufferInfo = &gpuSphereDescriptorBufferInfo;
-
-            VkDescriptorBufferInfo gpuLightDescriptorBufferInfo = {};
-            gpuLightDescriptorBufferInfo.buffer = gpuLightBuffer.vkBuffer;
-            gpuLightDescriptorBufferInfo.range = gpuLightBuffer.size;
-
-            writeDescriptors[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeDescriptors[2].dstSet = _globalDescriptorSet.value[i];
-            writeDescriptors[2].dstBinding = 3;
-            writeDescriptors[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            writeDescriptors[2].descriptorCount = 1;
-            writeDescriptors[2].dstArrayElement = 0;
-            writeDescriptors[2].pBufferInfo = &gpuLightDescriptorBufferInfo;
-
-            VkDescriptorBufferInfo gpuMaterialDescriptorBufferInfo = {};
-            gpuMaterialDescriptorBufferInfo.buffer = gpuMaterialBuffer.vkBuffer;
-            gpuMaterialDescriptorBufferInfo.range = gpuMaterialBuffer.size;
-
-            writeDescriptors[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeDescriptors[4].dstSet = _globalDescriptorSet.value[i];
-            writeDescriptors[4].dstBinding = 4;
-            writeDescriptors[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            writeDescriptors[4].descriptorCount = 1;
-            writeDescriptors[4].dstArrayElement = 0;
-            writeDescriptors[4].pBufferInfo = &gpuMaterialDescriptorBufferInfo;
-            
-            {
-                VkDescriptorImageInfo descriptorImageInfo = {};
-                descriptorImageInfo.imageView = _renderTarget.vkImageView;
-                descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-                
-                writeDescriptors[5].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                writeDescriptors[5].dstSet = _globalDescriptorSet.value[i];
-                writeDescriptors[5].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-                writeDescriptors[5].dstBinding = 5;
-                writeDescriptors[5].descriptorCount = 1;
-                writeDescriptors[5].dstArrayElement = 0;
-                writeDescriptors[5].pImageInfo = &descriptorImageInfo;
-            }
-            
-            {
-                VkDescriptorImageInfo descriptorImageInfo = {};
-                descriptorImageInfo.imageView = _renderTarget.vkImageView;
-                descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                descriptorImageInfo.sampler = _generalSampler;
-                
-                writeDescriptors[6].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                writeDescriptors[6].dstSet = _globalDescriptorSet.value[i];
-                writeDescriptors[6].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                writeDescriptors[6].dstBinding = 6;
-                writeDescriptors[6].descriptorCount = 1;
-                writeDescriptors[6].dstArrayElement = 0;
-                writeDescriptors[6].pImageInfo = &descriptorImageInfo;
-            }
+        checkVkResult(vkAllocateDescriptorSets(_vulkanContext.device, &descriptorSetAllocateInfo, &_globalDescriptorSet));
 
-            {
-                VkDescriptorImageInfo descriptorImageInfo = {};
-                descriptorImageInfo.imageLayout = _sceneEnviromentMap.imageLayout;
-                descriptorImageInfo.imageView = _sceneEnviromentMap.vkImageView;
-                descriptorImageInfo.sampler = _generalSampler;
-
-                writeDescriptors[7].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                writeDescriptors[7].dstSet = _globalDescriptorSet.value[i];
-                writeDescriptors[7].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                writeDescriptors[7].dstBinding = 7;
-                writeDescriptors[7].descriptorCount = 1;
-                writeDescriptors[7].dstArrayElement = 0;
-                writeDescriptors[7].pImageInfo = &descriptorImageInfo;
-            }
+        writeFrameDataDescriptors();
 
-            vkUpdateDescriptorSets(_vulkanContext.device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr);
+        std::array<VkWriteDescriptorSet, 5> writeDescriptors = {};
+
+        VkDescriptorImageInfo renderTargetStorageImageInfo = {};
+        renderTargetStorageImageInfo.imageView = _renderTarget.vkImageView;
+        renderTargetStorageImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        
+        writeDescriptors[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptors[0].dstSet = _globalDescriptorSet;
+        writeDescriptors[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writeDescriptors[0].dstBinding = 5;
+        writeDescriptors[0].descriptorCount = 1;
+        writeDescriptors[0].dstArrayElement = 0;
+        writeDescriptors[0].pImageInfo = &renderTargetStorageImageInfo;
+        
+        VkDescriptorImageInfo renderTargetSampledImageInfo = {};
+        renderTargetSampledImageInfo.imageView = _renderTarget.vkImageView;
+        renderTargetSampledImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        renderTargetSampledImageInfo.sampler = _generalSampler;
+        
+        writeDescriptors[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptors[1].dstSet = _globalDescriptorSet;
+        writeDescriptors[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writeDescriptors[1].dstBinding = 6;
+        writeDescriptors[1].descriptorCount = 1;
+        writeDescriptors[1].dstArrayElement = 0;
+        writeDescriptors[1].pImageInfo = &renderTargetSampledImageInfo;
+
+        // The prefiltered enviroment, irradiance and BRDF LUT in bindings 7 to 9
+        const std::array<VkDescriptorImageInfo, 3> iblImageInfos = {
+            VkDescriptorImageInfo{_iblBaker.sampler, _iblMaps.specularMap.vkImageView, _iblMaps.specularMap.imageLayout},
+            VkDescriptorImageInfo{_iblBaker.sampler, _iblMaps.irradianceMap.vkImageView, _iblMaps.irradianceMap.imageLayout},
+            VkDescriptorImageInfo{_iblBaker.sampler, _iblMaps.brdfLut.vkImageView, _iblMaps.brdfLut.imageLayout}
+        };
+
+        for (uint32_t i = 0; i != iblImageInfos.size(); ++i) {
+            writeDescriptors[2 + i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptors[2 + i].dstSet = _globalDescriptorSet;
+            writeDescriptors[2 + i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writeDescriptors[2 + i].dstBinding = 7 + i;
+            writeDescriptors[2 + i].descriptorCount = 1;
+            writeDescriptors[2 + i].dstArrayElement = 0;
+            writeDescriptors[2 + i].pImageInfo = &iblImageInfos[i];
+        }
+
+        vkUpdateDescriptorSets(_vulkanContext.device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr);
+    }
+
+    void SandboxLayer::writeFrameDataDescriptors()
+    {
+        // Both uniform bindings point at the frame allocator, the actual sub-range is picked with a dynamic offset at bind time.
+        // Scene arrays are not bound at all, rtCompute reads them through the device addresses in ScenePushConstant
+        const std::array<VkDescriptorBufferInfo, 2> frameDataBufferInfos = {
+            VkDescriptorBufferInfo{_frameAllocator.buffer.vkBuffer, 0, sizeof(SceneBuffer)},
+            VkDescriptorBufferInfo{_frameAllocator.buffer.vkBuffer, 0, sizeof(CameraBuffer)}
+        };
+
+        std::array<VkWriteDescriptorSet, 2> writeDescriptors = {};
+
+        for (uint32_t i = 0; i != frameDataBufferInfos.size(); ++i) {
+            writeDescriptors[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptors[i].dstSet = _globalDescriptorSet;
+            writeDescriptors[i].dstBinding = i;
+            writeDescriptors[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            writeDescriptors[i].descriptorCount = 1;
+            writeDescriptors[i].dstArrayElement = 0;
+            writeDescriptors[i].pBufferInfo = &frameDataBufferInfos[i];
+        }
+
+        vkUpdateDescriptorSets(_vulkanContext.device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr);
+    }
+
+    void SandboxLayer::recreateFrameAllocator(const HostWritePath writePath)
+    {
+        // The global descriptor set is rewritten below, which is only allowed once no submitted frame uses it anymore
+        checkVkResult(vkDeviceWaitIdle(_vulkanContext.device));
+
+        destroyFrameAllocator(_vulkanContext, _frameAllocator);
+        _frameAllocator = createFrameAllocator(_vulkanContext, frameDataCapacity, writePath);
+
+        if (_globalDescriptorSet) {
+            writeFrameDataDescriptors();
         }
     }
 
@@ -546,37 +724,61 @@ namespace arsenic
     void SandboxLayer::initializeFrame()
     {
         for (Frame &frame : _frames.value) {
-            VkFenceCreateInfo fenceCI = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-            fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-            checkVkResult(vkCreateFence(_vulkanContext.device, &fenceCI, nullptr, &frame.frameInFlightFence));
+            frame.timelineValue = 0;
 
             VkSemaphoreCreateInfo semaphoreCI = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
-            checkVkResult(vkCreateSemaphore(_vulkanContext.device, &semaphoreCI, nullptr, &frame.imageReadySemaphore));
-            checkVkResult(vkCreateSemaphore(_vulkanContext.device, &semaphoreCI, nullptr, &frame.renderFinishSemaphore));
+            checkVkResult(vkCreateSemaphore(_vulkanContext.device, &semaphoreCI, getHostAllocationCallbacks(HostAllocationTag::Sync), &frame.imageReadySemaphore));
+            checkVkResult(vkCreateSemaphore(_vulkanContext.device, &semaphoreCI, getHostAllocationCallbacks(HostAllocationTag::Sync), &frame.renderFinishSemaphore));
 
             VkCommandPoolCreateInfo commandPoolCI = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
             commandPoolCI.queueFamilyIndex = _vulkanContext.physicalDevice.queueFamilies.graphicsFamily.value();
-            checkVkResult(vkCreateCommandPool(_vulkanContext.device, &commandPoolCI, nullptr, &frame.commandPool));
+            checkVkResult(vkCreateCommandPool(_vulkanContext.device, &commandPoolCI, getHostAllocationCallbacks(HostAllocationTag::Command), &frame.commandPool));
+        }
+
+        // timestampComputeAndGraphics only promises timestamps on every graphics and compute family at once,
+        // the valid bits tell whether the family the frame is recorded for supports them
+        const PhysicalDevice &physicalDevice = _vulkanContext.physicalDevice;
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice.vkPhysicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice.vkPhysicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+
+        const uint32_t timestampValidBits = queueFamilyProperties[physicalDevice.queueFamilies.graphicsFamily.value()].timestampValidBits;
+
+        if (timestampValidBits == 0) {
+            ARSENIC_WARN("The graphics queue cannot write timestamps, GPU timings are disabled");
+            return;
         }
+
+        _timestampMask = timestampValidBits >= 64 ? ~0ull : (1ull << timestampValidBits) - 1;
+
+        VkQueryPoolCreateInfo queryPoolCI = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+        queryPoolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolCI.queryCount = 2 * maxFrameInFlight;
+        checkVkResult(vkCreateQueryPool(_vulkanContext.device, &queryPoolCI, getHostAllocationCallbacks(HostAllocationTag::Command), &_timestampQueryPool));
     }
 
     void SandboxLayer::deInitializeFrame()
     {
         for (Frame &frame : _frames.value) {
-            vkDestroyFence(_vulkanContext.device, frame.frameInFlightFence, nullptr);
-            vkDestroySemaphore(_vulkanContext.device, frame.imageReadySemaphore, nullptr);
-            vkDestroySemaphore(_vulkanContext.device, frame.renderFinishSemaphore, nullptr);
-            vkDestroyCommandPool(_vulkanContext.device, frame.commandPool, nullptr);
+            vkDestroySemaphore(_vulkanContext.device, frame.imageReadySemaphore, getHostAllocationCallbacks(HostAllocationTag::Sync));
+            vkDestroySemaphore(_vulkanContext.device, frame.renderFinishSemaphore, getHostAllocationCallbacks(HostAllocationTag::Sync));
+            vkDestroyCommandPool(_vulkanContext.device, frame.commandPool, getHostAllocationCallbacks(HostAllocationTag::Command));
         }
+
+        vkDestroyQueryPool(_vulkanContext.device, _timestampQueryPool, getHostAllocationCallbacks(HostAllocationTag::Command));
+        _timestampQueryPool = VK_NULL_HANDLE;
     }
 
     void SandboxLayer::createRenderTarget()
     {
         const VkFormat format = _vulkanContext.findSupportedFormat({VK_FORMAT_R8G8B8A8_SNORM}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
      
-        const VulkanImageDesc imageDesc = VulkanImageDesc::create(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VulkanImageDesc imageDesc = VulkanImageDesc::create(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                                                                 {_renderTargetExtent.width, _renderTargetExtent.height, 1},
                                                                 format, 1, false);
+        imageDesc.dedicatedAllocation = true;
 
         _renderTarget = createImage2D(_vulkanContext, imageDesc);
         _renderTarget.vkImageView = createImageView(_vulkanContext, _renderTarget.vkImage, VK_IMAGE_VIEW_TYPE_2D,
@@ -586,7 +788,7 @@ namespace arsenic
     void SandboxLayer::destroyRenderTarget()
     {
         destroyImage(_vulkanContext, _renderTarget);
-        vkDestroyImageView(_vulkanContext.device, _renderTarget.vkImageView, nullptr);
+        vkDestroyImageView(_vulkanContext.device, _renderTarget.vkImageView, getHostAllocationCallbacks(HostAllocationTag::Resource));
         _renderTarget = {};
     }
 
@@ -595,9 +797,10 @@ namespace arsenic
         const VkFormat format = _vulkanContext.findSupportedFormat({VK_FORMAT_D24_UNORM_S8_UINT}, 
                                                 VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 
-        const VulkanImageDesc imageDesc = VulkanImageDesc::create(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 
+        VulkanImageDesc imageDesc = VulkanImageDesc::create(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 
                                                     {_swapchain.imageExtent.width, _swapchain.imageExtent.height, 1},
                                                     format, 1, false);
+        imageDesc.dedicatedAllocation = true;
 
         _depthTexture = createImage2D(_vulkanContext, imageDesc);
         _depthTexture.vkImageView = createImageView(_vulkanContext, _depthTexture.vkImage, VK_IMAGE_VIEW_TYPE_2D, 
@@ -608,7 +811,7 @@ namespace arsenic
     void SandboxLayer::destroyDepthTexture()
     {
         destroyImage(_vulkanContext, _depthTexture);
-        vkDestroyImageView(_vulkanContext.device, _depthTexture.vkImageView, nullptr);
+        vkDestroyImageView(_vulkanContext.device, _depthTexture.vkImageView, getHostAllocationCallbacks(HostAllocationTag::Resource));
         _depthTexture = {};
     }
 
@@ -665,7 +868,7 @@ namespace arsenic
         renderPassCI.dependencyCount = 1;
         renderPassCI.pDependencies = &subpassDependency;
 
-        checkVkResult(vkCreateRenderPass(_vulkanContext.device, &renderPassCI, nullptr, &_renderpass));
+        checkVkResult(vkCreateRenderPass(_vulkanContext.device, &renderPassCI, getHostAllocationCallbacks(HostAllocationTag::Resource), &_renderpass));
     }
 
     void SandboxLayer::createFramebuffers()
@@ -683,26 +886,38 @@ namespace arsenic
             framebufferCI.layers = 1;
             framebufferCI.renderPass = _renderpass;
 
-            checkVkResult(vkCreateFramebuffer(_vulkanContext.device, &framebufferCI, nullptr, &_frameBuffers[i]));
+            checkVkResult(vkCreateFramebuffer(_vulkanContext.device, &framebufferCI, getHostAllocationCallbacks(HostAllocationTag::Resource), &_frameBuffers[i]));
         }
     }
 
     void SandboxLayer::destroyFramebuffers()
     {
         for (const VkFramebuffer framebuffer : _frameBuffers) {
-            vkDestroyFramebuffer(_vulkanContext.device, framebuffer, nullptr);
+            vkDestroyFramebuffer(_vulkanContext.device, framebuffer, getHostAllocationCallbacks(HostAllocationTag::Resource));
         }
     }
 
     void SandboxLayer::recreateSwapchain(const VkExtent2D desiredExtent2D)
     {
-        checkVkResult(vkDeviceWaitIdle(_vulkanContext.device));
+        // Frames in flight may still reference the old swapchain, framebuffers and depth texture,
+        // so they are retired through the deletion queue instead of waiting for the device to go idle
+        Swapchain oldSwapchain = _swapchain;
+        std::vector<VkFramebuffer> oldFrameBuffers = std::move(_frameBuffers);
+        _frameBuffers.clear();
+
+        const uint64_t retireValue = _vulkanContext.graphicsTimeline.submittedValue;
+
+        deferDestroyImage(_deletionQueue, _depthTexture, retireValue);
+        deferDestroy(_deletionQueue, [oldSwapchain, oldFrameBuffers](const VulkanContext &vulkanContext) mutable {
+            for (const VkFramebuffer framebuffer : oldFrameBuffers) {
+                vkDestroyFramebuffer(vulkanContext.device, framebuffer, getHostAllocationCallbacks(HostAllocationTag::Resource));
+            }
 
-        destroyFramebuffers();
-        destroyDepthTexture();
-        destroySwapchain(_vulkanContext.device, _swapchain);
+            destroySwapchain(vulkanContext.device, oldSwapchain);
+        }, retireValue);
 
-        _swapchain = createSwapchain(_vulkanContext.device, _vulkanContext.surface, _vulkanContext.physicalDevice.vkPhysicalDevice, desiredExtent2D);
+        _swapchain = createSwapchain(_vulkanContext.device, _vulkanContext.surface, _vulkanContext.physicalDevice.vkPhysicalDevice, desiredExtent2D,
+                                    oldSwapchain.vkSwapchain);
         createDepthTexture();
         createFramebuffers();
     }
@@ -728,7 +943,7 @@ namespace arsenic
         descriptorPoolCI.pPoolSizes = poolSizes.data();
         descriptorPoolCI.maxSets = 1000 * poolSizes.size();
 
-        checkVkResult(vkCreateDescriptorPool(_vulkanContext.device, &descriptorPoolCI, nullptr, &_imguiDescriptorPool));
+        checkVkResult(vkCreateDescriptorPool(_vulkanContext.device, &descriptorPoolCI, getHostAllocationCallbacks(HostAllocationTag::Descriptor), &_imguiDescriptorPool));
 
         IMGUI_CHECKVERSION();
         ImGui::CreateContext();
@@ -750,6 +965,7 @@ namespace arsenic
         init_info.Device = _vulkanContext.device;
         init_info.QueueFamily = _vulkanContext.physicalDevice.queueFamilies.graphicsFamily.value();
         init_info.Queue = _vulkanContext.graphicsQueue;
+        init_info.PipelineCache = _vulkanContext.pipelineCache;
         init_info.DescriptorPool = _imguiDescriptorPool;
         init_info.MinImageCount = _swapchain.minImageCount;
         init_info.ImageCount = _swapchain.imageCount;
@@ -773,12 +989,7 @@ namespace arsenic
 
         checkVkResult(vkEndCommandBuffer(commandBuffer));
 
-        VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
-    
-        checkVkResult(vkResetFences(_vulkanContext.device, 1, &frame.frameInFlightFence));
-        checkVkResult(vkQueueSubmit(_vulkanContext.graphicsQueue, 1, &submitInfo, frame.frameInFlightFence));
-        checkVkResult(vkWaitForFences(_vulkanContext.device, 1, &frame.frameInFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+        const uint64_t uploadValue = submitToTimeline(_vulkanContext.graphicsQueue, _vulkanContext.graphicsTimeline, commandBuffer);
+        waitForTimelineValue(_vulkanContext.device, _vulkanContext.graphicsTimeline, uploadValue);
     }
 }
\ No newline at end of file
@@ -5,8 +5,18 @@
 namespace arsenic
 {
     constexpr std::size_t maxSphereMeshes = 10;
-    constexpr std::size_t maxMaterials = 1E6;
-    constexpr std::size_t maxLights = 1E6;
+    constexpr std::size_t maxLights = 16;
+    constexpr std::size_t maxMaterials = maxSphereMeshes;
+    constexpr VkDeviceSize frameDataCapacity = 4 * 1024 * 1024;
+    constexpr float timingSmoothing = 0.05f;
+    constexpr uint32_t defragmentationCheckInterval = 240;
+    // Written on shutdown, so the next launch creates its pipelines without compiling them
+    constexpr const char *pipelineCacheFilePath = "Assets/Cache/pipeline.cache";
+    constexpr const char *rtComputeSpvFilePath = "Assets/Shaders/Spv/rtCompute.comp.spv";
+    constexpr const char *fullScreenPsoFilePath = "Assets/Pso/fullScreenPSO.json";
+    // Cooked with ArsenicCooker --shader-bundle, used instead of the sources above when present and valid
+    constexpr const char *rtComputeBundleFilePath = "Assets/Shaders/Spv/rtCompute.comp.bundle";
+    constexpr const char *fullScreenBundleFilePath = "Assets/Pso/fullScreenPSO.bundle";
 
     class SandboxLayer : public Layer
     {
@@ -29,6 +39,8 @@ namespace arsenic
         void setupShaderResource();
         void createEngineDescriptorPool();
         void setupGlobalDescriptorSet();
+        void writeFrameDataDescriptors();
+        void recreateFrameAllocator(const HostWritePath writePath);
         void setupPerPassDescriptorSet();
         void initializeFrame();
         void deInitializeFrame();
@@ -46,9 +58,15 @@ namespace arsenic
     private:
         VulkanContext _vulkanContext;
         MaterialManager _materialManager;   
+        TextureStreamer _textureStreamer;
+        TextureHandle _streamedTexture = invalidHandle;
+        TextureFeedback _textureFeedback;
 
         PerFrame<Frame> _frames;
         uint32_t _currentFrame = 0;
+        uint32_t _frameCount = 0;
+        DeletionQueue _deletionQueue;
+        Defragmenter _defragmenter;
         Swapchain _swapchain;
         VulkanImage _depthTexture;
         std::vector<VkFramebuffer> _frameBuffers;
@@ -60,14 +78,26 @@ namespace arsenic
         VkDescriptorPool _imguiDescriptorPool = VK_NULL_HANDLE;
         VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
 
-        PerFrame<VkDescriptorSet> _globalDescriptorSet;
+        VkDescriptorSet _globalDescriptorSet = VK_NULL_HANDLE;
+        // Set when the defragmenter moved an image the global descriptor set refers to
+        bool _globalDescriptorSetStale = false;
         PerFrame<VkDescriptorSet> _perPassDescriptorSets;
 
-        PerFrame<VulkanBuffer> _gpuSceneBuffers;
-        PerFrame<VulkanBuffer> _gpuCameraBuffers;
-        PerFrame<VulkanBuffer> _gpuSphereBuffers;
-        PerFrame<VulkanBuffer> _gpuLightBuffers;
-        PerFrame<VulkanBuffer> _gpuMaterialBuffers;
+        FrameAllocator _frameAllocator;
+        bool _forceStagingFrameData = false;
+
+        ScatterUploader _scatterUploader;
+        MipDownsampler _mipDownsampler;
+        ScatterBuffer _sphereMeshScatterBuffer;
+        ScatterBuffer _lightScatterBuffer;
+        ScatterBuffer _materialScatterBuffer;
+
+        // Left null when the graphics queue cannot write timestamps
+        VkQueryPool _timestampQueryPool = VK_NULL_HANDLE;
+        uint64_t _timestampMask = 0;
+        PerFrame<bool> _timestampsWritten = {};
+        float _frameDataWriteTimeMs = 0.0f;
+        float _rtComputeGpuTimeMs = 0.0f;
 
         SceneBuffer _sceneBuffer;
         CameraBuffer _cameraBuffer;
@@ -75,13 +105,17 @@ namespace arsenic
         std::vector<Light> _lights;
         std::vector<Material> _materials;
         
-        VulkanImage _sceneEnviromentMap;
+        IblBaker _iblBaker;
+        IblMaps _iblMaps;
         VkSampler _generalSampler;
         
-        ShaderEffect _rtShaderEffect;
-        ShaderEffect _fullScreenShaderEffect;
-        ShaderPass _rtShaderPass;
-        ShaderPass _fullScreenPass;
+        PipelineBuilder _pipelineBuilder;
+        ShaderHotReloader _shaderHotReloader;
+        ShaderVariantCache _rtVariantCache;
+        std::future<ShaderPass> _rtShaderPassFuture;
+        std::future<ShaderPass> _fullScreenPassFuture;
+        ShaderPass _rtShaderPass = {};
+        ShaderPass _fullScreenPass = {};
      
         Scene _scene;
         Camera _camera;
@@ -0,0 +1,19 @@
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Match maxBindlessTextures and maxBindlessSamplers in BindlessTable.hpp
+#define MAX_BINDLESS_TEXTURES 4096
+#define MAX_BINDLESS_SAMPLERS 64
+
+// Indexed by the map and sampler indices of Material, only slots that were registered may be read
+layout(set = 1, binding = 0) uniform texture2D bindlessTextures[MAX_BINDLESS_TEXTURES];
+layout(set = 1, binding = 1) uniform sampler bindlessSamplers[MAX_BINDLESS_SAMPLERS];
+
+vec4 sampleBindlessTextureLod(int textureIndex, int samplerIndex, vec2 uv, float lod)
+{
+    return textureLod(sampler2D(bindlessTextures[nonuniformEXT(textureIndex)], bindlessSamplers[nonuniformEXT(samplerIndex)]), uv, lod);
+}
+
+#endif
\ No newline at end of file
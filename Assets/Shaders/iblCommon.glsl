@@ -0,0 +1,68 @@
+#ifndef IBL_COMMON_GLSL
+#define IBL_COMMON_GLSL
+
+#define PI 3.1415926535f
+
+// Direction through a texel of a cube face, faces are the array layers in the +X -X +Y -Y +Z -Z order cube views use
+vec3 getCubeDirection(uint face, vec2 uv)
+{
+    vec2 st = uv * 2.0f - 1.0f;
+    vec3 direction;
+
+    switch (face) {
+        case 0u: direction = vec3(1.0f, -st.y, -st.x); break;
+        case 1u: direction = vec3(-1.0f, -st.y, st.x); break;
+        case 2u: direction = vec3(st.x, 1.0f, st.y); break;
+        case 3u: direction = vec3(st.x, -1.0f, -st.y); break;
+        case 4u: direction = vec3(st.x, -st.y, 1.0f); break;
+        default: direction = vec3(-st.x, -st.y, -1.0f); break;
+    }
+
+    return normalize(direction);
+}
+
+vec2 hammersley(uint i, uint count)
+{
+    return vec2(float(i) / float(count), float(bitfieldReverse(i)) * 2.3283064365386963e-10f);
+}
+
+vec3 tangentToWorld(vec3 v, vec3 N)
+{
+    vec3 up = abs(N.z) < 0.999f ? vec3(0.0f, 0.0f, 1.0f) : vec3(1.0f, 0.0f, 0.0f);
+    vec3 tangent = normalize(cross(up, N));
+    vec3 bitangent = cross(N, tangent);
+
+    return tangent * v.x + bitangent * v.y + N * v.z;
+}
+
+// Same distribution as D_ggx in rtCompute.comp, where roughness squared is alpha squared
+float D_ggx(float NdotH, float roughness)
+{
+    float a2 = roughness * roughness;
+    float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+
+    return a2 / (PI * denom * denom);
+}
+
+// Half vector distributed proportionally to D_ggx(NdotH) * NdotH
+vec3 importanceSampleGgx(vec2 xi, vec3 N, float roughness)
+{
+    float a2 = roughness * roughness;
+    float phi = 2.0f * PI * xi.x;
+    float cosTheta = sqrt((1.0f - xi.y) / (1.0f + (a2 - 1.0f) * xi.y));
+    float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+
+    return tangentToWorld(vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta), N);
+}
+
+// Filtered importance sampling: reads the mip whose texels cover about the solid angle one sample stands for,
+// which converges with far fewer samples than always reading mip 0
+float getSourceLod(float pdf, uint sampleCount, float sourceSize, float maxLod)
+{
+    float texelSolidAngle = 4.0f * PI / (6.0f * sourceSize * sourceSize);
+    float sampleSolidAngle = 1.0f / (float(sampleCount) * pdf + 0.0001f);
+
+    return clamp(0.5f * log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f, maxLod);
+}
+
+#endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef STRUCTURES_GLSL
 #define STRUCTURES_GLSL
 
+#extension GL_EXT_buffer_reference : require
+
 struct SphereMesh
 {
     vec3 center;
@@ -62,30 +64,47 @@ layout(set = 0, binding = 1) uniform CameraBuffer
     int pad2;
 } _cameraBuffer;
 
-layout(set = 0, binding = 2) buffer readonly SphereMeshBuffer
+// Scene arrays are reached through buffer device addresses passed in the push constant block
+layout(buffer_reference, std430, buffer_reference_align = 16) buffer readonly SphereMeshBuffer
 {
     SphereMesh sphereMeshes[];
-} _sphereMeshBuffer;
+};
 
-layout(set = 0, binding = 3) buffer readonly LightBuffer
+layout(buffer_reference, std430, buffer_reference_align = 16) buffer readonly LightBuffer
 {
     Light lights[];
-} _lightBuffer;
+};
 
-layout(set = 0, binding = 4) buffer readonly MaterialBuffer
+layout(buffer_reference, std430, buffer_reference_align = 16) buffer readonly MaterialBuffer
 {
     Material materials[];
-} _materialBuffer;
+};
+
+// One entry per bindless texture slot, the float bits of the smallest uv distance a pixel covered, see TextureFeedback.hpp
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer TextureFeedbackBuffer
+{
+    uint uvFootprints[];
+};
 
 layout(set = 0, binding = 5, rgba8) uniform writeonly image2D rtrenderTarget;
 
 layout(set = 0, binding = 6) uniform sampler2D rtRenderTarget;
 
+// GGX prefiltered environment, mip m holds roughness m / (levels - 1) and mip 0 the environment itself
 layout(set = 0, binding = 7) uniform samplerCube sceneEnviromentMap;
 
+layout(set = 0, binding = 8) uniform samplerCube sceneIrradianceMap;
+
+// Split sum scale and bias applied to F0, indexed by (NdotV, roughness)
+layout(set = 0, binding = 9) uniform sampler2D sceneBrdfLut;
+
 
 layout(push_constant) uniform PushConstant
 {
+    SphereMeshBuffer sphereMeshBuffer;
+    LightBuffer lightBuffer;
+    MaterialBuffer materialBuffer;
+    TextureFeedbackBuffer textureFeedbackBuffer;
     int renderObjectIndex;
 } _pushConstant;
 
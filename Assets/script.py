@@ -1,15 +1,7 @@
+# Shaders are compiled by the ArsenicShaders CMake target and textures cooked by ArsenicTextures, build before copying
 import os
 import shutil
 
-def compileShader():
-    print("Before compiling shaders:")
-
-    os.system('cmd /c "glslc Shaders/rtCompute.comp -o Shaders/Spv/rtCompute.comp.spv"')
-    os.system('cmd /c "glslc Shaders/fullScreen.vert -o Shaders/Spv/fullScreen.vert.spv"')
-    os.system('cmd /c "glslc Shaders/fullScreen.frag -o Shaders/Spv/fullScreen.frag.spv"')
-
-    print("After compiling shaders:")
-
 def copyAssets():
     print("Before copying Assets:")
 
@@ -24,5 +16,4 @@ def copyAssets():
 
     print("After copying Assets:")
 
-compileShader()
 copyAssets()
\ No newline at end of file